@@ -19,22 +19,63 @@
  * @date 2014
  * RLP tool.
  */
+#include <atomic>
 #include <clocale>
+#include <cstdlib>
 #include <fstream>
 #include <iostream>
+#include <new>
+#include <thread>
 #include <boost/algorithm/string.hpp>
 #include <boost/filesystem.hpp>
 #include <json_spirit/JsonSpiritHeaders.h>
 #include <libdevcore/CommonIO.h>
+#include <libdevcore/Hash.h>
 #include <libdevcore/RLP.h>
 #include <libdevcore/SHA3.h>
 #include <libdevcore/MemoryDB.h>
 #include <libdevcore/TrieDB.h>
+#include <libdevcore/TrieHash.h>
 #include <libdevcrypto/Common.h>
 #include <libdevcrypto/CryptoPP.h>
+#include <libethash/ethash.h>
+#include <libethcore/SealEngine.h>
+#include <libethereum/Block.h>
+#include <libethereum/BlockChain.h>
+#include <libethereum/State.h>
+#include <libethashseal/Ethash.h>
+#include <libethashseal/EthashAux.h>
+#include <libethashseal/GenesisInfo.h>
+#include <libevm/VM.h>
+#include <libevm/VMFactory.h>
+#include <libp2p/Host.h>
+#include <libp2p/Session.h>
+#include <libp2p/Capability.h>
+#include <libp2p/HostCapability.h>
 using namespace std;
 using namespace dev;
+using namespace dev::eth;
 namespace js = json_spirit;
+namespace fs = boost::filesystem;
+
+namespace
+{
+atomic<uint64_t> g_allocations{0};
+}
+
+// Counts every allocation, for the replay benchmark.
+void* operator new(size_t _size)
+{
+	g_allocations.fetch_add(1, memory_order_relaxed);
+	if (void* ret = malloc(_size ? _size : 1))
+		return ret;
+	throw bad_alloc();
+}
+
+void operator delete(void* _p) noexcept
+{
+	free(_p);
+}
 
 void help()
 {
@@ -42,6 +83,28 @@ void help()
 		<< "Usage bench <mode> [OPTIONS]" << endl
 		<< "Modes:" << endl
 		<< "    trie  Trie benchmarks." << endl
+		<< "    ordered-trie  Transactions/receipts root of 10 to 10000 items, against the generic trie hash." << endl
+		<< "    sha3  SHA3 benchmarks." << endl
+		<< "    hash  SHA-256 (per kernel) and RIPEMD-160 throughput on 32B to 1MB inputs." << endl
+		<< "    p2p  Loopback p2p message throughput against peer count." << endl
+		<< "    ethash  Light (cache-only) seal verification of many headers." << endl
+		<< "    record  Record a chain segment from a synced database, with the state it reads, into a file." << endl
+		<< "    replay  Import a recorded chain segment, verifying state roots, and report its throughput." << endl
+		<< endl
+		<< "P2P options:" << endl
+		<< "    --threads <n>  Number of network IO threads of the receiving host (default: 1)." << endl
+		<< endl
+		<< "Record options:" << endl
+		<< "    --db <path>  Database of the synced node (default: the default eth database)." << endl
+		<< "    --network main|ropsten  Chain of the database (default: main)." << endl
+		<< "    --from <n> --to <n>  First and last block of the segment." << endl
+		<< "    --file <path>  File to write the segment to." << endl
+		<< endl
+		<< "Replay options:" << endl
+		<< "    --file <path>  Recorded segment to replay." << endl
+		<< "    --threads <n>  Number of block verification threads (default: 1)." << endl
+		<< "    --vm interpreter|threaded|jit|smart  VM to execute the transactions with (default: interpreter)." << endl
+		<< "    --state-cache <n>  Unchanged accounts a state keeps cached (default: 1000)." << endl
 		<< endl
 		<< "General options:" << endl
 		<< "    -h,--help  Print this help message and exit." << endl
@@ -81,7 +144,13 @@ void setDefaultOrCLocale()
 
 enum class Mode {
 	Trie,
-	SHA3
+	OrderedTrie,
+	SHA3,
+	Hash,
+	P2P,
+	Ethash,
+	Record,
+	Replay
 };
 
 enum class Alphabet
@@ -146,10 +215,257 @@ private:
 	}
 };
 
+class BenchCapability: public p2p::Capability
+{
+public:
+	BenchCapability(shared_ptr<p2p::SessionFace> _s, p2p::HostCapabilityFace* _h, unsigned _idOffset, p2p::CapDesc const&, uint16_t _capID): Capability(_s, _h, _idOffset, _capID) {}
+	static string name() { return "bench"; }
+	static u256 version() { return 1; }
+	static unsigned messageCount() { return p2p::UserPacket + 1; }
+	void sendBenchMessage(bytes const& _payload) { RLPStream s; sealAndSend(prep(s, p2p::UserPacket, 1) << _payload); }
+
+	static atomic<unsigned> s_received;
+
+protected:
+	bool interpret(unsigned _id, RLP const&) override { ++s_received; return _id == p2p::UserPacket; }
+};
+
+atomic<unsigned> BenchCapability::s_received(0);
+
+class BenchHostCapability: public p2p::HostCapability<BenchCapability>
+{
+public:
+	void sendToAll(bytes const& _payload)
+	{
+		for (auto const& i: peerSessions())
+			if (auto c = p2p::capabilityFromSession<BenchCapability>(*i.first))
+				c->sendBenchMessage(_payload);
+	}
+};
+
+/// Connects @a _peers hosts to a single receiving host over loopback and measures the rate at which
+/// the receiver interprets their messages.
+void benchP2P(unsigned _peers, unsigned _ioThreads)
+{
+	char const* const localhost = "127.0.0.1";
+	unsigned const messages = 1000;
+	bytes const payload(256, 0x42);
+
+	p2p::NetworkPreferences serverPrefs(localhost, 0, false);
+	serverPrefs.discovery = false;
+	serverPrefs.ioThreads = _ioThreads;
+	p2p::Host server("bench", serverPrefs);
+	server.registerCapability(make_shared<BenchHostCapability>());
+	server.start();
+
+	vector<shared_ptr<p2p::Host>> clients;
+	vector<shared_ptr<BenchHostCapability>> caps;
+	for (unsigned i = 0; i < _peers; ++i)
+	{
+		p2p::NetworkPreferences prefs(localhost, 0, false);
+		prefs.discovery = false;
+		auto client = make_shared<p2p::Host>("bench", prefs);
+		caps.push_back(client->registerCapability(make_shared<BenchHostCapability>()));
+		client->start();
+		client->requirePeer(server.id(), p2p::NodeIPEndpoint(bi::address::from_string(localhost), server.listenPort(), server.listenPort()));
+		clients.push_back(client);
+	}
+
+	for (unsigned i = 0; i < 30000 && server.peerCount() < _peers; i += 10)
+		this_thread::sleep_for(chrono::milliseconds(10));
+	if (server.peerCount() < _peers)
+	{
+		cout << _peers << " peers: only " << server.peerCount() << " connected, skipping." << endl;
+		return;
+	}
+
+	BenchCapability::s_received = 0;
+	unsigned const total = _peers * messages;
+	Timer t;
+	for (unsigned i = 0; i < messages; ++i)
+		for (auto const& c: caps)
+			c->sendToAll(payload);
+	while (BenchCapability::s_received < total && t.elapsed() < 60)
+		this_thread::sleep_for(chrono::milliseconds(1));
+	double e = t.elapsed();
+
+	cout << _peers << " peers, " << _ioThreads << " io threads: " << BenchCapability::s_received << "/" << total << " messages, " << unsigned(BenchCapability::s_received / e) << " msg/s" << endl;
+}
+
+/// Version of the segment files written by recordSegment(). A segment file is the RLP list
+/// [version, network, [[block, total difficulty]...], [block...], [state node...]]: the blocks to replay, up to 256
+/// of their ancestors for BLOCKHASH and uncle checks, and every state trie node and code the blocks read.
+unsigned const c_segmentVersion = 1;
+
+int recordSegment(Network _network, string const& _dbPath, unsigned _from, unsigned _to, string const& _file)
+{
+	BlockChain bc(genesisParams(_network), _dbPath, WithExisting::Trust);
+	if (!_from || _from > _to || _to > bc.number())
+	{
+		cerr << "Blocks " << _from << " to " << _to << " are not in the database, which ends at " << bc.number() << "." << endl;
+		return 1;
+	}
+
+	// Anything read from disk is part of the pre-state; what the blocks write stays in the overlay.
+	map<h256, string> nodes;
+	OverlayDB stateDB = State::openDB(_dbPath, bc.genesisHash(), WithExisting::Trust);
+	stateDB.setReadObserver([&](h256 const& _h, string const& _v) { nodes.emplace(_h, _v); });
+
+	unsigned first = _from > 256 ? _from - 256 : 1;
+	RLPStream ancestors(_from - first);
+	for (unsigned n = first; n < _from; ++n)
+	{
+		h256 h = bc.numberHash(n);
+		ancestors.appendList(2) << bc.block(h) << bc.details(h).totalDifficulty;
+	}
+
+	RLPStream blocks(_to - _from + 1);
+	Block s(bc, stateDB);
+	Timer t;
+	for (unsigned n = _from; n <= _to; ++n)
+	{
+		bytes b = bc.block(bc.numberHash(n));
+		s.enactOn(bc.verifyBlock(&b, function<void(Exception&)>(), ImportRequirements::CheckTransactions), bc);
+		blocks << b;
+	}
+
+	RLPStream nodeList(nodes.size());
+	size_t nodeBytes = 0;
+	for (auto const& i: nodes)
+	{
+		nodeList << i.second;
+		nodeBytes += i.second.size();
+	}
+
+	RLPStream out(5);
+	out << c_segmentVersion << (unsigned)_network;
+	out.appendRaw(ancestors.out()).appendRaw(blocks.out()).appendRaw(nodeList.out());
+	writeFile(_file, out.out());
+	cout << "Recorded blocks " << _from << " to " << _to << " in " << t.elapsed() << " s: " << nodes.size() << " state nodes (" << nodeBytes / 1024 << " KB), " << (_from - first) << " ancestors." << endl;
+	return 0;
+}
+
+int replaySegment(string const& _file, unsigned _threads)
+{
+	bytes data = contents(_file);
+	RLP segment(data);
+	if (!segment.isList() || segment.itemCount() != 5 || segment[0].toInt<unsigned>() != c_segmentVersion)
+	{
+		cerr << "Not a recorded segment: " << _file << endl;
+		return 1;
+	}
+
+	fs::path dir = fs::temp_directory_path() / fs::unique_path("bench-replay-%%%%-%%%%-%%%%");
+	int ret = 0;
+	{
+		BlockChain bc(genesisParams((Network)segment[1].toInt<unsigned>()), dir.string(), WithExisting::Kill);
+		for (auto const& a: segment[2])
+			bc.insertWithoutParent(a[0].toBytes(), a[1].toInt<u256>());
+		u256 td = bc.details().totalDifficulty;
+
+		// No disk database: the whole pre-state is in the overlay.
+		OverlayDB db;
+		for (auto const& n: segment[4])
+		{
+			bytesConstRef v = n.toBytesConstRef();
+			db.insert(sha3(v), v);
+		}
+		vector<bytes> blocks;
+		for (auto const& b: segment[3])
+			blocks.push_back(b.toBytes());
+
+		// Seals aren't checked: that is ethash's cost, which the ethash mode measures.
+		Timer t;
+		vector<VerifiedBlockRef> verified(blocks.size());
+		vector<exception_ptr> errors(blocks.size());
+		atomic<size_t> next{0};
+		vector<thread> verifiers;
+		for (unsigned i = 0; i < _threads; ++i)
+			verifiers.push_back(thread([&]()
+			{
+				for (size_t j = next++; j < blocks.size(); j = next++)
+					try
+					{
+						verified[j] = bc.verifyBlock(&blocks[j], function<void(Exception&)>(), ImportRequirements::CheckTransactions | ImportRequirements::UncleBasic);
+					}
+					catch (...)
+					{
+						errors[j] = current_exception();
+					}
+			}));
+		for (auto& v: verifiers)
+			v.join();
+		double verifyTime = t.elapsed();
+		for (auto const& e: errors)
+			if (e)
+				rethrow_exception(e);
+
+		double enactTime = 0;
+		double commitTime = 0;
+		double insertTime = 0;
+		u256 gas;
+		size_t transactions = 0;
+		unsigned replayed = 0;
+		uint64_t allocations = g_allocations;
+		uint64_t translationsMade = VM::translationsMade();
+		uint64_t translationsReused = VM::translationsReused();
+		Block s(bc, db);
+		for (size_t i = 0; i < blocks.size(); ++i)
+		{
+			try
+			{
+				t.restart();
+				// Checks the state, receipts and log bloom against the header.
+				td += s.enactOn(verified[i], bc);
+				enactTime += t.elapsed();
+				t.restart();
+				s.cleanup(true);
+				commitTime += t.elapsed();
+			}
+			catch (Exception const& _e)
+			{
+				cerr << "Block #" << verified[i].info.number() << " failed: " << diagnostic_information(_e) << endl;
+				ret = 1;
+				break;
+			}
+			t.restart();
+			bc.insertWithoutParent(blocks[i], td);
+			insertTime += t.elapsed();
+			gas += verified[i].info.gasUsed();
+			transactions += verified[i].transactions.size();
+			++replayed;
+		}
+		allocations = g_allocations - allocations;
+		translationsMade = VM::translationsMade() - translationsMade;
+		translationsReused = VM::translationsReused() - translationsReused;
+
+		double total = verifyTime + enactTime + commitTime + insertTime;
+		cout << "Replayed " << replayed << "/" << blocks.size() << " blocks (" << transactions << " transactions, " << gas << " gas) with state roots verified." << endl;
+		cout << "  " << replayed / total << " blocks/s, " << double(gas) / total / 1000000 << " Mgas/s" << endl;
+		cout << "  verify: " << verifyTime * 1000 << " ms (" << _threads << " threads)" << endl;
+		cout << "  enact:  " << enactTime * 1000 << " ms" << endl;
+		cout << "  commit: " << commitTime * 1000 << " ms" << endl;
+		cout << "  chain:  " << insertTime * 1000 << " ms" << endl;
+		cout << "  " << allocations << " allocations importing, " << (replayed ? allocations / replayed : 0) << " per block" << endl;
+		if (translationsMade + translationsReused)
+			cout << "  threaded VM: " << translationsMade << " codes translated, " << translationsReused << " runs on a shared translation" << endl;
+	}
+	fs::remove_all(dir);
+	return ret;
+}
+
 int main(int argc, char** argv)
 {
 	setDefaultOrCLocale();
+	// Measurements start from a cold light cache and leave none behind in the DAG directory.
+	EthashAux::setLightPersistence(false);
 	Mode mode = Mode::Trie;
+	unsigned ioThreads = 1;
+	string dbPath;
+	Network network = Network::MainNetwork;
+	unsigned from = 0;
+	unsigned to = 0;
+	string file;
 
 	for (int i = 1; i < argc; ++i)
 	{
@@ -158,8 +474,64 @@ int main(int argc, char** argv)
 			help();
 		else if (arg == "trie")
 			mode = Mode::Trie;
+		else if (arg == "ordered-trie")
+			mode = Mode::OrderedTrie;
 		else if (arg == "sha3")
 			mode = Mode::SHA3;
+		else if (arg == "hash")
+			mode = Mode::Hash;
+		else if (arg == "p2p")
+			mode = Mode::P2P;
+		else if (arg == "ethash")
+			mode = Mode::Ethash;
+		else if (arg == "record")
+			mode = Mode::Record;
+		else if (arg == "replay")
+			mode = Mode::Replay;
+		else if (arg == "--threads" && i + 1 < argc)
+			ioThreads = max(1, atoi(argv[++i]));
+		else if (arg == "--db" && i + 1 < argc)
+			dbPath = argv[++i];
+		else if (arg == "--network" && i + 1 < argc)
+		{
+			string n = argv[++i];
+			if (n == "main")
+				network = Network::MainNetwork;
+			else if (n == "ropsten")
+				network = Network::Ropsten;
+			else
+			{
+				cerr << "Unknown network: " << n << endl;
+				return 1;
+			}
+		}
+		else if (arg == "--from" && i + 1 < argc)
+			from = atoi(argv[++i]);
+		else if (arg == "--to" && i + 1 < argc)
+			to = atoi(argv[++i]);
+		else if (arg == "--file" && i + 1 < argc)
+			file = argv[++i];
+		else if (arg == "--state-cache" && i + 1 < argc)
+			State::setCacheLimit(atoi(argv[++i]));
+		else if (arg == "--vm" && i + 1 < argc)
+		{
+			string vm = argv[++i];
+			if (vm == "interpreter")
+				VMFactory::setKind(VMKind::Interpreter);
+			else if (vm == "threaded")
+				VMFactory::setKind(VMKind::Threaded);
+#if ETH_EVMJIT
+			else if (vm == "jit")
+				VMFactory::setKind(VMKind::JIT);
+			else if (vm == "smart")
+				VMFactory::setKind(VMKind::Smart);
+#endif
+			else
+			{
+				cerr << "Unknown/unsupported VM kind: " << vm << endl;
+				return 1;
+			}
+		}
 		else if (arg == "-V" || arg == "--version")
 			version();
 	}
@@ -190,6 +562,36 @@ int main(int argc, char** argv)
 			cout << sm.first << ": " << e * 1000000 << " us, root=" << t.root() << endl;
 		}
 	}
+	else if (mode == Mode::OrderedTrie)
+	{
+		h256 seed;
+		for (unsigned count: { 10, 100, 1000, 10000 })
+		{
+			// Transaction-sized items.
+			vector<bytes> items;
+			BytesMap m;
+			for (unsigned i = 0; i < count; ++i)
+			{
+				seed = sha3(seed);
+				items.push_back(bytes(100 + seed[0] % 100, seed[1]));
+				m[rlp(i)] = items.back();
+			}
+			unsigned trials = max(1u, 100000 / count);
+
+			Timer t;
+			h256 ordered;
+			for (unsigned trial = 0; trial < trials; ++trial)
+				ordered = orderedTrieRoot(items);
+			double e = t.elapsed() / trials;
+			t.restart();
+			h256 generic;
+			for (unsigned trial = 0; trial < trials; ++trial)
+				generic = hash256(m);
+			double g = t.elapsed() / trials;
+
+			cout << count << " items: " << e * 1000000 << " us ordered, " << g * 1000000 << " us generic" << (ordered == generic ? "" : " MISMATCH") << endl;
+		}
+	}
 	else if (mode == Mode::SHA3)
 	{
 		unsigned trials = 50;
@@ -202,6 +604,68 @@ int main(int argc, char** argv)
 		}
 		cout << "sha3 x 1000: " << t.elapsed() / trials * 1000000 << "us " << endl;
 	}
+	else if (mode == Mode::Hash)
+	{
+		// Each size hashes 64MB in total, so the per-call overhead shows at the small end.
+		size_t const total = 64 * 1024 * 1024;
+		auto run = [&](string const& _name, function<void(bytesConstRef)> const& _hash)
+		{
+			cout << _name << ":";
+			for (size_t size: { 32, 256, 4096, 65536, 1048576 })
+			{
+				bytes data(size, 0x5a);
+				Timer t;
+				for (size_t done = 0; done < total; done += size)
+					_hash(&data);
+				cout << " " << size << "B " << total / t.elapsed() / 1048576 << "MB/s";
+			}
+			cout << endl;
+		};
+		if (sha256Supported(SHA256Kernel::SHAExtensions))
+			run("sha256 (SHA extensions)", [](bytesConstRef _d) { sha256(_d, SHA256Kernel::SHAExtensions); });
+		run("sha256 (portable)", [](bytesConstRef _d) { sha256(_d, SHA256Kernel::Portable); });
+		run("ripemd160", [](bytesConstRef _d) { ripemd160(_d); });
+	}
+	else if (mode == Mode::P2P)
+	{
+		p2p::NodeIPEndpoint::test_allowLocal = true;
+		for (unsigned peers: { 1, 4, 16, 64 })
+			benchP2P(peers, ioThreads);
+	}
+	else if (mode == Mode::Ethash)
+	{
+		unsigned const headers = 1024;
+		ethash_light_t light = ethash_light_new(0);
+		vector<ethash_h256_t> headerHashes(headers);
+		vector<uint64_t> nonces(headers);
+		for (unsigned i = 0; i < headers; ++i)
+		{
+			h256 h = sha3(toBigEndian(u256(i)));
+			memcpy(&headerHashes[i], h.data(), 32);
+			nonces[i] = i;
+		}
+
+		Timer t;
+		for (unsigned i = 0; i < headers; ++i)
+			ethash_light_compute(light, headerHashes[i], nonces[i]);
+		double elapsed = t.elapsed();
+
+		cout << "ethash light x " << headers << ": " << elapsed * 1000 << "ms, " << elapsed * 1000000 / headers << "us per header" << endl;
+		ethash_light_delete(light);
+	}
+	else if (mode == Mode::Record || mode == Mode::Replay)
+	{
+		if (file.empty())
+		{
+			cerr << "No --file given." << endl;
+			return 1;
+		}
+		Ethash::init();
+		NoProof::init();
+		if (mode == Mode::Record)
+			return recordSegment(network, dbPath, from, to, file);
+		return replaySegment(file, ioThreads);
+	}
 
 	return 0;
 }
@@ -32,11 +32,13 @@
 #include <boost/filesystem.hpp>
 
 #include <libdevcore/FileSystem.h>
+#include <libdevcore/MemoryAccounting.h>
 #include <libethashseal/EthashAux.h>
 #include <libevm/VM.h>
 #include <libevm/VMFactory.h>
 #include <libethcore/KeyManager.h>
 #include <libethcore/ICAP.h>
+#include <libethcore/PrecompiledCache.h>
 #include <libethereum/Defaults.h>
 #include <libethereum/BlockChainSync.h>
 #include <libethashseal/EthashClient.h>
@@ -131,6 +133,7 @@ void help()
 		<< "    --no-bootstrap  Do not connect to the default Ethereum peer servers (default only when --no-discovery is used)." << endl
 		<< "    -x,--peers <number>  Attempt to connect to a given number of peers (default: 11)." << endl
 		<< "    --peer-stretch <number>  Give the accepted connection multiplier (default: 7)." << endl
+		<< "    --network-threads <number>  Number of threads servicing network IO (default: 1)." << endl
 
 		<< "    --public-ip <ip>  Force advertised public IP to the given IP (default: auto)." << endl
 		<< "    --listen-ip <ip>(:<port>)  Listen on the given IP for incoming connections (default: 0.0.0.0)." << endl
@@ -162,9 +165,9 @@ void help()
 		<< endl
 		<< "General Options:" << endl
 		<< "    -d,--db-path,--datadir <path>  Load database from path (default: " << getDataDir() << ")." << endl
-#if ETH_EVMJIT
-		<< "    --vm <vm-kind>  Select VM; options are: interpreter, jit or smart (default: interpreter)." << endl
-#endif // ETH_EVMJIT
+		<< "    --memory-limit <name>=<bytes>  Trim the caches or queues reporting memory under name when they grow past bytes (see admin_memoryUsage)." << endl
+		<< "    --vm <vm-kind>  Select VM; options are: interpreter, threaded, jit or smart (default: interpreter)." << endl
+		<< "    --no-precompiled-cache  Always run the precompiled contracts rather than reuse outputs for repeated inputs." << endl
 		<< "    -v,--verbosity <0 - 9>  Set the log verbosity from 0 to 9 (default: 8)." << endl
 		<< "    -V,--version  Show the version and exit." << endl
 		<< "    -h,--help  Show this help message and exit." << endl
@@ -343,7 +346,7 @@ int main(int argc, char** argv)
 	std::string rpcCorsDomain = "";
 
 	string jsonAdmin;
-	ChainParams chainParams(genesisInfo(eth::Network::MainNetwork), genesisStateRoot(eth::Network::MainNetwork));
+	ChainParams chainParams = genesisParams(eth::Network::MainNetwork);
 	u256 gasFloor = Invalid256;
 	string privateChain;
 
@@ -360,6 +363,7 @@ int main(int argc, char** argv)
 
 	unsigned peers = 11;
 	unsigned peerStretch = 7;
+	unsigned networkThreads = 1;
 	std::map<NodeID, pair<NodeIPEndpoint,bool>> preferredNodes;
 	bool bootstrap = true;
 	bool disableDiscovery = false;
@@ -573,6 +577,19 @@ int main(int argc, char** argv)
 			setDataDir(argv[++i]);
 		else if (arg == "--ipcpath" && i + 1 < argc )
 			setIpcPath(argv[++i]);
+		else if (arg == "--memory-limit" && i + 1 < argc)
+			try {
+				string limit = argv[++i];
+				size_t eq = limit.find('=');
+				if (eq == string::npos || !eq)
+					throw invalid_argument(limit);
+				MemoryAccounting::get().setSoftLimit(limit.substr(0, eq), stoull(limit.substr(eq + 1)));
+			}
+			catch (...)
+			{
+				cerr << "Bad " << arg << " option: " << argv[i] << endl;
+				return -1;
+			}
 		else if ((arg == "--genesis-json" || arg == "--genesis") && i + 1 < argc)
 		{
 			try
@@ -612,12 +629,12 @@ int main(int argc, char** argv)
 		else if (arg == "--gas-floor" && i + 1 < argc)
 			gasFloor = u256(argv[++i]);
 		else if (arg == "--mainnet")
-			chainParams = ChainParams(genesisInfo(eth::Network::MainNetwork), genesisStateRoot(eth::Network::MainNetwork));
+			chainParams = genesisParams(eth::Network::MainNetwork);
 		else if (arg == "--ropsten" || arg == "--testnet")
-			chainParams = ChainParams(genesisInfo(eth::Network::Ropsten), genesisStateRoot(eth::Network::Ropsten));
+			chainParams = genesisParams(eth::Network::Ropsten);
 		else if (arg == "--oppose-dao-fork")
 		{
-			chainParams = ChainParams(genesisInfo(eth::Network::MainNetwork), genesisStateRoot(eth::Network::MainNetwork));
+			chainParams = genesisParams(eth::Network::MainNetwork);
 			chainParams.otherParams["daoHardforkBlock"] = toHex(u256(-1) - 10, HexPrefix::Add);
 		}
 		else if (arg == "--support-dao-fork")
@@ -770,6 +787,8 @@ int main(int argc, char** argv)
 			peers = atoi(argv[++i]);
 		else if (arg == "--peer-stretch" && i + 1 < argc)
 			peerStretch = atoi(argv[++i]);
+		else if (arg == "--network-threads" && i + 1 < argc)
+			networkThreads = max(1, atoi(argv[++i]));
 		else if (arg == "--peerset" && i + 1 < argc)
 		{
 			string peerset = argv[++i];
@@ -840,23 +859,27 @@ int main(int argc, char** argv)
 				return -1;
 			}
 		}
-#if ETH_EVMJIT
 		else if (arg == "--vm" && i + 1 < argc)
 		{
 			string vmKind = argv[++i];
 			if (vmKind == "interpreter")
 				VMFactory::setKind(VMKind::Interpreter);
+			else if (vmKind == "threaded")
+				VMFactory::setKind(VMKind::Threaded);
+#if ETH_EVMJIT
 			else if (vmKind == "jit")
 				VMFactory::setKind(VMKind::JIT);
 			else if (vmKind == "smart")
 				VMFactory::setKind(VMKind::Smart);
+#endif
 			else
 			{
 				cerr << "Unknown VM kind: " << vmKind << endl;
 				return -1;
 			}
 		}
-#endif
+		else if (arg == "--no-precompiled-cache")
+			PrecompiledCache::instance().setEnabled(false);
 		else if (arg == "--shh")
 			useWhisper = true;
 		else if (arg == "-h" || arg == "--help")
@@ -1003,6 +1026,7 @@ int main(int argc, char** argv)
 	auto netPrefs = publicIP.empty() ? NetworkPreferences(listenIP, listenPort, upnp) : NetworkPreferences(publicIP, listenIP ,listenPort, upnp);
 	netPrefs.discovery = (privateChain.empty() && !disableDiscovery) || enableDiscovery;
 	netPrefs.pin = (pinning || !privateChain.empty()) && !noPinning;
+	netPrefs.ioThreads = networkThreads;
 
 	auto nodesState = contents(getDataDir() + "/network.rlp");
 	auto caps = useWhisper ? set<string>{"eth", "shh"} : set<string>{"eth"};
@@ -0,0 +1,229 @@
+/*
+	This file is part of cpp-ethereum.
+
+	cpp-ethereum is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	cpp-ethereum is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with cpp-ethereum.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/** @file FarmIpcClient.h
+ * @date 2017
+ * Work server connection over the node's IPC socket, with work pushed by the node.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <json/json.h>
+#include <libdevcore/CommonJS.h>
+#include <libdevcore/Guards.h>
+#include <libdevcore/Log.h>
+#if !defined(_WIN32)
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+/**
+ * @brief Talks to a node through its IPC socket, subscribing to "newWork" rather than polling eth_getWork.
+ * Submissions are written without waiting for the node's answers, which the reader thread reports as they come.
+ */
+class FarmIpcClient
+{
+public:
+	struct Work
+	{
+		dev::h256 headerHash;
+		dev::h256 seedHash;
+		dev::h256 boundary;
+		int64_t latency;			///< Microseconds between the node publishing the work and it arriving here.
+	};
+	using WorkHandler = std::function<void(Work const&)>;
+
+	/// Connects to the socket at @a _path and subscribes; @a _onWork is called from the reader thread.
+	/// @throws std::runtime_error if the node can't be reached.
+	FarmIpcClient(std::string const& _path, WorkHandler const& _onWork): m_onWork(_onWork)
+	{
+#if defined(_WIN32)
+		(void)_path;
+		throw std::runtime_error("IPC farming is not supported on Windows");
+#else
+		sockaddr_un addr;
+		std::memset(&addr, 0, sizeof(addr));
+		addr.sun_family = AF_UNIX;
+		if (_path.size() >= sizeof(addr.sun_path))
+			throw std::runtime_error("IPC path too long: " + _path);
+		std::strncpy(addr.sun_path, _path.c_str(), sizeof(addr.sun_path) - 1);
+
+		m_socket = ::socket(AF_UNIX, SOCK_STREAM, 0);
+		if (m_socket < 0 || ::connect(m_socket, (sockaddr const*)&addr, sizeof(addr)) < 0)
+		{
+			if (m_socket >= 0)
+				::close(m_socket);
+			throw std::runtime_error("Couldn't connect to " + _path);
+		}
+		m_open = true;
+		m_reader = std::thread([this]() { read(); });
+
+		Json::Value params(Json::arrayValue);
+		params.append("newWork");
+		send("eth_subscribe", params, c_subscribeId);
+#endif
+	}
+
+	~FarmIpcClient()
+	{
+#if !defined(_WIN32)
+		m_open = false;
+		::shutdown(m_socket, SHUT_RDWR);
+		if (m_reader.joinable())
+			m_reader.join();
+		::close(m_socket);
+#endif
+	}
+
+	/// @returns false once the connection was lost or the subscription was refused.
+	bool isOpen() const { return m_open; }
+
+	void submitWork(dev::h64 const& _nonce, dev::h256 const& _headerHash, dev::h256 const& _mixHash)
+	{
+		Json::Value params(Json::arrayValue);
+		params.append("0x" + _nonce.hex());
+		params.append("0x" + _headerHash.hex());
+		params.append("0x" + _mixHash.hex());
+		send("eth_submitWork", params, ++m_lastId);
+	}
+
+	void submitHashrate(dev::u256 const& _rate, dev::h256 const& _id)
+	{
+		Json::Value params(Json::arrayValue);
+		params.append(dev::toJS(_rate));
+		params.append("0x" + _id.hex());
+		send("eth_submitHashrate", params, c_hashrateId);
+	}
+
+private:
+	static int const c_subscribeId = 1;
+	static int const c_hashrateId = 2;
+
+	void send(std::string const& _method, Json::Value const& _params, int _id)
+	{
+#if !defined(_WIN32)
+		Json::Value r(Json::objectValue);
+		r["jsonrpc"] = "2.0";
+		r["method"] = _method;
+		r["params"] = _params;
+		r["id"] = _id;
+		std::string s = Json::FastWriter().write(r);
+		dev::Guard l(x_write);
+		for (size_t done = 0; done < s.size() && m_open;)
+		{
+			ssize_t n = ::send(m_socket, s.data() + done, s.size() - done, MSG_NOSIGNAL);
+			if (n <= 0)
+				m_open = false;
+			else
+				done += n;
+		}
+#else
+		(void)_method;
+		(void)_params;
+		(void)_id;
+#endif
+	}
+
+	/// Splits the stream into messages the same way the node's IPC server does, by balancing braces.
+	void read()
+	{
+#if !defined(_WIN32)
+		std::string message;
+		int depth = 0;
+		bool escaped = false;
+		bool inString = false;
+		char buffer[4096];
+		while (m_open)
+		{
+			ssize_t n = ::recv(m_socket, buffer, sizeof(buffer), 0);
+			if (n <= 0)
+				break;
+			for (ssize_t i = 0; i < n; ++i)
+			{
+				char c = buffer[i];
+				if (!depth && c != '{')
+					continue;
+				message += c;
+				if (escaped)
+					escaped = false;
+				else if (inString && c == '\\')
+					escaped = true;
+				else if (c == '"')
+					inString = !inString;
+				else if (!inString && c == '{')
+					++depth;
+				else if (!inString && c == '}' && !--depth)
+				{
+					handle(message);
+					message.clear();
+				}
+			}
+		}
+		m_open = false;
+#endif
+	}
+
+	void handle(std::string const& _message)
+	{
+		Json::Value v;
+		if (!Json::Reader().parse(_message, v, false) || !v.isObject())
+			return;
+
+		if (v["method"].asString() == "eth_subscription")
+		{
+			Json::Value const& result = v["params"]["result"];
+			Json::Value const& work = result["work"];
+			if (!work.isArray() || work.size() < 3)
+				return;
+			int64_t now = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+			Work w;
+			w.headerHash = dev::h256(work[0].asString());
+			w.seedHash = dev::h256(work[1].asString());
+			w.boundary = dev::h256(dev::fromHex(work[2].asString()), dev::h256::AlignRight);
+			w.latency = result.isMember("publishedAt") ? std::max<int64_t>(now - result["publishedAt"].asInt64(), 0) : 0;
+			m_onWork(w);
+		}
+		else if (v.isMember("error"))
+		{
+			cwarn << "Work server error:" << v["error"]["message"].asString();
+			if (v["id"].asInt() == c_subscribeId)
+				m_open = false;
+		}
+		else if (v["id"].asInt() > c_hashrateId)
+		{
+			if (v["result"].asBool())
+				cnote << "B-) Submitted and accepted.";
+			else
+				cwarn << ":-( Not accepted.";
+		}
+	}
+
+	WorkHandler m_onWork;
+	int m_socket = -1;
+	std::atomic<bool> m_open{false};
+	std::atomic<int> m_lastId{c_hashrateId};
+	std::thread m_reader;
+	dev::Mutex x_write;
+};
@@ -24,11 +24,13 @@
 
 #include <boost/algorithm/string/case_conv.hpp>
 #include <libdevcore/CommonJS.h>
+#include <libdevcore/FileSystem.h>
 #include <libethcore/BasicAuthority.h>
 #include <libethcore/Exceptions.h>
 #include <libethashseal/EthashCPUMiner.h>
 #include <jsonrpccpp/client/connectors/httpclient.h>
 #include "FarmClient.h"
+#include "FarmIpcClient.h"
 
 // TODO - having using derivatives in header files is very poor style, and we need to fix these up.
 //
@@ -112,6 +114,11 @@ public:
 			mode = OperationMode::Farm;
 			m_farmURL = argv[++i];
 		}
+		else if (arg == "--farm-ipc")
+		{
+			mode = OperationMode::Farm;
+			m_farmIpcPath = (i + 1 < argc && argv[i + 1][0] != '-') ? argv[++i] : getIpcPath() + "/geth.ipc";
+		}
 		else if (arg == "--farm-recheck" && i + 1 < argc)
 			try {
 				m_farmRecheckPeriod = stol(argv[++i]);
@@ -150,6 +157,25 @@ public:
 			}
 		else if (arg == "-C" || arg == "--cpu")
 			m_minerType = "cpu";
+		else if (arg == "--dag-pages" && i + 1 < argc)
+		{
+			string p = argv[++i];
+			if (p == "default")
+				m_dagPlacement.pages = ETHASH_PAGES_DEFAULT;
+			else if (p == "thp")
+				m_dagPlacement.pages = ETHASH_PAGES_TRANSPARENT;
+			else if (p == "2mb")
+				m_dagPlacement.pages = ETHASH_PAGES_2MB;
+			else if (p == "1gb")
+				m_dagPlacement.pages = ETHASH_PAGES_1GB;
+			else
+			{
+				cerr << "Bad " << arg << " option: " << p << endl;
+				BOOST_THROW_EXCEPTION(BadArgument());
+			}
+		}
+		else if (arg == "--numa")
+			m_dagPlacement.perNumaNode = true;
 		else if (arg == "--current-block" && i + 1 < argc)
 			m_currentBlock = stol(argv[++i]);
 		else if (arg == "--no-precompute")
@@ -230,11 +256,16 @@ public:
 	void execute()
 	{
 		if (m_minerType == "cpu")
+		{
 			EthashCPUMiner::setNumInstances(m_miningThreads);
+			EthashAux::setDAGPlacement(m_dagPlacement);
+		}
 		if (mode == OperationMode::DAGInit)
 			doInitDAG(m_initDAG);
 		else if (mode == OperationMode::Benchmark)
 			doBenchmark(m_minerType, m_benchmarkWarmup, m_benchmarkTrial, m_benchmarkTrials);
+		else if (mode == OperationMode::Farm && !m_farmIpcPath.empty())
+			doFarmIpc(m_minerType, m_farmIpcPath);
 		else if (mode == OperationMode::Farm)
 			doFarm(m_minerType, m_farmURL, m_farmRecheckPeriod);
 	}
@@ -245,6 +276,7 @@ public:
 			<< "Work farming mode:" << endl
 			<< "    -F,--farm <url>  Put into mining farm mode with the work server at URL (default: http://127.0.0.1:8545)" << endl
 			<< "    --farm-recheck <n>  Leave n ms between checks for changed work (default: 500)." << endl
+			<< "    --farm-ipc [path]  Put into mining farm mode with work pushed over the node's IPC socket (default: " << getIpcPath() << "/geth.ipc)." << endl
 			<< "    --no-precompute  Don't precompute the next epoch's DAG." << endl
 			<< "Ethash verify mode:" << endl
 			<< "    -w,--check-pow <headerHash> <seedHash> <difficulty> <nonce>  Check PoW credentials for validity." << endl
@@ -259,6 +291,8 @@ public:
 			<< "Mining configuration:" << endl
 			<< "    -C,--cpu  When mining, use the CPU." << endl
 			<< "    -t, --mining-threads <n> Limit number of CPU/GPU miners to n (default: use everything available on selected platform)" << endl
+			<< "    --dag-pages <default|thp|2mb|1gb>  Keep the CPU miner's DAG on (transparent or explicit) huge pages, falling back to smaller ones (default: default)." << endl
+			<< "    --numa  Replicate the CPU miner's DAG on each NUMA node and pin miner threads next to their copy." << endl
 			<< "    --current-block Let the miner know the current block number at configuration time. Will help determine DAG size and required GPU memory." << endl
 			<< "    --disable-submit-hashrate  When mining, don't submit hashrate to node." << endl;
 	}
@@ -300,6 +334,7 @@ private:
 		map<u256, WorkingProgress> results;
 		u256 mean = 0;
 		u256 innerMean = 0;
+		pair<uint64_t, uint64_t> lastDtlb = EthashCPUMiner::dtlbMisses();
 		for (unsigned i = 0; i <= _trials; ++i)
 		{
 			if (!i)
@@ -310,11 +345,17 @@ private:
 
 			auto mp = f.miningProgress();
 			f.resetMiningProgress();
+			auto dtlb = EthashCPUMiner::dtlbMisses();
+			auto trialDtlb = make_pair(dtlb.first - lastDtlb.first, dtlb.second - lastDtlb.second);
+			lastDtlb = dtlb;
 			if (!i)
 				continue;
 			auto rate = mp.rate();
 
-			cout << rate << endl;
+			cout << rate;
+			if (_m == "cpu" && trialDtlb.second)
+				cout << " (" << (double)trialDtlb.first / trialDtlb.second << " dTLB misses/hash)";
+			cout << endl;
 			results[rate] = mp;
 			mean += rate;
 		}
@@ -439,6 +480,104 @@ private:
 		exit(0);
 	}
 
+	/// Farms on work pushed by the node over IPC: new work reaches the miners as soon as it is prepared, and
+	/// solutions go out without waiting for the node's answer.
+	void doFarmIpc(std::string _m, string const& _path)
+	{
+		map<string, GenericFarm<EthashProofOfWork>::SealerDescriptor> sealers;
+		sealers["cpu"] = GenericFarm<EthashProofOfWork>::SealerDescriptor{&EthashCPUMiner::instances, [](GenericMiner<EthashProofOfWork>::ConstructionInfo ci){ return new EthashCPUMiner(ci); }};
+
+		h256 id = h256::random();
+		GenericFarm<EthashProofOfWork> f;
+		f.setSealers(sealers);
+		f.start(_m);
+
+		Mutex x_current;
+		EthashProofOfWork::WorkPackage current;
+		EthashAux::FullType dag;
+		unsigned packages = 0;
+		int64_t totalLatency = 0;
+		int64_t maxLatency = 0;
+		auto onWork = [&](FarmIpcClient::Work const& _w)
+		{
+			if (current.seedHash != _w.seedHash)
+			{
+				minelog << "Grabbing DAG for" << _w.seedHash;
+				if (!(dag = EthashAux::full(_w.seedHash, true, [&](unsigned _pc){ cout << "\rCreating DAG. " << _pc << "% done..." << flush; return 0; })))
+				{
+					cwarn << "Couldn't create the DAG for" << _w.seedHash;
+					return;
+				}
+				if (m_precompute)
+					EthashAux::computeFull(sha3(_w.seedHash), true);
+			}
+			EthashProofOfWork::WorkPackage w;
+			w.headerHash = _w.headerHash;
+			w.seedHash = _w.seedHash;
+			w.boundary = _w.boundary;
+			DEV_GUARDED(x_current)
+			{
+				current = w;
+				++packages;
+				totalLatency += _w.latency;
+				maxLatency = max(maxLatency, _w.latency);
+			}
+			minelog << "Got work package" << w.headerHash.abridged() << "delivered in" << _w.latency << "us";
+			f.setWork(w);
+		};
+
+		while (true)
+		{
+			shared_ptr<FarmIpcClient> node;
+			try
+			{
+				node = make_shared<FarmIpcClient>(_path, onWork);
+			}
+			catch (std::runtime_error const& _e)
+			{
+				for (auto i = 3; --i; this_thread::sleep_for(chrono::seconds(1)))
+					cerr << _e.what() << ". Retrying in " << i << "... \r";
+				cerr << endl;
+				continue;
+			}
+
+			// A miner thread may still be in this handler after it is replaced below, so it holds its own
+			// reference to the client.
+			f.onSolutionFound([&, node](EthashProofOfWork::Solution sol)
+			{
+				EthashProofOfWork::WorkPackage w;
+				DEV_GUARDED(x_current)
+					w = current;
+				if (!w || EthashAux::eval(w.seedHash, w.headerHash, sol.nonce).value >= w.boundary)
+				{
+					cwarn << "FAILURE: GPU gave incorrect result!";
+					return false;
+				}
+				cnote << "Solution found for" << w.headerHash.abridged() << "; submitting nonce" << sol.nonce.hex();
+				node->submitWork(sol.nonce, w.headerHash, sol.mixHash);
+				// Keep mining until the node pushes the next package; the answer comes back asynchronously.
+				return false;
+			});
+
+			while (node->isOpen())
+			{
+				this_thread::sleep_for(chrono::seconds(1));
+				auto mp = f.miningProgress();
+				f.resetMiningProgress();
+				DEV_GUARDED(x_current)
+					if (current)
+						minelog << "Mining on PoWhash" << current.headerHash << ": " << mp << "; work latency" << (totalLatency / packages) << "us mean," << maxLatency << "us max over" << packages << "packages";
+					else
+						minelog << "Waiting for work package...";
+				if (m_submitHashrate)
+					node->submitHashrate((u256)mp.rate(), id);
+			}
+			f.onSolutionFound([](EthashProofOfWork::Solution) { return false; });
+			cerr << "Lost connection to " << _path << "." << endl;
+		}
+		exit(0);
+	}
+
 	/// Operating mode.
 	OperationMode mode;
 
@@ -451,6 +590,7 @@ private:
 	unsigned m_initDAG = 0;
 
 	/// Benchmarking params
+	EthashAux::DAGPlacement m_dagPlacement;
 	unsigned m_benchmarkWarmup = 3;
 	unsigned m_benchmarkTrial = 3;
 	unsigned m_benchmarkTrials = 5;
@@ -458,6 +598,7 @@ private:
 	/// Farm params
 	string m_farmURL = "http://127.0.0.1:8545";
 	unsigned m_farmRecheckPeriod = 500;
+	string m_farmIpcPath;
 	bool m_precompute = true;
 	bool m_submitHashrate = true;
 };
@@ -32,18 +32,20 @@
 #include <libethereum/ChainParams.h>
 #include <libethashseal/GenesisInfo.h>
 #include <libethashseal/Ethash.h>
+#include <libethashseal/EthashAux.h>
 #include <libevm/VM.h>
 #include <libevm/VMFactory.h>
+#include <libevm/VMProfiler.h>
 using namespace std;
 using namespace dev;
 using namespace eth;
 
-static const int64_t MaxBlockGasLimit = ChainParams(genesisInfo(Network::MainNetwork)).u256Param("maxGasLimit").convert_to<int64_t>();
+static const int64_t MaxBlockGasLimit = genesisConfig(Network::MainNetwork).u256Param("maxGasLimit").convert_to<int64_t>();
 
 void help()
 {
 	cout
-		<< "Usage ethvm <options> [trace|stats|output|test] (<file>|-)" << endl
+		<< "Usage ethvm <options> [trace|stats|profile|output|test] (<file>|-)" << endl
 		<< "Transaction options:" << endl
 		<< "    --value <n>  Transaction should transfer the <n> wei (default: 0)." << endl
 		<< "    --gas <n>    Transaction should be given <n> gas (default: block gas limit)." << endl
@@ -53,10 +55,12 @@ void help()
 		<< "    --origin <a>  Transaction origin should be <a> (default: 0000...0069)." << endl
 		<< "    --input <d>   Transaction code should be <d>" << endl
 		<< "    --code <d>    Contract code <d>. Makes transaction a call to this contract" << endl
-#if ETH_EVMJIT
 		<< endl
 		<< "VM options:" << endl
-		<< "    --vm <vm-kind>  Select VM. Options are: interpreter, jit, smart. (default: interpreter)" << endl
+#if ETH_EVMJIT
+		<< "    --vm <vm-kind>  Select VM. Options are: interpreter, threaded, jit, smart. (default: interpreter)" << endl
+#else
+		<< "    --vm <vm-kind>  Select VM. Options are: interpreter, threaded. (default: interpreter)" << endl
 #endif // ETH_EVMJIT
 		<< "Network options:" << endl
 		<< "    --network Main|Ropsten|Homestead|Frontier" << endl
@@ -65,6 +69,11 @@ void help()
 		<< "    --flat  Minimal whitespace in the JSON." << endl
 		<< "    --mnemonics  Show instruction mnemonics in the trace (non-standard)." << endl
 		<< endl
+		<< "Options for profile:" << endl
+		<< "    --metric instructions|gas|cycles  Sort and fold by this metric (default: cycles)." << endl
+		<< "    --folded <file>  Also write flame graph stacks (folded format) to <file>." << endl
+		<< "    --folded-by opcode|contract  Stack by opcode or by contract and code range (default: opcode)." << endl
+		<< endl
 		<< "General options:" << endl
 		<< "    -V,--version  Show the version and exit." << endl
 		<< "    -h,--help  Show this help message and exit." << endl;
@@ -106,6 +115,8 @@ enum class Mode
 {
 	Trace,
 	Statistics,
+	/// Counts per opcode and per code range, through VMProfiler rather than OnOpFunc.
+	Profile,
 	OutputOnly,
 
 	/// Test mode -- output information needed for test verification and
@@ -133,9 +144,14 @@ int main(int argc, char** argv)
 	envInfo.setGasLimit(MaxBlockGasLimit);
 	bytes data;
 	bytes code;
+	VMProfiler::Metric metric = VMProfiler::Metric::Cycles;
+	string foldedFile;
+	bool foldedByContract = false;
 
 	Ethash::init();
 	NoProof::init();
+	// A one-off run: not worth leaving light caches in the DAG directory.
+	EthashAux::setLightPersistence(false);
 
 	for (int i = 1; i < argc; ++i)
 	{
@@ -149,6 +165,8 @@ int main(int argc, char** argv)
 			string vmKindStr = argv[++i];
 			if (vmKindStr == "interpreter")
 				vmKind = VMKind::Interpreter;
+			else if (vmKindStr == "threaded")
+				vmKind = VMKind::Threaded;
 #if ETH_EVMJIT
 			else if (vmKindStr == "jit")
 				vmKind = VMKind::JIT;
@@ -204,6 +222,36 @@ int main(int argc, char** argv)
 		}
 		else if (arg == "stats")
 			mode = Mode::Statistics;
+		else if (arg == "profile")
+			mode = Mode::Profile;
+		else if (arg == "--metric" && i + 1 < argc)
+		{
+			string m = argv[++i];
+			if (m == "instructions")
+				metric = VMProfiler::Metric::Instructions;
+			else if (m == "gas")
+				metric = VMProfiler::Metric::Gas;
+			else if (m == "cycles")
+				metric = VMProfiler::Metric::Cycles;
+			else
+			{
+				cerr << "Unknown metric: " << m << endl;
+				return -1;
+			}
+		}
+		else if (arg == "--folded" && i + 1 < argc)
+			foldedFile = argv[++i];
+		else if (arg == "--folded-by" && i + 1 < argc)
+		{
+			string by = argv[++i];
+			if (by == "opcode" || by == "contract")
+				foldedByContract = by == "contract";
+			else
+			{
+				cerr << "Unknown --folded-by: " << by << endl;
+				return -1;
+			}
+		}
 		else if (arg == "output")
 			mode = Mode::OutputOnly;
 		else if (arg == "trace")
@@ -267,7 +315,7 @@ int main(int argc, char** argv)
 
 	state.addBalance(sender, value);
 
-	unique_ptr<SealEngineFace> se(ChainParams(genesisInfo(networkName)).createSealEngine());
+	unique_ptr<SealEngineFace> se(genesisConfig(networkName).createSealEngine());
 	Executive executive(state, envInfo, *se);
 	ExecutionResult res;
 	executive.setResultRecipient(res);
@@ -295,6 +343,12 @@ int main(int argc, char** argv)
 	else
 		executive.create(sender, value, gasPrice, gas, &data, origin);
 
+	if (mode == Mode::Profile)
+	{
+		if (vmKind != VMKind::Interpreter && vmKind != VMKind::Threaded)
+			cerr << "Only the interpreters are profiled." << endl;
+		VMProfiler::start();
+	}
 	Timer timer;
 	if ((mode == Mode::Statistics || mode == Mode::Trace) && vmKind == VMKind::Interpreter)
 		// If we use onOp, the factory falls back to "interpreter"
@@ -302,6 +356,9 @@ int main(int argc, char** argv)
 	else
 		executive.go();
 	double execTime = timer.elapsed();
+	VMProfiler::Profile profile;
+	if (mode == Mode::Profile)
+		profile = VMProfiler::stop();
 	executive.finalize();
 	bytes output = std::move(res.output);
 
@@ -325,6 +382,28 @@ int main(int argc, char** argv)
 			if (!!counts[(byte)c].first)
 				cout << "  " << instructionInfo(c).name << " x " << counts[(byte)c].first << " (" << counts[(byte)c].second << " gas)" << endl;
 	}
+	else if (mode == Mode::Profile)
+	{
+		cout << "Gas used: " << res.gasUsed << " in " << execTime << " seconds." << endl;
+		vector<unsigned> ops;
+		VMProfiler::Stats total;
+		for (unsigned i = 0; i < 256; ++i)
+			if (profile.opcodes[i].count)
+			{
+				ops.push_back(i);
+				total += profile.opcodes[i];
+			}
+		sort(ops.begin(), ops.end(), [&](unsigned a, unsigned b) { return VMProfiler::value(profile.opcodes[a], metric) > VMProfiler::value(profile.opcodes[b], metric); });
+		cout << left << setw(16) << "opcode" << right << setw(14) << "count" << setw(14) << "gas" << setw(16) << "cycles" << setw(10) << "% cycles" << endl;
+		for (unsigned i: ops)
+		{
+			VMProfiler::Stats const& s = profile.opcodes[i];
+			cout << left << setw(16) << instructionInfo(Instruction(i)).name << right << setw(14) << s.count << setw(14) << s.gas << setw(16) << s.cycles << setw(10) << fixed << setprecision(2) << (total.cycles ? 100.0 * s.cycles / total.cycles : 0.0) << endl;
+		}
+		cout << left << setw(16) << "total" << right << setw(14) << total.count << setw(14) << total.gas << setw(16) << total.cycles << endl;
+		if (!foldedFile.empty())
+			writeFile(foldedFile, profile.folded(metric, foldedByContract));
+	}
 	else if (mode == Mode::Trace)
 		cout << st.json(styledJson);
 	else if (mode == Mode::OutputOnly)
@@ -23,20 +23,220 @@
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
-#include "picosha2.h"
+#if defined(__GNUC__) && defined(__x86_64__)
+#include <cpuid.h>
+#include <immintrin.h>
+#define ETH_SHA_NI 1
+#endif
 using namespace std;
 using namespace dev;
 
 namespace dev
 {
 
-h256 sha256(bytesConstRef _input)
+namespace sha256impl
+{
+
+uint32_t const c_k[64] = {
+	0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+	0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+	0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+	0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+	0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+	0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+	0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+	0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+uint32_t const c_init[8] = { 0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19 };
+
+/// Compresses @a _blocks consecutive 64-byte blocks into @a _state.
+using Compress = void(*)(uint32_t* _state, byte const* _data, size_t _blocks);
+
+inline uint32_t ror(uint32_t _x, unsigned _n) { return (_x >> _n) | (_x << (32 - _n)); }
+inline uint32_t loadBigEndian(byte const* _p) { return (uint32_t(_p[0]) << 24) | (uint32_t(_p[1]) << 16) | (uint32_t(_p[2]) << 8) | _p[3]; }
+
+// One round, with the schedule kept in a rolling window of 16 words.
+#define SHA256_ROUND(a, b, c, d, e, f, g, h, i) \
+{\
+	if ((i) >= 16) \
+		w[(i) & 15] += (ror(w[((i) - 2) & 15], 17) ^ ror(w[((i) - 2) & 15], 19) ^ (w[((i) - 2) & 15] >> 10)) + w[((i) - 7) & 15] + \
+			(ror(w[((i) - 15) & 15], 7) ^ ror(w[((i) - 15) & 15], 18) ^ (w[((i) - 15) & 15] >> 3)); \
+	uint32_t t1 = h + (ror(e, 6) ^ ror(e, 11) ^ ror(e, 25)) + (g ^ (e & (f ^ g))) + c_k[i] + w[(i) & 15]; \
+	uint32_t t2 = (ror(a, 2) ^ ror(a, 13) ^ ror(a, 22)) + ((a & b) | (c & (a | b))); \
+	d += t1; \
+	h = t1 + t2; \
+}
+
+void compressPortable(uint32_t* _state, byte const* _data, size_t _blocks)
+{
+	for (; _blocks; --_blocks, _data += 64)
+	{
+		uint32_t w[16];
+		for (unsigned i = 0; i < 16; ++i)
+			w[i] = loadBigEndian(_data + 4 * i);
+		uint32_t a = _state[0], b = _state[1], c = _state[2], d = _state[3], e = _state[4], f = _state[5], g = _state[6], h = _state[7];
+		for (unsigned i = 0; i < 64; i += 8)
+		{
+			SHA256_ROUND(a, b, c, d, e, f, g, h, i);
+			SHA256_ROUND(h, a, b, c, d, e, f, g, i + 1);
+			SHA256_ROUND(g, h, a, b, c, d, e, f, i + 2);
+			SHA256_ROUND(f, g, h, a, b, c, d, e, i + 3);
+			SHA256_ROUND(e, f, g, h, a, b, c, d, i + 4);
+			SHA256_ROUND(d, e, f, g, h, a, b, c, i + 5);
+			SHA256_ROUND(c, d, e, f, g, h, a, b, i + 6);
+			SHA256_ROUND(b, c, d, e, f, g, h, a, i + 7);
+		}
+		_state[0] += a; _state[1] += b; _state[2] += c; _state[3] += d;
+		_state[4] += e; _state[5] += f; _state[6] += g; _state[7] += h;
+	}
+}
+
+#undef SHA256_ROUND
+
+#if ETH_SHA_NI
+
+// Four rounds on message words m, also advancing the schedule: mn, the words after m, gets its
+// second half and mp, the words before, its first half, when they are still needed.
+#define SHA256_QUAD(q, m, mn, mp) \
+{\
+	__m128i msg = _mm_add_epi32(m, _mm_loadu_si128((__m128i const*)&c_k[4 * (q)])); \
+	state1 = _mm_sha256rnds2_epu32(state1, state0, msg); \
+	if ((q) >= 3 && (q) <= 14) \
+		mn = _mm_sha256msg2_epu32(_mm_add_epi32(mn, _mm_alignr_epi8(m, mp, 4)), m); \
+	state0 = _mm_sha256rnds2_epu32(state0, state1, _mm_shuffle_epi32(msg, 0x0e)); \
+	if ((q) >= 1 && (q) <= 12) \
+		mp = _mm_sha256msg1_epu32(mp, m); \
+}
+
+__attribute__((target("sha,sse4.1")))
+void compressSHAExtensions(uint32_t* _state, byte const* _data, size_t _blocks)
+{
+	__m128i const byteSwap = _mm_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL);
+
+	// The instructions want the state as ABEF and CDGH.
+	__m128i t = _mm_shuffle_epi32(_mm_loadu_si128((__m128i const*)&_state[0]), 0xb1);
+	__m128i state1 = _mm_shuffle_epi32(_mm_loadu_si128((__m128i const*)&_state[4]), 0x1b);
+	__m128i state0 = _mm_alignr_epi8(t, state1, 8);
+	state1 = _mm_blend_epi16(state1, t, 0xf0);
+
+	for (; _blocks; --_blocks, _data += 64)
+	{
+		__m128i abef = state0;
+		__m128i cdgh = state1;
+		__m128i m0 = _mm_shuffle_epi8(_mm_loadu_si128((__m128i const*)(_data + 0)), byteSwap);
+		__m128i m1 = _mm_shuffle_epi8(_mm_loadu_si128((__m128i const*)(_data + 16)), byteSwap);
+		__m128i m2 = _mm_shuffle_epi8(_mm_loadu_si128((__m128i const*)(_data + 32)), byteSwap);
+		__m128i m3 = _mm_shuffle_epi8(_mm_loadu_si128((__m128i const*)(_data + 48)), byteSwap);
+
+		SHA256_QUAD(0, m0, m1, m3);
+		SHA256_QUAD(1, m1, m2, m0);
+		SHA256_QUAD(2, m2, m3, m1);
+		SHA256_QUAD(3, m3, m0, m2);
+		SHA256_QUAD(4, m0, m1, m3);
+		SHA256_QUAD(5, m1, m2, m0);
+		SHA256_QUAD(6, m2, m3, m1);
+		SHA256_QUAD(7, m3, m0, m2);
+		SHA256_QUAD(8, m0, m1, m3);
+		SHA256_QUAD(9, m1, m2, m0);
+		SHA256_QUAD(10, m2, m3, m1);
+		SHA256_QUAD(11, m3, m0, m2);
+		SHA256_QUAD(12, m0, m1, m3);
+		SHA256_QUAD(13, m1, m2, m0);
+		SHA256_QUAD(14, m2, m3, m1);
+		SHA256_QUAD(15, m3, m0, m2);
+
+		state0 = _mm_add_epi32(state0, abef);
+		state1 = _mm_add_epi32(state1, cdgh);
+	}
+
+	t = _mm_shuffle_epi32(state0, 0x1b);
+	state1 = _mm_shuffle_epi32(state1, 0xb1);
+	_mm_storeu_si128((__m128i*)&_state[0], _mm_blend_epi16(t, state1, 0xf0));
+	_mm_storeu_si128((__m128i*)&_state[4], _mm_alignr_epi8(state1, t, 8));
+}
+
+#undef SHA256_QUAD
+
+bool cpuHasSHAExtensions()
+{
+	unsigned eax, ebx, ecx, edx;
+	if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx) || !(ecx & bit_SSSE3) || !(ecx & bit_SSE4_1))
+		return false;
+	return __get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx) && (ebx & (1u << 29));
+}
+
+#endif
+
+Compress compressFor(SHA256Kernel _kernel)
 {
+#if ETH_SHA_NI
+	if (_kernel == SHA256Kernel::SHAExtensions)
+		return compressSHAExtensions;
+#endif
+	(void)_kernel;
+	return compressPortable;
+}
+
+SHA256Kernel bestKernel()
+{
+	return sha256Supported(SHA256Kernel::SHAExtensions) ? SHA256Kernel::SHAExtensions : SHA256Kernel::Portable;
+}
+
+h256 hash(bytesConstRef _input, Compress _compress)
+{
+	uint32_t state[8];
+	memcpy(state, c_init, sizeof(state));
+	_compress(state, _input.data(), _input.size() / 64);
+
+	// The tail, the 0x80 terminator and the bit length fill one or two more blocks.
+	byte tail[128] = {};
+	size_t rest = _input.size() % 64;
+	if (rest)
+		memcpy(tail, _input.data() + _input.size() - rest, rest);
+	tail[rest] = 0x80;
+	size_t tailSize = rest < 56 ? 64 : 128;
+	uint64_t bits = uint64_t(_input.size()) * 8;
+	for (unsigned i = 0; i < 8; ++i)
+		tail[tailSize - 1 - i] = byte(bits >> (8 * i));
+	_compress(state, tail, tailSize / 64);
+
 	h256 ret;
-	picosha2::hash256(_input.begin(), _input.end(), ret.data(), ret.data() + 32);
+	for (unsigned i = 0; i < 8; ++i)
+		for (unsigned j = 0; j < 4; ++j)
+			ret[4 * i + j] = byte(state[i] >> (24 - 8 * j));
 	return ret;
 }
 
+}
+
+bool sha256Supported(SHA256Kernel _kernel)
+{
+#if ETH_SHA_NI
+	static bool const s_shaExtensions = sha256impl::cpuHasSHAExtensions();
+	if (_kernel == SHA256Kernel::SHAExtensions)
+		return s_shaExtensions;
+#endif
+	return _kernel == SHA256Kernel::Portable;
+}
+
+SHA256Kernel sha256Kernel()
+{
+	static SHA256Kernel const s_kernel = sha256impl::bestKernel();
+	return s_kernel;
+}
+
+h256 sha256(bytesConstRef _input, SHA256Kernel _kernel)
+{
+	return sha256impl::hash(_input, sha256impl::compressFor(_kernel));
+}
+
+h256 sha256(bytesConstRef _input)
+{
+	static sha256impl::Compress const s_compress = sha256impl::compressFor(sha256Kernel());
+	return sha256impl::hash(_input, s_compress);
+}
+
 namespace rmd160
 {
 
@@ -77,9 +277,9 @@ namespace rmd160
 
 /* the five basic functions F(), G() and H() */
 #define F(x, y, z)        ((x) ^ (y) ^ (z))
-#define G(x, y, z)        (((x) & (y)) | (~(x) & (z)))
+#define G(x, y, z)        ((z) ^ ((x) & ((y) ^ (z))))
 #define H(x, y, z)        (((x) | ~(y)) ^ (z))
-#define I(x, y, z)        (((x) & (z)) | ((y) & ~(z)))
+#define I(x, y, z)        ((y) ^ ((z) & ((x) ^ (y))))
 #define J(x, y, z)        ((x) ^ ((y) | ~(z)))
 
 /* the ten basic operations FF() through III() */
@@ -147,191 +347,183 @@ void MDinit(uint32_t *MDbuf)
 
 /********************************************************************/
 
-void MDcompress(uint32_t *MDbuf, uint32_t *X)
+void MDcompress(uint32_t *MDbuf, uint32_t const *X)
 {
 	uint32_t aa = MDbuf[0],  bb = MDbuf[1],  cc = MDbuf[2],
 	dd = MDbuf[3],  ee = MDbuf[4];
 	uint32_t aaa = MDbuf[0], bbb = MDbuf[1], ccc = MDbuf[2],
 	ddd = MDbuf[3], eee = MDbuf[4];
 
-	/* round 1 */
-	FF(aa, bb, cc, dd, ee, X[ 0], 11);
-	FF(ee, aa, bb, cc, dd, X[ 1], 14);
-	FF(dd, ee, aa, bb, cc, X[ 2], 15);
-	FF(cc, dd, ee, aa, bb, X[ 3], 12);
-	FF(bb, cc, dd, ee, aa, X[ 4],  5);
-	FF(aa, bb, cc, dd, ee, X[ 5],  8);
-	FF(ee, aa, bb, cc, dd, X[ 6],  7);
-	FF(dd, ee, aa, bb, cc, X[ 7],  9);
-	FF(cc, dd, ee, aa, bb, X[ 8], 11);
-	FF(bb, cc, dd, ee, aa, X[ 9], 13);
-	FF(aa, bb, cc, dd, ee, X[10], 14);
-	FF(ee, aa, bb, cc, dd, X[11], 15);
-	FF(dd, ee, aa, bb, cc, X[12],  6);
-	FF(cc, dd, ee, aa, bb, X[13],  7);
-	FF(bb, cc, dd, ee, aa, X[14],  9);
-	FF(aa, bb, cc, dd, ee, X[15],  8);
+	/* the two lines are independent; interleave them for instruction-level parallelism */
 
-	/* round 2 */
-	GG(ee, aa, bb, cc, dd, X[ 7],  7);
-	GG(dd, ee, aa, bb, cc, X[ 4],  6);
-	GG(cc, dd, ee, aa, bb, X[13],  8);
-	GG(bb, cc, dd, ee, aa, X[ 1], 13);
-	GG(aa, bb, cc, dd, ee, X[10], 11);
-	GG(ee, aa, bb, cc, dd, X[ 6],  9);
-	GG(dd, ee, aa, bb, cc, X[15],  7);
-	GG(cc, dd, ee, aa, bb, X[ 3], 15);
-	GG(bb, cc, dd, ee, aa, X[12],  7);
-	GG(aa, bb, cc, dd, ee, X[ 0], 12);
-	GG(ee, aa, bb, cc, dd, X[ 9], 15);
-	GG(dd, ee, aa, bb, cc, X[ 5],  9);
-	GG(cc, dd, ee, aa, bb, X[ 2], 11);
-	GG(bb, cc, dd, ee, aa, X[14],  7);
-	GG(aa, bb, cc, dd, ee, X[11], 13);
-	GG(ee, aa, bb, cc, dd, X[ 8], 12);
-
-	/* round 3 */
-	HH(dd, ee, aa, bb, cc, X[ 3], 11);
-	HH(cc, dd, ee, aa, bb, X[10], 13);
-	HH(bb, cc, dd, ee, aa, X[14],  6);
-	HH(aa, bb, cc, dd, ee, X[ 4],  7);
-	HH(ee, aa, bb, cc, dd, X[ 9], 14);
-	HH(dd, ee, aa, bb, cc, X[15],  9);
-	HH(cc, dd, ee, aa, bb, X[ 8], 13);
-	HH(bb, cc, dd, ee, aa, X[ 1], 15);
-	HH(aa, bb, cc, dd, ee, X[ 2], 14);
-	HH(ee, aa, bb, cc, dd, X[ 7],  8);
-	HH(dd, ee, aa, bb, cc, X[ 0], 13);
-	HH(cc, dd, ee, aa, bb, X[ 6],  6);
-	HH(bb, cc, dd, ee, aa, X[13],  5);
-	HH(aa, bb, cc, dd, ee, X[11], 12);
-	HH(ee, aa, bb, cc, dd, X[ 5],  7);
-	HH(dd, ee, aa, bb, cc, X[12],  5);
-
-	/* round 4 */
-	II(cc, dd, ee, aa, bb, X[ 1], 11);
-	II(bb, cc, dd, ee, aa, X[ 9], 12);
-	II(aa, bb, cc, dd, ee, X[11], 14);
-	II(ee, aa, bb, cc, dd, X[10], 15);
-	II(dd, ee, aa, bb, cc, X[ 0], 14);
-	II(cc, dd, ee, aa, bb, X[ 8], 15);
-	II(bb, cc, dd, ee, aa, X[12],  9);
-	II(aa, bb, cc, dd, ee, X[ 4],  8);
-	II(ee, aa, bb, cc, dd, X[13],  9);
-	II(dd, ee, aa, bb, cc, X[ 3], 14);
-	II(cc, dd, ee, aa, bb, X[ 7],  5);
-	II(bb, cc, dd, ee, aa, X[15],  6);
-	II(aa, bb, cc, dd, ee, X[14],  8);
-	II(ee, aa, bb, cc, dd, X[ 5],  6);
-	II(dd, ee, aa, bb, cc, X[ 6],  5);
-	II(cc, dd, ee, aa, bb, X[ 2], 12);
-
-	/* round 5 */
-	JJ(bb, cc, dd, ee, aa, X[ 4],  9);
-	JJ(aa, bb, cc, dd, ee, X[ 0], 15);
-	JJ(ee, aa, bb, cc, dd, X[ 5],  5);
-	JJ(dd, ee, aa, bb, cc, X[ 9], 11);
-	JJ(cc, dd, ee, aa, bb, X[ 7],  6);
-	JJ(bb, cc, dd, ee, aa, X[12],  8);
-	JJ(aa, bb, cc, dd, ee, X[ 2], 13);
-	JJ(ee, aa, bb, cc, dd, X[10], 12);
-	JJ(dd, ee, aa, bb, cc, X[14],  5);
-	JJ(cc, dd, ee, aa, bb, X[ 1], 12);
-	JJ(bb, cc, dd, ee, aa, X[ 3], 13);
-	JJ(aa, bb, cc, dd, ee, X[ 8], 14);
-	JJ(ee, aa, bb, cc, dd, X[11], 11);
-	JJ(dd, ee, aa, bb, cc, X[ 6],  8);
-	JJ(cc, dd, ee, aa, bb, X[15],  5);
-	JJ(bb, cc, dd, ee, aa, X[13],  6);
-
-	/* parallel round 1 */
+	/* round 1, parallel round 1 */
+	FF(aa, bb, cc, dd, ee, X[ 0], 11);
 	JJJ(aaa, bbb, ccc, ddd, eee, X[ 5],  8);
+	FF(ee, aa, bb, cc, dd, X[ 1], 14);
 	JJJ(eee, aaa, bbb, ccc, ddd, X[14],  9);
+	FF(dd, ee, aa, bb, cc, X[ 2], 15);
 	JJJ(ddd, eee, aaa, bbb, ccc, X[ 7],  9);
+	FF(cc, dd, ee, aa, bb, X[ 3], 12);
 	JJJ(ccc, ddd, eee, aaa, bbb, X[ 0], 11);
+	FF(bb, cc, dd, ee, aa, X[ 4],  5);
 	JJJ(bbb, ccc, ddd, eee, aaa, X[ 9], 13);
+	FF(aa, bb, cc, dd, ee, X[ 5],  8);
 	JJJ(aaa, bbb, ccc, ddd, eee, X[ 2], 15);
+	FF(ee, aa, bb, cc, dd, X[ 6],  7);
 	JJJ(eee, aaa, bbb, ccc, ddd, X[11], 15);
+	FF(dd, ee, aa, bb, cc, X[ 7],  9);
 	JJJ(ddd, eee, aaa, bbb, ccc, X[ 4],  5);
+	FF(cc, dd, ee, aa, bb, X[ 8], 11);
 	JJJ(ccc, ddd, eee, aaa, bbb, X[13],  7);
+	FF(bb, cc, dd, ee, aa, X[ 9], 13);
 	JJJ(bbb, ccc, ddd, eee, aaa, X[ 6],  7);
+	FF(aa, bb, cc, dd, ee, X[10], 14);
 	JJJ(aaa, bbb, ccc, ddd, eee, X[15],  8);
+	FF(ee, aa, bb, cc, dd, X[11], 15);
 	JJJ(eee, aaa, bbb, ccc, ddd, X[ 8], 11);
+	FF(dd, ee, aa, bb, cc, X[12],  6);
 	JJJ(ddd, eee, aaa, bbb, ccc, X[ 1], 14);
+	FF(cc, dd, ee, aa, bb, X[13],  7);
 	JJJ(ccc, ddd, eee, aaa, bbb, X[10], 14);
+	FF(bb, cc, dd, ee, aa, X[14],  9);
 	JJJ(bbb, ccc, ddd, eee, aaa, X[ 3], 12);
+	FF(aa, bb, cc, dd, ee, X[15],  8);
 	JJJ(aaa, bbb, ccc, ddd, eee, X[12],  6);
 
-	/* parallel round 2 */
+	/* round 2, parallel round 2 */
+	GG(ee, aa, bb, cc, dd, X[ 7],  7);
 	III(eee, aaa, bbb, ccc, ddd, X[ 6],  9);
+	GG(dd, ee, aa, bb, cc, X[ 4],  6);
 	III(ddd, eee, aaa, bbb, ccc, X[11], 13);
+	GG(cc, dd, ee, aa, bb, X[13],  8);
 	III(ccc, ddd, eee, aaa, bbb, X[ 3], 15);
+	GG(bb, cc, dd, ee, aa, X[ 1], 13);
 	III(bbb, ccc, ddd, eee, aaa, X[ 7],  7);
+	GG(aa, bb, cc, dd, ee, X[10], 11);
 	III(aaa, bbb, ccc, ddd, eee, X[ 0], 12);
+	GG(ee, aa, bb, cc, dd, X[ 6],  9);
 	III(eee, aaa, bbb, ccc, ddd, X[13],  8);
+	GG(dd, ee, aa, bb, cc, X[15],  7);
 	III(ddd, eee, aaa, bbb, ccc, X[ 5],  9);
+	GG(cc, dd, ee, aa, bb, X[ 3], 15);
 	III(ccc, ddd, eee, aaa, bbb, X[10], 11);
+	GG(bb, cc, dd, ee, aa, X[12],  7);
 	III(bbb, ccc, ddd, eee, aaa, X[14],  7);
+	GG(aa, bb, cc, dd, ee, X[ 0], 12);
 	III(aaa, bbb, ccc, ddd, eee, X[15],  7);
+	GG(ee, aa, bb, cc, dd, X[ 9], 15);
 	III(eee, aaa, bbb, ccc, ddd, X[ 8], 12);
+	GG(dd, ee, aa, bb, cc, X[ 5],  9);
 	III(ddd, eee, aaa, bbb, ccc, X[12],  7);
+	GG(cc, dd, ee, aa, bb, X[ 2], 11);
 	III(ccc, ddd, eee, aaa, bbb, X[ 4],  6);
+	GG(bb, cc, dd, ee, aa, X[14],  7);
 	III(bbb, ccc, ddd, eee, aaa, X[ 9], 15);
+	GG(aa, bb, cc, dd, ee, X[11], 13);
 	III(aaa, bbb, ccc, ddd, eee, X[ 1], 13);
+	GG(ee, aa, bb, cc, dd, X[ 8], 12);
 	III(eee, aaa, bbb, ccc, ddd, X[ 2], 11);
 
-	/* parallel round 3 */
+	/* round 3, parallel round 3 */
+	HH(dd, ee, aa, bb, cc, X[ 3], 11);
 	HHH(ddd, eee, aaa, bbb, ccc, X[15],  9);
+	HH(cc, dd, ee, aa, bb, X[10], 13);
 	HHH(ccc, ddd, eee, aaa, bbb, X[ 5],  7);
+	HH(bb, cc, dd, ee, aa, X[14],  6);
 	HHH(bbb, ccc, ddd, eee, aaa, X[ 1], 15);
+	HH(aa, bb, cc, dd, ee, X[ 4],  7);
 	HHH(aaa, bbb, ccc, ddd, eee, X[ 3], 11);
+	HH(ee, aa, bb, cc, dd, X[ 9], 14);
 	HHH(eee, aaa, bbb, ccc, ddd, X[ 7],  8);
+	HH(dd, ee, aa, bb, cc, X[15],  9);
 	HHH(ddd, eee, aaa, bbb, ccc, X[14],  6);
+	HH(cc, dd, ee, aa, bb, X[ 8], 13);
 	HHH(ccc, ddd, eee, aaa, bbb, X[ 6],  6);
+	HH(bb, cc, dd, ee, aa, X[ 1], 15);
 	HHH(bbb, ccc, ddd, eee, aaa, X[ 9], 14);
+	HH(aa, bb, cc, dd, ee, X[ 2], 14);
 	HHH(aaa, bbb, ccc, ddd, eee, X[11], 12);
+	HH(ee, aa, bb, cc, dd, X[ 7],  8);
 	HHH(eee, aaa, bbb, ccc, ddd, X[ 8], 13);
+	HH(dd, ee, aa, bb, cc, X[ 0], 13);
 	HHH(ddd, eee, aaa, bbb, ccc, X[12],  5);
+	HH(cc, dd, ee, aa, bb, X[ 6],  6);
 	HHH(ccc, ddd, eee, aaa, bbb, X[ 2], 14);
+	HH(bb, cc, dd, ee, aa, X[13],  5);
 	HHH(bbb, ccc, ddd, eee, aaa, X[10], 13);
+	HH(aa, bb, cc, dd, ee, X[11], 12);
 	HHH(aaa, bbb, ccc, ddd, eee, X[ 0], 13);
+	HH(ee, aa, bb, cc, dd, X[ 5],  7);
 	HHH(eee, aaa, bbb, ccc, ddd, X[ 4],  7);
+	HH(dd, ee, aa, bb, cc, X[12],  5);
 	HHH(ddd, eee, aaa, bbb, ccc, X[13],  5);
 
-	/* parallel round 4 */
+	/* round 4, parallel round 4 */
+	II(cc, dd, ee, aa, bb, X[ 1], 11);
 	GGG(ccc, ddd, eee, aaa, bbb, X[ 8], 15);
+	II(bb, cc, dd, ee, aa, X[ 9], 12);
 	GGG(bbb, ccc, ddd, eee, aaa, X[ 6],  5);
+	II(aa, bb, cc, dd, ee, X[11], 14);
 	GGG(aaa, bbb, ccc, ddd, eee, X[ 4],  8);
+	II(ee, aa, bb, cc, dd, X[10], 15);
 	GGG(eee, aaa, bbb, ccc, ddd, X[ 1], 11);
+	II(dd, ee, aa, bb, cc, X[ 0], 14);
 	GGG(ddd, eee, aaa, bbb, ccc, X[ 3], 14);
+	II(cc, dd, ee, aa, bb, X[ 8], 15);
 	GGG(ccc, ddd, eee, aaa, bbb, X[11], 14);
+	II(bb, cc, dd, ee, aa, X[12],  9);
 	GGG(bbb, ccc, ddd, eee, aaa, X[15],  6);
+	II(aa, bb, cc, dd, ee, X[ 4],  8);
 	GGG(aaa, bbb, ccc, ddd, eee, X[ 0], 14);
+	II(ee, aa, bb, cc, dd, X[13],  9);
 	GGG(eee, aaa, bbb, ccc, ddd, X[ 5],  6);
+	II(dd, ee, aa, bb, cc, X[ 3], 14);
 	GGG(ddd, eee, aaa, bbb, ccc, X[12],  9);
+	II(cc, dd, ee, aa, bb, X[ 7],  5);
 	GGG(ccc, ddd, eee, aaa, bbb, X[ 2], 12);
+	II(bb, cc, dd, ee, aa, X[15],  6);
 	GGG(bbb, ccc, ddd, eee, aaa, X[13],  9);
+	II(aa, bb, cc, dd, ee, X[14],  8);
 	GGG(aaa, bbb, ccc, ddd, eee, X[ 9], 12);
+	II(ee, aa, bb, cc, dd, X[ 5],  6);
 	GGG(eee, aaa, bbb, ccc, ddd, X[ 7],  5);
+	II(dd, ee, aa, bb, cc, X[ 6],  5);
 	GGG(ddd, eee, aaa, bbb, ccc, X[10], 15);
+	II(cc, dd, ee, aa, bb, X[ 2], 12);
 	GGG(ccc, ddd, eee, aaa, bbb, X[14],  8);
 
-	/* parallel round 5 */
+	/* round 5, parallel round 5 */
+	JJ(bb, cc, dd, ee, aa, X[ 4],  9);
 	FFF(bbb, ccc, ddd, eee, aaa, X[12] ,  8);
+	JJ(aa, bb, cc, dd, ee, X[ 0], 15);
 	FFF(aaa, bbb, ccc, ddd, eee, X[15] ,  5);
+	JJ(ee, aa, bb, cc, dd, X[ 5],  5);
 	FFF(eee, aaa, bbb, ccc, ddd, X[10] , 12);
+	JJ(dd, ee, aa, bb, cc, X[ 9], 11);
 	FFF(ddd, eee, aaa, bbb, ccc, X[ 4] ,  9);
+	JJ(cc, dd, ee, aa, bb, X[ 7],  6);
 	FFF(ccc, ddd, eee, aaa, bbb, X[ 1] , 12);
+	JJ(bb, cc, dd, ee, aa, X[12],  8);
 	FFF(bbb, ccc, ddd, eee, aaa, X[ 5] ,  5);
+	JJ(aa, bb, cc, dd, ee, X[ 2], 13);
 	FFF(aaa, bbb, ccc, ddd, eee, X[ 8] , 14);
+	JJ(ee, aa, bb, cc, dd, X[10], 12);
 	FFF(eee, aaa, bbb, ccc, ddd, X[ 7] ,  6);
+	JJ(dd, ee, aa, bb, cc, X[14],  5);
 	FFF(ddd, eee, aaa, bbb, ccc, X[ 6] ,  8);
+	JJ(cc, dd, ee, aa, bb, X[ 1], 12);
 	FFF(ccc, ddd, eee, aaa, bbb, X[ 2] , 13);
+	JJ(bb, cc, dd, ee, aa, X[ 3], 13);
 	FFF(bbb, ccc, ddd, eee, aaa, X[13] ,  6);
+	JJ(aa, bb, cc, dd, ee, X[ 8], 14);
 	FFF(aaa, bbb, ccc, ddd, eee, X[14] ,  5);
+	JJ(ee, aa, bb, cc, dd, X[11], 11);
 	FFF(eee, aaa, bbb, ccc, ddd, X[ 0] , 15);
+	JJ(dd, ee, aa, bb, cc, X[ 6],  8);
 	FFF(ddd, eee, aaa, bbb, ccc, X[ 3] , 13);
+	JJ(cc, dd, ee, aa, bb, X[15],  5);
 	FFF(ccc, ddd, eee, aaa, bbb, X[ 9] , 11);
+	JJ(bb, cc, dd, ee, aa, X[13],  6);
 	FFF(bbb, ccc, ddd, eee, aaa, X[11] , 11);
 
 	/* combine results */
@@ -406,22 +598,28 @@ h160 ripemd160(bytesConstRef _input)
 	// initialize
 	rmd160::MDinit(buffer);
 	byte const* message = _input.data();
-	uint32_t remaining = _input.size();	// # of bytes not yet processed
+	size_t remaining = _input.size();	// # of bytes not yet processed
 
 	// process message in 16x 4-byte chunks
 	for (; remaining >= 64; remaining -= 64)
 	{
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+		// The words are little-endian already.
+		memcpy(current, message, 64);
+		message += 64;
+#else
 		for (unsigned i = 0; i < 16; i++)
 		{
 			current[i] = BYTES_TO_DWORD(message);
 			message += 4;
 		}
+#endif
 		rmd160::MDcompress(buffer, current);
 	}
 	// length mod 64 bytes left
 
 	// finish:
-	rmd160::MDfinish(buffer, message, _input.size(), 0);
+	rmd160::MDfinish(buffer, message, uint32_t(_input.size()), uint32_t(uint64_t(_input.size()) >> 32));
 
 	for (unsigned i = 0; i < RMDsize / 8; i += 4)
 	{
@@ -33,6 +33,22 @@ namespace dev
 
 h256 sha256(bytesConstRef _input);
 
+/// The SHA-256 block functions sha256() picks from, the fastest the CPU supports winning.
+enum class SHA256Kernel
+{
+	Portable,
+	SHAExtensions	///< x86 SHA-NI.
+};
+
+/// @returns true if this build and CPU can run @a _kernel.
+bool sha256Supported(SHA256Kernel _kernel);
+
+/// @returns the kernel sha256() uses.
+SHA256Kernel sha256Kernel();
+
+/// SHA-256 with the given, supported, kernel. For tests and benchmarks; use sha256().
+h256 sha256(bytesConstRef _input, SHA256Kernel _kernel);
+
 h160 ripemd160(bytesConstRef _input);
 
 }
@@ -0,0 +1,155 @@
+/*
+	This file is part of cpp-ethereum.
+
+	cpp-ethereum is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	cpp-ethereum is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with cpp-ethereum.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/** @file MemoryAccounting.cpp
+ * @date 2017
+ */
+
+#include "MemoryAccounting.h"
+#include <algorithm>
+#include <sstream>
+#include <vector>
+#include "Common.h"
+using namespace std;
+using namespace dev;
+
+const char* MemoryChannel::name() { return EthTeal "mem"; }
+
+namespace
+{
+string inBytes(uint64_t _b) { return inUnits(_b, {"B", "KB", "MB", "GB"}); }
+}
+
+chrono::seconds const MemoryAccounting::logInterval = chrono::seconds(60);
+
+MemoryAccounting& MemoryAccounting::get()
+{
+	// Never destroyed, so that sources owned by other statics can unregister whenever they go.
+	static MemoryAccounting* s_this = new MemoryAccounting;
+	return *s_this;
+}
+
+MemoryAccounting::Handle MemoryAccounting::add(string const& _name, Sampler const& _sample, Trimmer const& _trim)
+{
+	Guard l(x_sources);
+	unsigned id = m_nextId++;
+	m_sources[id] = Source{_name, _sample, _trim};
+	return Handle(new Registration(id));
+}
+
+void MemoryAccounting::remove(unsigned _id)
+{
+	// Waits for any sampling in progress, which may be calling into the source.
+	Guard l(x_sampling);
+	Guard l2(x_sources);
+	m_sources.erase(_id);
+}
+
+void MemoryAccounting::setSoftLimit(string const& _name, uint64_t _bytes)
+{
+	Guard l(x_sources);
+	if (_bytes)
+		m_softLimits[_name] = _bytes;
+	else
+		m_softLimits.erase(_name);
+}
+
+MemoryAccounting::Reports MemoryAccounting::sample() const
+{
+	Guard l(x_sampling);
+	return sample_WITH_SAMPLING_LOCK();
+}
+
+MemoryAccounting::Reports MemoryAccounting::sample_WITH_SAMPLING_LOCK() const
+{
+	Reports ret;
+	map<unsigned, Source> sources;
+	DEV_GUARDED(x_sources)
+	{
+		sources = m_sources;
+		for (auto const& i: m_softLimits)
+			ret[i.first].softLimit = i.second;
+		for (auto const& i: m_trims)
+			ret[i.first].trims = i.second;
+	}
+	for (auto const& i: sources)
+	{
+		Report& r = ret[i.second.name];
+		r.usage += i.second.sample();
+		++r.sources;
+	}
+	// Limits set for names nothing reports under are kept but not reported.
+	for (auto i = ret.begin(); i != ret.end();)
+		if (i->second.sources)
+			++i;
+		else
+			i = ret.erase(i);
+	return ret;
+}
+
+MemoryAccounting::Reports MemoryAccounting::check()
+{
+	Guard l(x_sampling);
+	Reports ret = sample_WITH_SAMPLING_LOCK();
+
+	vector<string> over;
+	for (auto const& i: ret)
+		if (i.second.softLimit && i.second.usage.bytes > i.second.softLimit)
+			over.push_back(i.first);
+	if (!over.empty())
+	{
+		vector<Trimmer> trims;
+		DEV_GUARDED(x_sources)
+			for (auto const& name: over)
+			{
+				for (auto const& s: m_sources)
+					if (s.second.name == name && s.second.trim)
+						trims.push_back(s.second.trim);
+				++m_trims[name];
+			}
+		for (auto const& t: trims)
+			t();
+
+		Reports after = sample_WITH_SAMPLING_LOCK();
+		for (auto const& name: over)
+			clog(MemoryChannel) << "Trimmed" << name << "from" << inBytes(ret[name].usage.bytes) << "to" << inBytes(after[name].usage.bytes) << "for its soft limit of" << inBytes(ret[name].softLimit);
+		ret.swap(after);
+	}
+
+	auto now = chrono::steady_clock::now();
+	if (now - m_lastLog >= logInterval)
+	{
+		m_lastLog = now;
+		clog(MemoryChannel) << summary(ret);
+	}
+	return ret;
+}
+
+string MemoryAccounting::summary(Reports const& _reports)
+{
+	vector<pair<string, Report>> sorted(_reports.begin(), _reports.end());
+	stable_sort(sorted.begin(), sorted.end(), [](pair<string, Report> const& _a, pair<string, Report> const& _b) { return _a.second.usage.bytes > _b.second.usage.bytes; });
+
+	uint64_t total = 0;
+	for (auto const& i: sorted)
+		total += i.second.usage.bytes;
+
+	ostringstream ret;
+	ret << "Total " << inBytes(total);
+	for (auto const& i: sorted)
+		ret << ", " << i.first << " " << inBytes(i.second.usage.bytes) << " (" << i.second.usage.items << ")";
+	return ret.str();
+}
@@ -0,0 +1,126 @@
+/*
+	This file is part of cpp-ethereum.
+
+	cpp-ethereum is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	cpp-ethereum is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with cpp-ethereum.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/** @file MemoryAccounting.h
+ * @date 2017
+ * Process-wide registry of what the caches and queues hold in memory.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include "Guards.h"
+#include "Log.h"
+
+namespace dev
+{
+
+struct MemoryChannel: public LogChannel { static const char* name(); static const int verbosity = 2; };
+
+/// Approximate memory held by a structure: payload plus a rough per-item overhead.
+struct MemoryUsage
+{
+	MemoryUsage& operator+=(MemoryUsage const& _u) { bytes += _u.bytes; items += _u.items; return *this; }
+
+	uint64_t bytes = 0;
+	uint64_t items = 0;
+};
+
+/**
+ * @brief Subsystems register a sampler reporting their MemoryUsage under a name, and optionally a trim hook that
+ * releases what they can. check() is meant to run every few seconds: it samples every source, trims the names that
+ * are over their soft limits and now and then logs a summary line.
+ * A source can't go away while sampling is in progress, so samplers and trim hooks must not unregister sources;
+ * sources can be added at any time.
+ * @threadsafe
+ */
+class MemoryAccounting
+{
+public:
+	using Sampler = std::function<MemoryUsage()>;
+	using Trimmer = std::function<void()>;
+
+	/// Keeps a source registered for as long as it lives; keep it as the last member of the owner.
+	class Registration
+	{
+		friend class MemoryAccounting;
+
+	public:
+		~Registration() { MemoryAccounting::get().remove(m_id); }
+
+	private:
+		explicit Registration(unsigned _id): m_id(_id) {}
+
+		unsigned m_id;
+	};
+	using Handle = std::unique_ptr<Registration>;
+
+	/// Totals of the sources registered under one name.
+	struct Report
+	{
+		MemoryUsage usage;
+		uint64_t softLimit = 0;		///< Zero if there is none.
+		unsigned sources = 0;
+		unsigned trims = 0;			///< Times the name was trimmed for going over its soft limit.
+	};
+	using Reports = std::map<std::string, Report>;
+
+	static MemoryAccounting& get();
+
+	/// Registers a source under @a _name, which several sources may share.
+	Handle add(std::string const& _name, Sampler const& _sample, Trimmer const& _trim = Trimmer());
+
+	/// Sets the bytes above which the sources under @a _name get trimmed; zero removes the limit.
+	void setSoftLimit(std::string const& _name, uint64_t _bytes);
+
+	Reports sample() const;
+
+	/// Samples every source, trims those over their soft limits and logs a summary once every logInterval.
+	/// @returns the usage after trimming.
+	Reports check();
+
+	/// @returns a single line listing the reports by size.
+	static std::string summary(Reports const& _reports);
+
+	static std::chrono::seconds const logInterval;
+
+private:
+	struct Source
+	{
+		std::string name;
+		Sampler sample;
+		Trimmer trim;
+	};
+
+	MemoryAccounting() {}
+
+	void remove(unsigned _id);
+	Reports sample_WITH_SAMPLING_LOCK() const;
+
+	mutable Mutex x_sampling;				///< Held while samplers and trim hooks run.
+	mutable Mutex x_sources;
+	std::map<unsigned, Source> m_sources;
+	unsigned m_nextId = 0;
+	std::map<std::string, uint64_t> m_softLimits;
+	std::map<std::string, unsigned> m_trims;
+	std::chrono::steady_clock::time_point m_lastLog;
+};
+
+}
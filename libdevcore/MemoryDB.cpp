@@ -42,6 +42,18 @@ std::unordered_map<h256, std::string> MemoryDB::get() const
 	return ret;
 }
 
+std::unordered_map<h256, bytes> MemoryDB::getAux() const
+{
+#if DEV_GUARDED_DB
+	ReadGuard l(x_this);
+#endif
+	std::unordered_map<h256, bytes> ret;
+	for (auto const& i: m_aux)
+		if (!m_enforceRefs || i.second.second)
+			ret.insert(make_pair(i.first, i.second.first));
+	return ret;
+}
+
 MemoryDB& MemoryDB::operator=(MemoryDB const& _c)
 {
 	if (this == &_c)
@@ -188,4 +200,21 @@ h256Hash MemoryDB::keys() const
 	return ret;
 }
 
+
+MemoryUsage MemoryDB::usage() const
+{
+#if DEV_GUARDED_DB
+	ReadGuard l(x_this);
+#endif
+	// Key, value header and hash node overhead per entry on top of the payload.
+	MemoryUsage ret;
+	ret.items = m_main.size() + m_aux.size();
+	ret.bytes = ret.items * 96;
+	for (auto const& i: m_main)
+		ret.bytes += i.second.first.size();
+	for (auto const& i: m_aux)
+		ret.bytes += i.second.first.size();
+	return ret;
+}
+
 }
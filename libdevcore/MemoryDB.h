@@ -26,6 +26,7 @@
 #include "Guards.h"
 #include "FixedHash.h"
 #include "Log.h"
+#include "MemoryAccounting.h"
 #include "RLP.h"
 #include "SHA3.h"
 
@@ -50,6 +51,8 @@ public:
 
 	void clear() { m_main.clear(); m_aux.clear(); }	// WARNING !!!! didn't originally clear m_refCount!!!
 	std::unordered_map<h256, std::string> get() const;
+	/// @returns the auxiliary entries, e.g. the key preimages of a FatGenericTrieDB.
+	std::unordered_map<h256, bytes> getAux() const;
 
 	std::string lookup(h256 const& _h) const;
 	bool exists(h256 const& _h) const;
@@ -63,6 +66,9 @@ public:
 
 	h256Hash keys() const;
 
+	/// @returns roughly how much memory the entries take, for MemoryAccounting.
+	MemoryUsage usage() const;
+
 protected:
 #if DEV_GUARDED_DB
 	mutable SharedMutex x_this;
@@ -0,0 +1,269 @@
+/*
+	This file is part of cpp-ethereum.
+
+	cpp-ethereum is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	cpp-ethereum is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with cpp-ethereum.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/** @file Metrics.cpp
+ * @date 2017
+ */
+
+#include "Metrics.h"
+#include <sstream>
+#include "Log.h"
+using namespace std;
+using namespace dev;
+
+namespace
+{
+
+/// Small per-thread number, used to pick shards and to tell threads apart in traces.
+unsigned threadIndex()
+{
+	static atomic<unsigned> s_next{0};
+	static thread_local unsigned t_index = s_next++;
+	return t_index;
+}
+
+int clz64(uint64_t _v)
+{
+#if defined(__GNUC__)
+	return __builtin_clzll(_v);
+#else
+	int ret = 0;
+	for (uint64_t bit = uint64_t(1) << 63; !(_v & bit); bit >>= 1)
+		++ret;
+	return ret;
+#endif
+}
+
+void appendJsonString(ostringstream& _out, string const& _s)
+{
+	_out << '"';
+	for (char c: _s)
+		if (c == '"' || c == '\\')
+			_out << '\\' << c;
+		else if ((unsigned char)c < 0x20)
+			_out << ' ';
+		else
+			_out << c;
+	_out << '"';
+}
+
+}
+
+unsigned Histogram::bucket(uint64_t _value)
+{
+	if (_value < (1u << c_subBits))
+		return (unsigned)_value;
+	unsigned shift = 63 - clz64(_value) - c_subBits;
+	return ((shift + 1) << c_subBits) + (unsigned)((_value >> shift) & ((1u << c_subBits) - 1));
+}
+
+uint64_t Histogram::bucketFloor(unsigned _i)
+{
+	if (_i < (1u << c_subBits))
+		return _i;
+	unsigned shift = (_i >> c_subBits) - 1;
+	return (uint64_t((1u << c_subBits) + (_i & ((1u << c_subBits) - 1)))) << shift;
+}
+
+void Histogram::record(uint64_t _value)
+{
+	Shard& s = m_shards[threadIndex() % c_shards];
+	s.buckets[bucket(_value)].fetch_add(1, memory_order_relaxed);
+	s.count.fetch_add(1, memory_order_relaxed);
+	s.sum.fetch_add(_value, memory_order_relaxed);
+	uint64_t m = s.max.load(memory_order_relaxed);
+	while (_value > m && !s.max.compare_exchange_weak(m, _value, memory_order_relaxed)) {}
+}
+
+Histogram::Snapshot Histogram::snapshot() const
+{
+	Snapshot ret;
+	ret.buckets.resize(c_buckets);
+	for (Shard const& s: m_shards)
+	{
+		for (unsigned i = 0; i < c_buckets; ++i)
+			ret.buckets[i] += s.buckets[i].load(memory_order_relaxed);
+		ret.count += s.count.load(memory_order_relaxed);
+		ret.sum += s.sum.load(memory_order_relaxed);
+		ret.max = max(ret.max, s.max.load(memory_order_relaxed));
+	}
+	return ret;
+}
+
+void Histogram::reset()
+{
+	for (Shard& s: m_shards)
+	{
+		for (auto& b: s.buckets)
+			b.store(0, memory_order_relaxed);
+		s.count.store(0, memory_order_relaxed);
+		s.sum.store(0, memory_order_relaxed);
+		s.max.store(0, memory_order_relaxed);
+	}
+}
+
+uint64_t Histogram::Snapshot::percentile(double _q) const
+{
+	// Counts are read shard by shard while being written to, so go by the buckets' own total.
+	uint64_t total = 0;
+	for (uint64_t b: buckets)
+		total += b;
+	if (!total)
+		return 0;
+	uint64_t rank = std::max<uint64_t>(1, (uint64_t)(_q * total + 0.5));
+	uint64_t seen = 0;
+	for (unsigned i = 0; i < buckets.size(); ++i)
+		if ((seen += buckets[i]) >= rank)
+		{
+			// The middle of the bucket, but no more than the largest value seen.
+			uint64_t floor = bucketFloor(i);
+			uint64_t next = i + 1 < buckets.size() ? bucketFloor(i + 1) : floor;
+			return std::min(floor + (next - floor) / 2, std::max(max, floor));
+		}
+	return max;
+}
+
+void Counter::add(uint64_t _n)
+{
+	m_shards[threadIndex() % c_shards].value.fetch_add(_n, memory_order_relaxed);
+}
+
+uint64_t Counter::value() const
+{
+	uint64_t ret = 0;
+	for (Shard const& s: m_shards)
+		ret += s.value.load(memory_order_relaxed);
+	return ret;
+}
+
+void Counter::reset()
+{
+	for (Shard& s: m_shards)
+		s.value.store(0, memory_order_relaxed);
+}
+
+atomic<bool> Metrics::s_enabled{true};
+atomic<bool> Metrics::s_tracing{false};
+
+Metrics& Metrics::get()
+{
+	// Never destroyed, so that metered scopes in threads outliving main() stay valid.
+	static Metrics* s_this = new Metrics;
+	return *s_this;
+}
+
+Histogram& Metrics::histogram(string const& _name)
+{
+	Guard l(x_metrics);
+	auto& h = m_histograms[_name];
+	if (!h)
+		h.reset(new Histogram(_name));
+	return *h;
+}
+
+Counter& Metrics::counter(string const& _name)
+{
+	Guard l(x_metrics);
+	auto& c = m_counters[_name];
+	if (!c)
+		c.reset(new Counter);
+	return *c;
+}
+
+map<string, Histogram::Snapshot> Metrics::histograms() const
+{
+	map<string, Histogram::Snapshot> ret;
+	Guard l(x_metrics);
+	for (auto const& i: m_histograms)
+		ret[i.first] = i.second->snapshot();
+	return ret;
+}
+
+map<string, uint64_t> Metrics::counters() const
+{
+	map<string, uint64_t> ret;
+	Guard l(x_metrics);
+	for (auto const& i: m_counters)
+		ret[i.first] = i.second->value();
+	return ret;
+}
+
+void Metrics::reset()
+{
+	Guard l(x_metrics);
+	for (auto const& i: m_histograms)
+		i.second->reset();
+	for (auto const& i: m_counters)
+		i.second->reset();
+}
+
+void Metrics::startTracing(size_t _maxSpans)
+{
+	Guard l(x_trace);
+	m_spans.clear();
+	m_spans.reserve(min<size_t>(_maxSpans, 65536));
+	m_threadNames.clear();
+	m_maxSpans = _maxSpans;
+	m_traceBegin = Clock::now();
+	s_tracing = true;
+}
+
+void Metrics::span(char const* _name, Clock::time_point _begin, Clock::time_point _end)
+{
+	unsigned thread = threadIndex();
+	Guard l(x_trace);
+	if (!s_tracing || m_spans.size() >= m_maxSpans || _begin < m_traceBegin)
+		return;
+	if (!m_threadNames.count(thread))
+		m_threadNames[thread] = getThreadName();
+	m_spans.push_back(Span{_name, thread, _begin, _end});
+}
+
+string Metrics::stopTracing()
+{
+	vector<Span> spans;
+	map<unsigned, string> threadNames;
+	Clock::time_point begin;
+	DEV_GUARDED(x_trace)
+	{
+		s_tracing = false;
+		spans.swap(m_spans);
+		threadNames.swap(m_threadNames);
+		begin = m_traceBegin;
+	}
+
+	auto micros = [](Clock::duration _d) { return chrono::duration_cast<chrono::duration<double, micro>>(_d).count(); };
+	ostringstream ret;
+	ret.precision(3);
+	ret << fixed << "{\"traceEvents\":[";
+	bool first = true;
+	for (auto const& i: threadNames)
+	{
+		ret << (first ? "" : ",") << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << i.first << ",\"args\":{\"name\":";
+		appendJsonString(ret, i.second);
+		ret << "}}";
+		first = false;
+	}
+	for (Span const& s: spans)
+	{
+		ret << (first ? "" : ",") << "{\"name\":";
+		appendJsonString(ret, s.name);
+		ret << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << s.thread << ",\"ts\":" << micros(s.begin - begin) << ",\"dur\":" << micros(s.end - s.begin) << "}";
+		first = false;
+	}
+	ret << "],\"displayTimeUnit\":\"ns\"}";
+	return ret.str();
+}
@@ -0,0 +1,212 @@
+/*
+	This file is part of cpp-ethereum.
+
+	cpp-ethereum is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	cpp-ethereum is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with cpp-ethereum.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/** @file Metrics.h
+ * @date 2017
+ * Always-on latency histograms and counters, and optional span tracing.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+#include "Guards.h"
+
+namespace dev
+{
+
+/**
+ * @brief Histogram of values (nanoseconds, for latencies) in log-linear buckets: eight per power of two, so that any
+ * percentile is off by at most 1/16 of its value. Recording takes a couple of relaxed atomic increments on the
+ * calling thread's shard, so threads don't contend on the same cache lines.
+ * @threadsafe
+ */
+class Histogram
+{
+public:
+	static unsigned const c_subBits = 3;
+	static unsigned const c_buckets = (64 - c_subBits + 1) << c_subBits;
+
+	/// Totals of all shards at one point in time.
+	struct Snapshot
+	{
+		uint64_t count = 0;
+		uint64_t sum = 0;
+		uint64_t max = 0;
+		std::vector<uint64_t> buckets;
+
+		/// @returns the value below which a fraction @a _q of the values fall, to within the bucket's width.
+		uint64_t percentile(double _q) const;
+		double mean() const { return count ? double(sum) / count : 0; }
+	};
+
+	explicit Histogram(std::string const& _name): m_name(_name) {}
+
+	std::string const& name() const { return m_name; }
+
+	void record(uint64_t _value);
+	Snapshot snapshot() const;
+	void reset();
+
+	static unsigned bucket(uint64_t _value);
+	/// @returns the lowest value falling into bucket @a _i.
+	static uint64_t bucketFloor(unsigned _i);
+
+private:
+	static unsigned const c_shards = 8;
+
+	struct Shard
+	{
+		std::atomic<uint64_t> buckets[c_buckets];
+		std::atomic<uint64_t> count;
+		std::atomic<uint64_t> sum;
+		std::atomic<uint64_t> max;
+	};
+
+	std::string m_name;
+	Shard m_shards[c_shards] = {};
+};
+
+/// Monotonic counter, sharded like Histogram. @threadsafe
+class Counter
+{
+public:
+	void add(uint64_t _n = 1);
+	uint64_t value() const;
+	void reset();
+
+private:
+	static unsigned const c_shards = 8;
+
+	struct Shard
+	{
+		std::atomic<uint64_t> value;
+		char padding[56];
+	};
+
+	Shard m_shards[c_shards] = {};
+};
+
+/**
+ * @brief Registry of named histograms and counters, which live for as long as the process, and the span tracer.
+ * While tracing, every metered scope is also recorded as a span, up to a given number of them, and the trace can be
+ * exported in Chrome's trace event format.
+ * @threadsafe
+ */
+class Metrics
+{
+public:
+	using Clock = std::chrono::steady_clock;
+
+	static Metrics& get();
+
+	/// @returns the histogram called @a _name, creating it if needed. Keep the reference rather than looking it up
+	/// on hot paths.
+	Histogram& histogram(std::string const& _name);
+	Counter& counter(std::string const& _name);
+
+	std::map<std::string, Histogram::Snapshot> histograms() const;
+	std::map<std::string, uint64_t> counters() const;
+	/// Zeroes every histogram and counter.
+	void reset();
+
+	/// Turns metered scopes on or off; they are on by default.
+	static void setEnabled(bool _enabled) { s_enabled = _enabled; }
+	static bool enabled() { return s_enabled.load(std::memory_order_relaxed); }
+	static bool tracing() { return s_tracing.load(std::memory_order_relaxed); }
+
+	/// Starts recording spans, dropping those of a previous trace; stops recording after @a _maxSpans.
+	void startTracing(size_t _maxSpans = 1000000);
+	/// Stops recording spans. @returns them in Chrome's trace event JSON format.
+	std::string stopTracing();
+
+	/// Records a span called @a _name, which must outlive the trace, if tracing.
+	void span(char const* _name, Clock::time_point _begin, Clock::time_point _end);
+
+private:
+	struct Span
+	{
+		char const* name;
+		unsigned thread;
+		Clock::time_point begin;
+		Clock::time_point end;
+	};
+
+	Metrics() {}
+
+	static std::atomic<bool> s_enabled;
+	static std::atomic<bool> s_tracing;
+
+	mutable Mutex x_metrics;
+	std::map<std::string, std::unique_ptr<Histogram>> m_histograms;
+	std::map<std::string, std::unique_ptr<Counter>> m_counters;
+
+	Mutex x_trace;
+	std::vector<Span> m_spans;
+	size_t m_maxSpans = 0;
+	Clock::time_point m_traceBegin;
+	std::map<unsigned, std::string> m_threadNames;
+};
+
+/// Records the time between its construction and destruction into a histogram, and as a span while tracing.
+class MeteredScope
+{
+public:
+	explicit MeteredScope(Histogram& _h): m_h(_h) { if (Metrics::enabled()) m_begin = Metrics::Clock::now(); }
+	~MeteredScope()
+	{
+		if (m_begin == Metrics::Clock::time_point())
+			return;
+		Metrics::Clock::time_point end = Metrics::Clock::now();
+		m_h.record(std::chrono::duration_cast<std::chrono::nanoseconds>(end - m_begin).count());
+		if (Metrics::tracing())
+			Metrics::get().span(m_h.name().c_str(), m_begin, end);
+	}
+
+	/// For DEV_METERED: true the first time only.
+	bool firstPass() { bool ret = !m_passed; m_passed = true; return ret; }
+
+private:
+	Histogram& m_h;
+	Metrics::Clock::time_point m_begin;
+	bool m_passed = false;
+};
+
+/// Records the time since @a _begin into @a _h, for operations that complete in a callback.
+inline void recordSince(Histogram& _h, Metrics::Clock::time_point _begin)
+{
+	if (!Metrics::enabled())
+		return;
+	Metrics::Clock::time_point end = Metrics::Clock::now();
+	_h.record(std::chrono::duration_cast<std::chrono::nanoseconds>(end - _begin).count());
+	if (Metrics::tracing())
+		Metrics::get().span(_h.name().c_str(), _begin, end);
+}
+
+}
+
+/// The histogram called S, looked up once per call site.
+#define DEV_METRICS_HISTOGRAM(S) ([]() -> ::dev::Histogram& { static ::dev::Histogram& s_h = ::dev::Metrics::get().histogram(S); return s_h; }())
+/// Meters the statement or block that follows into the histogram called S.
+#define DEV_METERED(S) for (::dev::MeteredScope __eth_m(DEV_METRICS_HISTOGRAM(S)); __eth_m.firstPass();)
+/// Meters the rest of the enclosing scope into the histogram called S.
+#define DEV_METERED_SCOPE(S) ::dev::MeteredScope __eth_ms(DEV_METRICS_HISTOGRAM(S))
+/// Adds N to the counter called S, looked up once per call site.
+#define DEV_COUNT(S, N) ([]() -> ::dev::Counter& { static ::dev::Counter& s_c = ::dev::Metrics::get().counter(S); return s_c; }().add(N))
@@ -23,6 +23,7 @@
 #include <thread>
 #include <libdevcore/db.h>
 #include <libdevcore/Common.h>
+#include <libdevcore/Metrics.h>
 #include "OverlayDB.h"
 using namespace std;
 using namespace dev;
@@ -46,6 +47,7 @@ class WriteBatchNoter: public ldb::WriteBatch::Handler
 
 void OverlayDB::commit()
 {
+	DEV_METERED_SCOPE("overlaydb.commit");
 	if (m_db)
 	{
 		ldb::WriteBatch batch;
@@ -121,7 +123,11 @@ std::string OverlayDB::lookup(h256 const& _h) const
 {
 	std::string ret = MemoryDB::lookup(_h);
 	if (ret.empty() && m_db)
+	{
 		m_db->Get(m_readOptions, ldb::Slice((char const*)_h.data(), 32), &ret);
+		if (m_onRead && !ret.empty())
+			m_onRead(_h, ret);
+	}
 	return ret;
 }
 
@@ -132,6 +138,8 @@ bool OverlayDB::exists(h256 const& _h) const
 	std::string ret;
 	if (m_db)
 		m_db->Get(m_readOptions, ldb::Slice((char const*)_h.data(), 32), &ret);
+	if (m_onRead && !ret.empty())
+		m_onRead(_h, ret);
 	return !ret.empty();
 }
 
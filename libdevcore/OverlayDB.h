@@ -21,6 +21,7 @@
 
 #pragma once
 
+#include <functional>
 #include <memory>
 #include <libdevcore/db.h>
 #include <libdevcore/Common.h>
@@ -48,10 +49,15 @@ public:
 
 	bytes lookupAux(h256 const& _h) const;
 
+	/// Called with every node read from the disk database rather than the overlay; copies keep calling it.
+	using ReadObserver = std::function<void(h256 const&, std::string const&)>;
+	void setReadObserver(ReadObserver const& _o) { m_onRead = _o; }
+
 private:
 	using MemoryDB::clear;
 
 	std::shared_ptr<ldb::DB> m_db;
+	ReadObserver m_onRead;
 
 	ldb::ReadOptions m_readOptions;
 	ldb::WriteOptions m_writeOptions;
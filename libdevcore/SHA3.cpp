@@ -125,6 +125,49 @@ static inline void keccakf(void* state) {
   }
 }
 
+/*** Keccak-f[1600] of c_lanes states at once, word-interleaved (a[word][lane]) so the
+     independent lanes fill the pipeline and vectorise. ***/
+static const unsigned c_lanes = 4;
+#define LANES(e) for (unsigned l = 0; l < c_lanes; ++l) { e; }
+// Inlined into the sponge the interleaved state gets spilled, which costs more than the call.
+#if defined(__GNUC__)
+#define NOINLINE __attribute__((noinline))
+#else
+#define NOINLINE
+#endif
+
+NOINLINE static void keccakfLanes(uint64_t (*a)[c_lanes]) {
+  uint64_t b[5][c_lanes];
+  uint64_t t[c_lanes];
+  uint8_t x, y;
+
+  for (int i = 0; i < 24; i++) {
+	// Theta
+	FOR5(x, 1,
+		 LANES(b[x][l] = a[x][l] ^ a[x + 5][l] ^ a[x + 10][l] ^ a[x + 15][l] ^ a[x + 20][l]))
+	FOR5(x, 1,
+		 LANES(t[l] = b[(x + 4) % 5][l] ^ rol(b[(x + 1) % 5][l], 1))
+		 FOR5(y, 5,
+			  LANES(a[y + x][l] ^= t[l]) ))
+	// Rho and pi
+	LANES(t[l] = a[1][l])
+	x = 0;
+	REPEAT24(LANES(b[0][l] = a[pi[x]][l];
+				   a[pi[x]][l] = rol(t[l], rho[x]);
+				   t[l] = b[0][l])
+			 x++; )
+	// Chi
+	FOR5(y,
+	   5,
+	   FOR5(x, 1,
+			LANES(b[x][l] = a[y + x][l]))
+	   FOR5(x, 1,
+			LANES(a[y + x][l] = b[x][l] ^ ((~b[(x + 1) % 5][l]) & b[(x + 2) % 5][l])) ))
+	// Iota
+	LANES(a[0][l] ^= RC[i])
+  }
+}
+
 /******** The FIPS202-defined functions. ********/
 
 /*** Some helper macros. ***/
@@ -221,4 +264,55 @@ bool sha3(bytesConstRef _input, bytesRef o_output)
 	return true;
 }
 
+void sha3Batch(bytesConstRef const* _inputs, size_t _count, h256* o_outputs)
+{
+	size_t const rate = 200 - 256 / 4;
+	size_t const lanes = keccak::c_lanes;
+	for (size_t g = 0; g < _count; g += lanes)
+	{
+		size_t const n = min(lanes, _count - g);
+		if (n == 1)
+		{
+			sha3(_inputs[g], o_outputs[g].ref());
+			continue;
+		}
+
+		// Each lane absorbs its own number of blocks; idle lanes are permuted along and ignored.
+		uint64_t a[25][lanes] = {};
+		size_t blocks[lanes];
+		size_t maxBlocks = 0;
+		for (size_t l = 0; l < n; ++l)
+			maxBlocks = max(maxBlocks, blocks[l] = _inputs[g + l].size() / rate + 1);
+		for (size_t k = 0; k < maxBlocks; ++k)
+		{
+			for (size_t l = 0; l < n; ++l)
+				if (k < blocks[l])
+				{
+					bytesConstRef in = _inputs[g + l].cropped(k * rate);
+					uint8_t last[rate];
+					if (k + 1 == blocks[l])
+					{
+						memset(last, 0, rate);
+						if (in.size())
+							memcpy(last, in.data(), in.size());
+						last[in.size()] ^= 0x01;
+						last[rate - 1] ^= 0x80;
+						in = bytesConstRef(last, rate);
+					}
+					for (size_t w = 0; w < rate / 8; ++w)
+					{
+						uint64_t word;
+						memcpy(&word, in.data() + w * 8, 8);
+						a[w][l] ^= word;
+					}
+				}
+			keccak::keccakfLanes(a);
+			for (size_t l = 0; l < n; ++l)
+				if (k + 1 == blocks[l])
+					for (size_t w = 0; w < 4; ++w)
+						memcpy(o_outputs[g + l].data() + w * 8, &a[w][l], 8);
+		}
+	}
+}
+
 }
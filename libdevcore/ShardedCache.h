@@ -0,0 +1,130 @@
+/*
+	This file is part of cpp-ethereum.
+
+	cpp-ethereum is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	cpp-ethereum is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with cpp-ethereum.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/** @file ShardedCache.h
+ * @date 2017
+ * A bounded, thread-safe map from hashes to values, for caches shared between threads.
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <map>
+#include "Guards.h"
+
+namespace dev
+{
+
+/**
+ * @brief Bounded thread-safe cache keyed by hashes (FixedHash), split into independently locked shards
+ * so that threads rarely contend. A full shard makes room by removing an arbitrary element: keys are
+ * hashes, so the neighbour of a fresh one is as good as a random victim.
+ */
+template <class _Key, class _Value, unsigned _Shards = 16>
+class ShardedCache
+{
+public:
+	static const unsigned c_shards = _Shards;
+
+	/// @param _maxShardSize the number of elements each of the shards holds at most.
+	explicit ShardedCache(size_t _maxShardSize): m_maxShardSize(_maxShardSize) {}
+
+	/// Stores @a _value under @a _key, replacing whatever was there.
+	void insert(_Key const& _key, _Value const& _value)
+	{
+		Shard& s = shardOf(_key);
+		Guard l(s.x_cache);
+		if (s.cache.size() >= m_maxShardSize && !s.cache.count(_key))
+		{
+			auto it = s.cache.lower_bound(_key);
+			if (it == s.cache.end())
+				it = s.cache.begin();
+			s.cache.erase(it);
+		}
+		s.cache[_key] = _value;
+	}
+
+	/// Copies the value under @a _key into @a o_value. @returns false, leaving @a o_value alone, if there is none.
+	bool lookup(_Key const& _key, _Value& o_value)
+	{
+		Shard& s = shardOf(_key);
+		Guard l(s.x_cache);
+		auto it = s.cache.find(_key);
+		if (it == s.cache.end())
+		{
+			++m_misses;
+			return false;
+		}
+		++m_hits;
+		o_value = it->second;
+		return true;
+	}
+
+	void erase(_Key const& _key)
+	{
+		Shard& s = shardOf(_key);
+		DEV_GUARDED(s.x_cache)
+			s.cache.erase(_key);
+	}
+
+	/// Calls @a _f with each key and value, holding the lock of their shard.
+	template <class _F> void forEach(_F const& _f) const
+	{
+		for (auto const& s: m_shards)
+			DEV_GUARDED(s.x_cache)
+				for (auto const& i: s.cache)
+					_f(i.first, i.second);
+	}
+
+	/// @returns the number of lookups which found a value, since construction.
+	uint64_t hits() const { return m_hits; }
+	/// @returns the number of lookups which did not find a value, since construction.
+	uint64_t misses() const { return m_misses; }
+	/// @returns the number of cached values.
+	size_t size() const
+	{
+		size_t ret = 0;
+		for (auto const& s: m_shards)
+			DEV_GUARDED(s.x_cache)
+				ret += s.cache.size();
+		return ret;
+	}
+
+	/// Forgets all cached values. Statistics are kept.
+	void clear()
+	{
+		for (auto& s: m_shards)
+			DEV_GUARDED(s.x_cache)
+				s.cache.clear();
+	}
+
+private:
+	struct Shard
+	{
+		mutable Mutex x_cache;
+		std::map<_Key, _Value> cache;
+	};
+
+	Shard& shardOf(_Key const& _key) { return m_shards[_key[0] % c_shards]; }
+
+	size_t const m_maxShardSize;
+	std::array<Shard, c_shards> m_shards;
+	std::atomic<uint64_t> m_hits{0};
+	std::atomic<uint64_t> m_misses{0};
+};
+
+}
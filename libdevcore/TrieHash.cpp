@@ -176,22 +176,180 @@ h256 hash256(BytesMap const& _s)
 	return sha3(rlp256(_s));
 }
 
+namespace
+{
+
+/// The nibbles of rlp(i), the key of item i of an ordered trie.
+struct OrderedKey
+{
+	uint8_t size = 0;
+	uint8_t nibbles[2 * (1 + sizeof(size_t))];
+};
+
+/**
+ * @brief Computes the root of the trie mapping rlp(i) to the i-th value without a map of keys.
+ * The order of the keys follows from the item count alone: rlp(1) ... rlp(127) are single bytes below
+ * rlp(0) == 0x80, and the longer keys of 128 upwards start 0x81, 0x82, ... so they sort numerically.
+ * Nodes are encoded into a buffer reused at their depth, and the siblings under a branch are hashed together.
+ */
+class OrderedTrieBuilder
+{
+public:
+	explicit OrderedTrieBuilder(std::vector<bytesConstRef> const& _data)
+	{
+		size_t const n = _data.size();
+		size_t const firstLong = min<size_t>(n, 128);
+		m_values.reserve(n);
+		m_keys.resize(n);
+		for (size_t p = 0; p < n; ++p)
+		{
+			size_t i = p + 1 < firstLong ? p + 1 : p + 1 == firstLong ? 0 : p;
+			m_values.push_back(_data[i]);
+			setKey(m_keys[p], i);
+		}
+		m_nodes.resize(sizeof(OrderedKey::nibbles) + 2);
+		m_children.resize(m_nodes.size());
+	}
+
+	h256 root()
+	{
+		if (m_values.empty())
+			return sha3(rlp(""));
+		return sha3(encode(0, m_values.size(), 0, 0));
+	}
+
+private:
+	static void setKey(OrderedKey& o_key, size_t _i)
+	{
+		uint8_t b[1 + sizeof(size_t)];
+		unsigned size = 1;
+		if (!_i)
+			b[0] = 0x80;
+		else if (_i < 0x80)
+			b[0] = (uint8_t)_i;
+		else
+		{
+			unsigned l = bytesRequired(_i);
+			b[0] = (uint8_t)(0x80 + l);
+			for (unsigned j = l; j; --j, _i >>= 8)
+				b[j] = (uint8_t)_i;
+			size += l;
+		}
+		o_key.size = (uint8_t)(size * 2);
+		for (unsigned j = 0; j < size; ++j)
+		{
+			o_key.nibbles[j * 2] = b[j] >> 4;
+			o_key.nibbles[j * 2 + 1] = b[j] & 0x0f;
+		}
+	}
+
+	static void appendHexPrefix(RLPStream& _s, OrderedKey const& _k, unsigned _begin, unsigned _end, bool _leaf)
+	{
+		uint8_t hp[sizeof(OrderedKey::nibbles) / 2 + 1];
+		unsigned size = 0;
+		unsigned i = _begin;
+		hp[size++] = (_leaf ? 0x20 : 0) | ((_end - _begin) % 2 ? 0x10 | _k.nibbles[i++] : 0);
+		for (; i < _end; i += 2)
+			hp[size++] = (uint8_t)(_k.nibbles[i] << 4 | _k.nibbles[i + 1]);
+		_s.append(bytesConstRef(hp, size));
+	}
+
+	/// Encodes the node holding items [_b, _e), whose keys share their first _pre nibbles, into m_nodes[_depth].
+	bytesConstRef encode(size_t _b, size_t _e, unsigned _pre, unsigned _depth)
+	{
+		RLPStream& s = m_nodes[_depth];
+		OrderedKey const& first = m_keys[_b];
+		if (_e - _b == 1)
+		{
+			s.clear();
+			s.appendList(2);
+			appendHexPrefix(s, first, _pre, first.size, true);
+			s.append(m_values[_b]);
+			return &s.out();
+		}
+
+		// The keys are sorted and none is a prefix of another, so the first and the last share the common prefix.
+		OrderedKey const& last = m_keys[_e - 1];
+		unsigned shared = _pre;
+		while (first.nibbles[shared] == last.nibbles[shared])
+			++shared;
+		if (shared > _pre)
+		{
+			bytesConstRef child = encode(_b, _e, shared, _depth + 1);
+			h256 h;
+			if (child.size() >= 32)
+				h = sha3(child);
+			s.clear();
+			s.appendList(2);
+			appendHexPrefix(s, first, _pre, shared, false);
+			if (child.size() < 32)
+				s.appendRaw(child);
+			else
+				s << h;
+			return &s.out();
+		}
+
+		// A branch: encode the children one after the other, then hash the large ones in one go.
+		bytes& children = m_children[_depth];
+		children.clear();
+		size_t offsets[17] = {0};
+		for (unsigned i = 0; i < 16; ++i)
+		{
+			size_t n = _b;
+			for (; n < _e && m_keys[n].nibbles[_pre] == i; ++n) {}
+			if (n > _b)
+			{
+				bytesConstRef child = encode(_b, n, _pre + 1, _depth + 1);
+				children.insert(children.end(), child.begin(), child.end());
+			}
+			offsets[i + 1] = children.size();
+			_b = n;
+		}
+		bytesConstRef toHash[16];
+		h256 hashes[16];
+		size_t hashed = 0;
+		for (unsigned i = 0; i < 16; ++i)
+			if (offsets[i + 1] - offsets[i] >= 32)
+				toHash[hashed++] = bytesConstRef(&children).cropped(offsets[i], offsets[i + 1] - offsets[i]);
+		sha3Batch(toHash, hashed, hashes);
+
+		s.clear();
+		s.appendList(17);
+		hashed = 0;
+		for (unsigned i = 0; i < 16; ++i)
+		{
+			size_t size = offsets[i + 1] - offsets[i];
+			if (!size)
+				s << "";
+			else if (size < 32)
+				s.appendRaw(bytesConstRef(&children).cropped(offsets[i], size));
+			else
+				s << hashes[hashed++];
+		}
+		s << "";
+		return &s.out();
+	}
+
+	std::vector<bytesConstRef> m_values;	///< In the order of their keys.
+	std::vector<OrderedKey> m_keys;
+	std::vector<RLPStream> m_nodes;			///< The node being encoded at each depth.
+	std::vector<bytes> m_children;			///< The encoded children of the branch being encoded at each depth.
+};
+
+}
+
 h256 orderedTrieRoot(std::vector<bytes> const& _data)
 {
-	BytesMap m;
-	unsigned j = 0;
-	for (auto i: _data)
-		m[rlp(j++)] = i;
-	return hash256(m);
+	std::vector<bytesConstRef> refs;
+	refs.reserve(_data.size());
+	for (auto const& i: _data)
+		refs.push_back(&i);
+	return orderedTrieRoot(refs);
 }
 
 h256 orderedTrieRoot(std::vector<bytesConstRef> const& _data)
 {
-	BytesMap m;
-	unsigned j = 0;
-	for (auto i: _data)
-		m[rlp(j++)] = i.toBytes();
-	return hash256(m);
+	return OrderedTrieBuilder(_data).root();
 }
 
 }
@@ -0,0 +1,366 @@
+/*
+	This file is part of cpp-ethereum.
+
+	cpp-ethereum is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	cpp-ethereum is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with cpp-ethereum.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/** @file TrieScan.h
+ * @date 2017
+ * Range scans over a trie with its nodes read ahead of the visitor.
+ */
+
+#pragma once
+
+#include <condition_variable>
+#include <functional>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+#include "Guards.h"
+#include "RLP.h"
+#include "TrieCommon.h"
+
+namespace dev
+{
+
+/// A half-open range [begin, end) of trie keys; an empty end is past the last key.
+struct TrieRange
+{
+	bytes begin;
+	bytes end;
+};
+
+/**
+ * @brief Visits the keys and values of a trie within a TrieRange in key order, reading nodes ahead of the visitor.
+ * Reader threads take the nodes due next in key order a few at a time, so the children of a node are read in
+ * parallel, and keep up to a window of them ahead of the visitor. Values are handed over as views into the nodes
+ * as read from the DB, without further copies. The DB must not change during the scan.
+ */
+template <class DB>
+class TrieScan
+{
+public:
+	/// Called with each key and value in order; returns false to stop the scan.
+	using Visitor = std::function<bool(bytesConstRef _key, bytesConstRef _value)>;
+
+	/// @param _readers number of reader threads; with none, nodes are read as the visitor gets to them. Threads only
+	/// pay off for scans over many nodes, so ask for them only then.
+	/// @param _window number of nodes read but not yet visited above which the readers wait.
+	TrieScan(DB const& _db, h256 const& _root, TrieRange const& _range = TrieRange(), unsigned _readers = 0, size_t _window = 4096):
+		m_db(_db), m_root(_root), m_begin(nibbles(&_range.begin)), m_end(nibbles(&_range.end)), m_readerCount(_readers), m_window(_window)
+	{}
+
+	~TrieScan() { stopReaders(); }
+
+	/// Runs the scan. @returns false if the visitor stopped it.
+	bool run(Visitor const& _visit)
+	{
+		{
+			Guard l(x_nodes);
+			m_pending.clear();
+			m_fetched.clear();
+			m_stop = false;
+			if (m_readerCount)
+				m_pending.insert(std::make_pair(std::string(), m_root));
+		}
+		for (unsigned i = 0; i < m_readerCount; ++i)
+			m_readers.push_back(std::thread([this]() { read(); }));
+
+		std::string path;
+		bool ret;
+		try
+		{
+			std::shared_ptr<std::string const> root = node(path, m_root);
+			ret = walk(bytesConstRef(root.get()), path, _visit);
+		}
+		catch (...)
+		{
+			stopReaders();
+			throw;
+		}
+		stopReaders();
+		return ret;
+	}
+
+	/// Splits @a _range of the trie at @a _root into at most @a _parts consecutive ranges holding similar numbers of
+	/// subtrees, for independent scans to go through in parallel.
+	static std::vector<TrieRange> split(DB const& _db, h256 const& _root, TrieRange const& _range, unsigned _parts)
+	{
+		TrieScan s(_db, _root, _range, 0);
+		std::vector<std::pair<std::string, h256>> level{std::make_pair(std::string(), _root)};
+		for (unsigned depth = 0; depth < c_maxSplitDepth && level.size() < _parts * c_subtreesPerPart; ++depth)
+		{
+			std::vector<std::pair<std::string, h256>> next;
+			for (auto& i: level)
+			{
+				std::string n = _db.lookup(i.second);
+				s.children(bytesConstRef(&n), i.first, next);
+			}
+			if (next.size() <= level.size())
+				break;
+			level.swap(next);
+		}
+
+		std::vector<TrieRange> ret;
+		unsigned parts = std::max<size_t>(1, std::min<size_t>(_parts, level.size()));
+		bytes begin = _range.begin;
+		for (unsigned i = 1; i < parts; ++i)
+		{
+			bytes end = lowestKey(level[level.size() * i / parts].first);
+			ret.push_back(TrieRange{begin, end});
+			begin = end;
+		}
+		ret.push_back(TrieRange{begin, _range.end});
+		return ret;
+	}
+
+private:
+	static unsigned const c_batch = 4;				///< Nodes a reader takes at once.
+	static unsigned const c_maxSplitDepth = 4;
+	static unsigned const c_subtreesPerPart = 4;
+
+	static std::string nibbles(bytesConstRef _key)
+	{
+		std::string ret;
+		ret.reserve(_key.size() * 2);
+		for (byte b: _key)
+		{
+			ret.push_back(b >> 4);
+			ret.push_back(b & 15);
+		}
+		return ret;
+	}
+
+	/// @returns the lowest key with the nibbles @a _path as its prefix.
+	static bytes lowestKey(std::string const& _path)
+	{
+		bytes ret((_path.size() + 1) / 2, 0);
+		for (size_t i = 0; i < _path.size(); ++i)
+			ret[i / 2] |= i % 2 ? _path[i] : _path[i] << 4;
+		return ret;
+	}
+
+	bool inRange(std::string const& _key) const { return _key >= m_begin && (m_end.empty() || _key < m_end); }
+
+	/// @returns false if no key starting with @a _prefix is in range.
+	bool overlaps(std::string const& _prefix) const
+	{
+		if (_prefix.compare(0, _prefix.size(), m_begin, 0, _prefix.size()) < 0)
+			return false;
+		if (m_end.empty())
+			return true;
+		size_t shared = std::min(_prefix.size(), m_end.size());
+		int c = _prefix.compare(0, shared, m_end, 0, shared);
+		return c < 0 || (c == 0 && _prefix.size() < m_end.size());
+	}
+
+	/// Appends the paths and hashes of the in-range nodes referred to by @a _node (at @a io_path) to @a o_children.
+	void children(bytesConstRef _node, std::string& io_path, std::vector<std::pair<std::string, h256>>& o_children) const
+	{
+		RLP rlp(_node);
+		if (!rlp.isList())
+			return;
+		if (rlp.itemCount() == 2)
+		{
+			if (isLeaf(rlp))
+				return;
+			size_t size = io_path.size();
+			NibbleSlice k = keyOf(rlp);
+			for (unsigned i = 0; i < k.size(); ++i)
+				io_path.push_back(k[i]);
+			child(rlp[1], io_path, o_children);
+			io_path.resize(size);
+		}
+		else if (rlp.itemCount() == 17)
+			for (byte i = 0; i < 16; ++i)
+				if (!rlp[i].isEmpty())
+				{
+					io_path.push_back(i);
+					child(rlp[i], io_path, o_children);
+					io_path.pop_back();
+				}
+	}
+
+	void child(RLP const& _ref, std::string& io_path, std::vector<std::pair<std::string, h256>>& o_children) const
+	{
+		if (!overlaps(io_path))
+			return;
+		if (_ref.isList())
+			children(_ref.data(), io_path, o_children);
+		else if (_ref.isData() && _ref.size() == 32)
+			o_children.push_back(std::make_pair(io_path, _ref.toHash<h256>()));
+	}
+
+	void read()
+	{
+		std::vector<std::pair<std::string, h256>> batch;
+		std::vector<std::pair<std::string, std::shared_ptr<std::string const>>> done;
+		std::vector<std::pair<std::string, h256>> next;
+		while (true)
+		{
+			batch.clear();
+			{
+				UniqueGuard l(x_nodes);
+				m_changed.wait(l, [&]() { return m_stop || (!m_pending.empty() && m_fetched.size() + m_inFlight.size() < m_window); });
+				if (m_stop)
+					return;
+				while (batch.size() < c_batch && !m_pending.empty() && m_fetched.size() + m_inFlight.size() < m_window)
+				{
+					batch.push_back(*m_pending.begin());
+					m_pending.erase(m_pending.begin());
+					m_inFlight.insert(batch.back().first);
+				}
+			}
+
+			done.clear();
+			next.clear();
+			for (auto& i: batch)
+			{
+				done.push_back(std::make_pair(i.first, std::make_shared<std::string const>(m_db.lookup(i.second))));
+				children(bytesConstRef(done.back().second.get()), i.first, next);
+			}
+
+			Guard l(x_nodes);
+			for (auto& i: done)
+			{
+				m_inFlight.erase(i.first);
+				m_fetched[i.first] = i.second;
+			}
+			m_pending.insert(next.begin(), next.end());
+			m_changed.notify_all();
+		}
+	}
+
+	void stopReaders()
+	{
+		{
+			Guard l(x_nodes);
+			m_stop = true;
+		}
+		m_changed.notify_all();
+		for (auto& i: m_readers)
+			i.join();
+		m_readers.clear();
+		m_inFlight.clear();
+	}
+
+	/// @returns the node at @a _path, waiting for it if a reader is on it and reading it here if none got to it.
+	std::shared_ptr<std::string const> node(std::string const& _path, h256 const& _hash)
+	{
+		if (m_readerCount)
+		{
+			UniqueGuard l(x_nodes);
+			while (true)
+			{
+				auto f = m_fetched.find(_path);
+				if (f != m_fetched.end())
+				{
+					std::shared_ptr<std::string const> ret = f->second;
+					m_fetched.erase(f);
+					m_changed.notify_all();
+					return ret;
+				}
+				if (!m_inFlight.count(_path))
+					break;
+				m_changed.wait(l);
+			}
+			m_pending.erase(std::make_pair(_path, _hash));
+		}
+
+		std::shared_ptr<std::string const> ret = std::make_shared<std::string const>(m_db.lookup(_hash));
+		if (m_readerCount)
+		{
+			std::vector<std::pair<std::string, h256>> next;
+			std::string path = _path;
+			children(bytesConstRef(ret.get()), path, next);
+			Guard l(x_nodes);
+			m_pending.insert(next.begin(), next.end());
+			m_changed.notify_all();
+		}
+		return ret;
+	}
+
+	bool walk(bytesConstRef _node, std::string& io_path, Visitor const& _visit)
+	{
+		RLP rlp(_node);
+		if (!rlp.isList())
+			return true;
+		if (rlp.itemCount() == 2)
+		{
+			size_t size = io_path.size();
+			NibbleSlice k = keyOf(rlp);
+			for (unsigned i = 0; i < k.size(); ++i)
+				io_path.push_back(k[i]);
+			bool ret = true;
+			if (isLeaf(rlp))
+				ret = !inRange(io_path) || visit(io_path, rlp[1].payload(), _visit);
+			else if (overlaps(io_path))
+				ret = descend(rlp[1], io_path, _visit);
+			io_path.resize(size);
+			return ret;
+		}
+		if (rlp.itemCount() != 17)
+			return true;
+		if (!rlp[16].isEmpty() && inRange(io_path) && !visit(io_path, rlp[16].payload(), _visit))
+			return false;
+		for (byte i = 0; i < 16; ++i)
+			if (!rlp[i].isEmpty())
+			{
+				io_path.push_back(i);
+				bool ret = !overlaps(io_path) || descend(rlp[i], io_path, _visit);
+				io_path.pop_back();
+				if (!ret)
+					return false;
+			}
+		return true;
+	}
+
+	bool descend(RLP const& _ref, std::string& io_path, Visitor const& _visit)
+	{
+		if (_ref.isList())
+			return walk(_ref.data(), io_path, _visit);
+		if (!_ref.isData() || _ref.size() != 32)
+			return true;
+		std::shared_ptr<std::string const> n = node(io_path, _ref.toHash<h256>());
+		return walk(bytesConstRef(n.get()), io_path, _visit);
+	}
+
+	bool visit(std::string const& _path, bytesConstRef _value, Visitor const& _visit)
+	{
+		m_key.resize(_path.size() / 2);
+		for (size_t i = 0; i + 1 < _path.size(); i += 2)
+			m_key[i / 2] = (byte)(_path[i] << 4 | _path[i + 1]);
+		return _visit(&m_key, _value);
+	}
+
+	DB const& m_db;
+	h256 m_root;
+	std::string m_begin;				///< Range as nibbles.
+	std::string m_end;
+	unsigned m_readerCount;
+	size_t m_window;
+	bytes m_key;
+
+	Mutex x_nodes;
+	std::condition_variable m_changed;
+	std::set<std::pair<std::string, h256>> m_pending;					///< Nodes to read, by path; the first ones are due first.
+	std::set<std::string> m_inFlight;									///< Paths of nodes being read.
+	std::map<std::string, std::shared_ptr<std::string const>> m_fetched;	///< Nodes read but not yet visited, by path.
+	bool m_stop = false;
+	std::vector<std::thread> m_readers;
+};
+
+}
@@ -75,6 +75,19 @@ typedef struct ethash_return_value {
  *                       ERRNOMEM or invalid parameters used for @ref ethash_compute_cache_nodes()
  */
 ethash_light_t ethash_light_new(uint64_t block_number);
+/**
+ * Same as @ref ethash_light_new(), but maps the cache from a file in @a dirname when a
+ * valid one exists and otherwise computes it and stores it there for the next time.
+ * Failing to store the cache is not an error. Storing a new epoch deletes the files of
+ * all epochs before the previous one.
+ *
+ * @param block_number   The block number for which to create the handler
+ * @param dirname        The directory holding the light cache files, or NULL for the
+ *                       default DAG directory
+ * @return               Newly allocated ethash_light handler or NULL in case of
+ *                       ERRNOMEM or invalid parameters
+ */
+ethash_light_t ethash_light_new_persisted(uint64_t block_number, char const* dirname);
 /**
  * Frees a previously allocated ethash_light handler
  * @param light        The light handler to free
@@ -93,7 +106,6 @@ ethash_return_value_t ethash_light_compute(
 	ethash_h256_t const header_hash,
 	uint64_t nonce
 );
-
 /**
  * Allocate and initialize a new ethash_full handler
  *
@@ -110,6 +122,31 @@ ethash_return_value_t ethash_light_compute(
  */
 ethash_full_t ethash_full_new(ethash_light_t light, ethash_callback_t callback);
 
+/// Kinds of memory pages a DAG replica can live on; see @ref ethash_full_replicate()
+typedef enum ethash_pages {
+	ETHASH_PAGES_DEFAULT = 0,   ///< Regular pages
+	ETHASH_PAGES_TRANSPARENT,   ///< Regular pages, advised to be merged into transparent huge pages
+	ETHASH_PAGES_2MB,           ///< Explicit 2MB huge pages, from the kernel's hugetlb pool
+	ETHASH_PAGES_1GB            ///< Explicit 1GB huge pages, from the kernel's hugetlb pool
+} ethash_pages_t;
+
+/**
+ * Copy the DAG of a full handler into anonymous memory.
+ *
+ * The file-backed mapping of @ref ethash_full_new() always uses regular pages; a replica on
+ * huge pages spares the TLB most of the misses of hashimoto's random DAG reads. The copy is
+ * made (and so first touched) by the calling thread, so on NUMA systems the kernel places it
+ * on that thread's node.
+ *
+ * @param full          The full handler to copy
+ * @param pages         The kind of pages wanted. Whatever cannot be had falls back to the next
+ *                      smaller kind, down to regular pages.
+ * @param used          If not NULL, set to the kind of pages actually obtained
+ * @return              Newly allocated ethash_full handler, to be freed with
+ *                      @ref ethash_full_delete(), or NULL in case of ERRNOMEM
+ */
+ethash_full_t ethash_full_replicate(ethash_full_t full, ethash_pages_t pages, ethash_pages_t* used);
+
 /**
  * Frees a previously allocated ethash_full handler
  * @param full    The light handler to free
@@ -108,6 +108,13 @@ static bool ethash_compute_cache_nodes(
 	for (uint32_t j = 0; j != ETHASH_CACHE_ROUNDS; j++) {
 		for (uint32_t i = 0; i != num_nodes; i++) {
 			uint32_t const idx = nodes[i].words[0] % num_nodes;
+			// The next node's parent is already final, so fetch it while this node hashes.
+			// Mere hint: it may still be overwritten by this very iteration.
+#if defined(__GNUC__)
+			if (i + 1 != num_nodes) {
+				__builtin_prefetch(&nodes[nodes[i + 1].words[0] % num_nodes]);
+			}
+#endif
 			node data;
 			data = nodes[(num_nodes - 1 + i) % num_nodes];
 			for (uint32_t w = 0; w != NODE_WORDS; ++w) {
@@ -185,6 +192,44 @@ void ethash_calculate_dag_item(
 	SHA3_512(ret->bytes, ret->bytes, sizeof(node));
 }
 
+void ethash_calculate_dag_items(
+	node* const ret,
+	uint32_t const* node_indices,
+	uint32_t count,
+	ethash_light_t const light
+)
+{
+	uint32_t num_parent_nodes = (uint32_t) (light->cache_size / sizeof(node));
+	node const* cache_nodes = (node const *) light->cache;
+	node const* parents[MIX_NODES];
+
+	for (uint32_t l = 0; l != count; ++l) {
+		memcpy(&ret[l], &cache_nodes[node_indices[l] % num_parent_nodes], sizeof(node));
+		ret[l].words[0] ^= node_indices[l];
+		SHA3_512(ret[l].bytes, ret[l].bytes, sizeof(node));
+	}
+
+	for (uint32_t i = 0; i != ETHASH_DATASET_PARENTS; ++i) {
+		// find all lanes' parents before touching any of them, so the loads are in flight together
+		for (uint32_t l = 0; l != count; ++l) {
+			uint32_t parent_index = fnv_hash(node_indices[l] ^ i, ret[l].words[i % NODE_WORDS]) % num_parent_nodes;
+			parents[l] = &cache_nodes[parent_index];
+#if defined(__GNUC__)
+			__builtin_prefetch(parents[l]);
+#endif
+		}
+		for (uint32_t l = 0; l != count; ++l) {
+			for (unsigned w = 0; w != NODE_WORDS; ++w) {
+				ret[l].words[w] = fnv_hash(ret[l].words[w], parents[l]->words[w]);
+			}
+		}
+	}
+
+	for (uint32_t l = 0; l != count; ++l) {
+		SHA3_512(ret[l].bytes, ret[l].bytes, sizeof(node));
+	}
+}
+
 bool ethash_compute_full_data(
 	void* mem,
 	uint64_t full_size,
@@ -244,19 +289,26 @@ static bool ethash_hash(
 
 	unsigned const page_size = sizeof(uint32_t) * MIX_WORDS;
 	unsigned const num_full_pages = (unsigned) (full_size / page_size);
+	uint32_t indices[MIX_NODES];
+	node dag_nodes[MIX_NODES];
 
 	for (unsigned i = 0; i != ETHASH_ACCESSES; ++i) {
 		uint32_t const index = fnv_hash(s_mix->words[0] ^ i, mix->words[i % MIX_WORDS]) % num_full_pages;
 
-		for (unsigned n = 0; n != MIX_NODES; ++n) {
-			node const* dag_node;
-			if (full_nodes) {
-				dag_node = &full_nodes[MIX_NODES * index + n];
-			} else {
-				node tmp_node;
-				ethash_calculate_dag_item(&tmp_node, index * MIX_NODES + n, light);
-				dag_node = &tmp_node;
+		node const* page;
+		if (full_nodes) {
+			page = &full_nodes[MIX_NODES * index];
+		} else {
+			// the items of a page are computed together so that their parent lookups overlap
+			for (unsigned n = 0; n != MIX_NODES; ++n) {
+				indices[n] = index * MIX_NODES + n;
 			}
+			ethash_calculate_dag_items(dag_nodes, indices, MIX_NODES, light);
+			page = dag_nodes;
+		}
+
+		for (unsigned n = 0; n != MIX_NODES; ++n) {
+			node const* dag_node = &page[n];
 
 #if defined(_M_X64) && ENABLE_SSE
 			{
@@ -406,9 +458,60 @@ ethash_light_t ethash_light_new(uint64_t block_number)
 	return ret;
 }
 
+ethash_light_t ethash_light_new_persisted(uint64_t block_number, char const* dirname)
+{
+	char strbuf[256];
+	if (!dirname) {
+		if (!ethash_get_default_dirname(strbuf, 256)) {
+			return ethash_light_new(block_number);
+		}
+		dirname = strbuf;
+	}
+	ethash_h256_t const seedhash = ethash_get_seedhash(block_number);
+	uint64_t const cache_size = ethash_get_cachesize(block_number);
+	ethash_h256_t checksum;
+
+	uint8_t* map = ethash_io_light_load(dirname, seedhash, cache_size);
+	if (map) {
+		ethash_light_file_header const* header = (ethash_light_file_header const*)map;
+		SHA3_256(&checksum, map + sizeof(*header), (size_t)cache_size);
+		struct ethash_light* ret = NULL;
+		if (memcmp(&checksum, &header->checksum, sizeof(checksum)) == 0) {
+			ret = calloc(sizeof(*ret), 1);
+		}
+		if (ret) {
+			ret->cache = map + sizeof(*header);
+			ret->cache_size = cache_size;
+			ret->block_number = block_number;
+			ret->mapped = true;
+			return ret;
+		}
+		// corrupt (or out of memory): recompute, which also replaces the file
+		munmap(map, sizeof(*header) + (size_t)cache_size);
+	}
+
+	ethash_light_t ret = ethash_light_new(block_number);
+	if (ret) {
+		SHA3_256(&checksum, (uint8_t const*)ret->cache, (size_t)cache_size);
+		if (ethash_io_light_store(dirname, seedhash, ret->cache, cache_size, &checksum)) {
+			// a new epoch: keep its predecessor, which verification may still need, but no older ones
+			uint64_t const epoch = block_number / ETHASH_EPOCH_LENGTH;
+			ethash_h256_t old;
+			ethash_h256_reset(&old);
+			for (uint64_t e = 0; e + 1 < epoch; ++e) {
+				ethash_io_light_remove(dirname, old);
+				SHA3_256(&old, (uint8_t*)&old, 32);
+			}
+		}
+	}
+	return ret;
+}
+
 void ethash_light_delete(ethash_light_t light)
 {
-	if (light->cache) {
+	if (light->mapped) {
+		munmap((uint8_t*)light->cache - sizeof(ethash_light_file_header), sizeof(ethash_light_file_header) + (size_t)light->cache_size);
+	} else if (light->cache) {
 		free(light->cache);
 	}
 	free(light);
@@ -562,8 +665,72 @@ ethash_full_t ethash_full_new(ethash_light_t light, ethash_callback_t callback)
 	return ethash_full_new_internal(strbuf, seedhash, full_size, light, callback);
 }
 
+static void* ethash_map_pages(uint64_t size, ethash_pages_t pages, uint64_t* map_size)
+{
+	void* ret;
+	int flags = MAP_PRIVATE | MAP_ANONYMOUS;
+	uint64_t page_size = 0;
+#if defined(__linux__) && defined(MAP_HUGETLB)
+	// hugetlb page size selectors, missing from older headers
+#ifndef MAP_HUGE_SHIFT
+#define MAP_HUGE_SHIFT 26
+#endif
+	if (pages == ETHASH_PAGES_1GB) {
+		flags |= MAP_HUGETLB | (30 << MAP_HUGE_SHIFT);
+		page_size = 1ULL << 30;
+	} else if (pages == ETHASH_PAGES_2MB) {
+		flags |= MAP_HUGETLB | (21 << MAP_HUGE_SHIFT);
+		page_size = 1ULL << 21;
+	}
+#else
+	if (pages == ETHASH_PAGES_1GB || pages == ETHASH_PAGES_2MB) {
+		return MAP_FAILED;
+	}
+#endif
+	// hugetlb mappings must span whole pages
+	*map_size = page_size ? (size + page_size - 1) / page_size * page_size : size;
+	ret = mmap(NULL, (size_t)*map_size, PROT_READ | PROT_WRITE, flags, -1, 0);
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+	if (ret != MAP_FAILED && pages == ETHASH_PAGES_TRANSPARENT) {
+		// only advice: without THP support this is just a regular mapping
+		madvise(ret, (size_t)*map_size, MADV_HUGEPAGE);
+	}
+#endif
+	return ret;
+}
+
+ethash_full_t ethash_full_replicate(ethash_full_t full, ethash_pages_t pages, ethash_pages_t* used)
+{
+	struct ethash_full* ret = calloc(sizeof(*ret), 1);
+	if (!ret) {
+		return NULL;
+	}
+	ret->file_size = full->file_size;
+	for (;; pages = (ethash_pages_t)(pages - 1)) {
+		void* data = ethash_map_pages(full->file_size, pages, &ret->replica_size);
+		if (data != MAP_FAILED) {
+			ret->data = data;
+			break;
+		}
+		if (pages == ETHASH_PAGES_DEFAULT) {
+			free(ret);
+			return NULL;
+		}
+	}
+	memcpy(ret->data, full->data, (size_t)full->file_size);
+	if (used) {
+		*used = pages;
+	}
+	return ret;
+}
+
 void ethash_full_delete(ethash_full_t full)
 {
+	if (full->replica_size) {
+		munmap(full->data, (size_t)full->replica_size);
+		free(full);
+		return;
+	}
 	// could check that munmap(..) == 0 but even if it did not can't really do anything here
 	munmap(full->data, (size_t)full->file_size);
 	if (full->file) {
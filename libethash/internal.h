@@ -86,6 +86,7 @@ struct ethash_light {
 	void* cache;
 	uint64_t cache_size;
 	uint64_t block_number;
+	bool mapped; ///< cache points into a mapped light cache file, just past its header
 };
 
 /**
@@ -119,6 +120,7 @@ struct ethash_full {
 	FILE* file;
 	uint64_t file_size;
 	node* data;
+	uint64_t replica_size; ///< size of the anonymous mapping of a replica, 0 for the file-backed DAG
 };
 
 /**
@@ -152,6 +154,18 @@ void ethash_calculate_dag_item(
 	ethash_light_t const cache
 );
 
+/**
+ * Computes @a count (at most MIX_NODES, the items of one mix page) independent DAG items from the light cache.
+ * Equivalent to calling ethash_calculate_dag_item() for each, but the parent lookups of all
+ * items are interleaved so that their cache misses overlap instead of being waited out in turn.
+ */
+void ethash_calculate_dag_items(
+	node* const ret,
+	uint32_t const* node_indices,
+	uint32_t count,
+	ethash_light_t const cache
+);
+
 void ethash_quick_hash(
 	ethash_h256_t* return_hash,
 	ethash_h256_t const* header_hash,
@@ -19,6 +19,7 @@
  * @date 2015
  */
 #include "io.h"
+#include "mmap.h"
 #include <string.h>
 #include <stdio.h>
 #include <errno.h>
@@ -117,3 +118,132 @@ free_memo:
 end:
 	return ret;
 }
+
+uint8_t* ethash_io_light_load(
+	char const* dirname,
+	ethash_h256_t const seedhash,
+	uint64_t cache_size
+)
+{
+	char mutable_name[LIGHT_MUTABLE_NAME_MAX_SIZE];
+	size_t const map_size = sizeof(ethash_light_file_header) + (size_t)cache_size;
+	size_t found_size;
+	uint8_t* ret = NULL;
+	uint8_t* map;
+	FILE* f;
+	int fd;
+
+	if (!ethash_io_light_mutable_name(ETHASH_REVISION, &seedhash, mutable_name)) {
+		return NULL;
+	}
+	char* filename = ethash_io_create_filename(dirname, mutable_name, strlen(mutable_name));
+	if (!filename) {
+		return NULL;
+	}
+	f = ethash_fopen(filename, "rb");
+	if (!f) {
+		goto free_name;
+	}
+	if (!ethash_file_size(f, &found_size) || found_size != map_size) {
+		goto close_file;
+	}
+	if ((fd = ethash_fileno(f)) == -1) {
+		goto close_file;
+	}
+	map = mmap(NULL, map_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	if (map == MAP_FAILED) {
+		goto close_file;
+	}
+	ethash_light_file_header const* header = (ethash_light_file_header const*)map;
+	if (header->magic != ETHASH_LIGHT_MAGIC_NUM ||
+		header->version != ETHASH_LIGHT_FILE_VERSION ||
+		header->revision != ETHASH_REVISION ||
+		header->cache_size != cache_size ||
+		memcmp(&header->seed_hash, &seedhash, sizeof(seedhash)) != 0) {
+		munmap(map, map_size);
+		goto close_file;
+	}
+	ret = map;
+
+close_file:
+	// the mapping outlives the file handle
+	fclose(f);
+free_name:
+	free(filename);
+	return ret;
+}
+
+bool ethash_io_light_store(
+	char const* dirname,
+	ethash_h256_t const seedhash,
+	void const* cache,
+	uint64_t cache_size,
+	ethash_h256_t const* checksum
+)
+{
+	char mutable_name[LIGHT_MUTABLE_NAME_MAX_SIZE];
+	// ".<pid>-<address>.tmp": unique to this process and this cache, so concurrent writers never share it
+	char tmp_name[LIGHT_MUTABLE_NAME_MAX_SIZE + 1 + 10 + 1 + 16 + 4];
+	ethash_light_file_header header;
+	bool ret = false;
+	FILE* f;
+
+	if (!ethash_mkdir(dirname) || !ethash_io_light_mutable_name(ETHASH_REVISION, &seedhash, mutable_name)) {
+		return false;
+	}
+	snprintf(tmp_name, sizeof(tmp_name), "%s.%u-%" PRIxPTR ".tmp", mutable_name, ethash_process_id(), (uintptr_t)cache);
+	char* filename = ethash_io_create_filename(dirname, mutable_name, strlen(mutable_name));
+	char* tmp_filename = ethash_io_create_filename(dirname, tmp_name, strlen(tmp_name));
+	if (!filename || !tmp_filename) {
+		goto free_names;
+	}
+
+	memset(&header, 0, sizeof(header));
+	header.magic = ETHASH_LIGHT_MAGIC_NUM;
+	header.version = ETHASH_LIGHT_FILE_VERSION;
+	header.revision = ETHASH_REVISION;
+	header.cache_size = cache_size;
+	header.seed_hash = seedhash;
+	header.checksum = *checksum;
+
+	f = ethash_fopen(tmp_filename, "wb");
+	if (!f) {
+		ETHASH_CRITICAL("Could not create light cache file: \"%s\"", tmp_filename);
+		goto free_names;
+	}
+	if (fwrite(&header, sizeof(header), 1, f) != 1 ||
+		fwrite(cache, (size_t)cache_size, 1, f) != 1 ||
+		fflush(f) != 0) {
+		fclose(f);
+		remove(tmp_filename);
+		ETHASH_CRITICAL("Could not write light cache file: \"%s\". Insufficient space?", tmp_filename);
+		goto free_names;
+	}
+	fclose(f);
+	// rename() does not replace an existing file everywhere
+	remove(filename);
+	if (rename(tmp_filename, filename) != 0) {
+		remove(tmp_filename);
+		goto free_names;
+	}
+	ret = true;
+
+free_names:
+	free(filename);
+	free(tmp_filename);
+	return ret;
+}
+
+void ethash_io_light_remove(char const* dirname, ethash_h256_t const seedhash)
+{
+	char mutable_name[LIGHT_MUTABLE_NAME_MAX_SIZE];
+	if (!ethash_io_light_mutable_name(ETHASH_REVISION, &seedhash, mutable_name)) {
+		return;
+	}
+	char* filename = ethash_io_create_filename(dirname, mutable_name, strlen(mutable_name));
+	if (filename) {
+		// most epochs were never stored here; a missing file is fine
+		remove(filename);
+		free(filename);
+	}
+}
@@ -40,6 +40,24 @@ extern "C" {
 // the seedhash and last 1 is for the null terminating character
 // Reference: https://github.com/ethereum/wiki/wiki/Ethash-DAG
 #define DAG_MUTABLE_NAME_MAX_SIZE (6 + 10 + 1 + 16 + 1)
+// Same as above, but with 7 for "light-R"
+#define LIGHT_MUTABLE_NAME_MAX_SIZE (7 + 10 + 1 + 16 + 1)
+
+#define ETHASH_LIGHT_MAGIC_NUM 0xFEE1DEADCAC4E5EDULL
+// Bump whenever the layout of ethash_light_file_header changes
+#define ETHASH_LIGHT_FILE_VERSION 1
+
+/// Header of a persisted light cache file. The cache nodes follow it directly, in the
+/// same (native, endian-fixed) layout they have in memory.
+typedef struct ethash_light_file_header {
+	uint64_t magic;            ///< ETHASH_LIGHT_MAGIC_NUM
+	uint32_t version;          ///< ETHASH_LIGHT_FILE_VERSION
+	uint32_t revision;         ///< ETHASH_REVISION the cache was computed with
+	uint64_t cache_size;       ///< Size of the cache nodes in bytes
+	ethash_h256_t seed_hash;   ///< Seed hash of the epoch
+	ethash_h256_t checksum;    ///< SHA3-256 of the cache nodes
+	uint8_t reserved[40];      ///< Pads the header to 128 bytes so that the mapped nodes stay aligned
+} ethash_light_file_header;
 /// Possible return values of @see ethash_io_prepare
 enum ethash_io_rc {
 	ETHASH_IO_FAIL = 0,           ///< There has been an IO failure
@@ -111,6 +129,49 @@ enum ethash_io_rc ethash_io_prepare(
  * @param mode             Opening mode. Check fopen()
  * @return                 The FILE* or NULL in failure
  */
+/**
+ * Maps a persisted light cache read-only.
+ *
+ * @param dirname        The directory holding the light cache files
+ * @param seedhash       The seed hash of the epoch
+ * @param cache_size     The expected size of the cache nodes in bytes
+ * @return               The mapping, starting with an ethash_light_file_header whose
+ *                       fields match the arguments, or NULL if no such file exists.
+ *                       The checksum is left to the caller to verify.
+ */
+uint8_t* ethash_io_light_load(
+	char const* dirname,
+	ethash_h256_t const seedhash,
+	uint64_t cache_size
+);
+
+/**
+ * Persists a light cache. It is written to a temporary file first and renamed into place,
+ * so that concurrent readers never see a partial cache.
+ *
+ * @param dirname        The directory holding the light cache files
+ * @param seedhash       The seed hash of the epoch
+ * @param cache          The (endian-fixed) cache nodes
+ * @param cache_size     The size of the cache nodes in bytes
+ * @param checksum       SHA3-256 of the cache nodes
+ * @return               true for success and false on any IO failure
+ */
+bool ethash_io_light_store(
+	char const* dirname,
+	ethash_h256_t const seedhash,
+	void const* cache,
+	uint64_t cache_size,
+	ethash_h256_t const* checksum
+);
+
+/**
+ * Deletes the persisted light cache of an epoch, if there is one.
+ *
+ * @param dirname        The directory holding the light cache files
+ * @param seedhash       The seed hash of the epoch
+ */
+void ethash_io_light_remove(char const* dirname, ethash_h256_t const seedhash);
+
 FILE* ethash_fopen(char const* file_name, char const* mode);
 
 /**
@@ -149,6 +210,13 @@ bool ethash_mkdir(char const* dirname);
  */
 bool ethash_file_size(FILE* f, size_t* ret_size);
 
+/**
+ * Get the id of the calling process
+ *
+ * @return             The platform's process id
+ */
+unsigned ethash_process_id(void);
+
 /**
  * Get a file descriptor number from a FILE stream
  *
@@ -197,6 +265,19 @@ static inline bool ethash_io_mutable_name(
     return snprintf(output, DAG_MUTABLE_NAME_MAX_SIZE, "full-R%u-%016" PRIx64, revision, hash) >= 0;
 }
 
+static inline bool ethash_io_light_mutable_name(
+	uint32_t revision,
+	ethash_h256_t const* seed_hash,
+	char* output
+)
+{
+    uint64_t hash = *((uint64_t*)seed_hash);
+#if LITTLE_ENDIAN == BYTE_ORDER
+    hash = ethash_swap_u64(hash);
+#endif
+    return snprintf(output, LIGHT_MUTABLE_NAME_MAX_SIZE, "light-R%u-%016" PRIx64, revision, hash) >= 0;
+}
+
 #ifdef __cplusplus
 }
 #endif
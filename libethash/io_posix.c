@@ -45,6 +45,11 @@ bool ethash_mkdir(char const* dirname)
 	return rc != -1 || errno == EEXIST;
 }
 
+unsigned ethash_process_id(void)
+{
+	return (unsigned)getpid();
+}
+
 int ethash_fileno(FILE *f)
 {
 	return fileno(f);
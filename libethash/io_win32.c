@@ -22,6 +22,7 @@
 #include "io.h"
 #include <direct.h>
 #include <errno.h>
+#include <process.h>
 #include <stdio.h>
 #include <sys/stat.h>
 #include <sys/types.h>
@@ -44,6 +45,11 @@ bool ethash_mkdir(char const* dirname)
 	return rc != -1 || errno == EEXIST;
 }
 
+unsigned ethash_process_id(void)
+{
+	return (unsigned)_getpid();
+}
+
 int ethash_fileno(FILE* f)
 {
 	return _fileno(f);
@@ -24,7 +24,13 @@
 #include <boost/filesystem.hpp>
 #include <chrono>
 #include <array>
+#include <fstream>
 #include <thread>
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+#include <boost/algorithm/string.hpp>
 #include <libethash/internal.h>
 #include <libdevcore/Common.h>
 #include <libdevcore/Guards.h>
@@ -44,8 +50,16 @@ const char* DAGChannel::name() { return EthGreen "DAG"; }
 
 EthashAux* dev::eth::EthashAux::s_this = nullptr;
 
+EthashAux::EthashAux()
+{
+	m_memoryReport = MemoryAccounting::get().add("ethash", [this]() { return memoryUsage(); }, [this]() { trimLights(); });
+}
+
 EthashAux::~EthashAux()
 {
+	DEV_GUARDED(x_lightPrecomputer)
+		if (m_lightPrecomputer.joinable())
+			m_lightPrecomputer.join();
 }
 
 EthashAux* EthashAux::get()
@@ -110,6 +124,50 @@ uint64_t EthashAux::number(h256 const& _seedHash)
 	return epoch * ETHASH_EPOCH_LENGTH;
 }
 
+MemoryUsage EthashAux::memoryUsage()
+{
+	MemoryUsage ret;
+	DEV_READ_GUARDED(x_lights)
+		for (auto const& i: m_lights)
+		{
+			ret.bytes += i.second->size;
+			++ret.items;
+		}
+	DEV_GUARDED(x_fulls)
+		for (auto const& i: m_fulls)
+			if (FullType f = i.second.lock())
+			{
+				ret.bytes += f->size() * max<size_t>(f->replicas.size(), 1);
+				++ret.items;
+			}
+	return ret;
+}
+
+void EthashAux::trimLights()
+{
+	WriteGuard l(x_lights);
+	if (m_lights.size() < 2)
+		return;
+	// The highest epoch is usually the one precomputed ahead of the chain, so keep by use instead:
+	// the caches verification used last, and the next epoch's that is prepared for each of them.
+	// Those dropped but still in use stay allocated until their users let go.
+	int64_t latest = 0;
+	for (auto const& i: m_lights)
+		latest = max(latest, i.second->lastUsed.load(memory_order_relaxed));
+	h256Hash keep;
+	for (auto const& i: m_lights)
+		if (i.second->lastUsed.load(memory_order_relaxed) == latest)
+		{
+			keep.insert(i.first);
+			keep.insert(sha3(i.first));
+		}
+	for (auto it = m_lights.begin(); it != m_lights.end();)
+		if (keep.count(it->first))
+			++it;
+		else
+			it = m_lights.erase(it);
+}
+
 void EthashAux::killCache(h256 const& _s)
 {
 	WriteGuard l(x_lights);
@@ -118,19 +176,79 @@ void EthashAux::killCache(h256 const& _s)
 
 EthashAux::LightType EthashAux::light(h256 const& _seedHash)
 {
-	UpgradableGuard l(get()->x_lights);
-	if (get()->m_lights.count(_seedHash))
-		return get()->m_lights.at(_seedHash);
-	UpgradeGuard l2(l);
-	return (get()->m_lights[_seedHash] = make_shared<LightAllocation>(_seedHash));
+	LightType ret;
+	// Plain read lock for the common case: upgradable locks are exclusive among themselves, so they
+	// would serialise all the block verifiers checking seals of the same epoch.
+	DEV_READ_GUARDED(get()->x_lights)
+	{
+		auto it = get()->m_lights.find(_seedHash);
+		if (it != get()->m_lights.end())
+			ret = it->second;
+	}
+	if (!ret)
+	{
+		UpgradableGuard l(get()->x_lights);
+		if (get()->m_lights.count(_seedHash))
+			ret = get()->m_lights.at(_seedHash);
+		else
+		{
+			UpgradeGuard l2(l);
+			ret = get()->m_lights[_seedHash] = make_shared<LightAllocation>(_seedHash);
+		}
+	}
+	// Coarse, so that verifiers sharing a cache seldom write to it.
+	int64_t now = duration_cast<seconds>(steady_clock::now().time_since_epoch()).count();
+	if (ret->lastUsed.load(memory_order_relaxed) != now)
+		ret->lastUsed.store(now, memory_order_relaxed);
+	// Have the next epoch's cache ready by the time the chain gets there.
+	if (!ret->nextRequested.load(memory_order_relaxed) && !ret->nextRequested.exchange(true))
+		get()->precomputeLight(sha3(_seedHash));
+	return ret;
+}
+
+void EthashAux::precomputeLight(h256 const& _seedHash)
+{
+	Guard l(x_lightPrecomputer);
+	if (m_precomputingLight)
+		return;
+	DEV_READ_GUARDED(x_lights)
+		if (m_lights.count(_seedHash))
+			return;
+	// Not precomputing, so any previous thread is done and joins right away.
+	if (m_lightPrecomputer.joinable())
+		m_lightPrecomputer.join();
+	m_precomputingLight = true;
+	m_lightPrecomputer = thread([=]()
+	{
+		setThreadName("ethash");
+		try
+		{
+			LightType light = make_shared<LightAllocation>(_seedHash);
+			DEV_WRITE_GUARDED(x_lights)
+				m_lights.insert(make_pair(_seedHash, light));
+			clog(DAGChannel) << "Light cache prepared for seedhash" << _seedHash;
+		}
+		catch (...)
+		{
+			// Past the last epoch or out of memory; the foreground will find out itself if it ever gets there.
+		}
+		m_precomputingLight = false;
+	});
 }
 
 EthashAux::LightAllocation::LightAllocation(h256 const& _seedHash)
 {
 	uint64_t blockNumber = EthashAux::number(_seedHash);
-	light = ethash_light_new(blockNumber);
+	bool persist;
+	string dir;
+	DEV_GUARDED(get()->x_lightStore)
+	{
+		persist = get()->m_persistLights;
+		dir = get()->m_lightDir;
+	}
+	light = persist ? ethash_light_new_persisted(blockNumber, dir.empty() ? nullptr : dir.c_str()) : ethash_light_new(blockNumber);
 	if (!light)
-		BOOST_THROW_EXCEPTION(ExternalFunctionFailure("ethash_light_new()"));
+		BOOST_THROW_EXCEPTION(ExternalFunctionFailure("ethash_light_new_persisted()"));
 	size = ethash_get_cachesize(blockNumber);
 }
 
@@ -154,13 +272,49 @@ EthashAux::FullAllocation::FullAllocation(ethash_light_t _light, ethash_callback
 		clog(DAGChannel) << "DAG Generation Failure. Reason: "  << strerror(errno);
 		BOOST_THROW_EXCEPTION(ExternalFunctionFailure("ethash_full_new"));
 	}
+	DAGPlacement placement = dagPlacement();
+	if (placement.pages != ETHASH_PAGES_DEFAULT || placement.perNumaNode)
+		replicate(placement);
 }
 
 EthashAux::FullAllocation::~FullAllocation()
 {
+	for (auto r: replicas)
+		ethash_full_delete(r);
 	ethash_full_delete(full);
 }
 
+void EthashAux::FullAllocation::replicate(DAGPlacement const& _placement)
+{
+	vector<vector<unsigned>> nodes = _placement.perNumaNode ? numaNodes() : vector<vector<unsigned>>(1);
+	vector<ethash_full_t> copies(nodes.size(), nullptr);
+	vector<ethash_pages_t> used(nodes.size(), ETHASH_PAGES_DEFAULT);
+
+	// Each copy is made from a thread on its node, so that first touch puts its pages there.
+	vector<thread> copiers;
+	for (unsigned i = 0; i < nodes.size(); ++i)
+		copiers.push_back(thread([&, i]()
+		{
+			if (_placement.perNumaNode)
+				pinThread(nodes[i]);
+			copies[i] = ethash_full_replicate(full, _placement.pages, &used[i]);
+		}));
+	for (auto& t: copiers)
+		t.join();
+
+	if (find(copies.begin(), copies.end(), nullptr) != copies.end())
+	{
+		for (auto c: copies)
+			if (c)
+				ethash_full_delete(c);
+		clog(DAGChannel) << "Not enough memory to replicate the DAG; using it in place.";
+		return;
+	}
+	replicas = move(copies);
+	pages = *min_element(used.begin(), used.end());
+	clog(DAGChannel) << "DAG replicated to" << replicas.size() << "NUMA node(s) on" << pagesName(pages) << "pages";
+}
+
 bytesConstRef EthashAux::FullAllocation::data() const
 {
 	return bytesConstRef((byte const*)ethash_full_dag(full), size());
@@ -233,7 +387,7 @@ unsigned EthashAux::computeFull(h256 const& _seedHash, bool _createIfMissing)
 
 EthashProofOfWork::Result EthashAux::FullAllocation::compute(h256 const& _headerHash, Nonce const& _nonce) const
 {
-	ethash_return_value_t r = ethash_full_compute(full, *(ethash_h256_t*)_headerHash.data(), (uint64_t)(u64)_nonce);
+	ethash_return_value_t r = ethash_full_compute(local(0), *(ethash_h256_t*)_headerHash.data(), (uint64_t)(u64)_nonce);
 	if (!r.success)
 		BOOST_THROW_EXCEPTION(DAGCreationFailure());
 	return EthashProofOfWork::Result{h256((uint8_t*)&r.result, h256::ConstructFromPointer), h256((uint8_t*)&r.mix_hash, h256::ConstructFromPointer)};
@@ -257,3 +411,93 @@ EthashProofOfWork::Result EthashAux::eval(h256 const& _seedHash, h256 const& _he
 		return EthashProofOfWork::Result{ ~h256(), h256() };
 	}
 }
+
+void EthashAux::setDAGPlacement(DAGPlacement const& _placement)
+{
+	DEV_GUARDED(get()->x_fulls)
+		get()->m_placement = _placement;
+}
+
+EthashAux::DAGPlacement EthashAux::dagPlacement()
+{
+	Guard l(get()->x_fulls);
+	return get()->m_placement;
+}
+
+void EthashAux::setLightPersistence(bool _persist, string const& _dir)
+{
+	DEV_GUARDED(get()->x_lightStore)
+	{
+		get()->m_persistLights = _persist;
+		get()->m_lightDir = _dir;
+	}
+}
+
+char const* EthashAux::pagesName(ethash_pages_t _pages)
+{
+	switch (_pages)
+	{
+	case ETHASH_PAGES_TRANSPARENT: return "transparent huge";
+	case ETHASH_PAGES_2MB: return "2MB";
+	case ETHASH_PAGES_1GB: return "1GB";
+	default: return "regular";
+	}
+}
+
+vector<vector<unsigned>> const& EthashAux::numaNodes()
+{
+	static vector<vector<unsigned>> s_nodes;
+	static once_flag s_flag;
+	call_once(s_flag, []()
+	{
+#if defined(__linux__)
+		// cpulist holds ranges like "0-7,16-23".
+		for (unsigned n = 0; ; ++n)
+		{
+			ifstream f("/sys/devices/system/node/node" + toString(n) + "/cpulist");
+			if (!f)
+				break;
+			string list;
+			getline(f, list);
+			vector<string> ranges;
+			boost::split(ranges, list, boost::is_any_of(","));
+			vector<unsigned> cpus;
+			for (auto const& r: ranges)
+			{
+				unsigned from;
+				unsigned to;
+				char dash;
+				istringstream in(r);
+				if (!(in >> from))
+					continue;
+				if (!(in >> dash >> to))
+					to = from;
+				for (unsigned c = from; c <= to; ++c)
+					cpus.push_back(c);
+			}
+			s_nodes.push_back(cpus);
+		}
+#endif
+		if (s_nodes.empty())
+		{
+			s_nodes.resize(1);
+			for (unsigned c = 0; c < thread::hardware_concurrency(); ++c)
+				s_nodes[0].push_back(c);
+		}
+	});
+	return s_nodes;
+}
+
+bool EthashAux::pinThread(vector<unsigned> const& _cpus)
+{
+#if defined(__linux__)
+	cpu_set_t set;
+	CPU_ZERO(&set);
+	for (auto c: _cpus)
+		CPU_SET(c, &set);
+	return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+	(void)_cpus;
+	return false;
+#endif
+}
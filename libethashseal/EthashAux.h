@@ -21,9 +21,11 @@
 
 #pragma once
 
+#include <atomic>
 #include <condition_variable>
 #include <libethash/ethash.h>
 #include <libdevcore/Log.h>
+#include <libdevcore/MemoryAccounting.h>
 #include <libdevcore/Worker.h>
 #include "EthashProofOfWork.h"
 #include "Ethash.h"
@@ -52,6 +54,17 @@ public:
 		EthashProofOfWork::Result compute(h256 const& _headerHash, Nonce const& _nonce) const;
 		ethash_light_t light;
 		uint64_t size;
+		/// Set once the following epoch's cache has been asked for in the background.
+		std::atomic<bool> nextRequested{false};
+		/// Seconds (steady clock) at which light() last handed this cache out; tells trimLights() what is in use.
+		std::atomic<int64_t> lastUsed{0};
+	};
+
+	/// Where full DAGs live in memory; see setDAGPlacement().
+	struct DAGPlacement
+	{
+		ethash_pages_t pages = ETHASH_PAGES_DEFAULT;
+		bool perNumaNode = false;	///< One replica per NUMA node, for miner threads pinned to that node.
 	};
 
 	struct FullAllocation
@@ -61,7 +74,14 @@ public:
 		EthashProofOfWork::Result compute(h256 const& _headerHash, Nonce const& _nonce) const;
 		bytesConstRef data() const;
 		uint64_t size() const { return ethash_full_dag_size(full); }
+		/// The copy of the DAG to hash against from NUMA node @a _node.
+		ethash_full_t local(unsigned _node) const { return replicas.empty() ? full : replicas[_node < replicas.size() ? _node : 0]; }
 		ethash_full_t full;
+		std::vector<ethash_full_t> replicas;	///< Indexed by NUMA node; empty if the DAG is used straight from its file.
+		ethash_pages_t pages = ETHASH_PAGES_DEFAULT;	///< The pages the replicas actually got.
+
+	private:
+		void replicate(DAGPlacement const& _placement);
 	};
 
 	using LightType = std::shared_ptr<LightAllocation>;
@@ -84,18 +104,49 @@ public:
 
 	static EthashProofOfWork::Result eval(h256 const& _seedHash, h256 const& _headerHash, Nonce const& _nonce);
 
+	/// Sets how full DAGs loaded from now on are laid out: on which pages, and whether replicated per NUMA node.
+	static void setDAGPlacement(DAGPlacement const& _placement);
+	static DAGPlacement dagPlacement();
+	static char const* pagesName(ethash_pages_t _pages);
+
+	/// Where light caches created from now on are kept between runs: @a _dir, or the default DAG
+	/// directory if it is empty. With @a _persist false they are computed in memory only.
+	static void setLightPersistence(bool _persist, std::string const& _dir = std::string());
+
+	/// The CPUs of each NUMA node; a single node with all CPUs where the topology is not known.
+	static std::vector<std::vector<unsigned>> const& numaNodes();
+	/// Restricts the calling thread to @a _cpus. @returns false if that is not supported here.
+	static bool pinThread(std::vector<unsigned> const& _cpus);
+
 private:
-	EthashAux() {}
+	EthashAux();
 
 	/// Kicks off generation of DAG for @a _blocknumber and blocks until ready; @returns result.
 
 	void killCache(h256 const& _s);
 
+	/// Loads (or computes and persists) the light cache for @a _seedHash on a background thread,
+	/// unless one is already being prepared.
+	void precomputeLight(h256 const& _seedHash);
+
+	/// Memory held by the light caches and the full DAGs, reported to MemoryAccounting.
+	MemoryUsage memoryUsage();
+	/// Drops the light caches of all but the most recently used epoch(s) and the ones following them.
+	void trimLights();
+
 	static EthashAux* s_this;
 
 	SharedMutex x_lights;
 	std::unordered_map<h256, std::shared_ptr<LightAllocation>> m_lights;
 
+	Mutex x_lightStore;
+	bool m_persistLights = true;
+	std::string m_lightDir;	///< Empty for the default DAG directory.
+
+	Mutex x_lightPrecomputer;
+	std::thread m_lightPrecomputer;
+	std::atomic<bool> m_precomputingLight{false};
+
 	Mutex x_fulls;
 	std::condition_variable m_fullsChanged;
 	std::unordered_map<h256, std::weak_ptr<FullAllocation>> m_fulls;
@@ -103,10 +154,13 @@ private:
 	std::unique_ptr<std::thread> m_fullGenerator;
 	uint64_t m_generatingFullNumber = NotGenerating;
 	unsigned m_fullProgress;
+	DAGPlacement m_placement;
 
 	Mutex x_epochs;
 	std::unordered_map<h256, unsigned> m_epochs;
 	h256s m_seedHashes;
+
+	MemoryAccounting::Handle m_memoryReport;
 };
 
 }
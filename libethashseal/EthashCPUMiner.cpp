@@ -26,6 +26,11 @@
 #include <chrono>
 #include <boost/algorithm/string.hpp>
 #include <random>
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
 #if ETH_CPUID
 #define HAVE_STDINT_H
 #include <libcpuid/libcpuid.h>
@@ -35,6 +40,58 @@ using namespace dev;
 using namespace eth;
 
 unsigned EthashCPUMiner::s_numInstances = 0;
+std::atomic<uint64_t> EthashCPUMiner::s_dtlbMisses{0};
+std::atomic<uint64_t> EthashCPUMiner::s_dtlbHashes{0};
+
+namespace
+{
+
+/// Counts the dTLB load misses of the calling thread, where perf events are available.
+class DTLBMissCounter
+{
+public:
+	DTLBMissCounter()
+	{
+#if defined(__linux__)
+		perf_event_attr attr;
+		memset(&attr, 0, sizeof(attr));
+		attr.size = sizeof(attr);
+		attr.type = PERF_TYPE_HW_CACHE;
+		attr.config = PERF_COUNT_HW_CACHE_DTLB | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+		attr.exclude_kernel = 1;
+		attr.exclude_hv = 1;
+		m_fd = syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+#endif
+	}
+	~DTLBMissCounter()
+	{
+#if defined(__linux__)
+		if (m_fd != -1)
+			close(m_fd);
+#endif
+	}
+
+	bool available() const { return m_fd != -1; }
+
+	/// @returns the misses since the last call.
+	uint64_t take()
+	{
+		uint64_t total = 0;
+#if defined(__linux__)
+		if (m_fd == -1 || read(m_fd, &total, sizeof(total)) != sizeof(total))
+			return 0;
+#endif
+		uint64_t ret = total - m_last;
+		m_last = total;
+		return ret;
+	}
+
+private:
+	long m_fd = -1;
+	uint64_t m_last = 0;
+};
+
+}
 
 #if ETH_CPUID
 static string jsonEncode(map<string, string> const& _m)
@@ -92,22 +149,57 @@ void EthashCPUMiner::workLoop()
 		dag = EthashAux::full(w.seedHash, false);
 	}
 
+	ethash_full_t full = dag->local(pinToNode());
+	DTLBMissCounter dtlb;
+	dtlb.take();
+
 	h256 boundary = w.boundary;
 	unsigned hashCount = 1;
 	for (; !shouldStop(); tryNonce++, hashCount++)
 	{
-		ethashReturn = ethash_full_compute(dag->full, *(ethash_h256_t*)w.headerHash.data(), tryNonce);
+		ethashReturn = ethash_full_compute(full, *(ethash_h256_t*)w.headerHash.data(), tryNonce);
 		h256 value = h256((uint8_t*)&ethashReturn.result, h256::ConstructFromPointer);
 		if (value <= boundary && submitProof(EthashProofOfWork::Solution{(h64)(u64)tryNonce, h256((uint8_t*)&ethashReturn.mix_hash, h256::ConstructFromPointer)}))
 			break;
 		if (!(hashCount % 100))
+		{
 			accumulateHashes(100);
+			if (dtlb.available())
+			{
+				s_dtlbMisses += dtlb.take();
+				s_dtlbHashes += 100;
+			}
+		}
 	}
 }
 
+unsigned EthashCPUMiner::pinToNode()
+{
+	if (!EthashAux::dagPlacement().perNumaNode)
+		return 0;
+	// Spread the miners over all CPUs, node by node.
+	auto const& nodes = EthashAux::numaNodes();
+	unsigned cpus = 0;
+	for (auto const& n: nodes)
+		cpus += n.size();
+	if (!cpus)
+		return 0;
+	unsigned slot = index() % cpus;
+	for (unsigned n = 0; n < nodes.size(); slot -= nodes[n++].size())
+		if (slot < nodes[n].size())
+		{
+			EthashAux::pinThread({nodes[n][slot]});
+			return n;
+		}
+	return 0;
+}
+
 std::string EthashCPUMiner::platformInfo()
 {
-	string baseline = toString(std::thread::hardware_concurrency()) + "-thread CPU";
+	EthashAux::DAGPlacement placement = EthashAux::dagPlacement();
+	string dagPages = EthashAux::pagesName(placement.pages);
+	string dagReplicas = toString(placement.perNumaNode ? EthashAux::numaNodes().size() : 1);
+	string baseline = toString(std::thread::hardware_concurrency()) + "-thread CPU, DAG on " + dagPages + " pages x" + dagReplicas;
 
 #if ETH_CPUID
 	if (!cpuid_present())
@@ -129,6 +221,8 @@ std::string EthashCPUMiner::platformInfo()
 	m["threads"] = toString(data.num_logical_cpus);
 	m["clocknominal"] = toString(cpu_clock_by_os());
 	m["clocktested"] = toString(cpu_clock_measure(200, 0));
+	m["DAG pages"] = dagPages;
+	m["DAG replicas"] = dagReplicas;
 	/*
 	printf("  MMX         : %s\n", data.flags[CPU_FEATURE_MMX] ? "present" : "absent");
 	printf("  MMX-extended: %s\n", data.flags[CPU_FEATURE_MMXEXT] ? "present" : "absent");
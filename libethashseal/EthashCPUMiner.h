@@ -23,6 +23,7 @@
 
 #pragma once
 
+#include <atomic>
 #include "libdevcore/Worker.h"
 #include <libethereum/GenericMiner.h>
 #include "EthashAux.h"
@@ -43,6 +44,9 @@ public:
 	static void listDevices() {}
 	static bool configureGPU(unsigned, unsigned, unsigned, unsigned, unsigned, bool, unsigned, uint64_t) { return false; }
 	static void setNumInstances(unsigned _instances) { s_numInstances = std::min<unsigned>(_instances, std::thread::hardware_concurrency()); }
+	/// dTLB load misses counted by the miner threads so far, and the hashes computed while counting.
+	/// Both stay zero where hardware performance counters are not available.
+	static std::pair<uint64_t, uint64_t> dtlbMisses() { return std::make_pair(s_dtlbMisses.load(), s_dtlbHashes.load()); }
 
 protected:
 	void kickOff() override;
@@ -50,7 +54,12 @@ protected:
 
 private:
 	void workLoop() override;
+	/// Pins this miner to a CPU if the DAG is replicated per NUMA node. @returns the node to hash on.
+	unsigned pinToNode();
+
 	static unsigned s_numInstances;
+	static std::atomic<uint64_t> s_dtlbMisses;
+	static std::atomic<uint64_t> s_dtlbHashes;
 };
 
 }
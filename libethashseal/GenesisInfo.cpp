@@ -34,6 +34,9 @@ using namespace dev;
 #include "genesis/AnomalyMainNetwork.cpp"
 #include "genesis/AnomalyTestNetwork.cpp"
 
+// Generated at build time by mkgenesis
+#include "GenesisBinary.h"
+
 std::string const& dev::eth::genesisInfo(Network _n)
 {
 	switch (_n)
@@ -73,3 +76,33 @@ h256 const& dev::eth::genesisStateRoot(Network _n)
 		throw std::invalid_argument("Invalid network value");
 	}
 }
+
+dev::eth::ChainParams dev::eth::genesisParams(Network _n)
+{
+	auto fromBinary = [&](std::string const& _config, unsigned char const* _state, size_t _size)
+	{
+		return ChainParams(_config, genesisStateRoot(_n)).loadGenesisStateBinary(bytesConstRef(_state, _size), genesisStateRoot(_n));
+	};
+	switch (_n)
+	{
+	case Network::MainNetwork: return fromBinary(c_genesisConfigMainNetwork, c_genesisStateMainNetwork, sizeof(c_genesisStateMainNetwork));
+	case Network::Ropsten: return fromBinary(c_genesisConfigRopsten, c_genesisStateRopsten, sizeof(c_genesisStateRopsten));
+	case Network::AnomalyMainNetwork: return fromBinary(c_genesisConfigAnomalyMainNetwork, c_genesisStateAnomalyMainNetwork, sizeof(c_genesisStateAnomalyMainNetwork));
+	case Network::AnomalyTestNetwork: return fromBinary(c_genesisConfigAnomalyTestNetwork, c_genesisStateAnomalyTestNetwork, sizeof(c_genesisStateAnomalyTestNetwork));
+	default:
+		return ChainParams(genesisInfo(_n), genesisStateRoot(_n));
+	}
+}
+
+dev::eth::ChainParams dev::eth::genesisConfig(Network _n)
+{
+	switch (_n)
+	{
+	case Network::MainNetwork: return ChainParams(c_genesisConfigMainNetwork, genesisStateRoot(_n));
+	case Network::Ropsten: return ChainParams(c_genesisConfigRopsten, genesisStateRoot(_n));
+	case Network::AnomalyMainNetwork: return ChainParams(c_genesisConfigAnomalyMainNetwork, genesisStateRoot(_n));
+	case Network::AnomalyTestNetwork: return ChainParams(c_genesisConfigAnomalyTestNetwork, genesisStateRoot(_n));
+	default:
+		return ChainParams(genesisInfo(_n), genesisStateRoot(_n));
+	}
+}
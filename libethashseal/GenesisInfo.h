@@ -24,6 +24,7 @@
 #include <string>
 #include <libdevcore/FixedHash.h>
 #include <libethcore/Common.h>
+#include <libethereum/ChainParams.h>
 
 namespace dev
 {
@@ -52,5 +53,14 @@ enum class Network
 std::string const& genesisInfo(Network _n);
 h256 const& genesisStateRoot(Network _n);
 
+/// The chain parameters of network @a _n. Same as ChainParams(genesisInfo(_n), genesisStateRoot(_n)), but
+/// sizeable genesis states come from a binary built in at compile time: no JSON to parse and the state trie
+/// nodes ready to store.
+ChainParams genesisParams(Network _n);
+
+/// The chain parameters of network @a _n without decoding the sizeable genesis states; for tools that only
+/// need the chain's configuration.
+ChainParams genesisConfig(Network _n);
+
 }
 }
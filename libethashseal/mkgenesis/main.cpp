@@ -0,0 +1,108 @@
+/*
+	This file is part of cpp-ethereum.
+
+	cpp-ethereum is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	cpp-ethereum is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with cpp-ethereum.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/** @file main.cpp
+ * @date 2017
+ * Build-time tool: turns the genesis JSON of the networks with sizeable genesis states into
+ * ready-made state tries, so that starting up does not have to parse and hash them.
+ */
+
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <json_spirit/JsonSpiritHeaders.h>
+#include <libethereum/ChainParams.h>
+using namespace std;
+using namespace dev;
+using namespace dev::eth;
+namespace js = json_spirit;
+
+#include "../genesis/mainNetwork.cpp"
+#include "../genesis/ropsten.cpp"
+#include "../genesis/AnomalyMainNetwork.cpp"
+#include "../genesis/AnomalyTestNetwork.cpp"
+
+namespace
+{
+
+struct BuiltinNetwork
+{
+	char const* name;
+	string const& json;
+	h256 const& stateRoot;
+};
+
+/// @returns @a _json without the accounts that are plain state, which the binary holds instead.
+/// Precompiled contracts stay, since they also configure the chain.
+string stripAccounts(string const& _json)
+{
+	js::mValue v;
+	js::read_string(_json, v);
+	js::mObject& o = v.get_obj();
+	js::mObject kept;
+	for (auto const& a: o["accounts"].get_obj())
+		if (a.second.get_obj().count("precompiled"))
+			kept.insert(a);
+	o["accounts"] = kept;
+	return js::write_string(v, true);
+}
+
+void write(ostream& _out, BuiltinNetwork const& _n)
+{
+	ChainParams p(_n.json, _n.stateRoot);
+	bytes state = p.genesisStateBinary();
+	h256 root = RLP(state)[1].toHash<h256>();
+	if (_n.stateRoot && root != _n.stateRoot)
+	{
+		cerr << "Genesis state of " << _n.name << " has root " << root << " instead of " << _n.stateRoot << endl;
+		exit(1);
+	}
+
+	_out << "static std::string const c_genesisConfig" << _n.name << " = R\"E(" << stripAccounts(_n.json) << ")E\";\n";
+	_out << "static unsigned char const c_genesisState" << _n.name << "[] = {";
+	for (size_t i = 0; i < state.size(); ++i)
+		_out << (i % 16 ? " " : "\n\t") << "0x" << hex << setw(2) << setfill('0') << (unsigned)state[i] << ",";
+	_out << dec << "\n};\n\n";
+}
+
+}
+
+int main(int argc, char** argv)
+{
+	if (argc != 2)
+	{
+		cerr << "Usage: mkgenesis <output header>" << endl;
+		return 1;
+	}
+
+	BuiltinNetwork const networks[] = {
+		{"MainNetwork", c_genesisInfoMainNetwork, c_genesisStateRootMainNetwork},
+		{"Ropsten", c_genesisInfoRopsten, c_genesisStateRootRopsten},
+		{"AnomalyMainNetwork", c_genesisInfoAnomalyMainNetwork, c_genesisStateRootAnomalyMainNetwork},
+		{"AnomalyTestNetwork", c_genesisInfoAnomalyTestNetwork, c_genesisStateRootAnomalyTestNetwork}
+	};
+
+	ofstream out(argv[1]);
+	out << "// Generated by mkgenesis from libethashseal/genesis; do not edit.\n\n";
+	for (auto const& n: networks)
+		write(out, n);
+	if (!out)
+	{
+		cerr << "Could not write " << argv[1] << endl;
+		return 1;
+	}
+	return 0;
+}
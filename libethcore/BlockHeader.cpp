@@ -178,7 +178,11 @@ void BlockHeader::verify(Strictness _s, BlockHeader const& _parent, bytesConstRe
 		RLP root(_block);
 
 		auto txList = root[1];
-		auto expectedRoot = trieRootOver(txList.itemCount(), [&](unsigned i){ return rlp(i); }, [&](unsigned i){ return txList[i].data().toBytes(); });
+		vector<bytesConstRef> txData;
+		txData.reserve(txList.itemCount());
+		for (auto const& tx: txList)
+			txData.push_back(tx.data());
+		auto expectedRoot = orderedTrieRoot(txData);
 
 		clog(BlockInfoDiagnosticsChannel) << "Expected trie root:" << toString(expectedRoot);
 		if (m_transactionsRoot != expectedRoot)
@@ -199,8 +203,8 @@ void BlockHeader::verify(Strictness _s, BlockHeader const& _parent, bytesConstRe
 				txs.push_back(txList[i].data());
 				cdebug << toHex(k.out()) << toHex(txList[i].data());
 			}
-			cdebug << "trieRootOver" << expectedRoot;
-			cdebug << "orderedTrieRoot" << orderedTrieRoot(txs);
+			cdebug << "orderedTrieRoot" << expectedRoot;
+			cdebug << "trieRootOver" << trieRootOver(txList.itemCount(), [&](unsigned i){ return rlp(i); }, [&](unsigned i){ return txList[i].data().toBytes(); });
 			cdebug << "TrieDB" << transactionsTrie.root();
 			cdebug << "Contents:";
 			for (auto const& t: txs)
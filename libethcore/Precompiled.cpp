@@ -20,6 +20,7 @@
  */
 
 #include "Precompiled.h"
+#include "PrecompiledCache.h"
 #include <libdevcore/Log.h>
 #include <libdevcore/SHA3.h>
 #include <libdevcore/Hash.h>
@@ -41,7 +42,7 @@ PrecompiledExecutor const& PrecompiledRegistrar::executor(std::string const& _na
 namespace
 {
 
-ETH_REGISTER_PRECOMPILED(ecrecover)(bytesConstRef _in)
+pair<bool, bytes> ecrecoverUncached(bytesConstRef _in)
 {
 	struct
 	{
@@ -75,6 +76,14 @@ ETH_REGISTER_PRECOMPILED(ecrecover)(bytesConstRef _in)
 	return {true, {}};
 }
 
+ETH_REGISTER_PRECOMPILED(ecrecover)(bytesConstRef _in)
+{
+	// Only the first 128 bytes are read, zero-padded; key on just those so that equivalent inputs share an entry.
+	FixedHash<128> in;
+	memcpy(in.data(), _in.data(), min<size_t>(_in.size(), in.size));
+	return PrecompiledCache::instance().execute("ecrecover", in.ref(), ecrecoverUncached);
+}
+
 ETH_REGISTER_PRECOMPILED(sha256)(bytesConstRef _in)
 {
 	return {true, dev::sha256(_in).asBytes()};
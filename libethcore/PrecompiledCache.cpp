@@ -0,0 +1,46 @@
+/*
+	This file is part of cpp-ethereum.
+
+	cpp-ethereum is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	cpp-ethereum is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with cpp-ethereum.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/** @file PrecompiledCache.cpp
+ * @date 2017
+ */
+
+#include "PrecompiledCache.h"
+#include <libdevcore/SHA3.h>
+using namespace std;
+using namespace dev;
+using namespace dev::eth;
+
+pair<bool, bytes> PrecompiledCache::execute(string const& _name, bytesConstRef _in, PrecompiledExecutor const& _exec)
+{
+	if (!m_enabled)
+		return _exec(_in);
+
+	// The name is hashed along with the input, so that contracts never share entries.
+	bytes keyed = asBytes(_name);
+	keyed.push_back(0);
+	keyed.insert(keyed.end(), _in.begin(), _in.end());
+	h256 const key = sha3(keyed);
+
+	pair<bool, bytes> ret;
+	if (m_cache.lookup(key, ret))
+		return ret;
+
+	// Run unlocked; should two threads race on the same input, both compute the same output.
+	ret = _exec(_in);
+	m_cache.insert(key, ret);
+	return ret;
+}
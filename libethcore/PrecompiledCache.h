@@ -0,0 +1,70 @@
+/*
+	This file is part of cpp-ethereum.
+
+	cpp-ethereum is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	cpp-ethereum is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with cpp-ethereum.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/** @file PrecompiledCache.h
+ * @date 2017
+ */
+
+#pragma once
+
+#include <atomic>
+#include <string>
+#include <libdevcore/FixedHash.h>
+#include <libdevcore/ShardedCache.h>
+#include "Precompiled.h"
+
+namespace dev
+{
+namespace eth
+{
+
+/**
+ * @brief Process-wide thread-safe cache of precompiled contract outputs, keyed by the contract and the hash of its input.
+ * Only for contracts which are pure functions of their input and dearer to run than to hash (ecrecover), so
+ * that a signature checked again by another call, transaction or thread (verifiers, import, RPC) is not recovered twice.
+ * Entries never go stale, so the cache is not tied to a block.
+ */
+class PrecompiledCache
+{
+public:
+	/// @returns the output of precompiled contract @a _name on @a _in, from the cache or else by running @a _exec.
+	std::pair<bool, bytes> execute(std::string const& _name, bytesConstRef _in, PrecompiledExecutor const& _exec);
+
+	/// Enables or disables the cache. While disabled, contracts always run and nothing is counted.
+	void setEnabled(bool _enabled) { m_enabled = _enabled; }
+	bool enabled() const { return m_enabled; }
+
+	/// @returns the number of executions answered from the cache, since process start.
+	uint64_t hits() const { return m_cache.hits(); }
+	/// @returns the number of executions which had to run the contract, since process start.
+	uint64_t misses() const { return m_cache.misses(); }
+	/// @returns the number of cached outputs.
+	size_t size() const { return m_cache.size(); }
+
+	/// Forgets all cached outputs. Statistics are kept.
+	void clear() { m_cache.clear(); }
+
+	static PrecompiledCache& instance() { static PrecompiledCache cache; return cache; }
+
+private:
+	static const size_t c_maxShardSize = 1024;
+
+	ShardedCache<h256, std::pair<bool, bytes>> m_cache{c_maxShardSize};
+	std::atomic<bool> m_enabled{true};
+};
+
+}
+}
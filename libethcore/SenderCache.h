@@ -0,0 +1,65 @@
+/*
+	This file is part of cpp-ethereum.
+
+	cpp-ethereum is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	cpp-ethereum is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with cpp-ethereum.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/** @file SenderCache.h
+ * @date 2017
+ */
+
+#pragma once
+
+#include <libdevcore/FixedHash.h>
+#include <libdevcore/ShardedCache.h>
+#include <libethcore/Common.h>
+
+namespace dev
+{
+namespace eth
+{
+
+/**
+ * @brief Process-wide thread-safe cache mapping the hash of a signed transaction to its sender.
+ * Whoever recovers a sender first (transaction queue verifiers, block verification, RPC) stores it,
+ * so that the same transaction seen again in a block or a query skips signature recovery.
+ */
+class SenderCache
+{
+public:
+	/// Remembers @a _sender as the sender of the transaction with signed hash @a _txHash.
+	void store(h256 const& _txHash, Address const& _sender) { m_cache.insert(_txHash, _sender); }
+
+	/// @returns the sender of the transaction with signed hash @a _txHash, or a null Address if it is not cached.
+	Address lookup(h256 const& _txHash) { Address ret; m_cache.lookup(_txHash, ret); return ret; }
+
+	/// @returns the number of lookups which found a sender, since process start.
+	uint64_t hits() const { return m_cache.hits(); }
+	/// @returns the number of lookups which did not find a sender, since process start.
+	uint64_t misses() const { return m_cache.misses(); }
+	/// @returns the number of cached senders.
+	size_t size() const { return m_cache.size(); }
+
+	/// Forgets all cached senders. Statistics are kept.
+	void clear() { m_cache.clear(); }
+
+	static SenderCache& instance() { static SenderCache cache; return cache; }
+
+private:
+	static const size_t c_maxShardSize = 4096;
+
+	ShardedCache<h256, Address> m_cache{c_maxShardSize};
+};
+
+}
+}
@@ -25,6 +25,7 @@
 #include <libdevcrypto/Common.h>
 #include <libevmcore/EVMSchedule.h>
 #include <libethcore/Exceptions.h>
+#include "SenderCache.h"
 #include "Transaction.h"
 
 using namespace std;
@@ -64,7 +65,7 @@ TransactionBase::TransactionBase(bytesConstRef _rlpData, CheckTransaction _check
 		if (!rlp[field = 5].isData())
 			BOOST_THROW_EXCEPTION(InvalidTransactionFormat() << errinfo_comment("transaction data RLP must be an array"));
 
-		m_data = rlp[field = 5].toBytes();
+		bytesConstRef const data = rlp[field = 5].toBytesConstRef();
 
 		byte v = rlp[field = 6].toInt<byte>();
 		h256 r = rlp[field = 7].toInt<u256>();
@@ -85,6 +86,10 @@ TransactionBase::TransactionBase(bytesConstRef _rlpData, CheckTransaction _check
 		m_vrs = SignatureStruct{ r, s, v };
 		if (_checkSig >= CheckTransaction::Cheap && !m_vrs.isValid())
 			BOOST_THROW_EXCEPTION(InvalidSignature());
+		// The data stays in the shared encoding rather than in a copy of its own.
+		m_rlp = make_shared<bytes const>(rlp.data().toBytes());
+		m_dataOffset = data.data() - rlp.data().data();
+		m_dataSize = data.size();
 		if (_checkSig == CheckTransaction::Everything)
 			m_sender = sender();
 	}
@@ -111,10 +116,15 @@ Address const& TransactionBase::sender() const
 {
 	if (!m_sender)
 	{
+		h256 const h = sha3(WithSignature);
+		if (Address const cached = SenderCache::instance().lookup(h))
+			return m_sender = cached;
+
 		auto p = recover(m_vrs, sha3(WithoutSignature));
 		if (!p)
 			BOOST_THROW_EXCEPTION(InvalidSignature());
 		m_sender = right160(dev::sha3(bytesConstRef(p.data(), sizeof(p))));
+		SenderCache::instance().store(h, m_sender);
 	}
 	return m_sender;
 }
@@ -124,7 +134,18 @@ void TransactionBase::sign(Secret const& _priv)
 	auto sig = dev::sign(_priv, sha3(WithoutSignature));
 	SignatureStruct sigStruct = *(SignatureStruct const*)&sig;
 	if (sigStruct.isValid())
+	{
 		m_vrs = sigStruct;
+		noteSignatureChanged();
+	}
+}
+
+void TransactionBase::noteSignatureChanged()
+{
+	if (m_rlp)
+		m_data = data().toBytes();
+	m_rlp.reset();
+	m_hashWith = h256();
 }
 
 void TransactionBase::streamRLP(RLPStream& _s, IncludeSignature _sig, bool _forEip155hash) const
@@ -132,13 +153,19 @@ void TransactionBase::streamRLP(RLPStream& _s, IncludeSignature _sig, bool _forE
 	if (m_type == NullTransaction)
 		return;
 
+	if (_sig == WithSignature && m_rlp)
+	{
+		_s.appendRaw(*m_rlp);
+		return;
+	}
+
 	_s.appendList((_sig || _forEip155hash ? 3 : 0) + 6);
 	_s << m_nonce << m_gasPrice << m_gas;
 	if (m_type == MessageCall)
 		_s << m_receiveAddress;
 	else
 		_s << "";
-	_s << m_value << m_data;
+	_s << m_value << data();
 
 	if (_sig)
 	{
@@ -180,6 +207,9 @@ h256 TransactionBase::sha3(IncludeSignature _sig) const
 	if (_sig == WithSignature && m_hashWith)
 		return m_hashWith;
 
+	if (_sig == WithSignature && m_rlp)
+		return m_hashWith = dev::sha3(*m_rlp);
+
 	RLPStream s;
 	streamRLP(s, _sig, m_chainId > 0 && _sig == WithoutSignature);
 
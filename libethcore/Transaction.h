@@ -75,7 +75,7 @@ public:
 	explicit TransactionBase(bytes const& _rlp, CheckTransaction _checkSig): TransactionBase(&_rlp, _checkSig) {}
 
 	/// Checks equality of transactions.
-	bool operator==(TransactionBase const& _c) const { return m_type == _c.m_type && (m_type == ContractCreation || m_receiveAddress == _c.m_receiveAddress) && m_value == _c.m_value && m_data == _c.m_data; }
+	bool operator==(TransactionBase const& _c) const { return m_type == _c.m_type && (m_type == ContractCreation || m_receiveAddress == _c.m_receiveAddress) && m_value == _c.m_value && data().size() == _c.data().size() && std::equal(data().begin(), data().end(), _c.data().begin()); }
 	/// Checks inequality of transactions.
 	bool operator!=(TransactionBase const& _c) const { return !operator==(_c); }
 
@@ -101,10 +101,12 @@ public:
 	bool isCreation() const { return m_type == ContractCreation; }
 
 	/// Serialises this transaction to an RLPStream.
+	/// The signed form of a transaction decoded from RLP is streamed as the original encoding.
 	void streamRLP(RLPStream& _s, IncludeSignature _sig = WithSignature, bool _forEip155hash = false) const;
 
 	/// @returns the RLP serialisation of this transaction.
-	bytes rlp(IncludeSignature _sig = WithSignature) const { RLPStream s; streamRLP(s, _sig); return s.out(); }
+	/// The signed form of a transaction decoded from RLP is the original encoding, returned without re-encoding.
+	bytes rlp(IncludeSignature _sig = WithSignature) const { if (_sig == WithSignature && m_rlp) return *m_rlp; RLPStream s; streamRLP(s, _sig); return s.out(); }
 
 	/// @returns the SHA3 hash of the RLP serialisation of this transaction.
 	h256 sha3(IncludeSignature _sig = WithSignature) const;
@@ -128,7 +130,8 @@ public:
 	Address from() const { return safeSender(); }
 
 	/// @returns the data associated with this (message-call) transaction. Synonym for initCode().
-	bytes const& data() const { return m_data; }
+	/// Valid as long as this transaction is neither changed nor destroyed.
+	bytesConstRef data() const { return m_rlp ? bytesConstRef(m_rlp.get()).cropped(m_dataOffset, m_dataSize) : bytesConstRef(&m_data); }
 
 	/// @returns the transaction-count of the sender.
 	u256 nonce() const { return m_nonce; }
@@ -137,7 +140,7 @@ public:
 	void setNonce(u256 const& _n) { clearSignature(); m_nonce = _n; }
 
 	/// Clears the signature.
-	void clearSignature() { m_vrs = SignatureStruct(); }
+	void clearSignature() { m_vrs = SignatureStruct(); noteSignatureChanged(); }
 
 	/// @returns the signature of the transaction. Encodes the sender.
 	SignatureStruct const& signature() const { return m_vrs; }
@@ -145,12 +148,15 @@ public:
 	void sign(Secret const& _priv);			///< Sign the transaction.
 
 	/// @returns amount of gas required for the basic payment.
-	int64_t baseGasRequired(EVMSchedule const& _es) const { return baseGasRequired(isCreation(), &m_data, _es); }
+	int64_t baseGasRequired(EVMSchedule const& _es) const { return baseGasRequired(isCreation(), data(), _es); }
 
 	/// Get the fee associated for a transaction with the given data.
 	static int64_t baseGasRequired(bool _contractCreation, bytesConstRef _data, EVMSchedule const& _es);
 
 protected:
+	/// Drops the original encoding and the hash memo, which no longer reflect a changed signature.
+	void noteSignatureChanged();
+
 	/// Type of transaction.
 	enum Type
 	{
@@ -165,10 +171,13 @@ protected:
 	Address m_receiveAddress;			///< The receiving address of the transaction.
 	u256 m_gasPrice;					///< The base fee and thus the implied exchange rate of ETH to GAS.
 	u256 m_gas;							///< The total gas to convert, paid for from sender's account. Any unused gas gets refunded once the contract is ended.
-	bytes m_data;						///< The data associated with the transaction, or the initialiser if it's a creation transaction.
+	bytes m_data;						///< The data associated with the transaction, or the initialiser if it's a creation transaction. Empty while m_rlp holds it.
 	SignatureStruct m_vrs;				///< The signature of the transaction. Encodes the sender.
 	int m_chainId = -4;					///< EIP155 value for calculating transaction hash https://github.com/ethereum/EIPs/issues/155
 
+	std::shared_ptr<bytes const> m_rlp;	///< Original signed RLP encoding, shared between copies; null unless decoded from RLP.
+	size_t m_dataOffset = 0;			///< Where the data starts within m_rlp.
+	size_t m_dataSize = 0;				///< The size of the data within m_rlp.
 	mutable h256 m_hashWith;			///< Cached hash of transaction with signature.
 	mutable Address m_sender;			///< Cached sender, determined from signature.
 };
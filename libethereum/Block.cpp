@@ -298,6 +298,47 @@ bool Block::sync(BlockChain const& _bc, h256 const& _block, BlockHeader const& _
 	return ret;
 }
 
+namespace
+{
+
+Mutex x_transactionSyncStats;
+TransactionSyncStats s_transactionSyncStats;
+
+}
+
+TransactionSyncStats& TransactionSyncStats::operator+=(TransactionSyncStats const& _s)
+{
+	syncs += _s.syncs;
+	passes += _s.passes;
+	considered += _s.considered;
+	executed += _s.executed;
+	nonceBlocked += _s.nonceBlocked;
+	outOfGas += _s.outOfGas;
+	underpriced += _s.underpriced;
+	dropped += _s.dropped;
+	return *this;
+}
+
+TransactionSyncStats TransactionSyncStats::operator-(TransactionSyncStats const& _s) const
+{
+	TransactionSyncStats ret;
+	ret.syncs = syncs - _s.syncs;
+	ret.passes = passes - _s.passes;
+	ret.considered = considered - _s.considered;
+	ret.executed = executed - _s.executed;
+	ret.nonceBlocked = nonceBlocked - _s.nonceBlocked;
+	ret.outOfGas = outOfGas - _s.outOfGas;
+	ret.underpriced = underpriced - _s.underpriced;
+	ret.dropped = dropped - _s.dropped;
+	return ret;
+}
+
+TransactionSyncStats Block::transactionSyncStats()
+{
+	Guard l(x_transactionSyncStats);
+	return s_transactionSyncStats;
+}
+
 pair<TransactionReceipts, bool> Block::sync(BlockChain const& _bc, TransactionQueue& _tq, GasPricer const& _gp, unsigned msTimeout)
 {
 	if (isSealed())
@@ -307,94 +348,164 @@ pair<TransactionReceipts, bool> Block::sync(BlockChain const& _bc, TransactionQu
 
 	// TRANSACTIONS
 	pair<TransactionReceipts, bool> ret;
+	TransactionSyncStats stats;
+	stats.syncs = 1;
 
 	auto ts = _tq.topTransactions(c_maxSyncTransactions, m_transactionSet);
 	ret.second = (ts.size() == c_maxSyncTransactions);	// say there's more to the caller if we hit the limit
 
 	LastHashes lh;
+	u256 const ask = _gp.ask(*this);
 
 	auto deadline =  chrono::steady_clock::now() + chrono::milliseconds(msTimeout);
 
-	for (int goodTxs = max(0, (int)ts.size() - 1); goodTxs < (int)ts.size(); )
+	// Next nonce of each sender seen so far; lets us skip nonce gaps without executing anything.
+	unordered_map<Address, u256> nextNonce;
+	auto nonceOf = [&](Address const& _a) -> u256&
 	{
-		goodTxs = 0;
-		for (auto const& t: ts)
-			if (!m_transactionSet.count(t.sha3()))
+		auto it = nextNonce.find(_a);
+		if (it == nextNonce.end())
+			it = nextNonce.insert(make_pair(_a, transactionsFrom(_a))).first;
+		return it->second;
+	};
+
+	vector<Transaction const*> todo;
+	for (auto const& t: ts)
+		todo.push_back(&t);
+
+	while (!todo.empty())
+	{
+		++stats.passes;
+		// Transactions with a nonce gap; executing an earlier one from the same sender may close it.
+		vector<Transaction const*> blocked;
+		unsigned executed = 0;
+		for (Transaction const* tp: todo)
+		{
+			Transaction const& t = *tp;
+			++stats.considered;
+			try
 			{
-				try
+				if (t.gasPrice() < ask)
 				{
-					if (t.gasPrice() >= _gp.ask(*this))
-					{
-//						Timer t;
-						if (lh.empty())
-							lh = _bc.lastHashes();
-						execute(lh, t);
-						ret.first.push_back(m_receipts.back());
-						++goodTxs;
-//						cnote << "TX took:" << t.elapsed() * 1000;
-					}
-					else if (t.gasPrice() < _gp.ask(*this) * 9 / 10)
+					if (t.gasPrice() < ask * 9 / 10)
 					{
 						clog(StateTrace) << t.sha3() << "Dropping El Cheapo transaction (<90% of ask price)";
 						_tq.drop(t.sha3());
-					}
-				}
-				catch (InvalidNonce const& in)
-				{
-					bigint const& req = *boost::get_error_info<errinfo_required>(in);
-					bigint const& got = *boost::get_error_info<errinfo_got>(in);
-
-					if (req > got)
-					{
-						// too old
-						clog(StateTrace) << t.sha3() << "Dropping old transaction (nonce too low)";
-						_tq.drop(t.sha3());
-					}
-					else if (got > req + _tq.waiting(t.sender()))
-					{
-						// too new
-						clog(StateTrace) << t.sha3() << "Dropping new transaction (too many nonces ahead)";
-						_tq.drop(t.sha3());
+						++stats.dropped;
 					}
 					else
-						_tq.setFuture(t.sha3());
+						++stats.underpriced;
+					continue;
 				}
-				catch (BlockGasLimitReached const& e)
+
+				if (t.gas() > gasLimitRemaining())
 				{
-					bigint const& got = *boost::get_error_info<errinfo_got>(e);
-					if (got > m_currentBlock.gasLimit())
+					if (t.gas() > m_currentBlock.gasLimit())
 					{
 						clog(StateTrace) << t.sha3() << "Dropping over-gassy transaction (gas > block's gas limit)";
 						_tq.drop(t.sha3());
+						++stats.dropped;
 					}
 					else
-					{
-						clog(StateTrace) << t.sha3() << "Temporarily no gas left in current block (txs gas > block's gas limit)";
-						//_tq.drop(t.sha3());
 						// Temporarily no gas left in current block.
-						// OPTIMISE: could note this and then we don't evaluate until a block that does have the gas left.
-						// for now, just leave alone.
-					}
+						++stats.outOfGas;
+					continue;
+				}
+
+				u256& nonce = nonceOf(t.sender());
+				if (t.nonce() > nonce)
+				{
+					blocked.push_back(tp);
+					++stats.nonceBlocked;
+					continue;
+				}
+				if (t.nonce() < nonce)
+				{
+					clog(StateTrace) << t.sha3() << "Dropping old transaction (nonce too low)";
+					_tq.drop(t.sha3());
+					++stats.dropped;
+					continue;
 				}
-				catch (Exception const& _e)
+
+				if (lh.empty())
+					lh = _bc.lastHashes();
+				execute(lh, t);
+				ret.first.push_back(m_receipts.back());
+				++nonce;
+				++executed;
+				++stats.executed;
+			}
+			catch (InvalidNonce const& in)
+			{
+				bigint const& req = *boost::get_error_info<errinfo_required>(in);
+				bigint const& got = *boost::get_error_info<errinfo_got>(in);
+
+				if (req > got)
 				{
-					// Something else went wrong - drop it.
-					clog(StateTrace) << t.sha3() << "Dropping invalid transaction:" << diagnostic_information(_e);
+					// too old
+					clog(StateTrace) << t.sha3() << "Dropping old transaction (nonce too low)";
 					_tq.drop(t.sha3());
+					++stats.dropped;
 				}
-				catch (std::exception const&)
+				else if (got > req + _tq.waiting(t.sender()))
 				{
-					// Something else went wrong - drop it.
+					// too new
+					clog(StateTrace) << t.sha3() << "Dropping new transaction (too many nonces ahead)";
 					_tq.drop(t.sha3());
-					cwarn << t.sha3() << "Transaction caused low-level exception :(";
+					++stats.dropped;
 				}
+				else
+					_tq.setFuture(t.sha3());
+			}
+			catch (BlockGasLimitReached const&)
+			{
+				// Checked above; only here should the gas accounting ever disagree.
+				clog(StateTrace) << t.sha3() << "Temporarily no gas left in current block (txs gas > block's gas limit)";
+				++stats.outOfGas;
+			}
+			catch (Exception const& _e)
+			{
+				// Something else went wrong - drop it.
+				clog(StateTrace) << t.sha3() << "Dropping invalid transaction:" << diagnostic_information(_e);
+				_tq.drop(t.sha3());
+				++stats.dropped;
+			}
+			catch (std::exception const&)
+			{
+				// Something else went wrong - drop it.
+				_tq.drop(t.sha3());
+				++stats.dropped;
+				cwarn << t.sha3() << "Transaction caused low-level exception :(";
 			}
+		}
+
 		if (chrono::steady_clock::now() > deadline)
 		{
 			ret.second = true;	// say there's more to the caller if we ended up crossing the deadline.
 			break;
 		}
+		if (!executed)
+		{
+			// No progress, so nothing in the queue fills these gaps for now.
+			for (Transaction const* tp: blocked)
+			{
+				Transaction const& t = *tp;
+				if (t.nonce() > nonceOf(t.sender()) + _tq.waiting(t.sender()))
+				{
+					clog(StateTrace) << t.sha3() << "Dropping new transaction (too many nonces ahead)";
+					_tq.drop(t.sha3());
+					++stats.dropped;
+				}
+				else
+					_tq.setFuture(t.sha3());
+			}
+			break;
+		}
+		todo.swap(blocked);
 	}
+
+	DEV_GUARDED(x_transactionSyncStats)
+		s_transactionSyncStats += stats;
 	return ret;
 }
 
@@ -731,24 +842,23 @@ void Block::commitToSeal(BlockChain const& _bc, bytes const& _extraData)
 		}
 	}
 
-	BytesMap transactionsMap;
-	BytesMap receiptsMap;
+	vector<bytes> transactions;
+	vector<bytes> receipts;
+	transactions.reserve(m_transactions.size());
+	receipts.reserve(m_transactions.size());
 
 	RLPStream txs;
 	txs.appendList(m_transactions.size());
 
 	for (unsigned i = 0; i < m_transactions.size(); ++i)
 	{
-		RLPStream k;
-		k << i;
-
 		RLPStream receiptrlp;
 		m_receipts[i].streamRLP(receiptrlp);
-		receiptsMap.insert(std::make_pair(k.out(), receiptrlp.out()));
+		receipts.push_back(receiptrlp.out());
 
 		RLPStream txrlp;
 		m_transactions[i].streamRLP(txrlp);
-		transactionsMap.insert(std::make_pair(k.out(), txrlp.out()));
+		transactions.push_back(txrlp.out());
 
 		txs.appendRaw(txrlp.out());
 
@@ -778,7 +888,7 @@ void Block::commitToSeal(BlockChain const& _bc, bytes const& _extraData)
 
 	m_currentBlock.setLogBloom(logBloom());
 	m_currentBlock.setGasUsed(gasUsed());
-	m_currentBlock.setRoots(hash256(transactionsMap), hash256(receiptsMap), sha3(m_currentUncles), m_state.rootHash());
+	m_currentBlock.setRoots(orderedTrieRoot(transactions), orderedTrieRoot(receipts), sha3(m_currentUncles), m_state.rootHash());
 
 	m_currentBlock.setParentHash(m_previousBlock.hash());
 	m_currentBlock.setExtraData(_extraData);
@@ -62,6 +62,22 @@ struct PopulationStatistics
 	double enact;
 };
 
+/// What Block::sync(BlockChain const&, TransactionQueue&, ...) did with the queued transactions it looked at.
+struct TransactionSyncStats
+{
+	uint64_t syncs = 0;				///< Calls to sync().
+	uint64_t passes = 0;			///< Passes over the candidate transactions.
+	uint64_t considered = 0;		///< Candidates looked at, summed over passes.
+	uint64_t executed = 0;			///< Transactions added to the block.
+	uint64_t nonceBlocked = 0;		///< Skipped without execution: the sender has a nonce gap.
+	uint64_t outOfGas = 0;			///< Skipped without execution: the block has no gas left for them.
+	uint64_t underpriced = 0;		///< Skipped without execution: gas price below the ask.
+	uint64_t dropped = 0;			///< Removed from the queue.
+
+	TransactionSyncStats& operator+=(TransactionSyncStats const& _s);
+	TransactionSyncStats operator-(TransactionSyncStats const& _s) const;
+};
+
 DEV_SIMPLE_EXCEPTION(ChainOperationWithUnknownBlockChain);
 DEV_SIMPLE_EXCEPTION(InvalidOperationOnSealedBlock);
 
@@ -169,8 +185,9 @@ public:
 	h256 rootHash() const { return m_state.rootHash(); }
 
 	/// @returns the set containing all addresses currently in use in Ethereum.
+	/// @param _readers threads reading the state trie ahead of the walk; see State::addresses().
 	/// @throws InterfaceNotSupported if compiled without ETH_FATDB.
-	std::unordered_map<Address, u256> addresses() const { return m_state.addresses(); }
+	std::unordered_map<Address, u256> addresses(unsigned _readers = 0) const { return m_state.addresses(_readers); }
 
 	// For altering accounts behind-the-scenes
 
@@ -217,9 +234,16 @@ public:
 	ExecutionResult execute(LastHashes const& _lh, Transaction const& _t, Permanence _p = Permanence::Committed, OnOpFunc const& _onOp = OnOpFunc());
 
 	/// Sync our transactions, killing those from the queue that we have and assimilating those that we don't.
+	/// Transactions that can be seen to fail from the sender's nonce, the gas left in the block or the asking
+	/// price are skipped without being executed; another pass is only made if the previous one made progress.
+	/// Nothing is remembered between calls: a doomed transaction is either dropped from @a _tq, which then
+	/// refuses it if it comes again, or set aside in its future queue until the sender's nonce gap closes.
 	/// @returns a list of receipts one for each transaction placed from the queue into the state and bool, true iff there are more transactions to be processed.
 	std::pair<TransactionReceipts, bool> sync(BlockChain const& _bc, TransactionQueue& _tq, GasPricer const& _gp, unsigned _msTimeout = 100);
 
+	/// @returns the totals of all transaction queue syncs in this process so far.
+	static TransactionSyncStats transactionSyncStats();
+
 	/// Sync our state with the block chain.
 	/// This basically involves wiping ourselves if we've been superceded and rebuilding from the transaction queue.
 	bool sync(BlockChain const& _bc);
@@ -33,6 +33,7 @@
 #include <libdevcore/RLP.h>
 #include <libdevcore/TrieHash.h>
 #include <libdevcore/FileSystem.h>
+#include <libdevcore/Metrics.h>
 #include <libethcore/Exceptions.h>
 #include <libethcore/BlockHeader.h>
 #include "GenesisInfo.h"
@@ -143,15 +144,28 @@ static const unsigned c_minCacheSize = 1024 * 1024 * 32;
 
 #endif
 
+/// Max number of decoded blocks kept for queries.
+static const unsigned c_maxDecodedBlocks = 256;
+
 BlockChain::BlockChain(ChainParams const& _p, std::string const& _dbPath, WithExisting _we, ProgressCallback const& _pc):
+	m_decodedBlocks(c_maxDecodedBlocks / DecodedBlocks::c_shards),
 	m_dbPath(_dbPath)
 {
 	init(_p);
 	open(_dbPath, _we, _pc);
+	m_memoryReport = MemoryAccounting::get().add("blockchain", [this]()
+	{
+		Statistics s = usage(true);
+		MemoryUsage ret;
+		ret.bytes = s.memTotal();
+		ret.items = s.items;
+		return ret;
+	}, [this]() { garbageCollect(true); });
 }
 
 BlockChain::~BlockChain()
 {
+	m_memoryReport.reset();
 	close();
 }
 
@@ -289,6 +303,7 @@ void BlockChain::close()
 	m_transactionAddresses.clear();
 	m_blockHashes.clear();
 	m_blocksBlooms.clear();
+	noteDecodedBlocksChanged();
 	m_cacheUsage.clear();
 	m_inUse.clear();
 	m_lastLastHashes.clear();
@@ -332,6 +347,7 @@ void BlockChain::rebuild(std::string const& _path, std::function<void(unsigned,
 	m_transactionAddresses.clear();
 	m_blockHashes.clear();
 	m_blocksBlooms.clear();
+	noteDecodedBlocksChanged();
 	m_lastLastHashes.clear();
 	m_lastBlockHash = genesisHash();
 	m_lastBlockNumber = 0;
@@ -616,6 +632,7 @@ void BlockChain::insert(VerifiedBlockRef _block, bytesConstRef _receipts, bool _
 		if (!dev::contains(m_details[_block.info.parentHash()].children, _block.info.hash()))
 			m_details[_block.info.parentHash()].children.push_back(_block.info.hash());
 	}
+	noteDecodedBlocksChanged(_block.info.parentHash());
 
 	blocksBatch.Put(toSlice(_block.info.hash()), ldb::Slice(_block.block));
 	DEV_READ_GUARDED(x_details)
@@ -647,9 +664,45 @@ void BlockChain::insert(VerifiedBlockRef _block, bytesConstRef _receipts, bool _
 	}
 }
 
+void BlockChain::insertWithoutParent(bytes const& _block, u256 const& _totalDifficulty)
+{
+	BlockHeader header(&_block);
+	h256 hash = header.hash();
+	unsigned number = (unsigned)header.number();
+
+	ldb::WriteBatch blocksBatch;
+	ldb::WriteBatch extrasBatch;
+	blocksBatch.Put(toSlice(hash), ldb::Slice((char const*)_block.data(), _block.size()));
+	extrasBatch.Put(toSlice(hash, ExtraDetails), (ldb::Slice)dev::ref(BlockDetails(number, _totalDifficulty, header.parentHash(), {}).rlp()));
+	extrasBatch.Put(toSlice(h256(number), ExtraBlockHash), (ldb::Slice)dev::ref(BlockHash(hash).rlp()));
+
+	ldb::Status o = m_blocksDB->Write(m_writeOptions, &blocksBatch);
+	if (!o.ok())
+	{
+		cwarn << "Error writing to blockchain database: " << o.ToString();
+		cwarn << "Fail writing to blockchain database. Bombing out.";
+		exit(-1);
+	}
+	o = m_extrasDB->Write(m_writeOptions, &extrasBatch);
+	if (!o.ok())
+	{
+		cwarn << "Error writing to extras database: " << o.ToString();
+		cwarn << "Fail writing to extras database. Bombing out.";
+		exit(-1);
+	}
+
+	DEV_WRITE_GUARDED(x_lastBlockHash)
+	{
+		m_lastBlockHash = hash;
+		m_lastBlockNumber = number;
+		m_extrasDB->Put(m_writeOptions, ldb::Slice("best"), ldb::Slice((char const*)&m_lastBlockHash, 32));
+	}
+}
+
 ImportRoute BlockChain::import(VerifiedBlockRef const& _block, OverlayDB const& _db, bool _mustBeNew)
 {
 	//@tidy This is a behemoth of a method - could do to be split into a few smaller ones.
+	DEV_METERED_SCOPE("blockchain.import");
 
 #if ETH_TIMED_IMPORTS
 	Timer total;
@@ -699,7 +752,8 @@ ImportRoute BlockChain::import(VerifiedBlockRef const& _block, OverlayDB const&
 	}
 
 	// Verify parent-critical parts
-	verifyBlock(_block.block, m_onBad, ImportRequirements::InOrderChecks);
+	DEV_METERED("blockchain.import.verify")
+		verifyBlock(_block.block, m_onBad, ImportRequirements::InOrderChecks);
 
 	clog(BlockChainChat) << "Attempting import of " << _block.info.hash() << "...";
 
@@ -725,7 +779,9 @@ ImportRoute BlockChain::import(VerifiedBlockRef const& _block, OverlayDB const&
 		// Check transactions are valid and that they result in a state equivalent to our state_root.
 		// Get total difficulty increase and update state, checking it.
 		Block s(*this, _db);
-		auto tdIncrease = s.enactOn(_block, *this);
+		u256 tdIncrease;
+		DEV_METERED("blockchain.import.enact")
+			tdIncrease = s.enactOn(_block, *this);
 
 		for (unsigned i = 0; i < s.pending().size(); ++i)
 		{
@@ -734,7 +790,8 @@ ImportRoute BlockChain::import(VerifiedBlockRef const& _block, OverlayDB const&
 			goodTransactions.push_back(s.pending()[i]);
 		}
 
-		s.cleanup(true);
+		DEV_METERED("blockchain.import.commit")
+			s.cleanup(true);
 
 		td = pd.totalDifficulty + tdIncrease;
 
@@ -757,6 +814,7 @@ ImportRoute BlockChain::import(VerifiedBlockRef const& _block, OverlayDB const&
 		details(_block.info.parentHash());
 		DEV_WRITE_GUARDED(x_details)
 			m_details[_block.info.parentHash()].children.push_back(_block.info.hash());
+		noteDecodedBlocksChanged(_block.info.parentHash());
 
 #if ETH_TIMED_IMPORTS
 		collation = t.elapsed();
@@ -876,7 +934,9 @@ ImportRoute BlockChain::import(VerifiedBlockRef const& _block, OverlayDB const&
 		clog(BlockChainChat) << "   Imported but not best (oTD:" << details(last).totalDifficulty << " > TD:" << td << "; " << details(last).number << ".." << _block.info.number() << ")";
 	}
 
-	ldb::Status o = m_blocksDB->Write(m_writeOptions, &blocksBatch);
+	ldb::Status o;
+	DEV_METERED("blockchain.import.writeBlocks")
+		o = m_blocksDB->Write(m_writeOptions, &blocksBatch);
 	if (!o.ok())
 	{
 		cwarn << "Error writing to blockchain database: " << o.ToString();
@@ -886,7 +946,8 @@ ImportRoute BlockChain::import(VerifiedBlockRef const& _block, OverlayDB const&
 		exit(-1);
 	}
 	
-	o = m_extrasDB->Write(m_writeOptions, &extrasBatch);
+	DEV_METERED("blockchain.import.writeExtras")
+		o = m_extrasDB->Write(m_writeOptions, &extrasBatch);
 	if (!o.ok())
 	{
 		cwarn << "Error writing to extras database: " << o.ToString();
@@ -895,6 +956,8 @@ ImportRoute BlockChain::import(VerifiedBlockRef const& _block, OverlayDB const&
 		cwarn << "Fail writing to extras database. Bombing out.";
 		exit(-1);
 	}
+	DEV_COUNT("blockchain.import.blocks", 1);
+	DEV_COUNT("blockchain.import.transactions", goodTransactions.size());
 
 #if ETH_PARANOIA
 	if (isKnown(_block.info.hash()) && !details(_block.info.hash()))
@@ -1163,24 +1226,53 @@ template <class K, class T> static unsigned getHashSize(unordered_map<K, T> cons
 void BlockChain::updateStats() const
 {
 	m_lastStats.memBlocks = 0;
+	m_lastStats.items = 0;
 	DEV_READ_GUARDED(x_blocks)
+	{
 		for (auto const& i: m_blocks)
 			m_lastStats.memBlocks += i.second.size() + 64;
+		m_lastStats.items += m_blocks.size();
+	}
 	DEV_READ_GUARDED(x_details)
+	{
 		m_lastStats.memDetails = getHashSize(m_details);
+		m_lastStats.items += m_details.size();
+	}
 	DEV_READ_GUARDED(x_logBlooms)
 		DEV_READ_GUARDED(x_blocksBlooms)
+		{
 			m_lastStats.memLogBlooms = getHashSize(m_logBlooms) + getHashSize(m_blocksBlooms);
+			m_lastStats.items += m_logBlooms.size() + m_blocksBlooms.size();
+		}
 	DEV_READ_GUARDED(x_receipts)
+	{
 		m_lastStats.memReceipts = getHashSize(m_receipts);
+		m_lastStats.items += m_receipts.size();
+	}
 	DEV_READ_GUARDED(x_blockHashes)
+	{
 		m_lastStats.memBlockHashes = getHashSize(m_blockHashes);
+		m_lastStats.items += m_blockHashes.size();
+	}
 	DEV_READ_GUARDED(x_transactionAddresses)
+	{
 		m_lastStats.memTransactionAddresses = getHashSize(m_transactionAddresses);
+		m_lastStats.items += m_transactionAddresses.size();
+	}
+	m_lastStats.memDecodedBlocks = 0;
+	m_decodedBlocks.forEach([&](h256 const&, pair<DecodedBlockPtr, unsigned> const& _d)
+	{
+		m_lastStats.memDecodedBlocks += _d.second + 64;
+		++m_lastStats.items;
+	});
 }
 
 void BlockChain::garbageCollect(bool _force)
 {
+	// Decoded blocks are cheap to rebuild from the block cache; drop them all when forced.
+	if (_force)
+		noteDecodedBlocksChanged();
+
 	updateStats();
 
 	if (!_force && chrono::system_clock::now() < m_lastCollection + c_collectionDuration && m_lastStats.memTotal() < c_maxCacheSize)
@@ -1259,6 +1351,7 @@ void BlockChain::clearCachesDuringChainReversion(unsigned _firstInvalid)
 			m_blockHashes.erase(i);
 	DEV_WRITE_GUARDED(x_transactionAddresses)
 		m_transactionAddresses.clear();	// TODO: could perhaps delete them individually?
+	noteDecodedBlocksChanged();
 
 	// If we are reverting previous blocks, we need to clear their blooms (in particular, to
 	// rebuild any higher level blooms that they contributed to).
@@ -1406,6 +1499,63 @@ bytes BlockChain::block(h256 const& _hash) const
 	return m_blocks[_hash];
 }
 
+void BlockChain::noteDecodedBlocksChanged(h256 const& _hash) const
+{
+	// Bumped first: a decode that started earlier then either finds its entry already dropped or drops it itself.
+	++m_decodedBlocksEpoch;
+	if (_hash)
+		m_decodedBlocks.erase(_hash);
+	else
+		m_decodedBlocks.clear();
+}
+
+Transactions const& DecodedBlock::withSenders() const
+{
+	for (unsigned i = 0; i < transactions.size(); ++i)
+		withSender(i);
+	return transactions;
+}
+
+Transaction const& DecodedBlock::withSender(unsigned _i) const
+{
+	Transaction const& t = transactions[_i];
+	call_once(sendersRecovered[_i], [&]() { t.safeSender(); });
+	return t;
+}
+
+DecodedBlockPtr BlockChain::decodedBlock(h256 const& _hash) const
+{
+	pair<DecodedBlockPtr, unsigned> cached;
+	if (m_decodedBlocks.lookup(_hash, cached))
+		return cached.first;
+	unsigned const epoch = m_decodedBlocksEpoch;
+
+	bytes b = block(_hash);
+	if (b.empty())
+		return DecodedBlockPtr();
+
+	auto ret = make_shared<DecodedBlock>();
+	RLP r(b);
+	ret->header = BlockHeader(b);
+	ret->details = details(_hash);
+	for (auto const& u: r[2])
+		ret->uncleHashes.push_back(sha3(u.data()));
+	ret->transactions.reserve(r[1].itemCount());
+	ret->transactionHashes.reserve(r[1].itemCount());
+	for (auto const& tr: r[1])
+	{
+		ret->transactions.emplace_back(tr.data(), CheckTransaction::Cheap);
+		ret->transactionHashes.push_back(ret->transactions.back().sha3());
+	}
+	ret->sendersRecovered.reset(new once_flag[ret->transactions.size()]);
+
+	unsigned size = b.size() + ret->transactions.size() * (sizeof(Transaction) + sizeof(once_flag) + 32) + ret->uncleHashes.size() * 32;
+	m_decodedBlocks.insert(_hash, make_pair(ret, size));
+	if (epoch != m_decodedBlocksEpoch)
+		m_decodedBlocks.erase(_hash);
+	return ret;
+}
+
 bytes BlockChain::headerData(h256 const& _hash) const
 {
 	if (_hash == m_genesisHash)
@@ -1443,12 +1593,29 @@ Block BlockChain::genesisBlock(OverlayDB const& _db) const
 	if (!_db.exists(r))
 	{
 		ret.noteChain(*this);
-		dev::eth::commit(m_params.genesisState, ret.mutableState().m_state);		// bit horrible. maybe consider a better way of constructing it?
-		ret.mutableState().db().commit();											// have to use this db() since it's the one that has been altered with the above commit.
-		if (ret.mutableState().rootHash() != r)
+		h256 computed;
+		if (m_params.genesisStateNodes)
+		{
+			// Ready-made trie: bulk insert the nodes. They are keyed by their hashes, so finding the
+			// expected root among them verifies it.
+			for (auto const& n: *m_params.genesisStateNodes)
+				ret.mutableState().db().insert(sha3(n), &n);
+			if (m_params.genesisStateAux)
+				for (auto const& a: *m_params.genesisStateAux)
+					ret.mutableState().db().insertAux(sha3(a), &a);
+			computed = ret.mutableState().db().exists(r) ? r : h256();
+			ret.mutableState().db().commit();
+		}
+		else
+		{
+			dev::eth::commit(m_params.genesisState, ret.mutableState().m_state);		// bit horrible. maybe consider a better way of constructing it?
+			ret.mutableState().db().commit();											// have to use this db() since it's the one that has been altered with the above commit.
+			computed = ret.mutableState().rootHash();
+		}
+		if (computed != r)
 		{
 			cwarn << "Hinted genesis block's state root hash is incorrect!";
-			cwarn << "Hinted" << r << ", computed" << ret.mutableState().rootHash();
+			cwarn << "Hinted" << r << ", computed" << computed;
 			// TODO: maybe try to fix it by altering the m_params's genesis block?
 			exit(-1);
 		}
@@ -1460,7 +1627,11 @@ Block BlockChain::genesisBlock(OverlayDB const& _db) const
 
 VerifiedBlockRef BlockChain::verifyBlock(bytesConstRef _block, std::function<void(Exception&)> const& _onBad, ImportRequirements::value _ir) const
 {
-	VerifiedBlockRef res;
+	return verifyBlockBody(_block, verifyBlockHeader(_block, _onBad, _ir), _onBad, _ir);
+}
+
+BlockHeader BlockChain::verifyBlockHeader(bytesConstRef _block, std::function<void(Exception&)> const& _onBad, ImportRequirements::value _ir) const
+{
 	BlockHeader h;
 	try
 	{
@@ -1477,7 +1648,6 @@ VerifiedBlockRef BlockChain::verifyBlock(bytesConstRef _block, std::function<voi
 			parent = BlockHeader(parentHeader, HeaderData, h.parentHash());
 		}
 		sealEngine()->verify((_ir & ImportRequirements::ValidSeal) ? Strictness::CheckEverything : Strictness::QuickNonce, h, parent, _block);
-		res.info = h;
 	}
 	catch (Exception& ex)
 	{
@@ -1492,6 +1662,14 @@ VerifiedBlockRef BlockChain::verifyBlock(bytesConstRef _block, std::function<voi
 			_onBad(ex);
 		throw;
 	}
+	return h;
+}
+
+VerifiedBlockRef BlockChain::verifyBlockBody(bytesConstRef _block, BlockHeader const& _header, std::function<void(Exception&)> const& _onBad, ImportRequirements::value _ir) const
+{
+	VerifiedBlockRef res;
+	BlockHeader const& h = _header;
+	res.info = h;
 
 	RLP r(_block);
 	unsigned i = 0;
@@ -29,6 +29,8 @@
 #include <libdevcore/Log.h>
 #include <libdevcore/Exceptions.h>
 #include <libdevcore/Guards.h>
+#include <libdevcore/MemoryAccounting.h>
+#include <libdevcore/ShardedCache.h>
 #include <libethcore/Common.h>
 #include <libethcore/BlockHeader.h>
 #include <libethcore/SealEngine.h>
@@ -81,6 +83,27 @@ using BlocksHash = std::unordered_map<h256, bytes>;
 using TransactionHashes = h256s;
 using UncleHashes = h256s;
 
+/// A block decoded once for the query interface: header, details, uncle hashes and the transactions,
+/// whose hashes are already computed.
+struct DecodedBlock
+{
+	BlockHeader header;
+	BlockDetails details;
+	UncleHashes uncleHashes;
+	Transactions transactions;	///< Senders are recovered lazily; copy transactions only through withSender(s)().
+	TransactionHashes transactionHashes;
+
+	/// @returns the transactions, recovering all their senders on the first call.
+	/// Recovery writes the senders cached in the shared transactions, so any copy must be taken from
+	/// this result: one taken directly could race with another thread's recovery.
+	Transactions const& withSenders() const;
+	/// @returns transaction @a _i, recovering only its sender; the same rules as for withSenders() apply.
+	Transaction const& withSender(unsigned _i) const;
+
+	std::unique_ptr<std::once_flag[]> sendersRecovered;	///< One per transaction.
+};
+using DecodedBlockPtr = std::shared_ptr<DecodedBlock const>;
+
 enum {
 	ExtraDetails = 0,
 	ExtraBlockHash,
@@ -137,6 +160,11 @@ public:
 	void insert(bytes const& _block, bytesConstRef _receipts, bool _mustBeNew = true);
 	void insert(VerifiedBlockRef _block, bytesConstRef _receipts, bool _mustBeNew = true);
 
+	/// Adds a trusted block, whose parent needn't be known, with the given total difficulty and makes it the best.
+	/// Nothing is verified and no receipts are kept: this is for seeding a chain with the recent history it needs,
+	/// e.g. to replay blocks on top of it.
+	void insertWithoutParent(bytes const& _block, u256 const& _totalDifficulty);
+
 	/// Returns true if the given block is known (though not necessarily a part of the canon chain).
 	bool isKnown(h256 const& _hash, bool _isCurrent = true) const;
 
@@ -178,6 +206,10 @@ public:
 	/// Get a list of uncle hashes for a given block. Thread-safe.
 	UncleHashes uncleHashes(h256 const& _hash) const { auto b = block(_hash); RLP rlp(b); h256s ret; for (auto t: rlp[2]) ret.push_back(sha3(t.data())); return ret; }
 	UncleHashes uncleHashes() const { return uncleHashes(currentHash()); }
+
+	/// Get the block @a _hash fully decoded, decoding it only if it is not already cached. Thread-safe.
+	/// @returns null if the block is not known.
+	DecodedBlockPtr decodedBlock(h256 const& _hash) const;
 	
 	/// Get the hash for a given block's number.
 	h256 numberHash(unsigned _i) const { if (!_i) return genesisHash(); return queryExtras<BlockHash, uint64_t, ExtraBlockHash>(_i, m_blockHashes, x_blockHashes, NullBlockHash).value; }
@@ -280,7 +312,9 @@ public:
 		unsigned memReceipts;
 		unsigned memTransactionAddresses;
 		unsigned memBlockHashes;
-		unsigned memTotal() const { return memBlocks + memDetails + memLogBlooms + memReceipts + memTransactionAddresses + memBlockHashes; }
+		unsigned memDecodedBlocks;
+		unsigned items;			///< Entries across all of the caches.
+		unsigned memTotal() const { return memBlocks + memDetails + memLogBlooms + memReceipts + memTransactionAddresses + memBlockHashes + memDecodedBlocks; }
 	};
 
 	/// @returns statistics about memory usage.
@@ -300,6 +334,10 @@ public:
 
 	/// Verify block and prepare it for enactment
 	VerifiedBlockRef verifyBlock(bytesConstRef _block, std::function<void(Exception&)> const& _onBad, ImportRequirements::value _ir = ImportRequirements::OutOfOrderChecks) const;
+	/// Header stage of verifyBlock(): decodes the header and checks it (including the seal) against its parent.
+	BlockHeader verifyBlockHeader(bytesConstRef _block, std::function<void(Exception&)> const& _onBad, ImportRequirements::value _ir = ImportRequirements::OutOfOrderChecks) const;
+	/// Body stage of verifyBlock(): checks the uncles and transactions of @a _block, whose header @a _header has passed verifyBlockHeader().
+	VerifiedBlockRef verifyBlockBody(bytesConstRef _block, BlockHeader const& _header, std::function<void(Exception&)> const& _onBad, ImportRequirements::value _ir = ImportRequirements::OutOfOrderChecks) const;
 
 	/// Gives a dump of the blockchain database. For debug/test use only.
 	std::string dumpDatabase() const;
@@ -370,6 +408,10 @@ private:
 	mutable BlockHashHash m_blockHashes;
 	mutable SharedMutex x_blocksBlooms;
 	mutable BlocksBloomsHash m_blocksBlooms;
+	using DecodedBlocks = ShardedCache<h256, std::pair<DecodedBlockPtr, unsigned>>;
+	mutable DecodedBlocks m_decodedBlocks;	///< Decoded blocks with their encoded size.
+	mutable std::atomic<unsigned> m_decodedBlocksEpoch{0};	///< Bumped on every invalidation so a racing decode isn't cached.
+	void noteDecodedBlocksChanged(h256 const& _hash = h256()) const;
 
 	using CacheID = std::pair<h256, unsigned>;
 	mutable Mutex x_cacheUsage;
@@ -410,6 +452,8 @@ private:
 
 	std::string m_dbPath;
 
+	MemoryAccounting::Handle m_memoryReport;
+
 	friend std::ostream& operator<<(std::ostream& _out, BlockChain const& _bc);
 };
 
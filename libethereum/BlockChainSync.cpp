@@ -544,7 +544,11 @@ void BlockChainSync::onPeerBlockBodies(std::shared_ptr<EthereumPeer> _peer, RLP
 		RLP body(_r[i]);
 
 		auto txList = body[0];
-		h256 transactionRoot = trieRootOver(txList.itemCount(), [&](unsigned i){ return rlp(i); }, [&](unsigned i){ return txList[i].data().toBytes(); });
+		vector<bytesConstRef> txData;
+		txData.reserve(txList.itemCount());
+		for (auto const& tx: txList)
+			txData.push_back(tx.data());
+		h256 transactionRoot = orderedTrieRoot(txData);
 		h256 uncles = sha3(body[1].data());
 		HeaderId id { transactionRoot, uncles };
 		auto iter = m_headerIdToNumber.find(id);
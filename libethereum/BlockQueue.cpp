@@ -23,6 +23,7 @@
 #include <thread>
 #include <sstream>
 #include <libdevcore/Log.h>
+#include <libdevcore/Metrics.h>
 #include <libethcore/Exceptions.h>
 #include <libethcore/BlockHeader.h>
 #include "BlockChain.h"
@@ -53,6 +54,7 @@ BlockQueue::BlockQueue()
 			setThreadName("verifier" + toString(i));
 			this->verifierBody();
 		});
+	m_memoryReport = MemoryAccounting::get().add("blockqueue", [this]() { return memoryUsage(); }, [this]() { trim(); });
 }
 
 BlockQueue::~BlockQueue()
@@ -107,23 +109,55 @@ void BlockQueue::verifierBody()
 			m_verifying.enqueue(move(bi));
 		}
 
+		// Descendants of a bad block are bad; don't spend a seal check or a body check on them.
+		auto parentIsBad = [&]()
+		{
+			ReadGuard l(m_lock);
+			return m_knownBad.count(work.parentHash) > 0;
+		};
+		// @returns false if the block was no longer being verified.
+		auto discard = [&]()
+		{
+			// has to be this order as that's how invariants() assumes.
+			WriteGuard l2(m_lock);
+			unique_lock<Mutex> l(m_verification);
+			m_readySet.erase(work.hash);
+			m_knownBad.insert(work.hash);
+			bool ret = m_verifying.remove(work.hash);
+			drainVerified_WITH_BOTH_LOCKS();
+			return ret;
+		};
+		// An expected outcome rather than a verification failure, so it stays out of the warnings.
+		auto skipDescendant = [&]()
+		{
+			discard();
+			clog(BlockQueueChannel) << "Skipping" << work.hash << ": parent" << work.parentHash << "is bad";
+		};
+		if (parentIsBad())
+		{
+			skipDescendant();
+			continue;
+		}
+
 		VerifiedBlock res;
 		swap(work.blockData, res.blockData);
 		try
 		{
-			res.verified = m_bc->verifyBlock(&res.blockData, m_onBad, ImportRequirements::OutOfOrderChecks);
+			DEV_METERED_SCOPE("blockqueue.verify");
+			// Header and seal first: cheap to reject, and the parent may turn out bad meanwhile on another verifier.
+			BlockHeader header = m_bc->verifyBlockHeader(&res.blockData, m_onBad, ImportRequirements::OutOfOrderChecks);
+			if (parentIsBad())
+			{
+				skipDescendant();
+				continue;
+			}
+			res.verified = m_bc->verifyBlockBody(&res.blockData, header, m_onBad, ImportRequirements::OutOfOrderChecks);
 		}
 		catch (std::exception const& _ex)
 		{
 			// bad block.
-			// has to be this order as that's how invariants() assumes.
-			WriteGuard l2(m_lock);
-			unique_lock<Mutex> l(m_verification);
-			m_readySet.erase(work.hash);
-			m_knownBad.insert(work.hash);
-			if (!m_verifying.remove(work.hash))
+			if (!discard())
 				cwarn << "Unexpected exception when verifying block: " << _ex.what();
-			drainVerified_WITH_BOTH_LOCKS();
 			continue;
 		}
 
@@ -430,6 +464,36 @@ std::size_t BlockQueue::unknownCount() const
 	return m_future.count() + m_unknown.count();
 }
 
+MemoryUsage BlockQueue::memoryUsage() const
+{
+	// A block costs its RLP plus the decoded header and a few index entries.
+	static const uint64_t c_overhead = sizeof(VerifiedBlock) + 128;
+	MemoryUsage ret;
+	DEV_READ_GUARDED(m_lock)
+	{
+		ret.bytes = unknownSize() + unknownCount() * c_overhead + (m_readySet.size() + m_drainingSet.size() + m_unknownSet.size() + m_knownBad.size()) * 64;
+		ret.items = unknownCount() + m_knownBad.size();
+	}
+	DEV_GUARDED(m_verification)
+	{
+		ret.bytes += knownSize() + knownCount() * c_overhead;
+		ret.items += knownCount();
+	}
+	return ret;
+}
+
+void BlockQueue::trim()
+{
+	WriteGuard l(m_lock);
+	DEV_INVARIANT_CHECK;
+	while (!m_unknown.isEmpty())
+		for (auto const& b: m_unknown.removeByKeyEqual(m_unknown.firstKey()))
+		{
+			m_unknownSet.erase(b.first);
+			m_difficulty -= BlockHeader(b.second).difficulty();
+		}
+}
+
 void BlockQueue::drain(VerifiedBlocks& o_out, unsigned _max)
 {
 	bool wasFull = false;
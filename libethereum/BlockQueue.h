@@ -27,6 +27,7 @@
 #include <boost/thread.hpp>
 #include <libdevcore/Common.h>
 #include <libdevcore/Log.h>
+#include <libdevcore/MemoryAccounting.h>
 #include <libethcore/Common.h>
 #include <libdevcore/Guards.h>
 #include <libethcore/Common.h>
@@ -177,10 +178,11 @@ public:
 
 	void insert(KeyType const& _key, h256 const& _hash, bytes&& _blockData)
 	{
+		std::size_t size = _blockData.size();
 		auto hashAndBlock = std::make_pair(_hash, std::move(_blockData));
 		auto keyAndValue = std::make_pair(_key, std::move(hashAndBlock));
 		m_map.insert(std::move(keyAndValue));
-		m_size += _blockData.size();
+		m_size += size;
 	}
 
 	std::vector<std::pair<h256, bytes>> removeByKeyEqual(KeyType const& _key)
@@ -300,6 +302,12 @@ private:
 	std::size_t unknownSize() const;
 	std::size_t unknownCount() const;
 
+	/// Memory held by the queue, reported to MemoryAccounting.
+	MemoryUsage memoryUsage() const;
+	/// Drops the blocks with unknown parents, to make room when over the memory soft limit; they are sent again
+	/// once their ancestry turns up.
+	void trim();
+
 	BlockChain const* m_bc;												///< The blockchain into which our imports go.
 
 	mutable boost::shared_mutex m_lock;									///< General lock for the sets, m_future and m_unknown.
@@ -324,6 +332,8 @@ private:
 	std::function<void(Exception&)> m_onBad;							///< Called if we have a block that doesn't verify.
 	u256 m_difficulty;													///< Total difficulty of blocks in the queue
 	u256 m_drainingDifficulty;											///< Total difficulty of blocks in draining
+
+	MemoryAccounting::Handle m_memoryReport;
 };
 
 std::ostream& operator<<(std::ostream& _out, BlockQueueStatus const& _s);
@@ -0,0 +1,149 @@
+/*
+	This file is part of cpp-ethereum.
+
+	cpp-ethereum is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	cpp-ethereum is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with cpp-ethereum.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/** @file BlockSpeculator.cpp
+ * @date 2017
+ */
+
+#include "BlockSpeculator.h"
+#include "BlockChain.h"
+#include "GasPricer.h"
+#include "TransactionQueue.h"
+using namespace std;
+using namespace dev;
+using namespace dev::eth;
+
+BlockSpeculator::BlockSpeculator(BlockChain const& _bc, TransactionQueue& _tq, shared_ptr<GasPricer> const& _gp, function<void()> const& _onUpdated):
+	Worker("speculate", 0),
+	m_bc(_bc),
+	m_tq(_tq),
+	m_gp(_gp),
+	m_onUpdated(_onUpdated),
+	m_block(Block::Null)
+{
+}
+
+BlockSpeculator::~BlockSpeculator()
+{
+	stopWorking();
+}
+
+void BlockSpeculator::reset(Block const& _base)
+{
+	DEV_WRITE_GUARDED(x_block)
+	{
+		m_block = _base;
+		m_hasBase = true;
+		++m_generation;
+	}
+	noteTransactions();
+}
+
+void BlockSpeculator::noteTransactions()
+{
+	// Set under the lock, so that it can't land between doWork() finding nothing to do and waiting.
+	DEV_GUARDED(x_signalled)
+		m_dirty = true;
+	m_signalled.notify_all();
+}
+
+bool BlockSpeculator::extends(Block const& _ours, Block const& _theirs) const
+{
+	if (_ours.info().parentHash() != _theirs.info().parentHash() ||
+		_ours.info().timestamp() != _theirs.info().timestamp() ||
+		_ours.author() != _theirs.author())
+		return false;
+
+	Transactions const& ours = _ours.pending();
+	Transactions const& theirs = _theirs.pending();
+	if (ours.size() < theirs.size())
+		return false;
+	for (size_t i = 0; i < theirs.size(); ++i)
+		if (ours[i].sha3() != theirs[i].sha3())
+			return false;
+	return true;
+}
+
+bool BlockSpeculator::adopt(Block& io_block, TransactionReceipts& o_newReceipts)
+{
+	ReadGuard l(x_block);
+	if (!m_hasBase || io_block.isSealed() || m_block.pending().size() <= io_block.pending().size() || !extends(m_block, io_block))
+		return false;
+
+	for (size_t i = io_block.pending().size(); i < m_block.pending().size(); ++i)
+		o_newReceipts.push_back(m_block.receipt(i));
+	io_block = m_block;
+	++m_adopted;
+	return true;
+}
+
+bool BlockSpeculator::isBusyWith(Block const& _block) const
+{
+	if (!isWorking() || !(m_dirty || m_inPass))
+		return false;
+	ReadGuard l(x_block);
+	return m_hasBase && extends(m_block, _block);
+}
+
+void BlockSpeculator::doWork()
+{
+	{
+		std::unique_lock<std::mutex> l(x_signalled);
+		if (!m_signalled.wait_for(l, chrono::milliseconds(100), [&]() { return m_dirty.load() || shouldStop(); }) || !m_dirty)
+			return;
+		m_dirty = false;
+	}
+
+	m_inPass = true;
+	Block b(Block::Null);
+	unsigned generation;
+	DEV_READ_GUARDED(x_block)
+	{
+		if (!m_hasBase)
+		{
+			m_inPass = false;
+			return;
+		}
+		b = m_block;
+		generation = m_generation;
+	}
+
+	shared_ptr<GasPricer> gp;
+	DEV_GUARDED(x_gp)
+		gp = m_gp;
+
+	pair<TransactionReceipts, bool> r;
+	try
+	{
+		r = b.sync(m_bc, m_tq, *gp);
+	}
+	catch (Exception const& _e)
+	{
+		clog(StateTrace) << "Speculative execution failed:" << diagnostic_information(_e);
+	}
+
+	if (!r.first.empty())
+		DEV_WRITE_GUARDED(x_block)
+			if (generation == m_generation)
+				m_block = b;
+	if (r.second)
+		m_dirty = true;
+	m_inPass = false;
+
+	// Also after a pass that added nothing: the client may have deferred its own sync to us.
+	if (m_onUpdated)
+		m_onUpdated();
+}
@@ -0,0 +1,102 @@
+/*
+	This file is part of cpp-ethereum.
+
+	cpp-ethereum is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	cpp-ethereum is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with cpp-ethereum.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/** @file BlockSpeculator.h
+ * @date 2017
+ */
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <libdevcore/Guards.h>
+#include <libdevcore/Worker.h>
+#include "Block.h"
+
+namespace dev
+{
+namespace eth
+{
+
+class BlockChain;
+class TransactionQueue;
+class GasPricer;
+
+/**
+ * @brief Executes the top pending transactions ahead of the client's own sync.
+ * Builds a copy of the client's working block on its own thread, without holding the client's locks.
+ * Client::syncTransactionQueue() then adopts that copy if it is built on the same base as the working
+ * block and extends its transactions, instead of executing them again on the client thread.
+ * A new base (new head, new author, state reset) restarts speculation from scratch; transactions are
+ * only re-executed when their base changed.
+ */
+class BlockSpeculator: public Worker
+{
+public:
+	/// @param _onUpdated called on the speculator's thread after each pass over the transaction queue.
+	BlockSpeculator(BlockChain const& _bc, TransactionQueue& _tq, std::shared_ptr<GasPricer> const& _gp, std::function<void()> const& _onUpdated);
+	~BlockSpeculator();
+
+	void start() { startWorking(); }
+	void stop() { stopWorking(); }
+
+	/// Restarts speculation on top of @a _base, which must not be sealed.
+	void reset(Block const& _base);
+
+	/// Notes that the transaction queue has new transactions to execute.
+	void noteTransactions();
+
+	/// Prices the transactions of later passes with @a _gp.
+	void setGasPricer(std::shared_ptr<GasPricer> const& _gp) { DEV_GUARDED(x_gp) m_gp = _gp; }
+
+	/// Replaces @a io_block with the speculative block if it shares @a io_block's base and extends its transactions.
+	/// @returns false if nothing could be adopted; otherwise @a o_newReceipts holds the receipts of the added transactions.
+	bool adopt(Block& io_block, TransactionReceipts& o_newReceipts);
+
+	/// @returns true if a pass that would extend @a _block is under way or scheduled.
+	bool isBusyWith(Block const& _block) const;
+
+	unsigned adopted() const { return m_adopted; }
+
+private:
+	void doWork() override;
+
+	/// @returns true if @a _ours is built on the same base as @a _theirs and its transactions start with theirs.
+	bool extends(Block const& _ours, Block const& _theirs) const;
+
+	BlockChain const& m_bc;
+	TransactionQueue& m_tq;
+	mutable Mutex x_gp;
+	std::shared_ptr<GasPricer> m_gp;
+	std::function<void()> m_onUpdated;
+
+	mutable SharedMutex x_block;
+	Block m_block;							///< The speculative block; empty until the first reset().
+	unsigned m_generation = 0;				///< Bumped by reset(), so that a pass on a stale base is discarded.
+	bool m_hasBase = false;
+
+	std::atomic<bool> m_dirty = {false};	///< More transactions may be executed on m_block.
+	std::atomic<bool> m_inPass = {false};
+	std::atomic<unsigned> m_adopted = {0};
+
+	std::condition_variable m_signalled;
+	Mutex x_signalled;
+};
+
+}
+}
@@ -0,0 +1,78 @@
+/*
+	This file is part of cpp-ethereum.
+
+	cpp-ethereum is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	cpp-ethereum is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with cpp-ethereum.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/** @file ChainEvents.cpp
+ * @date 2017
+ */
+
+#include "ChainEvents.h"
+#include <chrono>
+using namespace std;
+using namespace dev;
+using namespace dev::eth;
+
+ChainEventBus::ChainEventBus(unsigned _capacityLog2):
+	m_slots(size_t(1) << _capacityLog2),
+	m_mask((uint64_t(1) << _capacityLog2) - 1)
+{
+}
+
+void ChainEventBus::publish(ChainEvent&& _e)
+{
+	Guard l(x_publish);
+	uint64_t sequence = m_head.load(memory_order_relaxed);
+	_e.sequence = sequence;
+	_e.publishedAt = chrono::duration_cast<chrono::microseconds>(chrono::system_clock::now().time_since_epoch()).count();
+	atomic_store(&m_slots[sequence & m_mask], ChainEventPtr(new ChainEvent(move(_e))));
+	m_head.store(sequence + 1, memory_order_release);
+}
+
+ChainEventSubscriber::ChainEventSubscriber(ChainEventBus const& _bus):
+	m_bus(_bus),
+	m_cursor(_bus.head())
+{
+	++m_bus.m_subscribers;
+}
+
+ChainEventSubscriber::~ChainEventSubscriber()
+{
+	--m_bus.m_subscribers;
+}
+
+uint64_t ChainEventSubscriber::poll(vector<ChainEventPtr>& o_events, unsigned _max)
+{
+	uint64_t missed = 0;
+	for (unsigned n = 0; n < _max;)
+	{
+		uint64_t head = m_bus.head();
+		if (m_cursor == head)
+			break;
+		if (head - m_cursor > m_bus.capacity())
+		{
+			// Lapped: skip to the oldest event still in the ring.
+			missed += head - m_bus.capacity() - m_cursor;
+			m_cursor = head - m_bus.capacity();
+		}
+		ChainEventPtr e = m_bus.slot(m_cursor);
+		if (!e || e->sequence != m_cursor)
+			// Overwritten since we read the head; re-read it and skip ahead.
+			continue;
+		o_events.push_back(move(e));
+		++m_cursor;
+		++n;
+	}
+	return missed;
+}
@@ -0,0 +1,126 @@
+/*
+	This file is part of cpp-ethereum.
+
+	cpp-ethereum is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	cpp-ethereum is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with cpp-ethereum.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/** @file ChainEvents.h
+ * @date 2017
+ */
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <vector>
+#include <libdevcore/Common.h>
+#include <libdevcore/Guards.h>
+#include <libdevcore/FixedHash.h>
+#include <libevm/ExtVMFace.h>
+
+namespace dev
+{
+namespace eth
+{
+
+enum class ChainEventType
+{
+	NewHead,				///< The canonical chain changed; deadBlocks is non-empty on a reorg.
+	PendingTransactions,	///< Transactions were added to the pending block.
+	Logs,					///< Logs of blocks that entered (BlockPolarity::Live) or left (Dead) the chain.
+	NewWork					///< A new block was prepared for sealing.
+};
+
+struct ChainEvent
+{
+	ChainEventType type;
+	uint64_t sequence = 0;			///< Position on the bus; assigned by ChainEventBus::publish().
+	int64_t publishedAt = 0;		///< Microseconds since the epoch (system clock); assigned by ChainEventBus::publish().
+	h256s deadBlocks;				///< NewHead: blocks that are no longer canonical.
+	h256s liveBlocks;				///< NewHead: blocks that became canonical, the new head last.
+	h256s transactions;				///< PendingTransactions: hashes of the new pending transactions.
+	LocalisedLogEntries logs;		///< Logs: entries of the dead blocks followed by those of the live ones.
+	h256 sealingHash;				///< NewWork: hash without seal of the block to seal.
+};
+
+using ChainEventPtr = std::shared_ptr<ChainEvent const>;
+
+class ChainEventBus;
+
+/**
+ * @brief A consumer of a ChainEventBus.
+ * Each subscriber owns its cursor, so consumers never contend with each other or with publishers.
+ * A subscriber that falls more than the bus capacity behind loses the oldest events; the number lost
+ * is reported by poll() rather than stalling the publisher.
+ * Not thread-safe: a subscriber is used by one consumer thread at a time.
+ */
+class ChainEventSubscriber
+{
+public:
+	explicit ChainEventSubscriber(ChainEventBus const& _bus);
+	~ChainEventSubscriber();
+
+	ChainEventSubscriber(ChainEventSubscriber const&) = delete;
+	ChainEventSubscriber& operator=(ChainEventSubscriber const&) = delete;
+
+	/// Appends up to @a _max events published since the last call to @a o_events.
+	/// @returns the number of events that were overwritten before this subscriber could read them.
+	uint64_t poll(std::vector<ChainEventPtr>& o_events, unsigned _max = 1024);
+
+	/// @returns the sequence number of the next event this subscriber will read.
+	uint64_t cursor() const { return m_cursor; }
+
+private:
+	ChainEventBus const& m_bus;
+	uint64_t m_cursor;
+};
+
+/**
+ * @brief Fixed-size ring of chain events with any number of publishers and subscribers.
+ * Publishers never wait for consumers: publish() stores the event in the next slot and advances
+ * the head. Subscribers read with their own cursor and detect being lapped through the sequence
+ * number stored in each event.
+ * Publishers are serialised among themselves, since Client publishes both from its worker thread
+ * and from whichever thread calls flushTransactions(); subscribers never take the lock.
+ */
+class ChainEventBus
+{
+public:
+	/// @param _capacityLog2 log2 of the number of events kept for slow subscribers.
+	explicit ChainEventBus(unsigned _capacityLog2 = 12);
+
+	/// Publishes @a _e to all subscribers; the sequence number is filled in here.
+	void publish(ChainEvent&& _e);
+
+	/// @returns true if anyone is listening; publishers use this to skip building events.
+	bool hasSubscribers() const { return m_subscribers.load(std::memory_order_relaxed) > 0; }
+
+	/// @returns the sequence number the next published event will get.
+	uint64_t head() const { return m_head.load(std::memory_order_acquire); }
+
+	uint64_t capacity() const { return m_slots.size(); }
+
+private:
+	friend class ChainEventSubscriber;
+
+	ChainEventPtr slot(uint64_t _sequence) const { return std::atomic_load(&m_slots[_sequence & m_mask]); }
+
+	std::vector<ChainEventPtr> m_slots;
+	uint64_t m_mask;
+	std::atomic<uint64_t> m_head = {0};
+	Mutex x_publish;						///< Held while an event takes its sequence number and slot.
+	mutable std::atomic<unsigned> m_subscribers = {0};
+};
+
+}
+}
@@ -26,6 +26,7 @@
 #include <libethcore/SealEngine.h>
 #include <libethcore/BlockHeader.h>
 #include <libethcore/Precompiled.h>
+#include <libethcore/Exceptions.h>
 #include "GenesisInfo.h"
 #include "State.h"
 #include "Account.h"
@@ -81,6 +82,8 @@ ChainParams ChainParams::loadGenesisState(string const& _json, h256 const& _stat
 {
 	ChainParams cp(*this);
 	cp.genesisState = jsonToAccountMap(_json, cp.accountStartNonce, nullptr, &cp.precompiled);
+	cp.genesisStateNodes.reset();
+	cp.genesisStateAux.reset();
 	cp.stateRoot = _stateRoot ? _stateRoot : cp.calculateStateRoot(true);
 	return cp;
 }
@@ -113,6 +116,88 @@ ChainParams ChainParams::loadGenesis(string const& _json, h256 const& _stateRoot
 	return cp;
 }
 
+static unsigned const c_genesisStateBinaryVersion = 2;
+
+ChainParams ChainParams::loadGenesisStateBinary(bytesConstRef _binary, h256 const& _stateRoot) const
+{
+	ChainParams cp(*this);
+	RLP r(_binary);
+	if (!r.isList() || r.itemCount() != 5 || r[0].toInt<unsigned>() != c_genesisStateBinaryVersion)
+		BOOST_THROW_EXCEPTION(InvalidStateRoot() << errinfo_comment("Unknown genesis state binary"));
+	cp.stateRoot = r[1].toHash<h256>();
+	if (_stateRoot && cp.stateRoot != _stateRoot)
+		BOOST_THROW_EXCEPTION(InvalidStateRoot() << errinfo_comment("Genesis state binary is of another state"));
+
+	cp.genesisState.clear();
+	cp.genesisState.reserve(r[2].itemCount());
+	for (auto const& a: r[2])
+	{
+		Account& account = cp.genesisState[a[0].toHash<Address>()] = Account(a[1].toInt<u256>(), a[2].toInt<u256>());
+		if (!a[3].isEmpty())
+			account.setNewCode(a[3].toBytes());
+		for (auto const& kv: a[4])
+			account.setStorage(kv[0].toInt<u256>(), kv[1].toInt<u256>());
+	}
+
+	auto nodes = make_shared<vector<bytes>>();
+	nodes->reserve(r[3].itemCount());
+	for (auto const& n: r[3])
+		nodes->push_back(n.toBytes());
+	cp.genesisStateNodes = nodes;
+
+	auto aux = make_shared<vector<bytes>>();
+	aux->reserve(r[4].itemCount());
+	for (auto const& a: r[4])
+		aux->push_back(a.toBytes());
+	cp.genesisStateAux = aux;
+	return cp;
+}
+
+bytes ChainParams::genesisStateBinary() const
+{
+	MemoryDB db;
+	SecureTrieDB<Address, MemoryDB> state(&db);
+	state.init();
+	dev::eth::commit(genesisState, state);
+
+	// Everything is sorted, so that the encoding is reproducible.
+	map<Address, Account const*> sorted;
+	for (auto const& i: genesisState)
+		sorted[i.first] = &i.second;
+	RLPStream accounts(sorted.size());
+	for (auto const& i: sorted)
+	{
+		map<u256, u256> storage(i.second->storageOverlay().begin(), i.second->storageOverlay().end());
+		accounts.appendList(5) << i.first << i.second->nonce() << i.second->balance() << i.second->code();
+		accounts.appendList(storage.size());
+		for (auto const& j: storage)
+			accounts.appendList(2) << j.first << j.second;
+	}
+
+	// Nodes are keyed by their own hashes, so the keys need not be stored.
+	map<h256, string> nodes;
+	for (auto const& i: db.get())
+		nodes.insert(i);
+	RLPStream nodeList(nodes.size());
+	for (auto const& i: nodes)
+		nodeList << i.second;
+
+	// Likewise the key preimages a fat trie records, without which the genesis accounts can't be listed.
+	map<h256, bytes> aux;
+	for (auto const& i: db.getAux())
+		aux.insert(i);
+	RLPStream auxList(aux.size());
+	for (auto const& i: aux)
+		auxList << i.second;
+
+	RLPStream ret(5);
+	ret << c_genesisStateBinaryVersion << state.root();
+	ret.appendRaw(accounts.out());
+	ret.appendRaw(nodeList.out());
+	ret.appendRaw(auxList.out());
+	return ret.out();
+}
+
 SealEngineFace* ChainParams::createSealEngine()
 {
 	SealEngineFace* ret = SealEngineRegistrar::create(sealEngineName);
@@ -139,6 +224,8 @@ void ChainParams::populateFromGenesis(bytes const& _genesisRLP, AccountMap const
 	timestamp = bi.timestamp();
 	extraData = bi.extraData();
 	genesisState = _state;
+	genesisStateNodes.reset();
+	genesisStateAux.reset();
 	RLP r(_genesisRLP);
 	sealFields = r[0].itemCount() - BlockHeader::BasicFields;
 	sealRLP.clear();
@@ -54,6 +54,11 @@ struct ChainParams: public ChainOperationParams
 	bytes extraData;
 	mutable h256 stateRoot;	///< Only pre-populate if known equivalent to genesisState's root. If they're different Bad Things Will Happen.
 	AccountMap genesisState;
+	/// The nodes (and code) of genesisState's trie, if they came ready-made with it; spares building the trie.
+	/// Anything that changes genesisState must reset this.
+	std::shared_ptr<std::vector<bytes> const> genesisStateNodes;
+	/// The auxiliary entries (key preimages) that go with genesisStateNodes; each is keyed by its hash.
+	std::shared_ptr<std::vector<bytes> const> genesisStateAux;
 
 	unsigned sealFields = 0;
 	bytes sealRLP;
@@ -66,6 +71,13 @@ struct ChainParams: public ChainOperationParams
 	ChainParams loadConfig(std::string const& _json, h256 const& _stateRoot = h256()) const;
 	ChainParams loadGenesisState(std::string const& _json,  h256 const& _stateRoot = h256()) const;
 	ChainParams loadGenesis(std::string const& _json, h256 const& _stateRoot = h256()) const;
+	/// Replaces the genesis state with one encoded by genesisStateBinary(), checking it against @a _stateRoot if given.
+	ChainParams loadGenesisStateBinary(bytesConstRef _binary, h256 const& _stateRoot = h256()) const;
+
+	/// Encodes the genesis state along with the nodes of its trie, so that loading it takes neither JSON parsing nor hashing.
+	/// RLP: [version (2), stateRoot, [[address, nonce, balance, code, [[key, value]...]]...], [node...], [preimage...]]
+	/// Nodes and preimages (the keys a fat trie records for each hashed address and storage key) are keyed by their hashes.
+	bytes genesisStateBinary() const;
 
 private:
 	void populateFromGenesis(bytes const& _genesisRLP, AccountMap const& _state);
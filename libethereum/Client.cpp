@@ -42,6 +42,15 @@ std::ostream& dev::eth::operator<<(std::ostream& _out, ActivityReport const& _r)
 {
 	_out << "Since " << toString(_r.since) << " (" << std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now() - _r.since).count();
 	_out << "): " << _r.ticks << "ticks";
+	uint64_t hits = SenderCache::instance().hits() - _r.senderCacheHits;
+	uint64_t lookups = hits + SenderCache::instance().misses() - _r.senderCacheMisses;
+	_out << ", sender cache " << hits << "/" << lookups << " hits";
+	uint64_t precompiledHits = PrecompiledCache::instance().hits() - _r.precompiledCacheHits;
+	uint64_t precompiledRuns = precompiledHits + PrecompiledCache::instance().misses() - _r.precompiledCacheMisses;
+	_out << ", precompiled cache " << precompiledHits << "/" << precompiledRuns << " hits";
+	TransactionSyncStats ts = Block::transactionSyncStats() - _r.transactionSync;
+	_out << ", tx sync " << ts.syncs << " syncs/" << ts.passes << " passes: " << ts.executed << " of " << ts.considered << " executed, ";
+	_out << ts.nonceBlocked << " nonce-blocked, " << ts.outOfGas << " out of gas, " << ts.underpriced << " underpriced, " << ts.dropped << " dropped";
 	return _out;
 }
 
@@ -72,7 +81,8 @@ Client::Client(
 	m_gp(_gpForAdoption ? _gpForAdoption : make_shared<TrivialGasPricer>()),
 	m_preSeal(chainParams().accountStartNonce),
 	m_postSeal(chainParams().accountStartNonce),
-	m_working(chainParams().accountStartNonce)
+	m_working(chainParams().accountStartNonce),
+	m_speculator(m_bc, m_tq, m_gp, [=](){ m_syncTransactionQueue = true; m_signalled.notify_all(); })
 {
 	init(_host, _dbPath, _forceAction, _networkID);
 }
@@ -118,6 +128,10 @@ void Client::init(p2p::Host* _extNet, std::string const& _dbPath, WithExisting _
 	_extNet->addCapability(host, EthereumHost::staticName(), EthereumHost::c_oldProtocolVersion); //TODO: remove this once v61+ protocol is common
 
 
+	m_memoryReports.push_back(MemoryAccounting::get().add("state.cache", [this]() { return stateCacheUsage(); }));
+	m_memoryReports.push_back(MemoryAccounting::get().add("state.overlay", [this]() { return stateOverlayUsage(); }));
+	m_memoryReports.push_back(MemoryAccounting::get().add("filters", [this]() { return filtersMemoryUsage(); }));
+
 	if (_dbPath.size())
 		Defaults::setDBPath(_dbPath);
 	doWork(false);
@@ -213,11 +227,15 @@ void Client::startedWorking()
 			m_working = m_preSeal;
 		DEV_WRITE_GUARDED(x_postSeal)
 			m_postSeal = m_preSeal;
+		m_speculator.reset(m_preSeal);
 	}
+	m_speculator.start();
 }
 
 void Client::doneWorking()
 {
+	m_speculator.stop();
+
 	// Synchronise the state according to the head of the block chain.
 	// TODO: currently it contains keys for *all* blocks. Make it remove old ones.
 	DEV_WRITE_GUARDED(x_preSeal)
@@ -366,6 +384,41 @@ void Client::appendFromBlock(h256 const& _block, BlockPolarity _polarity, h256Ha
 	}
 }
 
+void Client::publishChainEvents(ImportRoute const& _ir)
+{
+	if (!m_chainEvents.hasSubscribers() || (_ir.liveBlocks.empty() && _ir.deadBlocks.empty()))
+		return;
+
+	ChainEvent head;
+	head.type = ChainEventType::NewHead;
+	head.deadBlocks = _ir.deadBlocks;
+	head.liveBlocks = _ir.liveBlocks;
+	m_chainEvents.publish(move(head));
+
+	ChainEvent logs;
+	logs.type = ChainEventType::Logs;
+	auto appendLogs = [&](h256 const& _block, BlockPolarity _polarity)
+	{
+		auto receipts = bc().receipts(_block).receipts;
+		if (receipts.empty())
+			return;
+		auto hashes = bc().transactionHashes(_block);
+		auto number = (BlockNumber)bc().number(_block);
+		for (size_t j = 0; j < receipts.size() && j < hashes.size(); ++j)
+		{
+			LogEntries const& entries = receipts[j].log();
+			for (size_t k = 0; k < entries.size(); ++k)
+				logs.logs.push_back(LocalisedLogEntry(entries[k], _block, number, hashes[j], j, k, _polarity));
+		}
+	};
+	for (auto const& h: _ir.deadBlocks)
+		appendLogs(h, BlockPolarity::Dead);
+	for (auto const& h: _ir.liveBlocks)
+		appendLogs(h, BlockPolarity::Live);
+	if (!logs.logs.empty())
+		m_chainEvents.publish(move(logs));
+}
+
 ExecutionResult Client::call(Address _dest, bytes const& _data, u256 _gas, u256 _value, u256 _gasPrice, Address const& _from)
 {
 	ExecutionResult ret;
@@ -432,7 +485,13 @@ void Client::syncTransactionQueue()
 			return;
 		}
 
-		tie(newPendingReceipts, m_syncTransactionQueue) = m_working.sync(bc(), m_tq, *m_gp);
+		if (m_speculator.adopt(m_working, newPendingReceipts))
+			m_syncTransactionQueue = false;
+		else if (m_speculator.isBusyWith(m_working))
+			// It will call back once its pass is done; executing here too would only duplicate its work.
+			return;
+		else
+			tie(newPendingReceipts, m_syncTransactionQueue) = m_working.sync(bc(), m_tq, *m_gp);
 	}
 
 	if (newPendingReceipts.empty())
@@ -446,9 +505,17 @@ void Client::syncTransactionQueue()
 		DEV_WRITE_GUARDED(x_postSeal)
 			m_postSeal = m_working;
 
+	ChainEvent pending;
+	pending.type = ChainEventType::PendingTransactions;
 	DEV_READ_GUARDED(x_postSeal)
 		for (size_t i = 0; i < newPendingReceipts.size(); i++)
-			appendFromNewPending(newPendingReceipts[i], changeds, m_postSeal.pending()[i].sha3());
+		{
+			h256 h = m_postSeal.pending()[i].sha3();
+			appendFromNewPending(newPendingReceipts[i], changeds, h);
+			pending.transactions.push_back(h);
+		}
+	if (m_chainEvents.hasSubscribers())
+		m_chainEvents.publish(move(pending));
 
 	// Tell farm about new transaction (i.e. restart mining).
 	onPostStateChanged();
@@ -516,6 +583,7 @@ void Client::resyncStateFromChain()
 				m_preSeal = newPreMine;
 			DEV_WRITE_GUARDED(x_working)
 				m_working = newPreMine;
+			m_speculator.reset(newPreMine);
 			DEV_READ_GUARDED(x_postSeal)
 				if (!m_postSeal.isSealed() || m_postSeal.info().hash() != newPreMine.info().parentHash())
 					for (auto const& t: m_postSeal.pending())
@@ -538,6 +606,16 @@ void Client::resyncStateFromChain()
 	}
 }
 
+void Client::setAuthor(Address const& _us)
+{
+	DEV_WRITE_GUARDED(x_preSeal)
+	{
+		m_preSeal.setAuthor(_us);
+		// Speculation for the old author would never be adopted.
+		m_speculator.reset(m_preSeal);
+	}
+}
+
 void Client::resetState()
 {
 	Block newPreMine(chainParams().accountStartNonce);
@@ -546,6 +624,7 @@ void Client::resetState()
 
 	DEV_WRITE_GUARDED(x_working)
 		m_working = newPreMine;
+	m_speculator.reset(newPreMine);
 	DEV_READ_GUARDED(x_working) DEV_WRITE_GUARDED(x_postSeal)
 		m_postSeal = m_working;
 
@@ -564,6 +643,7 @@ void Client::onChainChanged(ImportRoute const& _ir)
 		m_tq.dropGood(t);
 	}
 	onNewBlocks(_ir.liveBlocks, changeds);
+	publishChainEvents(_ir);
 	resyncStateFromChain();
 	noteChanged(changeds);
 }
@@ -619,6 +699,21 @@ void Client::rejigSealing()
 				m_sealingInfo = m_working.info();
 			}
 
+			// Let pushed-to remote sealers know right away rather than on their next poll.
+			// rejigSealing() also runs on threads calling flushTransactions(), so the check and the
+			// publish happen together to announce each work package once.
+			h256 sealingHash = m_sealingInfo.hash(WithoutSeal);
+			if (m_chainEvents.hasSubscribers())
+				DEV_GUARDED(x_lastPublishedWork)
+					if (sealingHash != m_lastPublishedWork)
+					{
+						m_lastPublishedWork = sealingHash;
+						ChainEvent e;
+						e.type = ChainEventType::NewWork;
+						e.sealingHash = sealingHash;
+						m_chainEvents.publish(move(e));
+					}
+
 			if (wouldSeal())
 			{
 				sealEngine()->onSealGenerated([=](bytes const& header){
@@ -707,6 +802,11 @@ void Client::tick()
 		m_report.ticks++;
 		checkWatchGarbage();
 		m_bq.tick();
+		if (chrono::system_clock::now() - m_lastMemoryCheck > chrono::seconds(5))
+		{
+			MemoryAccounting::get().check();
+			m_lastMemoryCheck = chrono::system_clock::now();
+		}
 		m_lastTick = chrono::system_clock::now();
 		if (m_report.ticks == 15)
 			clog(ClientTrace) << activityReport();
@@ -736,6 +836,31 @@ void Client::checkWatchGarbage()
 	}
 }
 
+MemoryUsage Client::stateCacheUsage() const
+{
+	// Const State accessors fill the account cache, so readers of these blocks may be writing to it.
+	MemoryUsage ret;
+	DEV_WRITE_GUARDED(x_preSeal)
+		ret += m_preSeal.state().cacheUsage();
+	DEV_WRITE_GUARDED(x_working)
+		ret += m_working.state().cacheUsage();
+	DEV_WRITE_GUARDED(x_postSeal)
+		ret += m_postSeal.state().cacheUsage();
+	return ret;
+}
+
+MemoryUsage Client::stateOverlayUsage() const
+{
+	MemoryUsage ret = m_stateDB.usage();
+	DEV_READ_GUARDED(x_preSeal)
+		ret += m_preSeal.db().usage();
+	DEV_READ_GUARDED(x_working)
+		ret += m_working.db().usage();
+	DEV_READ_GUARDED(x_postSeal)
+		ret += m_postSeal.db().usage();
+	return ret;
+}
+
 void Client::prepareForTransaction()
 {
 	startWorking();
@@ -34,12 +34,16 @@
 #include <libdevcore/Guards.h>
 #include <libdevcore/Worker.h>
 #include <libethcore/SealEngine.h>
+#include <libethcore/PrecompiledCache.h>
+#include <libethcore/SenderCache.h>
 #include <libethcore/ABI.h>
 #include <libp2p/Common.h>
 #include "BlockChain.h"
 #include "Block.h"
 #include "CommonNet.h"
 #include "ClientBase.h"
+#include "ChainEvents.h"
+#include "BlockSpeculator.h"
 
 namespace dev
 {
@@ -65,6 +69,11 @@ struct ActivityReport
 {
 	unsigned ticks = 0;
 	std::chrono::system_clock::time_point since = std::chrono::system_clock::now();
+	uint64_t senderCacheHits = SenderCache::instance().hits();		///< Sender cache hits as of @a since.
+	uint64_t senderCacheMisses = SenderCache::instance().misses();	///< Sender cache misses as of @a since.
+	uint64_t precompiledCacheHits = PrecompiledCache::instance().hits();		///< Precompiled cache hits as of @a since.
+	uint64_t precompiledCacheMisses = PrecompiledCache::instance().misses();	///< Precompiled cache misses as of @a since.
+	TransactionSyncStats transactionSync = Block::transactionSyncStats();	///< Transaction queue sync totals as of @a since.
 };
 
 std::ostream& operator<<(std::ostream& _out, ActivityReport const& _r);
@@ -91,7 +100,7 @@ public:
 	ChainParams const& chainParams() const { return bc().chainParams(); }
 
 	/// Resets the gas pricer to some other object.
-	void setGasPricer(std::shared_ptr<GasPricer> _gp) { m_gp = _gp; }
+	void setGasPricer(std::shared_ptr<GasPricer> _gp) { m_gp = _gp; m_speculator.setGasPricer(_gp); }
 	std::shared_ptr<GasPricer> gasPricer() const { return m_gp; }
 
 	/// Blocks until all pending transactions have been processed.
@@ -142,7 +151,7 @@ public:
 	// Note: "mining"/"miner" is deprecated. Use "sealing"/"sealer".
 
 	virtual Address author() const override { ReadGuard l(x_preSeal); return m_preSeal.author(); }
-	virtual void setAuthor(Address const& _us) override { WriteGuard l(x_preSeal); m_preSeal.setAuthor(_us); }
+	virtual void setAuthor(Address const& _us) override;
 
 	/// Type of sealers available for this seal engine.
 	strings sealers() const { return sealEngine()->sealers(); }
@@ -174,6 +183,7 @@ public:
 
 	/// Get the seal engine.
 	SealEngineFace* sealEngine() const override { return bc().sealEngine(); }
+	ChainEventBus* chainEvents() override { return &m_chainEvents; }
 
 	// Debug stuff:
 
@@ -225,6 +235,9 @@ protected:
 	/// Insert any filters that are activated into @a o_changed.
 	void appendFromBlock(h256 const& _blockHash, BlockPolarity _polarity, h256Hash& io_changed);
 
+	/// Publish the head change and the logs of @a _ir to m_chainEvents, if anyone is subscribed.
+	void publishChainEvents(ImportRoute const& _ir);
+
 	/// Record that the set of filters @a _filters have changed.
 	/// This doesn't actually make any callbacks, but incrememnts some counters in m_watches.
 	void noteChanged(h256Hash const& _filters);
@@ -269,7 +282,7 @@ protected:
 	void syncTransactionQueue();
 
 	/// Magically called when m_tq needs syncing. Be nice and don't block.
-	void onTransactionQueueReady() { m_syncTransactionQueue = true; m_signalled.notify_all(); }
+	void onTransactionQueueReady() { m_speculator.noteTransactions(); m_syncTransactionQueue = true; m_signalled.notify_all(); }
 
 	/// Magically called when m_bq needs syncing. Be nice and don't block.
 	void onBlockQueueReady() { m_syncBlockQueue = true; m_signalled.notify_all(); }
@@ -291,6 +304,10 @@ protected:
 	/// Executes the pending functions in m_functionQueue
 	void callQueuedFunctions();
 
+	/// Memory held by the account caches and the DB overlays of the blocks we keep, reported to MemoryAccounting.
+	MemoryUsage stateCacheUsage() const;
+	MemoryUsage stateOverlayUsage() const;
+
 	BlockChain m_bc;						///< Maintains block database and owns the seal engine.
 	BlockQueue m_bq;						///< Maintains a list of incoming blocks not yet on the blockchain (to be imported).
 	std::shared_ptr<GasPricer> m_gp;		///< The gas pricer.
@@ -303,6 +320,7 @@ protected:
 	mutable SharedMutex x_working;			///< Lock on m_working.
 	Block m_working;						///< The state of the client which we're sealing (i.e. it'll have all the rewards added), while we're actually working on it.
 	BlockHeader m_sealingInfo;				///< The header we're attempting to seal on (derived from m_postSeal).
+	BlockSpeculator m_speculator;			///< Executes pending transactions on top of m_preSeal ahead of syncTransactionQueue().
 	bool remoteActive() const;				///< Is there an active and valid remote worker?
 	bool m_remoteWorking = false;			///< Has the remote worker recently been reset?
 	std::atomic<bool> m_needStateReset = { false };			///< Need reset working state to premin on next sync
@@ -326,6 +344,10 @@ protected:
 
 	ActivityReport m_report;
 
+	ChainEventBus m_chainEvents;			///< Push-based feed of chain changes; published from the worker thread and from flushTransactions().
+	h256 m_lastPublishedWork;				///< Sealing hash of the last NewWork event, so that each work package is published once.
+	Mutex x_lastPublishedWork;				///< Lock on m_lastPublishedWork.
+
 	SharedMutex x_functionQueue;
 	std::queue<std::function<void()>> m_functionQueue;	///< Functions waiting to be executed in the main thread.
 
@@ -335,6 +357,9 @@ protected:
 	std::atomic<bool> m_syncBlockQueue = {false};
 
 	bytes m_extraData;
+
+	mutable std::chrono::system_clock::time_point m_lastMemoryCheck;	///< When did we last check MemoryAccounting?
+	std::vector<MemoryAccounting::Handle> m_memoryReports;
 };
 
 }
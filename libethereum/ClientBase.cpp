@@ -36,6 +36,8 @@ const char* WorkOutChannel::name() { return EthOrange "⚒" EthNavy "◀▬"; }
 const char* WorkChannel::name() { return EthOrange "⚒" EthWhite "  "; }
 
 static const int64_t c_maxGasEstimate = 50000000;
+/// Threads reading the state trie ahead of a walk over all of it.
+static const unsigned c_stateScanReaders = 4;
 
 pair<h256, Address> ClientBase::submitTransaction(TransactionSkeleton const& _t, Secret const& _secret)
 {
@@ -56,21 +58,49 @@ pair<h256, Address> ClientBase::submitTransaction(TransactionSkeleton const& _t,
 	return make_pair(t.sha3(), toAddress(ts.from, ts.nonce));
 }
 
-// TODO: remove try/catch, allow exceptions
 ExecutionResult ClientBase::call(Address const& _from, u256 _value, Address _dest, bytes const& _data, u256 _gas, u256 _gasPrice, BlockNumber _blockNumber, FudgeFactor _ff)
 {
-	ExecutionResult ret;
+	TransactionSkeleton t;
+	t.from = _from;
+	t.value = _value;
+	t.to = _dest;
+	t.data = _data;
+	t.gas = _gas;
+	t.gasPrice = _gasPrice;
+	return callMany({t}, _blockNumber, _ff).front();
+}
+
+// TODO: remove try/catch, allow exceptions
+vector<ExecutionResult> ClientBase::callMany(vector<TransactionSkeleton> const& _calls, BlockNumber _blockNumber, FudgeFactor _ff)
+{
+	vector<ExecutionResult> ret(_calls.size());
 	try
 	{
+		// The copy of the state is the expensive part; share it between the calls.
 		Block temp = block(_blockNumber);
-		u256 nonce = max<u256>(temp.transactionsFrom(_from), m_tq.maxNonce(_from));
-		u256 gas = _gas == Invalid256 ? gasLimitRemaining() : _gas;
-		u256 gasPrice = _gasPrice == Invalid256 ? gasBidPrice() : _gasPrice;
-		Transaction t(_value, gasPrice, gas, _dest, _data, nonce);
-		t.forceSender(_from);
-		if (_ff == FudgeFactor::Lenient)
-			temp.mutableState().addBalance(_from, (u256)(t.gas() * t.gasPrice() + t.value()));
-		ret = temp.execute(bc().lastHashes(), t, Permanence::Reverted);
+		LastHashes lh = bc().lastHashes();
+		for (size_t i = 0; i < _calls.size(); ++i)
+		{
+			TransactionSkeleton const& c = _calls[i];
+			// A reverted execution leaves the state as it was, but a failing one may not get that far.
+			size_t savepoint = temp.mutableState().savepoint();
+			try
+			{
+				u256 nonce = max<u256>(temp.transactionsFrom(c.from), m_tq.maxNonce(c.from));
+				u256 gas = c.gas == Invalid256 ? gasLimitRemaining() : c.gas;
+				u256 gasPrice = c.gasPrice == Invalid256 ? gasBidPrice() : c.gasPrice;
+				Transaction t(c.value, gasPrice, gas, c.to, c.data, nonce);
+				t.forceSender(c.from);
+				if (_ff == FudgeFactor::Lenient)
+					temp.mutableState().addBalance(c.from, (u256)(t.gas() * t.gasPrice() + t.value()));
+				ret[i] = temp.execute(lh, t, Permanence::Reverted);
+			}
+			catch (...)
+			{
+				// TODO: Some sort of notification of failure.
+				temp.mutableState().rollback(savepoint);
+			}
+		}
 	}
 	catch (...)
 	{
@@ -375,11 +405,15 @@ BlockHeader ClientBase::blockInfo(h256 _hash) const
 {
 	if (_hash == PendingBlockHash)
 		return preSeal().info();
+	if (auto d = bc().decodedBlock(_hash))
+		return d->header;
 	return BlockHeader(bc().block(_hash));
 }
 
 BlockDetails ClientBase::blockDetails(h256 _hash) const
 {
+	if (auto d = bc().decodedBlock(_hash))
+		return d->details;
 	return bc().details(_hash);
 }
 
@@ -396,16 +430,18 @@ LocalisedTransaction ClientBase::localisedTransaction(h256 const& _transactionHa
 
 Transaction ClientBase::transaction(h256 _blockHash, unsigned _i) const
 {
-	auto bl = bc().block(_blockHash);
-	RLP b(bl);
-	if (_i < b[1].itemCount())
-		return Transaction(b[1][_i].data(), CheckTransaction::Cheap);
+	auto d = bc().decodedBlock(_blockHash);
+	if (d && _i < d->transactions.size())
+		return d->withSender(_i);
 	else
 		return Transaction();
 }
 
 LocalisedTransaction ClientBase::localisedTransaction(h256 const& _blockHash, unsigned _i) const
 {
+	auto d = bc().decodedBlock(_blockHash);
+	if (d && _i < d->transactions.size())
+		return LocalisedTransaction(d->withSender(_i), _blockHash, _i, d->details.number);
 	Transaction t = Transaction(bc().transaction(_blockHash, _i), CheckTransaction::Cheap);
 	return LocalisedTransaction(t, _blockHash, _i, numberFromHash(_blockHash));
 }
@@ -436,17 +472,16 @@ pair<h256, unsigned> ClientBase::transactionLocation(h256 const& _transactionHas
 
 Transactions ClientBase::transactions(h256 _blockHash) const
 {
-	auto bl = bc().block(_blockHash);
-	RLP b(bl);
-	Transactions res;
-	for (unsigned i = 0; i < b[1].itemCount(); i++)
-		res.emplace_back(b[1][i].data(), CheckTransaction::Cheap);
-	return res;
+	if (auto d = bc().decodedBlock(_blockHash))
+		return d->withSenders();
+	return Transactions();
 }
 
 TransactionHashes ClientBase::transactionHashes(h256 _blockHash) const
 {
-	return bc().transactionHashes(_blockHash);
+	if (auto d = bc().decodedBlock(_blockHash))
+		return d->transactionHashes;
+	return TransactionHashes();
 }
 
 BlockHeader ClientBase::uncle(h256 _blockHash, unsigned _i) const
@@ -461,21 +496,23 @@ BlockHeader ClientBase::uncle(h256 _blockHash, unsigned _i) const
 
 UncleHashes ClientBase::uncleHashes(h256 _blockHash) const
 {
-	return bc().uncleHashes(_blockHash);
+	if (auto d = bc().decodedBlock(_blockHash))
+		return d->uncleHashes;
+	return UncleHashes();
 }
 
 unsigned ClientBase::transactionCount(h256 _blockHash) const
 {
-	auto bl = bc().block(_blockHash);
-	RLP b(bl);
-	return b[1].itemCount();
+	if (auto d = bc().decodedBlock(_blockHash))
+		return d->transactions.size();
+	return 0;
 }
 
 unsigned ClientBase::uncleCount(h256 _blockHash) const
 {
-	auto bl = bc().block(_blockHash);
-	RLP b(bl);
-	return b[2].itemCount();
+	if (auto d = bc().decodedBlock(_blockHash))
+		return d->uncleHashes.size();
+	return 0;
 }
 
 unsigned ClientBase::number() const
@@ -508,7 +545,8 @@ BlockDetails ClientBase::pendingDetails() const
 Addresses ClientBase::addresses(BlockNumber _block) const
 {
 	Addresses ret;
-	for (auto const& i: block(_block).addresses())
+	// A walk of the whole state, so worth reading ahead.
+	for (auto const& i: block(_block).addresses(c_stateScanReaders))
 		ret.push_back(i.first);
 	return ret;
 }
@@ -588,3 +626,27 @@ Block ClientBase::block(BlockNumber _h) const
 		return preSeal();
 	return block(bc().numberHash(_h));
 }
+
+MemoryUsage ClientBase::filtersMemoryUsage() const
+{
+	MemoryUsage ret;
+	auto addChanges = [&](LocalisedLogEntries const& _changes)
+	{
+		for (auto const& i: _changes)
+			ret.bytes += sizeof(LocalisedLogEntry) + i.data.size() + i.topics.size() * sizeof(h256);
+		ret.items += _changes.size();
+	};
+	Guard l(x_filtersWatches);
+	for (auto const& i: m_filters)
+	{
+		ret.bytes += sizeof(InstalledFilter) + 64;
+		addChanges(i.second.changes);
+	}
+	for (auto const& i: m_watches)
+	{
+		ret.bytes += sizeof(ClientWatch) + 48;
+		addChanges(i.second.changes);
+	}
+	ret.items += m_filters.size() + m_watches.size();
+	return ret;
+}
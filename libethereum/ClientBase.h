@@ -88,6 +88,9 @@ public:
 	virtual ExecutionResult call(Address const& _secret, u256 _value, Address _dest, bytes const& _data, u256 _gas, u256 _gasPrice, BlockNumber _blockNumber, FudgeFactor _ff = FudgeFactor::Strict) override;
 	using Interface::call;
 
+	/// Makes the given calls against one copy of the state. Nothing is recorded into the state.
+	virtual std::vector<ExecutionResult> callMany(std::vector<TransactionSkeleton> const& _calls, BlockNumber _blockNumber, FudgeFactor _ff = FudgeFactor::Strict) override;
+
 	/// Makes the given create. Nothing is recorded into the state.
 	virtual ExecutionResult create(Address const& _secret, u256 _value, bytes const& _data, u256 _gas, u256 _gasPrice, BlockNumber _blockNumber, FudgeFactor _ff = FudgeFactor::Strict) override;
 
@@ -185,6 +188,9 @@ protected:
 	virtual void prepareForTransaction() = 0;
 	/// }
 
+	/// Memory held by the installed filters and watches and their pending changes.
+	MemoryUsage filtersMemoryUsage() const;
+
 	TransactionQueue m_tq;							///< Maintains a list of incoming transactions not yet in a block on the blockchain.
 
 	// filters
@@ -390,6 +390,7 @@ EthereumHost::EthereumHost(BlockChain const& _ch, OverlayDB const& _db, Transact
 	m_peerObserver = make_shared<EthereumPeerObserver>(*m_sync, x_sync, m_tq);
 	m_latestBlockSent = _ch.currentHash();
 	m_tq.onImport([this](ImportResult _ir, h256 const& _h, h512 const& _nodeId) { onTransactionImported(_ir, _h, _nodeId); });
+	m_memoryReport = MemoryAccounting::get().add("peers.known", [this]() { return knownMemoryUsage(); }, [this]() { trimKnown(); });
 }
 
 EthereumHost::~EthereumHost()
@@ -520,6 +521,42 @@ void EthereumHost::foreachPeer(std::function<bool(std::shared_ptr<EthereumPeer>)
 			return;
 }
 
+MemoryUsage EthereumHost::knownMemoryUsage() const
+{
+	// Hashes in hash sets, at about twice their size with the nodes and buckets.
+	MemoryUsage ret;
+	foreachPeer([&](shared_ptr<EthereumPeer> _p)
+	{
+		DEV_GUARDED(_p->x_knownBlocks)
+			ret.items += _p->m_knownBlocks.size();
+		DEV_GUARDED(_p->x_knownTransactions)
+			ret.items += _p->m_knownTransactions.size();
+		return true;
+	});
+	DEV_GUARDED(x_transactions)
+		ret.items += m_transactionsSent.size();
+	ret.bytes = ret.items * sizeof(h256) * 2;
+	return ret;
+}
+
+void EthereumHost::trimKnown()
+{
+	foreachPeer([](shared_ptr<EthereumPeer> _p)
+	{
+		DEV_GUARDED(_p->x_knownBlocks)
+			_p->m_knownBlocks.clear();
+		_p->clearKnownTransactions();
+		return true;
+	});
+	h256Hash queued = m_tq.knownTransactions();
+	DEV_GUARDED(x_transactions)
+		for (auto i = m_transactionsSent.begin(); i != m_transactionsSent.end();)
+			if (queued.count(*i))
+				++i;
+			else
+				i = m_transactionsSent.erase(i);
+}
+
 tuple<vector<shared_ptr<EthereumPeer>>, vector<shared_ptr<EthereumPeer>>, vector<shared_ptr<SessionFace>>> EthereumHost::randomSelection(unsigned _percent, std::function<bool(EthereumPeer*)> const& _allow)
 {
 	vector<shared_ptr<EthereumPeer>> chosen;
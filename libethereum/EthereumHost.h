@@ -30,6 +30,7 @@
 #include <thread>
 
 #include <libdevcore/Guards.h>
+#include <libdevcore/MemoryAccounting.h>
 #include <libdevcore/Worker.h>
 #include <libethcore/Common.h>
 #include <libp2p/Common.h>
@@ -114,6 +115,11 @@ private:
 	/// Initialises the network peer-state, doing the stuff that needs to be once-only. @returns true if it really was first.
 	bool ensureInitialised();
 
+	/// Memory held by what we and our peers know has been sent, reported to MemoryAccounting.
+	MemoryUsage knownMemoryUsage() const;
+	/// Forgets what our peers know and the sent transactions that have left the queue.
+	void trimKnown();
+
 	virtual void onStarting() override { startWorking(); }
 	virtual void onStopping() override { stopWorking(); }
 
@@ -139,6 +145,8 @@ private:
 
 	std::shared_ptr<EthereumHostDataFace> m_hostData;
 	std::shared_ptr<EthereumPeerObserverFace> m_peerObserver;
+
+	MemoryAccounting::Handle m_memoryReport;
 };
 
 }
@@ -23,6 +23,7 @@
 #include <json/json.h>
 #endif
 #include <libdevcore/CommonIO.h>
+#include <libdevcore/Metrics.h>
 #include <libevm/VMFactory.h>
 #include <libevm/VM.h>
 #include <libethcore/CommonJS.h>
@@ -253,9 +254,9 @@ bool Executive::execute()
 	m_s.subBalance(m_t.sender(), m_gasCost);
 
 	if (m_t.isCreation())
-		return create(m_t.sender(), m_t.value(), m_t.gasPrice(), m_t.gas() - (u256)m_baseGasRequired, &m_t.data(), m_t.sender());
+		return create(m_t.sender(), m_t.value(), m_t.gasPrice(), m_t.gas() - (u256)m_baseGasRequired, m_t.data(), m_t.sender());
 	else
-		return call(m_t.receiveAddress(), m_t.sender(), m_t.value(), m_t.gasPrice(), bytesConstRef(&m_t.data()), m_t.gas() - (u256)m_baseGasRequired);
+		return call(m_t.receiveAddress(), m_t.sender(), m_t.value(), m_t.gasPrice(), m_t.data(), m_t.gas() - (u256)m_baseGasRequired);
 }
 
 bool Executive::call(Address _receiveAddress, Address _senderAddress, u256 _value, u256 _gasPrice, bytesConstRef _data, u256 _gas)
@@ -385,6 +386,7 @@ OnOpFunc Executive::simpleTrace()
 
 bool Executive::go(OnOpFunc const& _onOp)
 {
+	DEV_METERED_SCOPE("executive.go");
 	if (m_ext)
 	{
 #if ETH_TIMED_EXECUTIONS
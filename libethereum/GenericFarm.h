@@ -152,8 +152,9 @@ public:
 	 * @brief Provides a valid header based upon that received previously with setWork().
 	 * @param _bi The now-valid header.
 	 * @return true if the header was good and that the Farm should pause until more work is submitted.
+	 * Miners call a copy of the handler, so one still running when it is replaced finishes undisturbed.
 	 */
-	void onSolutionFound(SolutionFound const& _handler) { m_onSolutionFound = _handler; }
+	void onSolutionFound(SolutionFound const& _handler) { Guard l(x_onSolutionFound); m_onSolutionFound = _handler; }
 
 	WorkPackage work() const { ReadGuard l(x_minerWork); return m_work; }
 
@@ -165,7 +166,10 @@ public:
 	 */
 	bool submitProof(Solution const& _s, Miner* _m) override
 	{
-		if (m_onSolutionFound && m_onSolutionFound(_s))
+		SolutionFound onSolutionFound;
+		DEV_GUARDED(x_onSolutionFound)
+			onSolutionFound = m_onSolutionFound;
+		if (onSolutionFound && onSolutionFound(_s))
 			if (x_minerWork.try_lock())
 			{
 				for (std::shared_ptr<Miner> const& m: m_miners)
@@ -194,6 +198,7 @@ private:
 	mutable WorkingProgress m_progress;
 	std::chrono::steady_clock::time_point m_lastStart;
 
+	Mutex x_onSolutionFound;
 	SolutionFound m_onSolutionFound;
 
 	std::map<std::string, SealerDescriptor> m_sealers;
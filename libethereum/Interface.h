@@ -37,6 +37,7 @@ namespace eth
 {
 
 struct SyncStatus;
+class ChainEventBus;
 
 using TransactionHashes = h256s;
 using UncleHashes = h256s;
@@ -95,6 +96,10 @@ public:
 	ExecutionResult call(Secret const& _secret, u256 _value, Address _dest, bytes const& _data, u256 _gas, u256 _gasPrice, BlockNumber _blockNumber, FudgeFactor _ff = FudgeFactor::Strict) { return call(toAddress(_secret), _value, _dest, _data, _gas, _gasPrice, _blockNumber, _ff); }
 	ExecutionResult call(Secret const& _secret, u256 _value, Address _dest, bytes const& _data, u256 _gas, u256 _gasPrice, FudgeFactor _ff = FudgeFactor::Strict) { return call(toAddress(_secret), _value, _dest, _data, _gas, _gasPrice, _ff); }
 
+	/// Makes each of the given calls against one copy of the state at @a _blockNumber; every call starts from that
+	/// same state. Nothing is recorded into the state. A call that fails gets a default ExecutionResult.
+	virtual std::vector<ExecutionResult> callMany(std::vector<TransactionSkeleton> const& _calls, BlockNumber _blockNumber, FudgeFactor _ff = FudgeFactor::Strict) = 0;
+
 	/// Does the given creation. Nothing is recorded into the state.
 	/// @returns the pair of the Address of the created contract together with its code.
 	virtual ExecutionResult create(Address const& _from, u256 _value, bytes const& _data, u256 _gas, u256 _gasPrice, BlockNumber _blockNumber, FudgeFactor _ff = FudgeFactor::Strict) = 0;
@@ -240,6 +245,9 @@ public:
 	/// Get the seal engine.
 	virtual SealEngineFace* sealEngine() const { return nullptr; }
 
+	/// Get the bus on which chain and pending-transaction events are pushed, if this client publishes them.
+	virtual ChainEventBus* chainEvents() { return nullptr; }
+
 protected:
 	int m_default = PendingBlock;
 };
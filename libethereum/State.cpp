@@ -26,6 +26,7 @@
 #include <boost/timer.hpp>
 #include <libdevcore/CommonIO.h>
 #include <libdevcore/Assertions.h>
+#include <libdevcore/TrieScan.h>
 #ifndef Anomaly_BUILD
 #include <libdevcore/TrieHash.h>
 #endif
@@ -51,6 +52,8 @@ const char* StateDetail::name() { return EthViolet "⚙" EthWhite " ◌"; }
 const char* StateTrace::name() { return EthViolet "⚙" EthGray " ◎"; }
 const char* StateChat::name() { return EthViolet "⚙" EthWhite " ◌"; }
 
+atomic<size_t> State::s_cacheLimit{1000};
+
 State::State(u256 const& _accountStartNonce, OverlayDB const& _db, BaseState _bs):
 	m_db(_db),
 	m_state(&m_db),
@@ -191,8 +194,7 @@ Account* State::account(Address const& _addr)
 
 void State::clearCacheIfTooLarge() const
 {
-	// TODO: Find a good magic number
-	while (m_unchangedCacheEntries.size() > 1000)
+	while (m_unchangedCacheEntries.size() > s_cacheLimit)
 	{
 		// Remove a random element
 		size_t const randomIndex = boost::random::uniform_int_distribution<size_t>(0, m_unchangedCacheEntries.size() - 1)(dev::s_fixedHashEngine);
@@ -207,6 +209,20 @@ void State::clearCacheIfTooLarge() const
 	}
 }
 
+MemoryUsage State::cacheUsage() const
+{
+	// Hash map nodes come on top of the entries themselves.
+	MemoryUsage ret;
+	ret.items = m_cache.size() + m_nonExistingAccountsCache.size();
+	ret.bytes = m_cache.size() * (sizeof(Address) + sizeof(Account) + 32) + m_nonExistingAccountsCache.size() * (sizeof(Address) + 48) + m_unchangedCacheEntries.size() * sizeof(Address);
+	for (auto const& i: m_cache)
+	{
+		ret.bytes += i.second.storageOverlay().size() * 96 + i.second.code().size();
+		ret.items += i.second.storageOverlay().size();
+	}
+	return ret;
+}
+
 void State::commit(CommitBehaviour _commitBehaviour)
 {
 	if (_commitBehaviour == CommitBehaviour::RemoveEmptyAccounts)
@@ -217,16 +233,20 @@ void State::commit(CommitBehaviour _commitBehaviour)
 	m_unchangedCacheEntries.clear();
 }
 
-unordered_map<Address, u256> State::addresses() const
+unordered_map<Address, u256> State::addresses(unsigned _readers) const
 {
 #if ETH_FATDB
 	unordered_map<Address, u256> ret;
 	for (auto& i: m_cache)
 		if (i.second.isAlive())
 			ret[i.first] = i.second.balance();
-	for (auto const& i: m_state)
-		if (m_cache.find(i.first) == m_cache.end())
-			ret[i.first] = RLP(i.second)[1].toInt<u256>();
+	TrieScan<OverlayDB>(m_db, m_state.root(), TrieRange(), _readers).run([&](bytesConstRef _hashedAddress, bytesConstRef _account)
+	{
+		Address const a(m_db.lookupAux(h256(_hashedAddress)));
+		if (m_cache.find(a) == m_cache.end())
+			ret[a] = RLP(_account)[1].toInt<u256>();
+		return true;
+	});
 	return ret;
 #else
 	BOOST_THROW_EXCEPTION(InterfaceNotSupported("State::addresses()"));
@@ -376,36 +396,46 @@ void State::setStorage(Address const& _contract, u256 const& _key, u256 const& _
 }
 
 map<h256, pair<u256, u256>> State::storage(Address const& _id) const
+{
+	return storage(_id, h256(), numeric_limits<unsigned>::max());
+}
+
+map<h256, pair<u256, u256>> State::storage(Address const& _id, h256 const& _begin, unsigned _maxResults, unsigned _readers) const
 {
 	map<h256, pair<u256, u256>> ret;
+	Account const* a = account(_id);
+	if (!a || !_maxResults)
+		return ret;
 
-	if (Account const* a = account(_id))
+	// Cached storage goes over the top of what's in the trie.
+	map<h256, pair<u256, u256>> overlay;
+	for (auto const& i: a->storageOverlay())
 	{
-		// Pull out all values from trie storage.
-		if (h256 root = a->baseRoot())
-		{
-			SecureTrieDB<h256, OverlayDB> memdb(const_cast<OverlayDB*>(&m_db), root);		// promise we won't alter the overlay! :)
+		h256 const key = i.first;
+		h256 const hashedKey = sha3(key);
+		if (hashedKey >= _begin)
+			overlay[hashedKey] = i;
+	}
 
-			for (auto it = memdb.hashedBegin(); it != memdb.hashedEnd(); ++it)
+	// Pull out values from trie storage until there are enough besides those cached.
+	if (h256 root = a->baseRoot())
+		TrieScan<OverlayDB>(m_db, root, TrieRange{_begin.asBytes(), bytes()}, _readers).run([&](bytesConstRef _hashedKey, bytesConstRef _value)
+		{
+			h256 const hashedKey(_hashedKey);
+			if (!overlay.count(hashedKey))
 			{
-				h256 const hashedKey((*it).first);
-				u256 const key = h256(it.key());
-				u256 const value = RLP((*it).second).toInt<u256>();
-				ret[hashedKey] = make_pair(key, value);
+				u256 const key = h256(m_db.lookupAux(hashedKey));
+				ret[hashedKey] = make_pair(key, RLP(_value).toInt<u256>());
 			}
-		}
-
-		// Then merge cached storage over the top.
-		for (auto const& i : a->storageOverlay())
-		{
-			h256 const key = i.first;
-			h256 const hashedKey = sha3(key);
-			if (i.second)
-				ret[hashedKey] = i;
-			else
-				ret.erase(hashedKey);
-		}
-	}
+			return ret.size() < _maxResults;
+		});
+
+	for (auto const& i: overlay)
+		if (i.second.second)
+			ret.insert(i);
+	// Anything past the first _maxResults may have come before trie entries that weren't read.
+	while (ret.size() > _maxResults)
+		ret.erase(prev(ret.end()));
 	return ret;
 }
 
@@ -22,6 +22,7 @@
 #pragma once
 
 #include <array>
+#include <atomic>
 #include <unordered_map>
 #include <libdevcore/Common.h>
 #include <libdevcore/RLP.h>
@@ -195,13 +196,20 @@ public:
 	OverlayDB const& db() const { return m_db; }
 	OverlayDB& db() { return m_db; }
 
+	/// @returns roughly how much memory the account cache takes, storage overlays and code included.
+	MemoryUsage cacheUsage() const;
+
+	/// Sets how many unchanged accounts a State keeps cached before it starts purging them (1000 by default).
+	static void setCacheLimit(size_t _accounts) { s_cacheLimit = _accounts; }
+
 	/// Populate the state from the given AccountMap. Just uses dev::eth::commit().
 	void populateFrom(AccountMap const& _map);
 
 	/// @returns the set containing all addresses currently in use in Ethereum.
 	/// @warning This is slowslowslow. Don't use it unless you want to lock the object for seconds or minutes at a time.
+	/// @param _readers threads reading the state trie ahead of the walk; see TrieScan.
 	/// @throws InterfaceNotSupported if compiled without ETH_FATDB.
-	std::unordered_map<Address, u256> addresses() const;
+	std::unordered_map<Address, u256> addresses(unsigned _readers = 0) const;
 
 	/// Execute a given transaction.
 	/// This will change the state accordingly.
@@ -263,6 +271,11 @@ public:
 	/// @returns map of hashed keys to key-value pairs or empty map if no account exists at that address.
 	std::map<h256, std::pair<u256, u256>> storage(Address const& _contract) const;
 
+	/// Get at most @a _maxResults entries of the storage of an account, starting at the hashed key @a _begin.
+	/// Only reads as much of the storage trie as it needs, ahead of time with @a _readers threads (see TrieScan).
+	/// @returns map of hashed keys to key-value pairs or empty map if no account exists at that address.
+	std::map<h256, std::pair<u256, u256>> storage(Address const& _contract, h256 const& _begin, unsigned _maxResults, unsigned _readers = 0) const;
+
 	/// Get the code of an account.
 	/// @returns bytes() if no account exists at that address.
 	/// @warning The reference to the code is only valid until the access to
@@ -335,6 +348,8 @@ protected: // Anomaly
 
 	u256 m_accountStartNonce;
 
+	static std::atomic<size_t> s_cacheLimit;
+
 	friend std::ostream& operator<<(std::ostream& _out, State const& _s);
 	std::vector<detail::Change> m_changeLog;
 };
@@ -44,6 +44,7 @@ TransactionQueue::TransactionQueue(unsigned _limit, unsigned _futureLimit):
 			setThreadName("txcheck" + toString(i));
 			this->verifierBody();
 		});
+	m_memoryReport = MemoryAccounting::get().add("txqueue", [this]() { return memoryUsage(); }, [this]() { trim(); });
 }
 
 TransactionQueue::~TransactionQueue()
@@ -371,6 +372,41 @@ void TransactionQueue::clear()
 	m_futureSize = 0;
 }
 
+MemoryUsage TransactionQueue::memoryUsage() const
+{
+	// A transaction costs its payload plus the decoded fields and the entries of the indices referring to it.
+	static const uint64_t c_overhead = sizeof(Transaction) + 192;
+	MemoryUsage ret;
+	DEV_READ_GUARDED(m_lock)
+	{
+		for (auto const& t: m_current)
+			ret.bytes += t.transaction.data().size() + c_overhead;
+		for (auto const& a: m_future)
+			for (auto const& t: a.second)
+				ret.bytes += t.second.transaction.data().size() + c_overhead;
+		ret.bytes += (m_known.size() + m_dropped.size()) * 64;
+		ret.items = m_current.size() + m_futureSize + m_dropped.size();
+	}
+	DEV_GUARDED(x_queue)
+	{
+		for (auto const& t: m_unverified)
+			ret.bytes += t.transaction.size() + sizeof(UnverifiedTransaction);
+		ret.items += m_unverified.size();
+	}
+	return ret;
+}
+
+void TransactionQueue::trim()
+{
+	WriteGuard l(m_lock);
+	m_dropped.clear();
+	for (auto const& a: m_future)
+		for (auto const& t: a.second)
+			m_known.erase(t.second.transaction.sha3());
+	m_future.clear();
+	m_futureSize = 0;
+}
+
 void TransactionQueue::enqueue(RLP const& _data, h512 const& _nodeId)
 {
 	bool queued = false;
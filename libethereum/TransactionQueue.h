@@ -28,6 +28,7 @@
 #include <libdevcore/Common.h>
 #include <libdevcore/Guards.h>
 #include <libdevcore/Log.h>
+#include <libdevcore/MemoryAccounting.h>
 #include <libethcore/Common.h>
 #include "Transaction.h"
 
@@ -189,6 +190,11 @@ private:
 	u256 maxNonce_WITH_LOCK(Address const& _a) const;
 	void verifierBody();
 
+	/// Memory held by the queue, reported to MemoryAccounting.
+	MemoryUsage memoryUsage() const;
+	/// Forgets dropped transactions and drops the future ones, to make room when over the memory soft limit.
+	void trim();
+
 	mutable SharedMutex m_lock;													///< General lock.
 	h256Hash m_known;															///< Headers of transactions in both sets.
 
@@ -212,6 +218,8 @@ private:
 	std::deque<UnverifiedTransaction> m_unverified;								///< Pending verification queue
 	mutable Mutex x_queue;														///< Verification queue mutex
 	std::atomic<bool> m_aborting = {false};										///< Exit condition for verifier.
+
+	MemoryAccounting::Handle m_memoryReport;
 };
 
 }
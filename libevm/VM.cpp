@@ -82,6 +82,8 @@ uint64_t VM::decodeJumpvDest(const byte* const _code, uint64_t& _pc, u256*& _sp)
 //
 void VM::onOperation()
 {
+	if (m_profile)
+		m_profile->record(m_OP, m_PC, m_runGas);
 	if (m_onOp)
 		(m_onOp)(++m_nSteps, m_PC, m_OP,
 			m_newMemSize > m_mem.size() ? (m_newMemSize - m_mem.size()) / 32 : uint64_t(0),
@@ -168,11 +170,14 @@ owning_bytes_ref VM::exec(u256& _io_gas, ExtVMFace& _ext, OnOpFunc const& _onOp)
 	m_schedule = &m_ext->evmSchedule();
 	m_onOp = _onOp;
 	m_onFail = &VM::onOperation;
+	if (VMProfiler::enabled())
+		m_profile.reset(new VMProfiler::Run(_ext.codeHash, _ext.code.size()));
+	m_traced = m_onOp || m_profile;
 	
 	try
 	{
 		// trampoline to minimize depth of call stack when calling out
-		m_bounce = &VM::initEntry;
+		m_bounce = m_threaded ? &VM::initThreadedEntry : &VM::initEntry;
 		do
 			(this->*m_bounce)();
 		while (m_bounce);
@@ -181,10 +186,12 @@ owning_bytes_ref VM::exec(u256& _io_gas, ExtVMFace& _ext, OnOpFunc const& _onOp)
 	catch (...)
 	{
 		*io_gas = m_io_gas;
+		m_profile.reset();
 		throw;
 	}
 
 	*io_gas = m_io_gas;
+	m_profile.reset();
 	return std::move(m_output);
 }
 
@@ -28,6 +28,7 @@
 #include <libdevcore/SHA3.h>
 #include <libethcore/BlockHeader.h>
 #include "VMFace.h"
+#include "VMProfiler.h"
 
 namespace dev
 {
@@ -54,12 +55,60 @@ struct InstructionMetric
 	int ret;
 };
 
+/// Handlers of the threaded interpreter: one per instruction or family of instructions,
+/// then the fused sequences of instructions.
+enum class ThreadedCode: uint8_t
+{
+	STOP, ADD, MUL, SUB, DIV, SDIV, MOD, SMOD, ADDMOD, MULMOD, EXP, SIGNEXTEND,
+	LT, GT, SLT, SGT, EQ, ISZERO, AND, OR, XOR, NOT, BYTE, SHA3,
+	ADDRESS, BALANCE, ORIGIN, CALLER, CALLVALUE, CALLDATALOAD, CALLDATASIZE, CALLDATACOPY,
+	CODESIZE, CODECOPY, GASPRICE, EXTCODESIZE, EXTCODECOPY,
+	BLOCKHASH, COINBASE, TIMESTAMP, NUMBER, DIFFICULTY, GASLIMIT,
+	POP, MLOAD, MSTORE, MSTORE8, SLOAD, SSTORE, JUMP, JUMPI, PC, MSIZE, GAS, JUMPDEST,
+	PUSH, DUP, SWAP, LOG, CREATE, CALL, RETURN, SUICIDE, INVALID,
+	PUSH_JUMP,            ///< PUSH to a valid JUMPDEST; JUMP
+	PUSH_JUMPI,           ///< PUSH to a valid JUMPDEST; JUMPI
+	ISZERO_PUSH_JUMPI,    ///< ISZERO; PUSH to a valid JUMPDEST; JUMPI
+	PUSH_MLOAD,           ///< PUSH of a 32-bit offset; MLOAD
+	PUSH_MSTORE,          ///< PUSH of a 32-bit offset; MSTORE
+	DUP_SWAP,             ///< DUPn; SWAPm
+	Count
+};
+
+/// An instruction, or a fused sequence of them, of the code as translated for the threaded interpreter.
+/// Stack bounds and static gas are those of the whole sequence.
+struct ThreadedOp
+{
+	void const* handler;  ///< Label of the handler, with computed-goto dispatch.
+	uint64_t arg;         ///< Constant index, jump target index, memory offset or DUP/SWAP/LOG operand.
+	uint32_t pc;          ///< Code offset of the (first) instruction.
+	uint32_t gas;         ///< Tier gas.
+	uint16_t minStack;
+	uint16_t maxStack;
+	ThreadedCode code;
+	Instruction op;       ///< The (first) instruction.
+};
+
+/// Code as translated for the threaded interpreter. Never changed once built, so that VMs on any
+/// thread running the same code under the same schedule share one translation.
+struct ThreadedProgram
+{
+	std::vector<ThreadedOp> ops;
+	std::vector<u256> constants;        ///< PUSH constants, indexed by ThreadedOp::arg.
+	std::vector<uint64_t> jumpDests;    ///< Code offsets of the JUMPDESTs, ascending.
+	std::vector<uint64_t> jumpDestOps;  ///< Index in ops of each of jumpDests.
+};
+
 
 /**
  */
 class VM: public VMFace
 {
 public:
+	/// @a _threaded selects the direct-threaded interpreter, which runs the code translated once into
+	/// pre-decoded handlers with resolved jumps and fused common sequences, instead of the bytecode.
+	explicit VM(bool _threaded = false): m_threaded(_threaded) {}
+
 	virtual owning_bytes_ref exec(u256& io_gas, ExtVMFace& _ext, OnOpFunc const& _onOp) override final;
 
 #if EVM_JUMPS_AND_SUBS
@@ -71,12 +120,20 @@ public:
 	bytes const& memory() const { return m_mem; }
 	u256s stack() const { assert(m_stack <= m_SP + 1); return u256s(m_stack, m_SP + 1); };
 
+	/// @returns how many runs of the threaded interpreter found their code already translated, since process start.
+	static uint64_t translationsReused();
+	/// @returns how many runs of the threaded interpreter translated their code for later runs to share, since process start.
+	static uint64_t translationsMade();
+
 private:
 
 	u256* io_gas = 0;
 	uint64_t m_io_gas = 0;
 	ExtVMFace* m_ext = 0;
 	OnOpFunc m_onOp;
+	std::unique_ptr<VMProfiler::Run> m_profile;	///< Only while profiling.
+	bool m_threaded = false;
+	bool m_traced = false;                      ///< Every instruction goes to onOperation().
 
 	static std::array<InstructionMetric, 256> c_metrics;
 	static void initMetrics();
@@ -88,6 +145,7 @@ private:
 	typedef void (VM::*MemFnPtr)();
 	MemFnPtr m_bounce = 0;
 	MemFnPtr m_onFail = 0;
+	MemFnPtr m_interpreter = 0;	///< Where to bounce back to after calling out.
 	uint64_t m_nSteps = 0;
 	EVMSchedule const* m_schedule = nullptr;
 
@@ -118,6 +176,11 @@ private:
 	// constant pool
 	u256 m_pool[256];
 
+	// translated code and the index of the op resumed after calling out
+	std::shared_ptr<ThreadedProgram const> m_program;
+	uint64_t m_ip = 0;
+	const void* const* c_threadedTable = 0;
+
 	// interpreter state
 	Instruction m_OP;                   // current operator
 	uint64_t    m_PC = 0;               // program counter
@@ -134,9 +197,12 @@ private:
 	// initialize interpreter
 	void initEntry();
 	void optimize();
+	void initThreadedEntry();
+	std::shared_ptr<ThreadedProgram const> translate() const;
 
 	// interpreter loop & switch
 	void interpretCases();
+	void interpretThreaded();
 
 	// interpreter cases that call out
 	void caseCreate();
@@ -156,6 +222,8 @@ private:
 	std::vector<uint64_t> m_beginSubs;
 	std::vector<uint64_t> m_jumpDests;
 	int64_t verifyJumpDest(u256 const& _dest, bool _throw = true);
+	uint64_t threadedJumpTarget(u256 const& _dest);
+	void throwThreadedBadStack(ThreadedOp const* _op);
 
 	int poolConstant(const u256&);
 
@@ -98,7 +98,7 @@ int64_t VM::verifyJumpDest(u256 const& _dest, bool _throw)
 
 void VM::caseCreate()
 {
-	m_bounce = &VM::interpretCases;
+	m_bounce = m_interpreter;
 	m_newMemSize = memNeed(*(m_SP - 1), *(m_SP - 2));
 	m_runGas = toInt63(m_schedule->createGas);
 	updateMem();
@@ -129,7 +129,7 @@ void VM::caseCreate()
 
 void VM::caseCall()
 {
-	m_bounce = &VM::interpretCases;
+	m_bounce = m_interpreter;
 	unique_ptr<CallParameters> callParams(new CallParameters());
 	bytesRef output;
 	if (caseCallSetup(callParams.get(), output))
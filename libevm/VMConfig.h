@@ -27,6 +27,9 @@ namespace eth
 // EVM_SWITCH_DISPATCH    - dispatch via loop and switch
 // EVM_JUMP_DISPATCH      - dispatch via a jump table - available only on GCC
 //
+// EVM_THREADED_GOTO      - threaded interpreter dispatches via computed goto rather
+//                          than loop and switch - available only on GCC
+//
 // EVM_USE_CONSTANT_POOL  - 256 constants unpacked and ready to assign to stack
 //
 // EVM_REPLACE_CONST_JUMP - with pre-verified jumps to save runtime lookup
@@ -48,6 +51,17 @@ namespace eth
 	#define EVM_SWITCH_DISPATCH
 #endif
 
+#ifndef EVM_THREADED_GOTO
+	#ifdef __GNUC__
+		#define EVM_THREADED_GOTO true
+	#else
+		#define EVM_THREADED_GOTO false
+	#endif
+#endif
+#if EVM_THREADED_GOTO && !defined(__GNUC__)
+	#error "address of label extension avaiable only on Gnu"
+#endif
+
 #ifndef EVM_OPTIMIZE
 	#define EVM_OPTIMIZE true
 #endif
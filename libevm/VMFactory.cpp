@@ -55,10 +55,12 @@ std::unique_ptr<VMFace> VMFactory::create(VMKind _kind)
 		return std::unique_ptr<VMFace>(new JitVM);
 	case VMKind::Smart:
 		return std::unique_ptr<VMFace>(new SmartVM);
+	case VMKind::Threaded:
+		return std::unique_ptr<VMFace>(new VM(true));
 	}
 #else
-	asserts(_kind == VMKind::Interpreter && "JIT disabled in build configuration");
-	return std::unique_ptr<VMFace>(new VM);
+	asserts((_kind == VMKind::Interpreter || _kind == VMKind::Threaded) && "JIT disabled in build configuration");
+	return std::unique_ptr<VMFace>(new VM(_kind == VMKind::Threaded));
 #endif
 }
 
@@ -27,7 +27,8 @@ enum class VMKind
 {
 	Interpreter,
 	JIT,
-	Smart
+	Smart,
+	Threaded	///< Interpreter over the code translated to direct-threaded handlers.
 };
 
 class VMFactory
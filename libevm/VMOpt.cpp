@@ -257,7 +257,7 @@ void VM::optimize()
 //
 void VM::initEntry()
 {
-	m_bounce = &VM::interpretCases; 	
+	m_bounce = m_interpreter = &VM::interpretCases;
 	interpretCases(); // first call initializes jump table
 	initMetrics();
 	optimize();
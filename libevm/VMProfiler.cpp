@@ -0,0 +1,189 @@
+/*
+	This file is part of cpp-ethereum.
+
+	cpp-ethereum is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	cpp-ethereum is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with cpp-ethereum.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/** @file VMProfiler.cpp
+ * @date 2017
+ */
+
+#include "VMProfiler.h"
+#include <atomic>
+#include <chrono>
+#include <sstream>
+#include <libdevcore/Guards.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+using namespace std;
+using namespace dev;
+using namespace dev::eth;
+
+namespace
+{
+
+atomic<bool> s_enabled{false};
+Mutex x_profile;
+VMProfiler::Profile s_profile;
+unsigned s_generation = 0;
+
+/// The instruction last recorded on this thread, which is charged the cycles until the next one.
+struct Pending
+{
+	VMProfiler::Stats* opcode;
+	VMProfiler::Stats* range;
+	uint64_t stamp;
+};
+thread_local Pending t_pending = {nullptr, nullptr, 0};
+
+inline uint64_t cycles()
+{
+#if defined(__x86_64__) || defined(__i386__)
+	return __rdtsc();
+#else
+	return chrono::steady_clock::now().time_since_epoch().count();
+#endif
+}
+
+}
+
+VMProfiler::Profile& VMProfiler::Profile::operator+=(Profile const& _p)
+{
+	for (unsigned i = 0; i < 256; ++i)
+		opcodes[i] += _p.opcodes[i];
+	for (auto const& c: _p.contracts)
+	{
+		vector<Stats>& ranges = contracts[c.first];
+		if (ranges.size() < c.second.size())
+			ranges.resize(c.second.size());
+		for (size_t i = 0; i < c.second.size(); ++i)
+			ranges[i] += c.second[i];
+	}
+	return *this;
+}
+
+map<h256, VMProfiler::Stats> VMProfiler::Profile::contractTotals() const
+{
+	map<h256, Stats> ret;
+	for (auto const& c: contracts)
+		for (Stats const& s: c.second)
+			ret[c.first] += s;
+	return ret;
+}
+
+string VMProfiler::Profile::folded(Metric _m, bool _byContract) const
+{
+	ostringstream ret;
+	if (_byContract)
+	{
+		for (auto const& c: contracts)
+			for (size_t i = 0; i < c.second.size(); ++i)
+				if (uint64_t v = value(c.second[i], _m))
+					ret << "0x" << c.first.hex() << ";0x" << hex << (i << c_rangeBits) << "-0x" << (((i + 1) << c_rangeBits) - 1) << dec << " " << v << "\n";
+	}
+	else
+		for (unsigned i = 0; i < 256; ++i)
+			if (uint64_t v = value(opcodes[i], _m))
+				ret << instructionInfo(Instruction(i)).name << " " << v << "\n";
+	return ret.str();
+}
+
+VMProfiler::Run::Run(h256 const& _codeHash, size_t _codeSize):
+	m_codeHash(_codeHash),
+	m_ranges((_codeSize >> c_rangeBits) + 1)
+{
+	DEV_GUARDED(x_profile)
+		m_generation = s_generation;
+}
+
+VMProfiler::Run::~Run()
+{
+	// Whatever ran last on this thread gets its cycles now, as it may be ours and about to go.
+	Pending& p = t_pending;
+	if (p.opcode)
+	{
+		uint64_t d = cycles() - p.stamp;
+		p.opcode->cycles += d;
+		p.range->cycles += d;
+		p.opcode = p.range = nullptr;
+	}
+
+	Guard l(x_profile);
+	if (!s_enabled || m_generation != s_generation)
+		return;
+	for (unsigned i = 0; i < 256; ++i)
+		s_profile.opcodes[i] += m_opcodes[i];
+	vector<Stats>& ranges = s_profile.contracts[m_codeHash];
+	if (ranges.size() < m_ranges.size())
+		ranges.resize(m_ranges.size());
+	for (size_t i = 0; i < m_ranges.size(); ++i)
+		ranges[i] += m_ranges[i];
+}
+
+void VMProfiler::Run::record(Instruction _op, uint64_t _pc, uint64_t _gas)
+{
+	uint64_t now = cycles();
+	Pending& p = t_pending;
+	if (p.opcode)
+	{
+		uint64_t d = now - p.stamp;
+		p.opcode->cycles += d;
+		p.range->cycles += d;
+	}
+
+	Stats& o = m_opcodes[(unsigned)_op];
+	++o.count;
+	o.gas += _gas;
+	// Past the end of the code is the implicit STOP.
+	Stats& r = m_ranges[min<uint64_t>(_pc >> c_rangeBits, m_ranges.size() - 1)];
+	++r.count;
+	r.gas += _gas;
+
+	p.opcode = &o;
+	p.range = &r;
+	p.stamp = now;
+}
+
+void VMProfiler::start()
+{
+	Guard l(x_profile);
+	s_profile = Profile();
+	++s_generation;
+	s_enabled = true;
+}
+
+VMProfiler::Profile VMProfiler::stop()
+{
+	Guard l(x_profile);
+	s_enabled = false;
+	++s_generation;
+	Profile ret;
+	swap(ret, s_profile);
+	return ret;
+}
+
+bool VMProfiler::enabled()
+{
+	return s_enabled.load(memory_order_relaxed);
+}
+
+uint64_t VMProfiler::value(Stats const& _s, Metric _m)
+{
+	switch (_m)
+	{
+	case Metric::Instructions: return _s.count;
+	case Metric::Gas: return _s.gas;
+	default: return _s.cycles;
+	}
+}
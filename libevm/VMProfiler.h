@@ -0,0 +1,106 @@
+/*
+	This file is part of cpp-ethereum.
+
+	cpp-ethereum is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	cpp-ethereum is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with cpp-ethereum.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/** @file VMProfiler.h
+ * @date 2017
+ * Instruction, gas and cycle counts of the interpreter per opcode and per code range.
+ */
+
+#pragma once
+
+#include <array>
+#include <map>
+#include <string>
+#include <vector>
+#include <libdevcore/FixedHash.h>
+#include <libevmcore/Instruction.h>
+
+namespace dev
+{
+namespace eth
+{
+
+/**
+ * @brief Profiles every execution of the interpreter between start() and stop(), across threads and nested calls.
+ * The interpreter records each instruction directly, without going through OnOpFunc. Cycles are counted from one
+ * instruction to the next on the same thread, so a CALL or CREATE is charged its setup but not the callee's code;
+ * gas is what the instruction was charged, which for calls and creates includes the gas handed over.
+ * @threadsafe
+ */
+class VMProfiler
+{
+public:
+	struct Stats
+	{
+		Stats& operator+=(Stats const& _s) { count += _s.count; gas += _s.gas; cycles += _s.cycles; return *this; }
+
+		uint64_t count = 0;
+		uint64_t gas = 0;
+		uint64_t cycles = 0;
+	};
+
+	enum class Metric
+	{
+		Instructions,
+		Gas,
+		Cycles
+	};
+
+	/// Contracts are profiled in ranges of 2^c_rangeBits bytes of code.
+	static unsigned const c_rangeBits = 5;
+
+	struct Profile
+	{
+		Profile& operator+=(Profile const& _p);
+
+		/// Stats of every range of a contract added up.
+		std::map<h256, Stats> contractTotals() const;
+
+		/// @returns one "frame;frame value" line per opcode (@a _byContract false) or per code range of each
+		/// contract, as taken by flamegraph.pl and compatible viewers.
+		std::string folded(Metric _m, bool _byContract) const;
+
+		std::array<Stats, 256> opcodes;
+		std::map<h256, std::vector<Stats>> contracts;	///< By code hash, then by code range.
+	};
+
+	/// Counts of a single execution, added to the profile when it goes.
+	class Run
+	{
+	public:
+		Run(h256 const& _codeHash, size_t _codeSize);
+		~Run();
+
+		void record(Instruction _op, uint64_t _pc, uint64_t _gas);
+
+	private:
+		h256 m_codeHash;
+		unsigned m_generation;
+		std::array<Stats, 256> m_opcodes;
+		std::vector<Stats> m_ranges;
+	};
+
+	/// Starts a new profile, dropping any current one.
+	static void start();
+	/// Stops profiling. @returns what was profiled since start().
+	static Profile stop();
+	static bool enabled();
+
+	static uint64_t value(Stats const& _s, Metric _m);
+};
+
+}
+}
@@ -0,0 +1,1158 @@
+/*
+	This file is part of cpp-ethereum.
+
+	cpp-ethereum is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	cpp-ethereum is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with cpp-ethereum.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/** @file VMThreaded.cpp
+ * @date 2017
+ * Direct-threaded interpreter over code translated once on entry.
+ */
+
+#include <libdevcore/RLP.h>
+#include <libdevcore/ShardedCache.h>
+#include <libethereum/ExtVM.h>
+#include "VMConfig.h"
+#include "VM.h"
+using namespace std;
+using namespace dev;
+using namespace dev::eth;
+
+namespace
+{
+
+template <class S> S divWorkaround(S const& _a, S const& _b)
+{
+	return (S)(s512(_a) / s512(_b));
+}
+
+template <class S> S modWorkaround(S const& _a, S const& _b)
+{
+	return (S)(s512(_a) % s512(_b));
+}
+
+bool isPush(Instruction _op)
+{
+	return (byte)Instruction::PUSH1 <= (byte)_op && (byte)_op <= (byte)Instruction::PUSH32;
+}
+
+bool isDup(Instruction _op)
+{
+	return (byte)Instruction::DUP1 <= (byte)_op && (byte)_op <= (byte)Instruction::DUP16;
+}
+
+bool isSwap(Instruction _op)
+{
+	return (byte)Instruction::SWAP1 <= (byte)_op && (byte)_op <= (byte)Instruction::SWAP16;
+}
+
+/// The handler of a single instruction; INVALID for those not to be run from user code.
+ThreadedCode threadedCode(Instruction _op, EVMSchedule const& _schedule)
+{
+	if (isPush(_op))
+		return ThreadedCode::PUSH;
+	if (isDup(_op))
+		return ThreadedCode::DUP;
+	if (isSwap(_op))
+		return ThreadedCode::SWAP;
+	if ((byte)Instruction::LOG0 <= (byte)_op && (byte)_op <= (byte)Instruction::LOG4)
+		return ThreadedCode::LOG;
+
+#define THREADED_CODE(name) case Instruction::name: return ThreadedCode::name;
+	switch (_op)
+	{
+	THREADED_CODE(STOP) THREADED_CODE(ADD) THREADED_CODE(MUL) THREADED_CODE(SUB) THREADED_CODE(DIV)
+	THREADED_CODE(SDIV) THREADED_CODE(MOD) THREADED_CODE(SMOD) THREADED_CODE(ADDMOD) THREADED_CODE(MULMOD)
+	THREADED_CODE(EXP) THREADED_CODE(SIGNEXTEND) THREADED_CODE(LT) THREADED_CODE(GT) THREADED_CODE(SLT)
+	THREADED_CODE(SGT) THREADED_CODE(EQ) THREADED_CODE(ISZERO) THREADED_CODE(AND) THREADED_CODE(OR)
+	THREADED_CODE(XOR) THREADED_CODE(NOT) THREADED_CODE(BYTE) THREADED_CODE(SHA3) THREADED_CODE(ADDRESS)
+	THREADED_CODE(BALANCE) THREADED_CODE(ORIGIN) THREADED_CODE(CALLER) THREADED_CODE(CALLVALUE)
+	THREADED_CODE(CALLDATALOAD) THREADED_CODE(CALLDATASIZE) THREADED_CODE(CALLDATACOPY)
+	THREADED_CODE(CODESIZE) THREADED_CODE(CODECOPY) THREADED_CODE(GASPRICE) THREADED_CODE(EXTCODESIZE)
+	THREADED_CODE(EXTCODECOPY) THREADED_CODE(BLOCKHASH) THREADED_CODE(COINBASE) THREADED_CODE(TIMESTAMP)
+	THREADED_CODE(NUMBER) THREADED_CODE(DIFFICULTY) THREADED_CODE(GASLIMIT) THREADED_CODE(POP)
+	THREADED_CODE(MLOAD) THREADED_CODE(MSTORE) THREADED_CODE(MSTORE8) THREADED_CODE(SLOAD)
+	THREADED_CODE(SSTORE) THREADED_CODE(JUMP) THREADED_CODE(JUMPI) THREADED_CODE(PC) THREADED_CODE(MSIZE)
+	THREADED_CODE(GAS) THREADED_CODE(JUMPDEST) THREADED_CODE(CREATE) THREADED_CODE(RETURN)
+	THREADED_CODE(SUICIDE)
+	case Instruction::CALL:
+	case Instruction::CALLCODE:
+		return ThreadedCode::CALL;
+	case Instruction::DELEGATECALL:
+		// Pre-homestead
+		return _schedule.haveDelegateCall ? ThreadedCode::CALL : ThreadedCode::INVALID;
+	default:
+		return ThreadedCode::INVALID;
+	}
+#undef THREADED_CODE
+}
+
+/// Translations shared by every VM, keyed by translationKey(). Entries never go stale: the key covers
+/// all that translation depends on. Bounded, as a program takes about 32 bytes per instruction.
+ShardedCache<h256, shared_ptr<ThreadedProgram const>>& translations()
+{
+	static ShardedCache<h256, shared_ptr<ThreadedProgram const>> s_translations(16);
+	return s_translations;
+}
+
+/// @returns the key of the translation of the code with hash @a _codeHash: besides the code, translation
+/// only reads the tier gas and DELEGATECALL support of @a _schedule and whether sequences are fused.
+h256 translationKey(h256 const& _codeHash, EVMSchedule const& _schedule, bool _fuse)
+{
+	RLPStream s(4);
+	s << _codeHash << _schedule.haveDelegateCall << _fuse;
+	s.appendList(_schedule.tierStepGas.size());
+	for (unsigned gas: _schedule.tierStepGas)
+		s << gas;
+	return sha3(s.out());
+}
+
+}
+
+
+//
+// translation of the code on entry
+//
+
+void VM::initThreadedEntry()
+{
+	m_bounce = m_interpreter = &VM::interpretThreaded;
+#if EVM_THREADED_GOTO
+	interpretThreaded(); // first call initializes jump table
+#endif
+	initMetrics();
+	m_ip = 0;
+
+	// code without a hash (run directly rather than from an account) is translated for this call only
+	if (!m_ext->codeHash)
+	{
+		m_program = translate();
+		return;
+	}
+	h256 const key = translationKey(m_ext->codeHash, *m_schedule, !m_traced);
+	if (!translations().lookup(key, m_program))
+	{
+		m_program = translate();
+		translations().insert(key, m_program);
+	}
+}
+
+uint64_t VM::translationsReused()
+{
+	return translations().hits();
+}
+
+uint64_t VM::translationsMade()
+{
+	return translations().misses();
+}
+
+shared_ptr<ThreadedProgram const> VM::translate() const
+{
+	bytes const& code = m_ext->code;
+	size_t const nBytes = code.size();
+	auto ret = make_shared<ThreadedProgram>();
+	vector<ThreadedOp>& program = ret->ops;
+	vector<uint64_t>& jumpDests = ret->jumpDests;
+	vector<uint64_t>& jumpDestOps = ret->jumpDestOps;
+
+	// decode instructions and PUSH data, and build the table of jump destinations
+	struct Decoded
+	{
+		uint64_t pc;
+		Instruction op;
+		u256 value;
+	};
+	vector<Decoded> decoded;
+	decoded.reserve(nBytes + 1);
+	size_t pc = 0;
+	for (; pc < nBytes; ++pc)
+	{
+		Instruction op = Instruction(code[pc]);
+		decoded.push_back(Decoded{pc, op, 0});
+		if (isPush(op))
+		{
+			// PUSH data past the end of the code reads as zeros
+			size_t const nPush = (byte)op - (byte)Instruction::PUSH1 + 1;
+			u256& value = decoded.back().value;
+			for (size_t i = pc + 1; i <= pc + nPush; ++i)
+				value = (value << 8) | (i < nBytes ? code[i] : 0);
+			pc += nPush;
+		}
+		else if (op == Instruction::JUMPDEST)
+			jumpDests.push_back(pc);
+	}
+	// running off the end of the code, or of PUSH data past it, stops
+	decoded.push_back(Decoded{pc, Instruction::STOP, 0});
+
+	auto isJumpDest = [&](u256 const& _dest)
+	{
+		return _dest < nBytes && binary_search(jumpDests.begin(), jumpDests.end(), uint64_t(_dest));
+	};
+	auto opAt = [&](size_t _i)
+	{
+		return _i < decoded.size() ? decoded[_i].op : Instruction::STOP;
+	};
+
+	// Fused sequences skip the per-instruction calls of onOperation(), so only fuse when not traced.
+	bool const fuse = !m_traced;
+	program.reserve(decoded.size());
+	for (size_t i = 0; i < decoded.size();)
+	{
+		Instruction const op = decoded[i].op;
+		Instruction const next = opAt(i + 1);
+		ThreadedOp t;
+		t.handler = nullptr;
+		t.pc = uint32_t(decoded[i].pc);
+		t.op = op;
+		size_t n = 1;
+
+		if (fuse && isPush(op) && (next == Instruction::JUMP || next == Instruction::JUMPI) && isJumpDest(decoded[i].value))
+		{
+			// jump targets are resolved to program indices once the program is complete
+			t.code = next == Instruction::JUMP ? ThreadedCode::PUSH_JUMP : ThreadedCode::PUSH_JUMPI;
+			t.arg = uint64_t(decoded[i].value);
+			n = 2;
+		}
+		else if (fuse && op == Instruction::ISZERO && isPush(next) && opAt(i + 2) == Instruction::JUMPI && isJumpDest(decoded[i + 1].value))
+		{
+			t.code = ThreadedCode::ISZERO_PUSH_JUMPI;
+			t.arg = uint64_t(decoded[i + 1].value);
+			n = 3;
+		}
+		else if (fuse && isPush(op) && (next == Instruction::MLOAD || next == Instruction::MSTORE) && decoded[i].value <= 0xFFFFFFFF)
+		{
+			t.code = next == Instruction::MLOAD ? ThreadedCode::PUSH_MLOAD : ThreadedCode::PUSH_MSTORE;
+			t.arg = uint64_t(decoded[i].value);
+			n = 2;
+		}
+		else if (fuse && isDup(op) && isSwap(next))
+		{
+			t.code = ThreadedCode::DUP_SWAP;
+			t.arg = ((byte)op - (byte)Instruction::DUP1 + 1) | ((byte)next - (byte)Instruction::SWAP1 + 1) << 8;
+			n = 2;
+		}
+		else
+		{
+			t.code = threadedCode(op, *m_schedule);
+			if (t.code == ThreadedCode::PUSH)
+			{
+				t.arg = ret->constants.size();
+				ret->constants.push_back(decoded[i].value);
+			}
+			else if (t.code == ThreadedCode::DUP)
+				t.arg = (byte)op - (byte)Instruction::DUP1 + 1;
+			else if (t.code == ThreadedCode::SWAP)
+				t.arg = (byte)op - (byte)Instruction::SWAP1 + 1;
+			else if (t.code == ThreadedCode::LOG)
+				t.arg = (byte)op - (byte)Instruction::LOG0;
+			else
+				t.arg = 0;
+			if (op == Instruction::JUMPDEST)
+				jumpDestOps.push_back(program.size());
+		}
+
+		// stack bounds and tier gas of the whole sequence
+		int minStack = 0;
+		int delta = 0;
+		int maxDelta = 0;
+		unsigned gas = 0;
+		if (t.code != ThreadedCode::INVALID)
+			for (size_t j = i; j < i + n; ++j)
+			{
+				InstructionMetric const& metric = c_metrics[(size_t)decoded[j].op];
+				minStack = max(minStack, metric.args - delta);
+				delta += metric.ret - metric.args;
+				maxDelta = max(maxDelta, delta);
+				if (metric.gasPriceTier < Tier::Special)
+					gas += m_schedule->tierStepGas[(unsigned)metric.gasPriceTier];
+			}
+		t.minStack = uint16_t(minStack);
+		t.maxStack = uint16_t(1024 - maxDelta);
+		t.gas = gas;
+#if EVM_THREADED_GOTO
+		t.handler = c_threadedTable[(size_t)t.code];
+#endif
+		program.push_back(t);
+		i += n;
+	}
+	assert(jumpDestOps.size() == jumpDests.size());
+
+	for (ThreadedOp& t: program)
+		if (t.code == ThreadedCode::PUSH_JUMP || t.code == ThreadedCode::PUSH_JUMPI || t.code == ThreadedCode::ISZERO_PUSH_JUMPI)
+			t.arg = jumpDestOps[lower_bound(jumpDests.begin(), jumpDests.end(), t.arg) - jumpDests.begin()];
+	return ret;
+}
+
+uint64_t VM::threadedJumpTarget(u256 const& _dest)
+{
+	if (_dest <= 0x7FFFFFFFFFFFFFFF)
+	{
+		vector<uint64_t> const& jumpDests = m_program->jumpDests;
+		auto it = lower_bound(jumpDests.begin(), jumpDests.end(), uint64_t(_dest));
+		if (it != jumpDests.end() && *it == uint64_t(_dest))
+			return m_program->jumpDestOps[it - jumpDests.begin()];
+	}
+	throwBadJumpDestination();
+	return 0;
+}
+
+void VM::throwThreadedBadStack(ThreadedOp const* _op)
+{
+	m_PC = _op->pc;
+	m_OP = _op->op;
+	// in the terms of checkStack(): too few for minStack, or too many once added
+	unsigned size = unsigned(1 + m_SP - m_stack);
+	throwBadStack(size, _op->minStack, _op->minStack + 1024 - _op->maxStack);
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// threaded interpreter dispatch
+//
+#if EVM_THREADED_GOTO
+	#define THREADED_CASE(name) T_##name:
+	#define THREADED_DEFAULT
+	#define THREADED_DISPATCH goto *ip->handler;
+	#define THREADED_DO_CASES THREADED_DISPATCH
+	#define THREADED_WHILE_CASES
+#else
+	#define THREADED_CASE(name) case ThreadedCode::name:
+	#define THREADED_DEFAULT default:
+	#define THREADED_DISPATCH continue;
+	#define THREADED_DO_CASES for (;;) switch (ip->code) {
+	#define THREADED_WHILE_CASES }
+#endif
+#define THREADED_NEXT ++ip; THREADED_DISPATCH
+#define THREADED_JUMP(target) ip = program + (target); THREADED_DISPATCH
+
+// stack bounds and tier gas of the op, before anything it charges on top
+#define THREADED_BEGIN \
+	{ \
+		ptrdiff_t const size = 1 + m_SP - m_stack; \
+		if (size < ip->minStack || size > ip->maxStack) \
+			throwThreadedBadStack(ip); \
+	} \
+	m_runGas = ip->gas;
+
+#define THREADED_ON_OP() \
+	if (m_traced) \
+	{ \
+		m_PC = ip->pc; \
+		m_OP = ip->op; \
+		onOperation(); \
+	}
+
+#define THREADED_GAS() THREADED_ON_OP(); updateIOGas();
+
+// hand over to the out-of-line CREATE and CALL cases, resuming with the next op
+#define THREADED_CALL_OUT(fn) \
+	m_PC = ip->pc; \
+	m_OP = ip->op; \
+	m_newMemSize = m_mem.size(); \
+	m_copyMemSize = 0; \
+	m_ip = ip - program + 1; \
+	m_bounce = &VM::fn; \
+	return;
+
+void VM::interpretThreaded()
+{
+#if EVM_THREADED_GOTO
+	static void const* const jumpTable[] =
+	{
+		&&T_STOP, &&T_ADD, &&T_MUL, &&T_SUB, &&T_DIV, &&T_SDIV, &&T_MOD, &&T_SMOD, &&T_ADDMOD, &&T_MULMOD, &&T_EXP, &&T_SIGNEXTEND,
+		&&T_LT, &&T_GT, &&T_SLT, &&T_SGT, &&T_EQ, &&T_ISZERO, &&T_AND, &&T_OR, &&T_XOR, &&T_NOT, &&T_BYTE, &&T_SHA3,
+		&&T_ADDRESS, &&T_BALANCE, &&T_ORIGIN, &&T_CALLER, &&T_CALLVALUE, &&T_CALLDATALOAD, &&T_CALLDATASIZE, &&T_CALLDATACOPY,
+		&&T_CODESIZE, &&T_CODECOPY, &&T_GASPRICE, &&T_EXTCODESIZE, &&T_EXTCODECOPY,
+		&&T_BLOCKHASH, &&T_COINBASE, &&T_TIMESTAMP, &&T_NUMBER, &&T_DIFFICULTY, &&T_GASLIMIT,
+		&&T_POP, &&T_MLOAD, &&T_MSTORE, &&T_MSTORE8, &&T_SLOAD, &&T_SSTORE, &&T_JUMP, &&T_JUMPI, &&T_PC, &&T_MSIZE, &&T_GAS, &&T_JUMPDEST,
+		&&T_PUSH, &&T_DUP, &&T_SWAP, &&T_LOG, &&T_CREATE, &&T_CALL, &&T_RETURN, &&T_SUICIDE, &&T_INVALID,
+		&&T_PUSH_JUMP, &&T_PUSH_JUMPI, &&T_ISZERO_PUSH_JUMPI, &&T_PUSH_MLOAD, &&T_PUSH_MSTORE, &&T_DUP_SWAP,
+	};
+	static_assert(sizeof(jumpTable) / sizeof(jumpTable[0]) == (size_t)ThreadedCode::Count, "Threaded jump table out of step with ThreadedCode");
+	if (!c_threadedTable)
+	{
+		c_threadedTable = jumpTable;
+		return;
+	}
+#endif
+
+	ThreadedOp const* const program = m_program->ops.data();
+	ThreadedOp const* ip = program + m_ip;
+	u256 const* const constants = m_program->constants.data();
+
+	THREADED_DO_CASES
+	{
+		//
+		// Call-related instructions
+		//
+
+		THREADED_CASE(CREATE)
+		{
+			THREADED_BEGIN
+			THREADED_CALL_OUT(caseCreate)
+		}
+
+		THREADED_CASE(CALL)
+		{
+			THREADED_BEGIN
+			THREADED_CALL_OUT(caseCall)
+		}
+
+		THREADED_CASE(RETURN)
+		{
+			THREADED_BEGIN
+			m_copyMemSize = 0;
+			m_newMemSize = memNeed(*m_SP, *(m_SP - 1));
+			updateMem();
+			THREADED_GAS();
+
+			size_t b = (size_t)*m_SP--;
+			size_t s = (size_t)*m_SP--;
+			m_output = owning_bytes_ref{std::move(m_mem), b, s};
+			m_bounce = 0;
+		}
+		return;
+
+		THREADED_CASE(SUICIDE)
+		{
+			THREADED_BEGIN
+			m_runGas = toInt63(m_schedule->suicideGas);
+			Address dest = asAddress(*m_SP);
+
+			// After EIP158 zero-value suicides do not have to pay account creation gas.
+			if (m_ext->balance(m_ext->myAddress) > 0 || m_schedule->zeroValueTransferChargesNewAccountGas())
+				// After EIP150 hard fork charge additional cost of sending
+				// ethers to non-existing account.
+				if (m_schedule->suicideChargesNewAccountGas() && !m_ext->exists(dest))
+					m_runGas += m_schedule->callNewAccountGas;
+
+			THREADED_GAS();
+			m_ext->suicide(dest);
+			m_bounce = 0;
+		}
+		return;
+
+		THREADED_CASE(STOP)
+		{
+			THREADED_BEGIN
+			THREADED_GAS();
+			m_bounce = 0;
+		}
+		return;
+
+		//
+		// instructions potentially expanding memory
+		//
+
+		THREADED_CASE(MLOAD)
+		{
+			THREADED_BEGIN
+			m_copyMemSize = 0;
+			m_newMemSize = toInt63(*m_SP) + 32;
+			updateMem();
+			THREADED_GAS();
+
+			*m_SP = (u256)*(h256 const*)(m_mem.data() + (unsigned)*m_SP);
+		}
+		THREADED_NEXT
+
+		THREADED_CASE(MSTORE)
+		{
+			THREADED_BEGIN
+			m_copyMemSize = 0;
+			m_newMemSize = toInt63(*m_SP) + 32;
+			updateMem();
+			THREADED_GAS();
+
+			*(h256*)&m_mem[(unsigned)*m_SP] = (h256)*(m_SP - 1);
+			m_SP -= 2;
+		}
+		THREADED_NEXT
+
+		THREADED_CASE(MSTORE8)
+		{
+			THREADED_BEGIN
+			m_copyMemSize = 0;
+			m_newMemSize = toInt63(*m_SP) + 1;
+			updateMem();
+			THREADED_GAS();
+
+			m_mem[(unsigned)*m_SP] = (byte)(*(m_SP - 1) & 0xff);
+			m_SP -= 2;
+		}
+		THREADED_NEXT
+
+		THREADED_CASE(SHA3)
+		{
+			THREADED_BEGIN
+			m_runGas = toInt63(m_schedule->sha3Gas + (u512(*(m_SP - 1)) + 31) / 32 * m_schedule->sha3WordGas);
+			m_copyMemSize = 0;
+			m_newMemSize = memNeed(*m_SP, *(m_SP - 1));
+			updateMem();
+			THREADED_GAS();
+
+			uint64_t inOff = (uint64_t)*m_SP--;
+			uint64_t inSize = (uint64_t)*m_SP--;
+			*++m_SP = (u256)sha3(bytesConstRef(m_mem.data() + inOff, inSize));
+		}
+		THREADED_NEXT
+
+		THREADED_CASE(LOG)
+		{
+			THREADED_BEGIN
+			m_OP = ip->op;
+			m_copyMemSize = 0;
+			logGasMem();
+			THREADED_GAS();
+
+			h256s topics;
+			for (uint64_t i = 0; i < ip->arg; ++i)
+				topics.push_back(h256(*(m_SP - 2 - i)));
+			m_ext->log(std::move(topics), bytesConstRef(m_mem.data() + (uint64_t)*m_SP, (uint64_t)*(m_SP - 1)));
+			m_SP -= 2 + ip->arg;
+		}
+		THREADED_NEXT
+
+		THREADED_CASE(EXP)
+		{
+			THREADED_BEGIN
+			u256 expon = *(m_SP - 1);
+			m_runGas = toInt63(m_schedule->expGas + m_schedule->expByteGas * (32 - (h256(expon).firstBitSet() / 8)));
+			THREADED_GAS();
+
+			u256 base = *m_SP--;
+			*m_SP = exp256(base, expon);
+		}
+		THREADED_NEXT
+
+		//
+		// ordinary instructions
+		//
+
+		THREADED_CASE(ADD)
+		{
+			THREADED_BEGIN
+			THREADED_GAS();
+
+			*(m_SP - 1) += *m_SP;
+			--m_SP;
+		}
+		THREADED_NEXT
+
+		THREADED_CASE(MUL)
+		{
+			THREADED_BEGIN
+			THREADED_GAS();
+
+			*(m_SP - 1) *= *m_SP;
+			--m_SP;
+		}
+		THREADED_NEXT
+
+		THREADED_CASE(SUB)
+		{
+			THREADED_BEGIN
+			THREADED_GAS();
+
+			*(m_SP - 1) = *m_SP - *(m_SP - 1);
+			--m_SP;
+		}
+		THREADED_NEXT
+
+		THREADED_CASE(DIV)
+		{
+			THREADED_BEGIN
+			THREADED_GAS();
+
+			*(m_SP - 1) = *(m_SP - 1) ? divWorkaround(*m_SP, *(m_SP - 1)) : 0;
+			--m_SP;
+		}
+		THREADED_NEXT
+
+		THREADED_CASE(SDIV)
+		{
+			THREADED_BEGIN
+			THREADED_GAS();
+
+			*(m_SP - 1) = *(m_SP - 1) ? s2u(divWorkaround(u2s(*m_SP), u2s(*(m_SP - 1)))) : 0;
+			--m_SP;
+		}
+		THREADED_NEXT
+
+		THREADED_CASE(MOD)
+		{
+			THREADED_BEGIN
+			THREADED_GAS();
+
+			*(m_SP - 1) = *(m_SP - 1) ? modWorkaround(*m_SP, *(m_SP - 1)) : 0;
+			--m_SP;
+		}
+		THREADED_NEXT
+
+		THREADED_CASE(SMOD)
+		{
+			THREADED_BEGIN
+			THREADED_GAS();
+
+			*(m_SP - 1) = *(m_SP - 1) ? s2u(modWorkaround(u2s(*m_SP), u2s(*(m_SP - 1)))) : 0;
+			--m_SP;
+		}
+		THREADED_NEXT
+
+		THREADED_CASE(NOT)
+		{
+			THREADED_BEGIN
+			THREADED_GAS();
+
+			*m_SP = ~*m_SP;
+		}
+		THREADED_NEXT
+
+		THREADED_CASE(LT)
+		{
+			THREADED_BEGIN
+			THREADED_GAS();
+
+			*(m_SP - 1) = *m_SP < *(m_SP - 1) ? 1 : 0;
+			--m_SP;
+		}
+		THREADED_NEXT
+
+		THREADED_CASE(GT)
+		{
+			THREADED_BEGIN
+			THREADED_GAS();
+
+			*(m_SP - 1) = *m_SP > *(m_SP - 1) ? 1 : 0;
+			--m_SP;
+		}
+		THREADED_NEXT
+
+		THREADED_CASE(SLT)
+		{
+			THREADED_BEGIN
+			THREADED_GAS();
+
+			*(m_SP - 1) = u2s(*m_SP) < u2s(*(m_SP - 1)) ? 1 : 0;
+			--m_SP;
+		}
+		THREADED_NEXT
+
+		THREADED_CASE(SGT)
+		{
+			THREADED_BEGIN
+			THREADED_GAS();
+
+			*(m_SP - 1) = u2s(*m_SP) > u2s(*(m_SP - 1)) ? 1 : 0;
+			--m_SP;
+		}
+		THREADED_NEXT
+
+		THREADED_CASE(EQ)
+		{
+			THREADED_BEGIN
+			THREADED_GAS();
+
+			*(m_SP - 1) = *m_SP == *(m_SP - 1) ? 1 : 0;
+			--m_SP;
+		}
+		THREADED_NEXT
+
+		THREADED_CASE(ISZERO)
+		{
+			THREADED_BEGIN
+			THREADED_GAS();
+
+			*m_SP = *m_SP ? 0 : 1;
+		}
+		THREADED_NEXT
+
+		THREADED_CASE(AND)
+		{
+			THREADED_BEGIN
+			THREADED_GAS();
+
+			*(m_SP - 1) = *m_SP & *(m_SP - 1);
+			--m_SP;
+		}
+		THREADED_NEXT
+
+		THREADED_CASE(OR)
+		{
+			THREADED_BEGIN
+			THREADED_GAS();
+
+			*(m_SP - 1) = *m_SP | *(m_SP - 1);
+			--m_SP;
+		}
+		THREADED_NEXT
+
+		THREADED_CASE(XOR)
+		{
+			THREADED_BEGIN
+			THREADED_GAS();
+
+			*(m_SP - 1) = *m_SP ^ *(m_SP - 1);
+			--m_SP;
+		}
+		THREADED_NEXT
+
+		THREADED_CASE(BYTE)
+		{
+			THREADED_BEGIN
+			THREADED_GAS();
+
+			*(m_SP - 1) = *m_SP < 32 ? (*(m_SP - 1) >> (unsigned)(8 * (31 - *m_SP))) & 0xff : 0;
+			--m_SP;
+		}
+		THREADED_NEXT
+
+		THREADED_CASE(ADDMOD)
+		{
+			THREADED_BEGIN
+			THREADED_GAS();
+
+			*(m_SP - 2) = *(m_SP - 2) ? u256((u512(*m_SP) + u512(*(m_SP - 1))) % *(m_SP - 2)) : 0;
+			m_SP -= 2;
+		}
+		THREADED_NEXT
+
+		THREADED_CASE(MULMOD)
+		{
+			THREADED_BEGIN
+			THREADED_GAS();
+
+			*(m_SP - 2) = *(m_SP - 2) ? u256((u512(*m_SP) * u512(*(m_SP - 1))) % *(m_SP - 2)) : 0;
+			m_SP -= 2;
+		}
+		THREADED_NEXT
+
+		THREADED_CASE(SIGNEXTEND)
+		{
+			THREADED_BEGIN
+			THREADED_GAS();
+
+			if (*m_SP < 31)
+			{
+				unsigned testBit = static_cast<unsigned>(*m_SP) * 8 + 7;
+				u256& number = *(m_SP - 1);
+				u256 mask = ((u256(1) << testBit) - 1);
+				if (boost::multiprecision::bit_test(number, testBit))
+					number |= ~mask;
+				else
+					number &= mask;
+			}
+			--m_SP;
+		}
+		THREADED_NEXT
+
+		THREADED_CASE(ADDRESS)
+		{
+			THREADED_BEGIN
+			THREADED_GAS();
+
+			*++m_SP = fromAddress(m_ext->myAddress);
+		}
+		THREADED_NEXT
+
+		THREADED_CASE(ORIGIN)
+		{
+			THREADED_BEGIN
+			THREADED_GAS();
+
+			*++m_SP = fromAddress(m_ext->origin);
+		}
+		THREADED_NEXT
+
+		THREADED_CASE(BALANCE)
+		{
+			THREADED_BEGIN
+			m_runGas = toInt63(m_schedule->balanceGas);
+			THREADED_GAS();
+
+			*m_SP = m_ext->balance(asAddress(*m_SP));
+		}
+		THREADED_NEXT
+
+		THREADED_CASE(CALLER)
+		{
+			THREADED_BEGIN
+			THREADED_GAS();
+
+			*++m_SP = fromAddress(m_ext->caller);
+		}
+		THREADED_NEXT
+
+		THREADED_CASE(CALLVALUE)
+		{
+			THREADED_BEGIN
+			THREADED_GAS();
+
+			*++m_SP = m_ext->value;
+		}
+		THREADED_NEXT
+
+		THREADED_CASE(CALLDATALOAD)
+		{
+			THREADED_BEGIN
+			THREADED_GAS();
+
+			if (u512(*m_SP) + 31 < m_ext->data.size())
+				*m_SP = (u256)*(h256 const*)(m_ext->data.data() + (size_t)*m_SP);
+			else if (*m_SP >= m_ext->data.size())
+				*m_SP = u256(0);
+			else
+			{
+				h256 r;
+				for (uint64_t i = (uint64_t)*m_SP, e = (uint64_t)*m_SP + (uint64_t)32, j = 0; i < e; ++i, ++j)
+					r[j] = i < m_ext->data.size() ? m_ext->data[i] : 0;
+				*m_SP = (u256)r;
+			}
+		}
+		THREADED_NEXT
+
+		THREADED_CASE(CALLDATASIZE)
+		{
+			THREADED_BEGIN
+			THREADED_GAS();
+
+			*++m_SP = m_ext->data.size();
+		}
+		THREADED_NEXT
+
+		THREADED_CASE(CODESIZE)
+		{
+			THREADED_BEGIN
+			THREADED_GAS();
+
+			*++m_SP = m_ext->code.size();
+		}
+		THREADED_NEXT
+
+		THREADED_CASE(EXTCODESIZE)
+		{
+			THREADED_BEGIN
+			m_runGas = toInt63(m_schedule->extcodesizeGas);
+			THREADED_GAS();
+
+			*m_SP = m_ext->codeSizeAt(asAddress(*m_SP));
+		}
+		THREADED_NEXT
+
+		THREADED_CASE(CALLDATACOPY)
+		{
+			THREADED_BEGIN
+			m_copyMemSize = toInt63(*(m_SP - 2));
+			m_newMemSize = memNeed(*m_SP, *(m_SP - 2));
+			updateMem();
+			THREADED_GAS();
+
+			copyDataToMemory(m_ext->data, m_SP);
+		}
+		THREADED_NEXT
+
+		THREADED_CASE(CODECOPY)
+		{
+			THREADED_BEGIN
+			m_copyMemSize = toInt63(*(m_SP - 2));
+			m_newMemSize = memNeed(*m_SP, *(m_SP - 2));
+			updateMem();
+			THREADED_GAS();
+
+			copyDataToMemory(&m_ext->code, m_SP);
+		}
+		THREADED_NEXT
+
+		THREADED_CASE(EXTCODECOPY)
+		{
+			THREADED_BEGIN
+			m_runGas = toInt63(m_schedule->extcodecopyGas);
+			m_copyMemSize = toInt63(*(m_SP - 3));
+			m_newMemSize = memNeed(*(m_SP - 1), *(m_SP - 3));
+			updateMem();
+			THREADED_GAS();
+
+			Address a = asAddress(*m_SP);
+			--m_SP;
+			copyDataToMemory(&m_ext->codeAt(a), m_SP);
+		}
+		THREADED_NEXT
+
+		THREADED_CASE(GASPRICE)
+		{
+			THREADED_BEGIN
+			THREADED_GAS();
+
+			*++m_SP = m_ext->gasPrice;
+		}
+		THREADED_NEXT
+
+		THREADED_CASE(BLOCKHASH)
+		{
+			THREADED_BEGIN
+			THREADED_GAS();
+
+			*m_SP = (u256)m_ext->blockHash(*m_SP);
+		}
+		THREADED_NEXT
+
+		THREADED_CASE(COINBASE)
+		{
+			THREADED_BEGIN
+			THREADED_GAS();
+
+			*++m_SP = (u160)m_ext->envInfo().author();
+		}
+		THREADED_NEXT
+
+		THREADED_CASE(TIMESTAMP)
+		{
+			THREADED_BEGIN
+			THREADED_GAS();
+
+			*++m_SP = m_ext->envInfo().timestamp();
+		}
+		THREADED_NEXT
+
+		THREADED_CASE(NUMBER)
+		{
+			THREADED_BEGIN
+			THREADED_GAS();
+
+			*++m_SP = m_ext->envInfo().number();
+		}
+		THREADED_NEXT
+
+		THREADED_CASE(DIFFICULTY)
+		{
+			THREADED_BEGIN
+			THREADED_GAS();
+
+			*++m_SP = m_ext->envInfo().difficulty();
+		}
+		THREADED_NEXT
+
+		THREADED_CASE(GASLIMIT)
+		{
+			THREADED_BEGIN
+			THREADED_GAS();
+
+			*++m_SP = m_ext->envInfo().gasLimit();
+		}
+		THREADED_NEXT
+
+		THREADED_CASE(POP)
+		{
+			THREADED_BEGIN
+			THREADED_GAS();
+
+			--m_SP;
+		}
+		THREADED_NEXT
+
+		THREADED_CASE(PUSH)
+		{
+			THREADED_BEGIN
+			THREADED_GAS();
+
+			*++m_SP = constants[ip->arg];
+		}
+		THREADED_NEXT
+
+		THREADED_CASE(JUMP)
+		{
+			THREADED_BEGIN
+			THREADED_GAS();
+
+			uint64_t target = threadedJumpTarget(*m_SP);
+			--m_SP;
+			THREADED_JUMP(target)
+		}
+
+		THREADED_CASE(JUMPI)
+		{
+			THREADED_BEGIN
+			THREADED_GAS();
+
+			if (*(m_SP - 1))
+			{
+				uint64_t target = threadedJumpTarget(*m_SP);
+				m_SP -= 2;
+				THREADED_JUMP(target)
+			}
+			m_SP -= 2;
+		}
+		THREADED_NEXT
+
+		THREADED_CASE(DUP)
+		{
+			THREADED_BEGIN
+			THREADED_GAS();
+
+			*(m_SP + 1) = *(m_SP + 1 - ip->arg);
+			++m_SP;
+		}
+		THREADED_NEXT
+
+		THREADED_CASE(SWAP)
+		{
+			THREADED_BEGIN
+			THREADED_GAS();
+
+			std::swap(*m_SP, *(m_SP - ip->arg));
+		}
+		THREADED_NEXT
+
+		THREADED_CASE(SLOAD)
+		{
+			THREADED_BEGIN
+			m_runGas = toInt63(m_schedule->sloadGas);
+			THREADED_GAS();
+
+			*m_SP = m_ext->store(*m_SP);
+		}
+		THREADED_NEXT
+
+		THREADED_CASE(SSTORE)
+		{
+			THREADED_BEGIN
+			if (!m_ext->store(*m_SP) && *(m_SP - 1))
+				m_runGas = toInt63(m_schedule->sstoreSetGas);
+			else if (m_ext->store(*m_SP) && !*(m_SP - 1))
+			{
+				m_runGas = toInt63(m_schedule->sstoreResetGas);
+				m_ext->sub.refunds += m_schedule->sstoreRefundGas;
+			}
+			else
+				m_runGas = toInt63(m_schedule->sstoreResetGas);
+			THREADED_GAS();
+
+			m_ext->setStore(*m_SP, *(m_SP - 1));
+			m_SP -= 2;
+		}
+		THREADED_NEXT
+
+		THREADED_CASE(PC)
+		{
+			THREADED_BEGIN
+			THREADED_GAS();
+
+			*++m_SP = ip->pc;
+		}
+		THREADED_NEXT
+
+		THREADED_CASE(MSIZE)
+		{
+			THREADED_BEGIN
+			THREADED_GAS();
+
+			*++m_SP = m_mem.size();
+		}
+		THREADED_NEXT
+
+		THREADED_CASE(GAS)
+		{
+			THREADED_BEGIN
+			THREADED_GAS();
+
+			*++m_SP = m_io_gas;
+		}
+		THREADED_NEXT
+
+		THREADED_CASE(JUMPDEST)
+		{
+			THREADED_BEGIN
+			m_runGas = 1;
+			THREADED_GAS();
+		}
+		THREADED_NEXT
+
+		//
+		// fused sequences, never traced
+		//
+
+		THREADED_CASE(PUSH_JUMP)
+		{
+			THREADED_BEGIN
+			updateIOGas();
+		}
+		THREADED_JUMP(ip->arg)
+
+		THREADED_CASE(PUSH_JUMPI)
+		{
+			THREADED_BEGIN
+			updateIOGas();
+
+			if (*m_SP--)
+			{
+				THREADED_JUMP(ip->arg)
+			}
+		}
+		THREADED_NEXT
+
+		THREADED_CASE(ISZERO_PUSH_JUMPI)
+		{
+			THREADED_BEGIN
+			updateIOGas();
+
+			if (!*m_SP--)
+			{
+				THREADED_JUMP(ip->arg)
+			}
+		}
+		THREADED_NEXT
+
+		THREADED_CASE(PUSH_MLOAD)
+		{
+			THREADED_BEGIN
+			m_copyMemSize = 0;
+			m_newMemSize = ip->arg + 32;
+			updateMem();
+			updateIOGas();
+
+			*++m_SP = (u256)*(h256 const*)(m_mem.data() + ip->arg);
+		}
+		THREADED_NEXT
+
+		THREADED_CASE(PUSH_MSTORE)
+		{
+			THREADED_BEGIN
+			m_copyMemSize = 0;
+			m_newMemSize = ip->arg + 32;
+			updateMem();
+			updateIOGas();
+
+			*(h256*)&m_mem[ip->arg] = (h256)*m_SP;
+			--m_SP;
+		}
+		THREADED_NEXT
+
+		THREADED_CASE(DUP_SWAP)
+		{
+			THREADED_BEGIN
+			updateIOGas();
+
+			*(m_SP + 1) = *(m_SP + 1 - (ip->arg & 0xff));
+			++m_SP;
+			std::swap(*m_SP, *(m_SP - (ip->arg >> 8)));
+		}
+		THREADED_NEXT
+
+		THREADED_CASE(INVALID)
+		THREADED_DEFAULT
+			throwBadInstruction();
+	}
+	THREADED_WHILE_CASES
+}
@@ -102,7 +102,8 @@ Host::Host(string const& _clientVersion, KeyPair const& _alias, NetworkPreferenc
 	m_clientVersion(_clientVersion),
 	m_netPrefs(_n),
 	m_ifAddresses(Network::getInterfaceAddresses()),
-	m_ioService(2),
+	m_ioService(max(2u, _n.ioThreads)),
+	m_strand(m_ioService),
 	m_tcp4Acceptor(m_ioService),
 	m_alias(_alias),
 	m_lastPing(chrono::steady_clock::time_point::min())
@@ -435,7 +436,7 @@ void Host::runAcceptor()
 		m_accepting = true;
 
 		auto socket = make_shared<RLPXSocket>(m_ioService);
-		m_tcp4Acceptor.async_accept(socket->ref(), [=](boost::system::error_code ec)
+		m_tcp4Acceptor.async_accept(socket->ref(), m_strand.wrap([=](boost::system::error_code ec)
 		{
 			m_accepting = false;
 			if (ec || !m_run)
@@ -457,7 +458,8 @@ void Host::runAcceptor()
 			{
 				// incoming connection; we don't yet know nodeid
 				auto handshake = make_shared<RLPXHandshake>(this, socket);
-				m_connecting.push_back(handshake);
+				DEV_GUARDED(x_connecting)
+					m_connecting.push_back(handshake);
 				handshake->start();
 				success = true;
 			}
@@ -473,7 +475,7 @@ void Host::runAcceptor()
 			if (!success)
 				socket->ref().close();
 			runAcceptor();
-		});
+		}));
 	}
 }
 
@@ -589,15 +591,20 @@ void Host::connect(std::shared_ptr<Peer> const& _p)
 		m_pendingPeerConns.insert(nptr);
 	}
 
-	_p->m_lastAttempted = std::chrono::system_clock::now();
+	DEV_RECURSIVE_GUARDED(x_sessions)
+		_p->m_lastAttempted = std::chrono::system_clock::now();
 	
 	bi::tcp::endpoint ep(_p->endpoint);
 	clog(NetConnect) << "Attempting connection to node" << _p->id << "@" << ep << "from" << id();
 	auto socket = make_shared<RLPXSocket>(m_ioService);
-	socket->ref().async_connect(ep, [=](boost::system::error_code const& ec)
+	socket->ref().async_connect(ep, socket->strand().wrap([=](boost::system::error_code const& ec)
 	{
-		_p->m_lastAttempted = std::chrono::system_clock::now();
-		_p->m_failedAttempts++;
+		// The socket strand only serialises this connection; the scheduler reads Peer state under x_sessions.
+		DEV_RECURSIVE_GUARDED(x_sessions)
+		{
+			_p->m_lastAttempted = std::chrono::system_clock::now();
+			_p->m_failedAttempts++;
+		}
 		
 		if (ec)
 		{
@@ -619,7 +626,7 @@ void Host::connect(std::shared_ptr<Peer> const& _p)
 		
 		Guard l(x_pendingNodeConns);
 		m_pendingPeerConns.erase(nptr);
-	});
+	}));
 }
 
 PeerSessionInfos Host::peerSessionInfo() const
@@ -716,7 +723,7 @@ void Host::run(boost::system::error_code const&)
 
 	auto runcb = [this](boost::system::error_code const& error) { run(error); };
 	m_timer->expires_from_now(boost::posix_time::milliseconds(c_timerInterval));
-	m_timer->async_wait(runcb);
+	m_timer->async_wait(m_strand.wrap(runcb));
 }
 
 void Host::startedWorking()
@@ -764,11 +771,29 @@ void Host::startedWorking()
 }
 
 void Host::doWork()
+{
+	if (!m_run)
+		return;
+
+	// Additional threads share the reactor with the worker thread; handlers of any
+	// single connection are serialised through the strand of its socket.
+	vector<thread> ioThreads;
+	for (unsigned i = 1; i < m_netPrefs.ioThreads; ++i)
+		ioThreads.push_back(thread([this, i]()
+		{
+			setThreadName("p2p" + toString(i));
+			runIOService();
+		}));
+	runIOService();
+	for (auto& t: ioThreads)
+		t.join();
+}
+
+void Host::runIOService()
 {
 	try
 	{
-		if (m_run)
-			m_ioService.run();
+		m_ioService.run();
 	}
 	catch (std::exception const& _e)
 	{
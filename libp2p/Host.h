@@ -277,8 +277,12 @@ private:
 	void run(boost::system::error_code const& error);			///< Run network. Called serially via ASIO deadline timer. Manages connection state transitions.
 
 	/// Run network. Not thread-safe; to be called only by worker.
+	/// Services the IO reactor from the worker thread and NetworkPreferences::ioThreads - 1 additional threads.
 	virtual void doWork();
 
+	/// Run the IO service until stopped, logging any exception. Called by doWork() from each network thread.
+	void runIOService();
+
 	/// Shutdown network. Not thread-safe; to be called only by worker.
 	virtual void doneWorking();
 
@@ -300,6 +304,7 @@ private:
 	int m_listenPort = -1;												///< What port are we listening on. -1 means binding failed or acceptor hasn't been initialized.
 
 	ba::io_service m_ioService;											///< IOService for network stuff.
+	ba::io_service::strand m_strand;										///< Serialises the scheduler timer and the acceptor.
 	bi::tcp::acceptor m_tcp4Acceptor;										///< Listening acceptor.
 
 	std::unique_ptr<boost::asio::deadline_timer> m_timer;					///< Timer which, when network is running, calls scheduler() every c_timerInterval ms.
@@ -62,6 +62,7 @@ struct NetworkPreferences
 	bool traverseNAT = true;
 	bool discovery = true;		// Discovery is activated with network.
 	bool pin = false;			// Only accept or connect to trusted peers.
+	unsigned ioThreads = 1;		// Number of threads servicing network IO. Each connection is serialised through its own strand.
 };
 
 /**
@@ -196,7 +196,7 @@ void NodeTable::doDiscover(NodeID _node, unsigned _round, shared_ptr<set<shared_
 		tried.pop_front();
 	}
 
-	m_timers.schedule(c_reqTimeout.count() * 2, [this, _node, _round, _tried](boost::system::error_code const& _ec)
+	m_timers.schedule(c_reqTimeout.count() * 2, m_socketPointer->strand().wrap([this, _node, _round, _tried](boost::system::error_code const& _ec)
 	{
 		if (_ec)
 			clog(NodeTableMessageDetail) << "Discovery timer was probably cancelled: " << _ec.value() << _ec.message();
@@ -211,7 +211,7 @@ void NodeTable::doDiscover(NodeID _node, unsigned _round, shared_ptr<set<shared_
 		// and therefore, in case of deallocation m_timers object no longer exists.
 
 		doDiscover(_node, _round + 1, _tried);
-	});
+	}));
 }
 
 vector<shared_ptr<NodeEntry>> NodeTable::nearestNodeEntries(NodeID _target)
@@ -530,7 +530,7 @@ void NodeTable::onReceived(UDPSocketFace*, bi::udp::endpoint const& _from, bytes
 
 void NodeTable::doCheckEvictions()
 {
-	m_timers.schedule(c_evictionCheckInterval.count(), [this](boost::system::error_code const& _ec)
+	m_timers.schedule(c_evictionCheckInterval.count(), m_socketPointer->strand().wrap([this](boost::system::error_code const& _ec)
 	{
 		if (_ec)
 			clog(NodeTableMessageDetail) << "Check Evictions timer was probably cancelled: " << _ec.value() << _ec.message();
@@ -556,12 +556,12 @@ void NodeTable::doCheckEvictions()
 		
 		if (evictionsRemain)
 			doCheckEvictions();
-	});
+	}));
 }
 
 void NodeTable::doDiscovery()
 {
-	m_timers.schedule(c_bucketRefresh.count(), [this](boost::system::error_code const& _ec)
+	m_timers.schedule(c_bucketRefresh.count(), m_socketPointer->strand().wrap([this](boost::system::error_code const& _ec)
 	{
 		if (_ec)
 			clog(NodeTableMessageDetail) << "Discovery timer was probably cancelled: " << _ec.value() << _ec.message();
@@ -574,7 +574,7 @@ void NodeTable::doDiscovery()
 		crypto::Nonce::get().ref().copyTo(randNodeId.ref().cropped(0, h256::size));
 		crypto::Nonce::get().ref().copyTo(randNodeId.ref().cropped(h256::size, h256::size));
 		doDiscover(randNodeId);
-	});
+	}));
 }
 
 unique_ptr<DiscoveryDatagram> DiscoveryDatagram::interpretUDP(bi::udp::endpoint const& _from, bytesConstRef _packet)
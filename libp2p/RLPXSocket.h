@@ -30,6 +30,9 @@ namespace p2p
 
 /**
  * @brief Shared pointer wrapper for ASIO TCP socket.
+ * Completion handlers of the handshake and session which use the socket are
+ * dispatched through strand() so that a connection is serviced by at most one
+ * network thread at a time.
  *
  * Thread Safety
  * Distinct Objects: Safe.
@@ -39,16 +42,18 @@ namespace p2p
 class RLPXSocket: public std::enable_shared_from_this<RLPXSocket>
 {
 public:
-	RLPXSocket(ba::io_service& _ioService): m_socket(_ioService) {}
+	RLPXSocket(ba::io_service& _ioService): m_socket(_ioService), m_strand(_ioService) {}
 	~RLPXSocket() { close(); }
 	
 	bool isConnected() const { return m_socket.is_open(); }
 	void close() { try { boost::system::error_code ec; m_socket.shutdown(bi::tcp::socket::shutdown_both, ec); if (m_socket.is_open()) m_socket.close(); } catch (...){} }
 	bi::tcp::endpoint remoteEndpoint() { boost::system::error_code ec; return m_socket.remote_endpoint(ec); }
 	bi::tcp::socket& ref() { return m_socket; }
+	ba::io_service::strand& strand() { return m_strand; }
 	
 protected:
 	bi::tcp::socket m_socket;
+	ba::io_service::strand m_strand;	///< Serialises handlers for this connection.
 };
 
 }
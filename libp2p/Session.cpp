@@ -26,6 +26,7 @@
 #include <libdevcore/Common.h>
 #include <libdevcore/CommonIO.h>
 #include <libdevcore/Exceptions.h>
+#include <libdevcore/Metrics.h>
 #include "Host.h"
 #include "Capability.h"
 using namespace std;
@@ -113,6 +114,8 @@ template <class T> vector<T> randomSelection(vector<T> const& _t, unsigned _n)
 
 bool Session::readPacket(uint16_t _capId, PacketType _t, RLP const& _r)
 {
+	DEV_METERED_SCOPE("p2p.session.read");
+	DEV_COUNT("p2p.session.bytesIn", _r.actualSize());
 	m_lastReceived = chrono::steady_clock::now();
 	clog(NetRight) << _t << _r;
 	try // Generic try-catch block designed to capture RLP format errors - TODO: give decent diagnostics, make a bit more specific over what is caught.
@@ -264,8 +267,11 @@ void Session::write()
 		out = &m_writeQueue[0];
 	}
 	auto self(shared_from_this());
-	ba::async_write(m_socket->ref(), ba::buffer(*out), [this, self](boost::system::error_code ec, std::size_t /*length*/)
+	auto begin = Metrics::Clock::now();
+	ba::async_write(m_socket->ref(), ba::buffer(*out), m_socket->strand().wrap([this, self, begin](boost::system::error_code ec, std::size_t length)
 	{
+		recordSince(DEV_METRICS_HISTOGRAM("p2p.session.write"), begin);
+		DEV_COUNT("p2p.session.bytesOut", length);
 		ThreadContext tc(info().id.abridged());
 		ThreadContext tc2(info().clientVersion);
 		// must check queue, as write callback can occur following dropped()
@@ -283,7 +289,7 @@ void Session::write()
 				return;
 		}
 		write();
-	});
+	}));
 }
 
 void Session::writeFrames()
@@ -298,8 +304,11 @@ void Session::writeFrames()
 	}
 
 	auto self(shared_from_this());
-	ba::async_write(m_socket->ref(), ba::buffer(*out), [this, self](boost::system::error_code ec, std::size_t /*length*/)
+	auto begin = Metrics::Clock::now();
+	ba::async_write(m_socket->ref(), ba::buffer(*out), m_socket->strand().wrap([this, self, begin](boost::system::error_code ec, std::size_t length)
 	{
+		recordSince(DEV_METRICS_HISTOGRAM("p2p.session.write"), begin);
+		DEV_COUNT("p2p.session.bytesOut", length);
 		ThreadContext tc(info().id.abridged());
 		ThreadContext tc2(info().clientVersion);
 		// must check queue, as write callback can occur following dropped()
@@ -321,7 +330,7 @@ void Session::writeFrames()
 		}
 
 		writeFrames();
-	});
+	}));
 }
 
 void Session::drop(DisconnectReason _reason)
@@ -379,7 +388,7 @@ void Session::doRead()
 
 	auto self(shared_from_this());
 	m_data.resize(h256::size);
-	ba::async_read(m_socket->ref(), boost::asio::buffer(m_data, h256::size), [this,self](boost::system::error_code ec, std::size_t length)
+	ba::async_read(m_socket->ref(), boost::asio::buffer(m_data, h256::size), m_socket->strand().wrap([this,self](boost::system::error_code ec, std::size_t length)
 	{
 		ThreadContext tc(info().id.abridged());
 		ThreadContext tc2(info().clientVersion);
@@ -412,7 +421,7 @@ void Session::doRead()
 		/// read padded frame and mac
 		auto tlen = hLength + hPadding + h128::size;
 		m_data.resize(tlen);
-		ba::async_read(m_socket->ref(), boost::asio::buffer(m_data, tlen), [this, self, hLength, hProtocolId, tlen](boost::system::error_code ec, std::size_t length)
+		ba::async_read(m_socket->ref(), boost::asio::buffer(m_data, tlen), m_socket->strand().wrap([this, self, hLength, hProtocolId, tlen](boost::system::error_code ec, std::size_t length)
 		{
 			ThreadContext tc(info().id.abridged());
 			ThreadContext tc2(info().clientVersion);
@@ -445,8 +454,8 @@ void Session::doRead()
 #endif
 			}
 			doRead();
-		});
-	});
+		}));
+	}));
 }
 
 bool Session::checkRead(std::size_t _expected, boost::system::error_code _ec, std::size_t _length)
@@ -483,7 +492,7 @@ void Session::doReadFrames()
 
 	auto self(shared_from_this());
 	m_data.resize(h256::size);
-	ba::async_read(m_socket->ref(), boost::asio::buffer(m_data, h256::size), [this, self](boost::system::error_code ec, std::size_t length)
+	ba::async_read(m_socket->ref(), boost::asio::buffer(m_data, h256::size), m_socket->strand().wrap([this, self](boost::system::error_code ec, std::size_t length)
 	{
 		ThreadContext tc(info().id.abridged());
 		ThreadContext tc2(info().clientVersion);
@@ -515,7 +524,7 @@ void Session::doReadFrames()
 		RLPXFrameInfo header(rawHeader);
 		auto tlen = header.length + header.padding + h128::size; // padded frame and mac
 		m_data.resize(tlen);
-		ba::async_read(m_socket->ref(), boost::asio::buffer(m_data, tlen), [this, self, tlen, header](boost::system::error_code ec, std::size_t length)
+		ba::async_read(m_socket->ref(), boost::asio::buffer(m_data, tlen), m_socket->strand().wrap([this, self, tlen, header](boost::system::error_code ec, std::size_t length)
 		{
 			ThreadContext tc(info().id.abridged());
 			ThreadContext tc2(info().clientVersion);
@@ -550,8 +559,8 @@ void Session::doReadFrames()
 				(void)ok;
 			}
 			doReadFrames();
-		});
-	});
+		}));
+	}));
 }
 
 std::shared_ptr<Session::Framing> Session::getFraming(uint16_t _protocolID)
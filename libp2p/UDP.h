@@ -111,10 +111,10 @@ public:
 	static_assert((unsigned)maxDatagramSize < 65507u, "UDP datagrams cannot be larger than 65507 bytes");
 
 	/// Create socket for specific endpoint.
-	UDPSocket(ba::io_service& _io, UDPSocketEvents& _host, bi::udp::endpoint _endpoint): m_host(_host), m_endpoint(_endpoint), m_socket(_io) { m_started.store(false); m_closed.store(true); };
+	UDPSocket(ba::io_service& _io, UDPSocketEvents& _host, bi::udp::endpoint _endpoint): m_host(_host), m_endpoint(_endpoint), m_socket(_io), m_strand(_io) { m_started.store(false); m_closed.store(true); };
 
 	/// Create socket which listens to all ports.
-	UDPSocket(ba::io_service& _io, UDPSocketEvents& _host, unsigned _port): m_host(_host), m_endpoint(bi::udp::v4(), _port), m_socket(_io) { m_started.store(false); m_closed.store(true); };
+	UDPSocket(ba::io_service& _io, UDPSocketEvents& _host, unsigned _port): m_host(_host), m_endpoint(bi::udp::v4(), _port), m_socket(_io), m_strand(_io) { m_started.store(false); m_closed.store(true); };
 	virtual ~UDPSocket() { disconnect(); }
 
 	/// Socket will begin listening for and delivering packets
@@ -129,6 +129,9 @@ public:
 	/// Disconnect socket.
 	void disconnect() { disconnectWithError(boost::asio::error::connection_reset); }
 
+	/// Strand through which send and receive completions are dispatched. The owner may wrap its own timers in it to serialise them with packet handling.
+	ba::io_service::strand& strand() { return m_strand; }
+
 protected:
 	void doRead();
 
@@ -147,6 +150,7 @@ protected:
 	std::array<byte, maxDatagramSize> m_recvData;	///< Buffer for ingress data.
 	bi::udp::endpoint m_recvEndpoint;				///< Endpoint data was received from.
 	bi::udp::socket m_socket;						///< Boost asio udp socket.
+	ba::io_service::strand m_strand;				///< Serialises completion handlers when the io_service is run from several threads.
 
 	Mutex x_socketError;							///< Mutex for error which can be set from host or IO thread.
 	boost::system::error_code m_socketError;		///< Set when shut down due to error.
@@ -198,7 +202,7 @@ void UDPSocket<Handler, MaxDatagramSize>::doRead()
 		return;
 
 	auto self(UDPSocket<Handler, MaxDatagramSize>::shared_from_this());
-	m_socket.async_receive_from(boost::asio::buffer(m_recvData), m_recvEndpoint, [this, self](boost::system::error_code _ec, size_t _len)
+	m_socket.async_receive_from(boost::asio::buffer(m_recvData), m_recvEndpoint, m_strand.wrap([this, self](boost::system::error_code _ec, size_t _len)
 	{
 		if (m_closed)
 			return disconnectWithError(_ec);
@@ -209,7 +213,7 @@ void UDPSocket<Handler, MaxDatagramSize>::doRead()
 		if (_len)
 			m_host.onReceived(this, m_recvEndpoint, bytesConstRef(m_recvData.data(), _len));
 		doRead();
-	});
+	}));
 }
 
 template <typename Handler, unsigned MaxDatagramSize>
@@ -221,7 +225,7 @@ void UDPSocket<Handler, MaxDatagramSize>::doWrite()
 	const UDPDatagram& datagram = m_sendQ[0];
 	auto self(UDPSocket<Handler, MaxDatagramSize>::shared_from_this());
 	bi::udp::endpoint endpoint(datagram.endpoint());
-	m_socket.async_send_to(boost::asio::buffer(datagram.data), endpoint, [this, self, endpoint](boost::system::error_code _ec, std::size_t)
+	m_socket.async_send_to(boost::asio::buffer(datagram.data), endpoint, m_strand.wrap([this, self, endpoint](boost::system::error_code _ec, std::size_t)
 	{
 		if (m_closed)
 			return disconnectWithError(_ec);
@@ -234,7 +238,7 @@ void UDPSocket<Handler, MaxDatagramSize>::doWrite()
 		if (m_sendQ.empty())
 			return;
 		doWrite();
-	});
+	}));
 }
 
 template <typename Handler, unsigned MaxDatagramSize>
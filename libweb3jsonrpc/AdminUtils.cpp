@@ -1,5 +1,9 @@
 #include <jsonrpccpp/common/exception.h>
+#include <libdevcore/CommonJS.h>
 #include <libdevcore/Log.h>
+#include <libdevcore/MemoryAccounting.h>
+#include <libdevcore/Metrics.h>
+#include <libevm/VMProfiler.h>
 #include <libethereum/Client.h>
 #include "SessionManager.h"
 #include "AdminUtils.h"
@@ -36,3 +40,117 @@ bool AdminUtils::admin_exit(std::string const& _session)
 	}
 	return false;
 }
+
+Json::Value AdminUtils::admin_memoryUsage(std::string const& _session)
+{
+	RPC_ADMIN;
+	Json::Value ret(Json::objectValue);
+	uint64_t total = 0;
+	for (auto const& i: MemoryAccounting::get().sample())
+	{
+		Json::Value r(Json::objectValue);
+		r["bytes"] = Json::UInt64(i.second.usage.bytes);
+		r["items"] = Json::UInt64(i.second.usage.items);
+		r["softLimit"] = Json::UInt64(i.second.softLimit);
+		r["sources"] = i.second.sources;
+		r["trims"] = i.second.trims;
+		ret[i.first] = r;
+		total += i.second.usage.bytes;
+	}
+	ret["total"] = Json::UInt64(total);
+	return ret;
+}
+
+bool AdminUtils::admin_setMemoryLimit(std::string const& _name, std::string const& _bytes, std::string const& _session)
+{
+	RPC_ADMIN;
+	MemoryAccounting::get().setSoftLimit(_name, (uint64_t)min<u256>(jsToU256(_bytes), numeric_limits<uint64_t>::max()));
+	return true;
+}
+
+Json::Value AdminUtils::admin_metrics(std::string const& _session)
+{
+	RPC_ADMIN;
+	Json::Value histograms(Json::objectValue);
+	for (auto const& i: Metrics::get().histograms())
+	{
+		// Every RPC method has a histogram from the start; leave out those never called.
+		if (!i.second.count)
+			continue;
+		Json::Value h(Json::objectValue);
+		h["count"] = Json::UInt64(i.second.count);
+		h["sum"] = Json::UInt64(i.second.sum);
+		h["mean"] = i.second.mean();
+		h["p50"] = Json::UInt64(i.second.percentile(0.5));
+		h["p90"] = Json::UInt64(i.second.percentile(0.9));
+		h["p99"] = Json::UInt64(i.second.percentile(0.99));
+		h["max"] = Json::UInt64(i.second.max);
+		histograms[i.first] = h;
+	}
+	Json::Value counters(Json::objectValue);
+	for (auto const& i: Metrics::get().counters())
+		counters[i.first] = Json::UInt64(i.second);
+
+	Json::Value ret(Json::objectValue);
+	ret["histograms"] = histograms;
+	ret["counters"] = counters;
+	return ret;
+}
+
+bool AdminUtils::admin_resetMetrics(std::string const& _session)
+{
+	RPC_ADMIN;
+	Metrics::get().reset();
+	return true;
+}
+
+bool AdminUtils::admin_startTracing(std::string const& _session)
+{
+	RPC_ADMIN;
+	Metrics::get().startTracing();
+	return true;
+}
+
+Json::Value AdminUtils::admin_stopTracing(std::string const& _session)
+{
+	RPC_ADMIN;
+	Json::Value ret;
+	Json::Reader().parse(Metrics::get().stopTracing(), ret);
+	return ret;
+}
+
+bool AdminUtils::admin_startVMProfiling(std::string const& _session)
+{
+	RPC_ADMIN;
+	VMProfiler::start();
+	return true;
+}
+
+Json::Value AdminUtils::admin_stopVMProfiling(std::string const& _session)
+{
+	RPC_ADMIN;
+	VMProfiler::Profile profile = VMProfiler::stop();
+	auto toJson = [](VMProfiler::Stats const& _s)
+	{
+		Json::Value ret(Json::objectValue);
+		ret["count"] = Json::UInt64(_s.count);
+		ret["gas"] = Json::UInt64(_s.gas);
+		ret["cycles"] = Json::UInt64(_s.cycles);
+		return ret;
+	};
+
+	Json::Value opcodes(Json::objectValue);
+	for (unsigned i = 0; i < 256; ++i)
+		if (profile.opcodes[i].count)
+			opcodes[instructionInfo(Instruction(i)).name] = toJson(profile.opcodes[i]);
+	Json::Value contracts(Json::objectValue);
+	for (auto const& i: profile.contractTotals())
+		contracts[toJS(i.first)] = toJson(i.second);
+
+	Json::Value ret(Json::objectValue);
+	ret["opcodes"] = opcodes;
+	ret["contracts"] = contracts;
+	ret["foldedOpcodes"] = profile.folded(VMProfiler::Metric::Cycles, false);
+	ret["foldedContracts"] = profile.folded(VMProfiler::Metric::Cycles, true);
+	return ret;
+}
@@ -25,6 +25,14 @@ public:
 	virtual bool admin_setVerbosity(int _v, std::string const& _session) override;
 	virtual bool admin_verbosity(int _v) override;
 	virtual bool admin_exit(std::string const& _session) override;
+	virtual Json::Value admin_memoryUsage(std::string const& _session) override;
+	virtual bool admin_setMemoryLimit(std::string const& _name, std::string const& _bytes, std::string const& _session) override;
+	virtual Json::Value admin_metrics(std::string const& _session) override;
+	virtual bool admin_resetMetrics(std::string const& _session) override;
+	virtual bool admin_startTracing(std::string const& _session) override;
+	virtual Json::Value admin_stopTracing(std::string const& _session) override;
+	virtual bool admin_startVMProfiling(std::string const& _session) override;
+	virtual Json::Value admin_stopVMProfiling(std::string const& _session) override;
 
 private:
 	SessionManager& m_sm;
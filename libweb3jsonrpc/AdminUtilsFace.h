@@ -17,6 +17,14 @@ namespace dev {
                     this->bindAndAddMethod(jsonrpc::Procedure("admin_setVerbosity", jsonrpc::PARAMS_BY_POSITION, jsonrpc::JSON_BOOLEAN, "param1",jsonrpc::JSON_INTEGER,"param2",jsonrpc::JSON_STRING, NULL), &dev::rpc::AdminUtilsFace::admin_setVerbosityI);
                     this->bindAndAddMethod(jsonrpc::Procedure("admin_verbosity", jsonrpc::PARAMS_BY_POSITION, jsonrpc::JSON_BOOLEAN, "param1",jsonrpc::JSON_INTEGER, NULL), &dev::rpc::AdminUtilsFace::admin_verbosityI);
                     this->bindAndAddMethod(jsonrpc::Procedure("admin_exit", jsonrpc::PARAMS_BY_POSITION, jsonrpc::JSON_BOOLEAN, "param1",jsonrpc::JSON_STRING, NULL), &dev::rpc::AdminUtilsFace::admin_exitI);
+                    this->bindAndAddMethod(jsonrpc::Procedure("admin_memoryUsage", jsonrpc::PARAMS_BY_POSITION, jsonrpc::JSON_OBJECT, "param1",jsonrpc::JSON_STRING, NULL), &dev::rpc::AdminUtilsFace::admin_memoryUsageI);
+                    this->bindAndAddMethod(jsonrpc::Procedure("admin_setMemoryLimit", jsonrpc::PARAMS_BY_POSITION, jsonrpc::JSON_BOOLEAN, "param1",jsonrpc::JSON_STRING,"param2",jsonrpc::JSON_STRING,"param3",jsonrpc::JSON_STRING, NULL), &dev::rpc::AdminUtilsFace::admin_setMemoryLimitI);
+                    this->bindAndAddMethod(jsonrpc::Procedure("admin_metrics", jsonrpc::PARAMS_BY_POSITION, jsonrpc::JSON_OBJECT, "param1",jsonrpc::JSON_STRING, NULL), &dev::rpc::AdminUtilsFace::admin_metricsI);
+                    this->bindAndAddMethod(jsonrpc::Procedure("admin_resetMetrics", jsonrpc::PARAMS_BY_POSITION, jsonrpc::JSON_BOOLEAN, "param1",jsonrpc::JSON_STRING, NULL), &dev::rpc::AdminUtilsFace::admin_resetMetricsI);
+                    this->bindAndAddMethod(jsonrpc::Procedure("admin_startTracing", jsonrpc::PARAMS_BY_POSITION, jsonrpc::JSON_BOOLEAN, "param1",jsonrpc::JSON_STRING, NULL), &dev::rpc::AdminUtilsFace::admin_startTracingI);
+                    this->bindAndAddMethod(jsonrpc::Procedure("admin_stopTracing", jsonrpc::PARAMS_BY_POSITION, jsonrpc::JSON_OBJECT, "param1",jsonrpc::JSON_STRING, NULL), &dev::rpc::AdminUtilsFace::admin_stopTracingI);
+                    this->bindAndAddMethod(jsonrpc::Procedure("admin_startVMProfiling", jsonrpc::PARAMS_BY_POSITION, jsonrpc::JSON_BOOLEAN, "param1",jsonrpc::JSON_STRING, NULL), &dev::rpc::AdminUtilsFace::admin_startVMProfilingI);
+                    this->bindAndAddMethod(jsonrpc::Procedure("admin_stopVMProfiling", jsonrpc::PARAMS_BY_POSITION, jsonrpc::JSON_OBJECT, "param1",jsonrpc::JSON_STRING, NULL), &dev::rpc::AdminUtilsFace::admin_stopVMProfilingI);
                 }
 
                 inline virtual void admin_setVerbosityI(const Json::Value &request, Json::Value &response)
@@ -31,9 +39,49 @@ namespace dev {
                 {
                     response = this->admin_exit(request[0u].asString());
                 }
+                inline virtual void admin_memoryUsageI(const Json::Value &request, Json::Value &response)
+                {
+                    response = this->admin_memoryUsage(request[0u].asString());
+                }
+                inline virtual void admin_setMemoryLimitI(const Json::Value &request, Json::Value &response)
+                {
+                    response = this->admin_setMemoryLimit(request[0u].asString(), request[1u].asString(), request[2u].asString());
+                }
+                inline virtual void admin_metricsI(const Json::Value &request, Json::Value &response)
+                {
+                    response = this->admin_metrics(request[0u].asString());
+                }
+                inline virtual void admin_resetMetricsI(const Json::Value &request, Json::Value &response)
+                {
+                    response = this->admin_resetMetrics(request[0u].asString());
+                }
+                inline virtual void admin_startTracingI(const Json::Value &request, Json::Value &response)
+                {
+                    response = this->admin_startTracing(request[0u].asString());
+                }
+                inline virtual void admin_stopTracingI(const Json::Value &request, Json::Value &response)
+                {
+                    response = this->admin_stopTracing(request[0u].asString());
+                }
+                inline virtual void admin_startVMProfilingI(const Json::Value &request, Json::Value &response)
+                {
+                    response = this->admin_startVMProfiling(request[0u].asString());
+                }
+                inline virtual void admin_stopVMProfilingI(const Json::Value &request, Json::Value &response)
+                {
+                    response = this->admin_stopVMProfiling(request[0u].asString());
+                }
                 virtual bool admin_setVerbosity(int param1, const std::string& param2) = 0;
                 virtual bool admin_verbosity(int param1) = 0;
                 virtual bool admin_exit(const std::string& param1) = 0;
+                virtual Json::Value admin_memoryUsage(const std::string& param1) = 0;
+                virtual bool admin_setMemoryLimit(const std::string& param1, const std::string& param2, const std::string& param3) = 0;
+                virtual Json::Value admin_metrics(const std::string& param1) = 0;
+                virtual bool admin_resetMetrics(const std::string& param1) = 0;
+                virtual bool admin_startTracing(const std::string& param1) = 0;
+                virtual Json::Value admin_stopTracing(const std::string& param1) = 0;
+                virtual bool admin_startVMProfiling(const std::string& param1) = 0;
+                virtual Json::Value admin_stopVMProfiling(const std::string& param1) = 0;
         };
 
     }
@@ -0,0 +1,187 @@
+/*
+	This file is part of cpp-ethereum.
+
+	cpp-ethereum is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	cpp-ethereum is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with cpp-ethereum.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/** @file BatchHandler.cpp
+ * @date 2017
+ */
+
+#include "BatchHandler.h"
+#include <atomic>
+#include <unordered_set>
+using namespace std;
+using namespace dev;
+using namespace dev::rpc;
+
+/// Upper bound on the workers, whatever the hardware.
+static const unsigned c_maxBatchThreads = 16;
+
+struct BatchHandler::Run
+{
+	Json::Value const* batch;
+	vector<unsigned> const* indices;
+	vector<Json::Value>* responses;
+	unsigned size;	///< Copied, as a late helper must not touch the caller's vectors.
+	atomic<unsigned> next{0};
+	unsigned done = 0;
+	Mutex x_done;
+	condition_variable finished;
+};
+
+BatchHandler::BatchHandler(jsonrpc::IProcedureInvokationHandler& _handler, unsigned _threads):
+	RpcProtocolServerV2(_handler)
+{
+	if (!_threads)
+		_threads = min(max(thread::hardware_concurrency(), 2u) - 1, c_maxBatchThreads);
+	for (unsigned i = 0; i < _threads; ++i)
+		m_workers.push_back(thread([this]()
+		{
+			while (true)
+			{
+				function<void()> f;
+				{
+					unique_lock<Mutex> l(x_queue);
+					m_queueChanged.wait(l, [this]() { return m_stopping || !m_queue.empty(); });
+					if (m_queue.empty())
+						return;
+					f = move(m_queue.front());
+					m_queue.pop_front();
+				}
+				f();
+			}
+		}));
+}
+
+BatchHandler::~BatchHandler()
+{
+	DEV_GUARDED(x_queue)
+		m_stopping = true;
+	m_queueChanged.notify_all();
+	for (auto& w: m_workers)
+		w.join();
+}
+
+bool BatchHandler::isReadOnly(string const& _method)
+{
+	static const unordered_set<string> s_readOnly = {
+		"eth_protocolVersion", "eth_hashrate", "eth_coinbase", "eth_mining", "eth_gasPrice", "eth_blockNumber",
+		"eth_getBalance", "eth_getStorageAt", "eth_getStorageRoot", "eth_getTransactionCount", "eth_getCode",
+		"eth_getBlockTransactionCountByHash", "eth_getBlockTransactionCountByNumber",
+		"eth_getUncleCountByBlockHash", "eth_getUncleCountByBlockNumber",
+		"eth_call", "eth_callMany", "eth_estimateGas",
+		"eth_getBlockByHash", "eth_getBlockByNumber",
+		"eth_getTransactionByHash", "eth_getTransactionByBlockHashAndIndex", "eth_getTransactionByBlockNumberAndIndex",
+		"eth_getTransactionReceipt", "eth_getUncleByBlockHashAndIndex", "eth_getUncleByBlockNumberAndIndex",
+		"eth_getLogs", "eth_getLogsEx", "eth_syncing",
+		"net_version", "net_peerCount", "net_listening",
+		"web3_clientVersion", "web3_sha3"
+	};
+	return s_readOnly.count(_method);
+}
+
+void BatchHandler::HandleJsonRequest(Json::Value const& _request, Json::Value& _response)
+{
+	if (!_request.isArray() || _request.size() < 2 || m_workers.empty())
+	{
+		RpcProtocolServerV2::HandleJsonRequest(_request, _response);
+		return;
+	}
+
+	vector<Json::Value> responses(_request.size());
+	vector<unsigned> run;
+	auto flush = [&]()
+	{
+		if (run.size() == 1)
+			handleSingle(_request[run[0]], responses[run[0]]);
+		else if (!run.empty())
+			handleRun(_request, run, responses);
+		run.clear();
+	};
+	for (unsigned i = 0; i < _request.size(); ++i)
+	{
+		Json::Value const& r = _request[i];
+		if (r.isObject() && r["method"].isString() && isReadOnly(r["method"].asString()))
+			run.push_back(i);
+		else
+		{
+			flush();
+			handleSingle(r, responses[i]);
+		}
+	}
+	flush();
+
+	// A batch of notifications only gets no response at all.
+	_response = Json::nullValue;
+	for (auto const& r: responses)
+		if (r != Json::nullValue)
+			_response.append(r);
+}
+
+void BatchHandler::handleSingle(Json::Value const& _request, Json::Value& o_response)
+{
+	// Batches don't nest; anything but a request object is answered as the library's own batch handling would.
+	if (_request.isObject())
+		RpcProtocolServerV2::HandleJsonRequest(_request, o_response);
+	else
+		WrapError(Json::nullValue, jsonrpc::Errors::ERROR_RPC_INVALID_REQUEST, jsonrpc::Errors::GetErrorMessage(jsonrpc::Errors::ERROR_RPC_INVALID_REQUEST), o_response);
+}
+
+void BatchHandler::handleRun(Json::Value const& _batch, vector<unsigned> const& _indices, vector<Json::Value>& o_responses)
+{
+	auto run = make_shared<Run>();
+	run->batch = &_batch;
+	run->indices = &_indices;
+	run->responses = &o_responses;
+	run->size = _indices.size();
+
+	// Helpers that start once the run is taken find nothing to do; the connection's thread works
+	// through it too, so a busy pool only costs the parallelism.
+	unsigned helpers = min<size_t>(m_workers.size(), _indices.size() - 1);
+	DEV_GUARDED(x_queue)
+		for (unsigned i = 0; i < helpers; ++i)
+			m_queue.push_back([this, run]() { work(run); });
+	m_queueChanged.notify_all();
+
+	work(run);
+	unique_lock<Mutex> l(run->x_done);
+	run->finished.wait(l, [&]() { return run->done == run->size; });
+}
+
+void BatchHandler::work(shared_ptr<Run> const& _run)
+{
+	unsigned n = _run->size;
+	unsigned handled = 0;
+	for (unsigned i = _run->next++; i < n; i = _run->next++, ++handled)
+	{
+		unsigned index = (*_run->indices)[i];
+		Json::Value const& request = (*_run->batch)[index];
+		try
+		{
+			handleSingle(request, (*_run->responses)[index]);
+		}
+		catch (...)
+		{
+			// Nothing may escape a worker; answer as the connector would for a failed call.
+			WrapError(request, jsonrpc::Errors::ERROR_RPC_INTERNAL_ERROR, jsonrpc::Errors::GetErrorMessage(jsonrpc::Errors::ERROR_RPC_INTERNAL_ERROR), (*_run->responses)[index]);
+		}
+	}
+	if (handled)
+	{
+		Guard l(_run->x_done);
+		_run->done += handled;
+		if (_run->done == n)
+			_run->finished.notify_all();
+	}
+}
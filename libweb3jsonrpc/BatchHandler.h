@@ -0,0 +1,72 @@
+/*
+	This file is part of cpp-ethereum.
+
+	cpp-ethereum is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	cpp-ethereum is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with cpp-ethereum.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/** @file BatchHandler.h
+ * @date 2017
+ */
+
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <string>
+#include <thread>
+#include <vector>
+#include <jsonrpccpp/server/rpcprotocolserverv2.h>
+#include <libdevcore/Guards.h>
+
+namespace dev
+{
+namespace rpc
+{
+
+/**
+ * @brief JSON-RPC 2.0 protocol handler that runs the read-only calls of a batch concurrently.
+ *
+ * Consecutive read-only calls of a batch are shared between the connection's thread and a bounded
+ * pool of workers; any other call runs on the connection's thread once those before it are done.
+ * Responses keep the order of the requests. Single requests are handled as before.
+ */
+class BatchHandler: public jsonrpc::RpcProtocolServerV2
+{
+public:
+	/// @param _threads Size of the worker pool, shared by all connections; 0 to size it by the hardware.
+	explicit BatchHandler(jsonrpc::IProcedureInvokationHandler& _handler, unsigned _threads = 0);
+	~BatchHandler();
+
+	void HandleJsonRequest(Json::Value const& _request, Json::Value& _response) override;
+
+	/// @returns true if @a _method only reads, so can run alongside the other calls of a batch.
+	static bool isReadOnly(std::string const& _method);
+
+private:
+	struct Run;
+
+	/// Handles one element of a batch.
+	void handleSingle(Json::Value const& _request, Json::Value& o_response);
+	void handleRun(Json::Value const& _batch, std::vector<unsigned> const& _indices, std::vector<Json::Value>& o_responses);
+	void work(std::shared_ptr<Run> const& _run);
+
+	std::vector<std::thread> m_workers;
+	Mutex x_queue;
+	std::condition_variable m_queueChanged;
+	std::deque<std::function<void()>> m_queue;
+	bool m_stopping = false;
+};
+
+}
+}
@@ -138,12 +138,10 @@ Json::Value Debug::debug_storageRangeAt(string const& _blockHashOrNumber, int _t
 		unsigned const i = ((unsigned)_txIndex < block.pending().size()) ? (unsigned)_txIndex : block.pending().size();
 		State state = block.fromPending(i);
 
-		map<h256, pair<u256, u256>> const storage(state.storage(Address(_address)));
+		// begin is inclusive; one more than asked for tells whether there is more.
+		map<h256, pair<u256, u256>> const storage(state.storage(Address(_address), h256fromHex(_begin), (unsigned)_maxResults + 1));
 
-		// begin is inclusive
-		auto itBegin = storage.lower_bound(h256fromHex(_begin));
-
-		for (auto it = itBegin; it != storage.end(); ++it)
+		for (auto it = storage.begin(); it != storage.end(); ++it)
 		{
 			if (ret["storage"].size() == static_cast<unsigned>(_maxResults))
 			{
@@ -32,6 +32,7 @@
 #include <libweb3jsonrpc/JsonHelper.h>
 #include "Eth.h"
 #include "AccountHolder.h"
+#include "Subscriptions.h"
 #include "JsonHelper.h"
 
 using namespace std;
@@ -54,6 +55,10 @@ Eth::Eth(eth::Interface& _eth, eth::AccountHolder& _ethAccounts):
 {
 }
 
+Eth::~Eth()
+{
+}
+
 string Eth::eth_protocolVersion()
 {
 	return toJS(eth::c_protocolVersion);
@@ -357,6 +362,27 @@ string Eth::eth_call(Json::Value const& _json, string const& _blockNumber)
 	}
 }
 
+Json::Value Eth::eth_callMany(Json::Value const& _json, string const& _blockNumber)
+{
+	try
+	{
+		vector<TransactionSkeleton> calls;
+		for (auto const& i: _json)
+		{
+			calls.push_back(toTransactionSkeleton(i));
+			setTransactionDefaults(calls.back());
+		}
+		Json::Value ret(Json::arrayValue);
+		for (ExecutionResult const& er: client()->callMany(calls, jsToBlockNumber(_blockNumber), FudgeFactor::Lenient))
+			ret.append(toJS(er.output));
+		return ret;
+	}
+	catch (...)
+	{
+		BOOST_THROW_EXCEPTION(JsonRpcException(Errors::ERROR_RPC_INVALID_PARAMS));
+	}
+}
+
 string Eth::eth_estimateGas(Json::Value const& _json)
 {
 	try
@@ -665,6 +691,39 @@ Json::Value Eth::eth_syncing()
 	return info;
 }
 
+string Eth::eth_subscribe(string const& _kind)
+{
+	IpcPush push = currentIpcConnection();
+	ChainEventBus* bus = client()->chainEvents();
+	if (!push || !bus)
+		BOOST_THROW_EXCEPTION(JsonRpcException("Subscriptions are only available over IPC."));
+
+	Subscriptions::WorkSource work;
+	if (_kind == "newWork")
+	{
+		// Throws unless this is an Ethash client; also marks the remote worker as active.
+		eth_getWork();
+		work = [this]() { return eth_getWork(); };
+	}
+
+	string id;
+	DEV_GUARDED(x_subscriptions)
+	{
+		if (!m_subscriptions)
+			m_subscriptions.reset(new Subscriptions(*bus));
+		id = m_subscriptions->subscribe(_kind, push, work);
+	}
+	if (id.empty())
+		BOOST_THROW_EXCEPTION(JsonRpcException(Errors::ERROR_RPC_INVALID_PARAMS));
+	return id;
+}
+
+bool Eth::eth_unsubscribe(string const& _subscriptionId)
+{
+	Guard l(x_subscriptions);
+	return m_subscriptions && m_subscriptions->unsubscribe(_subscriptionId);
+}
+
 bool Eth::eth_submitWork(string const& _nonce, string const&, string const& _mixHash)
 {
 	try
@@ -27,6 +27,7 @@
 #include <iostream>
 #include <jsonrpccpp/server.h>
 #include <jsonrpccpp/common/exception.h>
+#include <libdevcore/Guards.h>
 #include <libdevcrypto/Common.h>
 #include "SessionManager.h"
 #include "EthFace.h"
@@ -58,6 +59,8 @@ namespace dev
 namespace rpc
 {
 
+class Subscriptions;
+
 /**
  * @brief JSON-RPC api implementation
  */
@@ -65,6 +68,7 @@ class Eth: public dev::rpc::EthFace
 {
 public:
 	Eth(eth::Interface& _eth, eth::AccountHolder& _ethAccounts);
+	virtual ~Eth();
 
 	virtual RPCModules implementedModules() const override
 	{
@@ -92,6 +96,7 @@ public:
 	virtual std::string eth_getCode(std::string const& _address, std::string const& _blockNumber) override;
 	virtual std::string eth_sendTransaction(Json::Value const& _json) override;
 	virtual std::string eth_call(Json::Value const& _json, std::string const& _blockNumber) override;
+	virtual Json::Value eth_callMany(Json::Value const& _json, std::string const& _blockNumber) override;
 	virtual std::string eth_estimateGas(Json::Value const& _json) override;
 	virtual bool eth_flush() override;
 	virtual Json::Value eth_getBlockByHash(std::string const& _blockHash, bool _includeTransactions) override;
@@ -124,6 +129,9 @@ public:
 	virtual std::string eth_sendRawTransaction(std::string const& _rlp) override;
 	virtual bool eth_notePassword(std::string const&) override { return false; }
 	virtual Json::Value eth_syncing() override;
+	/// Subscribes the calling IPC connection to "newHeads", "logs" or "newPendingTransactions".
+	virtual std::string eth_subscribe(std::string const& _kind) override;
+	virtual bool eth_unsubscribe(std::string const& _subscriptionId) override;
 	
 	void setTransactionDefaults(eth::TransactionSkeleton& _t);
 protected:
@@ -133,6 +141,9 @@ protected:
 	eth::Interface& m_eth;
 	eth::AccountHolder& m_ethAccounts;
 
+	Mutex x_subscriptions;
+	std::unique_ptr<Subscriptions> m_subscriptions;	///< Created by the first eth_subscribe.
+
 };
 
 }
@@ -33,6 +33,7 @@ namespace dev {
                     this->bindAndAddMethod(jsonrpc::Procedure("eth_getCode", jsonrpc::PARAMS_BY_POSITION, jsonrpc::JSON_STRING, "param1",jsonrpc::JSON_STRING,"param2",jsonrpc::JSON_STRING, NULL), &dev::rpc::EthFace::eth_getCodeI);
                     this->bindAndAddMethod(jsonrpc::Procedure("eth_sendTransaction", jsonrpc::PARAMS_BY_POSITION, jsonrpc::JSON_STRING, "param1",jsonrpc::JSON_OBJECT, NULL), &dev::rpc::EthFace::eth_sendTransactionI);
                     this->bindAndAddMethod(jsonrpc::Procedure("eth_call", jsonrpc::PARAMS_BY_POSITION, jsonrpc::JSON_STRING, "param1",jsonrpc::JSON_OBJECT,"param2",jsonrpc::JSON_STRING, NULL), &dev::rpc::EthFace::eth_callI);
+                    this->bindAndAddMethod(jsonrpc::Procedure("eth_callMany", jsonrpc::PARAMS_BY_POSITION, jsonrpc::JSON_ARRAY, "param1",jsonrpc::JSON_ARRAY,"param2",jsonrpc::JSON_STRING, NULL), &dev::rpc::EthFace::eth_callManyI);
                     this->bindAndAddMethod(jsonrpc::Procedure("eth_flush", jsonrpc::PARAMS_BY_POSITION, jsonrpc::JSON_BOOLEAN,  NULL), &dev::rpc::EthFace::eth_flushI);
                     this->bindAndAddMethod(jsonrpc::Procedure("eth_getBlockByHash", jsonrpc::PARAMS_BY_POSITION, jsonrpc::JSON_OBJECT, "param1",jsonrpc::JSON_STRING,"param2",jsonrpc::JSON_BOOLEAN, NULL), &dev::rpc::EthFace::eth_getBlockByHashI);
                     this->bindAndAddMethod(jsonrpc::Procedure("eth_getBlockByNumber", jsonrpc::PARAMS_BY_POSITION, jsonrpc::JSON_OBJECT, "param1",jsonrpc::JSON_STRING,"param2",jsonrpc::JSON_BOOLEAN, NULL), &dev::rpc::EthFace::eth_getBlockByNumberI);
@@ -65,6 +66,8 @@ namespace dev {
                     this->bindAndAddMethod(jsonrpc::Procedure("eth_notePassword", jsonrpc::PARAMS_BY_POSITION, jsonrpc::JSON_BOOLEAN, "param1",jsonrpc::JSON_STRING, NULL), &dev::rpc::EthFace::eth_notePasswordI);
                     this->bindAndAddMethod(jsonrpc::Procedure("eth_syncing", jsonrpc::PARAMS_BY_POSITION, jsonrpc::JSON_OBJECT,  NULL), &dev::rpc::EthFace::eth_syncingI);
                     this->bindAndAddMethod(jsonrpc::Procedure("eth_estimateGas", jsonrpc::PARAMS_BY_POSITION, jsonrpc::JSON_STRING, "param1",jsonrpc::JSON_OBJECT, NULL), &dev::rpc::EthFace::eth_estimateGasI);
+                    this->bindAndAddMethod(jsonrpc::Procedure("eth_subscribe", jsonrpc::PARAMS_BY_POSITION, jsonrpc::JSON_STRING, "param1",jsonrpc::JSON_STRING, NULL), &dev::rpc::EthFace::eth_subscribeI);
+                    this->bindAndAddMethod(jsonrpc::Procedure("eth_unsubscribe", jsonrpc::PARAMS_BY_POSITION, jsonrpc::JSON_BOOLEAN, "param1",jsonrpc::JSON_STRING, NULL), &dev::rpc::EthFace::eth_unsubscribeI);
                 }
 
                 inline virtual void eth_protocolVersionI(const Json::Value &request, Json::Value &response)
@@ -151,6 +154,10 @@ namespace dev {
                 {
                     response = this->eth_call(request[0u], request[1u].asString());
                 }
+                inline virtual void eth_callManyI(const Json::Value &request, Json::Value &response)
+                {
+                    response = this->eth_callMany(request[0u], request[1u].asString());
+                }
                 inline virtual void eth_flushI(const Json::Value &request, Json::Value &response)
                 {
                     (void)request;
@@ -284,6 +291,14 @@ namespace dev {
                 {
                     response = this->eth_estimateGas(request[0u]);
                 }
+                inline virtual void eth_subscribeI(const Json::Value &request, Json::Value &response)
+                {
+                    response = this->eth_subscribe(request[0u].asString());
+                }
+                inline virtual void eth_unsubscribeI(const Json::Value &request, Json::Value &response)
+                {
+                    response = this->eth_unsubscribe(request[0u].asString());
+                }
                 virtual std::string eth_protocolVersion() = 0;
                 virtual std::string eth_hashrate() = 0;
                 virtual std::string eth_coinbase() = 0;
@@ -303,6 +318,7 @@ namespace dev {
                 virtual std::string eth_getCode(const std::string& param1, const std::string& param2) = 0;
                 virtual std::string eth_sendTransaction(const Json::Value& param1) = 0;
                 virtual std::string eth_call(const Json::Value& param1, const std::string& param2) = 0;
+                virtual Json::Value eth_callMany(const Json::Value& param1, const std::string& param2) = 0;
                 virtual bool eth_flush() = 0;
                 virtual Json::Value eth_getBlockByHash(const std::string& param1, bool param2) = 0;
                 virtual Json::Value eth_getBlockByNumber(const std::string& param1, bool param2) = 0;
@@ -335,6 +351,8 @@ namespace dev {
                 virtual bool eth_notePassword(const std::string& param1) = 0;
                 virtual Json::Value eth_syncing() = 0;
                 virtual std::string eth_estimateGas(const Json::Value& param1) = 0;
+                virtual std::string eth_subscribe(const std::string& param1) = 0;
+                virtual bool eth_unsubscribe(const std::string& param1) = 0;
         };
 
     }
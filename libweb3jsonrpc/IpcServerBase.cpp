@@ -38,6 +38,26 @@ struct IpcReceiveChannel: public LogChannel { static const char* name() { return
 #define cipcs dev::LogOutputStream<IpcSendChannel, true>()
 #define cipcr dev::LogOutputStream<IpcReceiveChannel, true>()
 
+namespace
+{
+
+/// Write lock and liveness of one IPC connection, shared between its reader thread and any pushers.
+struct IpcConnection
+{
+	std::mutex x_write;
+	bool open = true;
+};
+
+thread_local shared_ptr<IpcConnection> t_connection;
+thread_local IpcPush t_push;
+
+}
+
+IpcPush dev::currentIpcConnection()
+{
+	return t_push;
+}
+
 template <class S> IpcServerBase<S>::IpcServerBase(string const& _path):
 	m_path(_path)
 {
@@ -72,11 +92,20 @@ template <class S> bool IpcServerBase<S>::StopListening()
 }
 
 template <class S> bool IpcServerBase<S>::SendResponse(string const& _response, void* _addInfo)
+{
+	S socket = (S)(reinterpret_cast<intptr_t>(_addInfo));
+	if (!t_connection)
+		return WriteAll(socket, _response);
+	lock_guard<mutex> l(t_connection->x_write);
+	return WriteAll(socket, _response);
+}
+
+template <class S> bool IpcServerBase<S>::WriteAll(S _connection, string const& _data)
 {
 	bool fullyWritten = false;
 	bool errorOccured = false;
-	S socket = (S)(reinterpret_cast<intptr_t>(_addInfo));
-	string toSend = _response;
+	S socket = _connection;
+	string toSend = _data;
 	do
 	{
 		size_t bytesWritten = Write(socket, toSend);
@@ -90,7 +119,7 @@ template <class S> bool IpcServerBase<S>::SendResponse(string const& _response,
 		else
 			fullyWritten = true;
 	} while (!fullyWritten && !errorOccured);
-	cipcs << _response;
+	cipcs << _data;
 	return fullyWritten && !errorOccured;
 }
 
@@ -103,6 +132,15 @@ template <class S> void IpcServerBase<S>::GenerateResponse(S _connection)
 	size_t i = 0;
 	int depth = 0;
 	size_t nbytes = 0;
+
+	auto connection = make_shared<IpcConnection>();
+	t_connection = connection;
+	t_push = [this, connection, _connection](string const& _message)
+	{
+		lock_guard<mutex> l(connection->x_write);
+		return connection->open && WriteAll(_connection, _message);
+	};
+
 	do
 	{
 		nbytes = Read(_connection, buffer, c_bufferSize);
@@ -150,6 +188,12 @@ template <class S> void IpcServerBase<S>::GenerateResponse(S _connection)
 			i++;
 		}
 	} while (true);
+
+	DEV_GUARDED(connection->x_write)
+		connection->open = false;
+	t_push = IpcPush();
+	t_connection.reset();
+
 	DEV_GUARDED(x_sockets)
 		m_sockets.erase(_connection);
 }
@@ -23,6 +23,8 @@
 #pragma once
 
 #include <string>
+#include <functional>
+#include <memory>
 #include <thread>
 #include <mutex>
 #include <unordered_set>
@@ -30,6 +32,15 @@
 
 namespace dev
 {
+
+/// Writes a server-initiated message (e.g. a subscription notification) to an IPC client.
+/// @returns false once the connection has gone away.
+using IpcPush = std::function<bool(std::string const&)>;
+
+/// @returns a push channel to the IPC connection whose request is being handled on the calling thread,
+/// or an empty function if the request did not arrive over IPC.
+IpcPush currentIpcConnection();
+
 template <class S> class IpcServerBase: public jsonrpc::AbstractServerConnector
 {
 public:
@@ -44,6 +55,8 @@ protected:
 	virtual size_t Write(S _connection, std::string const& _data) = 0;
 	virtual size_t Read(S _connection, void* _data, size_t _size) = 0;
 	void GenerateResponse(S _connection);
+	/// Writes all of @a _data to @a _connection. Callers hold the connection's write lock.
+	bool WriteAll(S _connection, std::string const& _data);
 
 protected:
 	bool m_running = false;
@@ -124,7 +124,7 @@ Json::Value toJson(dev::eth::Transaction const& _t, std::pair<h256, unsigned> _l
 	if (_t)
 	{
 		res["hash"] = toJS(_t.sha3());
-		res["input"] = toJS(_t.data());
+		res["input"] = toJS(_t.data().toBytes());
 		res["to"] = _t.isCreation() ? Json::Value() : toJS(_t.receiveAddress());
 		res["from"] = toJS(_t.safeSender());
 		res["gas"] = toJS(_t.gas());
@@ -214,7 +214,7 @@ Json::Value toJson(dev::eth::Transaction const& _t)
 	res["gas"] = toJS(_t.gas());
 	res["gasPrice"] = toJS(_t.gasPrice());
 	res["value"] = toJS(_t.value());
-	res["data"] = toJS(_t.data(), 32);
+	res["data"] = toJS(_t.data().toBytes(), 32);
 	res["nonce"] = toJS(_t.nonce());
 	res["hash"] = toJS(_t.sha3(WithSignature));
 	res["sighash"] = toJS(_t.sha3(WithoutSignature));
@@ -230,7 +230,7 @@ Json::Value toJson(dev::eth::LocalisedTransaction const& _t)
 	if (_t)
 	{
 		res["hash"] = toJS(_t.sha3());
-		res["input"] = toJS(_t.data());
+		res["input"] = toJS(_t.data().toBytes());
 		res["to"] = _t.isCreation() ? Json::Value() : toJS(_t.receiveAddress());
 		res["from"] = toJS(_t.safeSender());
 		res["gas"] = toJS(_t.gas());
@@ -495,6 +495,7 @@ shh::Envelope toSealed(Json::Value const& _json, shh::Message const& _m, Secret
 {
 	unsigned ttl = 50;
 	unsigned workToProve = 50;
+	unsigned targetWork = 0;
 	shh::BuildTopic bt;
 
 	if (!_json["ttl"].empty())
@@ -503,6 +504,9 @@ shh::Envelope toSealed(Json::Value const& _json, shh::Message const& _m, Secret
 	if (!_json["workToProve"].empty())
 		workToProve = jsToInt(_json["workToProve"].asString());
 
+	if (!_json["targetWork"].empty())
+		targetWork = jsToInt(_json["targetWork"].asString());
+
 	if (!_json["topics"].empty())
 		for (auto i: _json["topics"])
 		{
@@ -516,7 +520,7 @@ shh::Envelope toSealed(Json::Value const& _json, shh::Message const& _m, Secret
 				bt.shift(jsToBytes(i.asString()));
 		}
 
-	return _m.seal(_from, bt, ttl, workToProve);
+	return _m.seal(_from, bt, ttl, workToProve, targetWork);
 }
 
 pair<shh::Topics, Public> toWatch(Json::Value const& _json)
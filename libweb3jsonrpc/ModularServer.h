@@ -30,7 +30,8 @@
 #include <jsonrpccpp/common/procedure.h>
 #include <jsonrpccpp/server/iprocedureinvokationhandler.h>
 #include <jsonrpccpp/server/abstractserverconnector.h>
-#include <jsonrpccpp/server/requesthandlerfactory.h>
+#include <libdevcore/Metrics.h>
+#include "BatchHandler.h"
 
 template <class I> using AbstractMethodPointer = void(I::*)(Json::Value const& _parameter, Json::Value& _result);
 template <class I> using AbstractNotificationPointer = void(I::*)(Json::Value const& _parameter);
@@ -69,7 +70,7 @@ class ModularServer: public jsonrpc::IProcedureInvokationHandler
 {
 public:
 	ModularServer()
-	: m_handler(jsonrpc::RequestHandlerFactory::createProtocolHandler(jsonrpc::JSONRPC_SERVER_V2, *this))
+	: m_handler(new dev::rpc::BatchHandler(*this))
 	{
 		m_handler->AddProcedure(jsonrpc::Procedure("rpc_modules", jsonrpc::PARAMS_BY_POSITION, jsonrpc::JSON_OBJECT, NULL));
 		m_implementedModules = Json::objectValue;
@@ -139,7 +140,9 @@ public:
 			return;
 		for (auto const& method: m_interface->methods())
 		{
-			m_methods[std::get<0>(method).GetProcedureName()] = std::get<1>(method);
+			std::string const& name = std::get<0>(method).GetProcedureName();
+			// Resolved here rather than per call, which would take the registry's lock on every request.
+			m_methods[name] = std::make_pair(std::get<1>(method), &dev::Metrics::get().histogram("rpc." + name));
 			this->m_handler->AddProcedure(std::get<0>(method));
 		}
 
@@ -157,7 +160,10 @@ public:
 	{
 		auto pointer = m_methods.find(_proc.GetProcedureName());
 		if (pointer != m_methods.end())
-			(m_interface.get()->*(pointer->second))(_input, _output);
+		{
+			dev::MeteredScope m(*pointer->second.second);
+			(m_interface.get()->*(pointer->second.first))(_input, _output);
+		}
 		else
 			ModularServer<Is...>::HandleMethodCall(_proc, _input, _output);
 	}
@@ -173,6 +179,6 @@ public:
 
 private:
 	std::unique_ptr<I> m_interface;
-	std::map<std::string, MethodPointer> m_methods;
+	std::map<std::string, std::pair<MethodPointer, dev::Histogram*>> m_methods;	///< With the histogram metering each method.
 	std::map<std::string, NotificationPointer> m_notifications;
 };
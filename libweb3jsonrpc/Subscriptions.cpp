@@ -0,0 +1,189 @@
+/*
+	This file is part of cpp-ethereum.
+
+	cpp-ethereum is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	cpp-ethereum is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with cpp-ethereum.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/** @file Subscriptions.cpp
+ * @date 2017
+ */
+
+#include "Subscriptions.h"
+#include <libdevcore/CommonJS.h>
+#include "JsonHelper.h"
+using namespace std;
+using namespace dev;
+using namespace dev::eth;
+using namespace dev::rpc;
+
+namespace
+{
+
+unsigned const c_idleWaitMs = 5;
+unsigned const c_maxEventsPerPoll = 256;
+/// How often a "newWork" subscription re-checks the work without being told; this also keeps the
+/// node's remote worker marked as active.
+chrono::seconds const c_workRecheck(5);
+
+string notification(string const& _id, Json::Value const& _result)
+{
+	Json::Value n(Json::objectValue);
+	n["jsonrpc"] = "2.0";
+	n["method"] = "eth_subscription";
+	n["params"]["subscription"] = _id;
+	n["params"]["result"] = _result;
+	return Json::FastWriter().write(n);
+}
+
+string overflow(string const& _id, uint64_t _missed)
+{
+	Json::Value n(Json::objectValue);
+	n["jsonrpc"] = "2.0";
+	n["method"] = "eth_subscription";
+	n["params"]["subscription"] = _id;
+	n["params"]["missed"] = Json::UInt64(_missed);
+	return Json::FastWriter().write(n);
+}
+
+Json::Value toJsonArray(h256s const& _hashes)
+{
+	Json::Value ret(Json::arrayValue);
+	for (auto const& h: _hashes)
+		ret.append(toJS(h));
+	return ret;
+}
+
+}
+
+Subscriptions::Subscriptions(ChainEventBus& _bus):
+	Worker("rpcsub", c_idleWaitMs),
+	m_bus(_bus)
+{
+	startWorking();
+}
+
+Subscriptions::~Subscriptions()
+{
+	stopWorking();
+}
+
+string Subscriptions::subscribe(string const& _kind, IpcPush const& _push, WorkSource const& _work)
+{
+	Kind kind;
+	if (_kind == "newHeads")
+		kind = Kind::NewHeads;
+	else if (_kind == "logs")
+		kind = Kind::Logs;
+	else if (_kind == "newPendingTransactions")
+		kind = Kind::PendingTransactions;
+	else if (_kind == "newWork" && _work)
+		kind = Kind::NewWork;
+	else
+		return string();
+
+	Guard l(x_subscriptions);
+	string id = toJS(++m_lastId);
+	m_subscriptions[id] = make_shared<Subscription>(m_bus, kind, _push, _work);
+	return id;
+}
+
+bool Subscriptions::unsubscribe(string const& _id)
+{
+	Guard l(x_subscriptions);
+	return m_subscriptions.erase(_id) > 0;
+}
+
+void Subscriptions::doWork()
+{
+	vector<pair<string, shared_ptr<Subscription>>> subscriptions;
+	DEV_GUARDED(x_subscriptions)
+		subscriptions.assign(m_subscriptions.begin(), m_subscriptions.end());
+
+	for (auto const& s: subscriptions)
+		if (!deliver(s.first, *s.second))
+			unsubscribe(s.first);
+}
+
+bool Subscriptions::deliver(string const& _id, Subscription& _s)
+{
+	vector<ChainEventPtr> events;
+	uint64_t missed = _s.events.poll(events, c_maxEventsPerPoll);
+	if (_s.kind == Kind::NewWork)
+	{
+		// Only the latest work matters, and missing some is no reason to tell.
+		int64_t publishedAt = 0;
+		for (ChainEventPtr const& e: events)
+			if (e->type == ChainEventType::NewWork)
+				publishedAt = e->publishedAt;
+		if (publishedAt || missed || chrono::steady_clock::now() - _s.lastWorkCheck > c_workRecheck)
+			return deliverWork(_id, _s, publishedAt);
+		return true;
+	}
+	if (missed && !_s.push(overflow(_id, missed)))
+		return false;
+
+	for (ChainEventPtr const& e: events)
+		switch (_s.kind)
+		{
+		case Kind::NewHeads:
+			if (e->type == ChainEventType::NewHead)
+			{
+				Json::Value r(Json::objectValue);
+				if (!e->liveBlocks.empty())
+					r["head"] = toJS(e->liveBlocks.back());
+				r["liveBlocks"] = toJsonArray(e->liveBlocks);
+				r["deadBlocks"] = toJsonArray(e->deadBlocks);
+				if (!_s.push(notification(_id, r)))
+					return false;
+			}
+			break;
+		case Kind::Logs:
+			if (e->type == ChainEventType::Logs)
+				for (LocalisedLogEntry const& l: e->logs)
+					if (!_s.push(notification(_id, toJson(l))))
+						return false;
+			break;
+		case Kind::PendingTransactions:
+			if (e->type == ChainEventType::PendingTransactions)
+				for (h256 const& h: e->transactions)
+					if (!_s.push(notification(_id, toJS(h))))
+						return false;
+			break;
+		case Kind::NewWork:
+			break;
+		}
+	return true;
+}
+
+bool Subscriptions::deliverWork(string const& _id, Subscription& _s, int64_t _publishedAt)
+{
+	_s.lastWorkCheck = chrono::steady_clock::now();
+	Json::Value work;
+	try
+	{
+		work = _s.work();
+	}
+	catch (...)
+	{
+		return true;
+	}
+	if (!work.isArray() || work.size() < 3 || work[0].asString() == _s.lastWork || jsToFixed<32>(work[0].asString()) == h256())
+		return true;
+	_s.lastWork = work[0].asString();
+
+	Json::Value r(Json::objectValue);
+	r["work"] = work;
+	// For the receiver to measure delivery latency; work found on a periodic check counts from now.
+	r["publishedAt"] = Json::Int64(_publishedAt ? _publishedAt : chrono::duration_cast<chrono::microseconds>(chrono::system_clock::now().time_since_epoch()).count());
+	return _s.push(notification(_id, r));
+}
@@ -0,0 +1,90 @@
+/*
+	This file is part of cpp-ethereum.
+
+	cpp-ethereum is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	cpp-ethereum is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with cpp-ethereum.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/** @file Subscriptions.h
+ * @date 2017
+ */
+
+#pragma once
+
+#include <chrono>
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <json/json.h>
+#include <libdevcore/Guards.h>
+#include <libdevcore/Worker.h>
+#include <libethereum/ChainEvents.h>
+#include "IpcServerBase.h"
+
+namespace dev
+{
+namespace rpc
+{
+
+/**
+ * @brief Pushes chain events to JSON-RPC subscribers ("eth_subscribe") as "eth_subscription" notifications.
+ * Each subscription reads the client's ChainEventBus through its own cursor on this worker's thread;
+ * a subscriber that falls behind gets a notification carrying the number of events it missed
+ * instead of slowing down block import.
+ */
+class Subscriptions: public Worker
+{
+public:
+	explicit Subscriptions(eth::ChainEventBus& _bus);
+	~Subscriptions();
+
+	/// Produces the current work package as eth_getWork returns it.
+	using WorkSource = std::function<Json::Value()>;
+
+	/// Subscribes @a _push to events of @a _kind ("newHeads", "logs", "newPendingTransactions" or "newWork").
+	/// "newWork" subscriptions need @a _work; it is called whenever new work was prepared, and periodically
+	/// otherwise, which keeps the node serving work to the subscriber.
+	/// @returns the subscription id, or an empty string if @a _kind is unknown.
+	std::string subscribe(std::string const& _kind, IpcPush const& _push, WorkSource const& _work = WorkSource());
+	/// @returns false if @a _id does not name a subscription.
+	bool unsubscribe(std::string const& _id);
+
+private:
+	enum class Kind { NewHeads, Logs, PendingTransactions, NewWork };
+
+	struct Subscription
+	{
+		Subscription(eth::ChainEventBus const& _bus, Kind _kind, IpcPush const& _push, WorkSource const& _work): kind(_kind), push(_push), work(_work), events(_bus) {}
+		Kind kind;
+		IpcPush push;
+		WorkSource work;
+		std::string lastWork;								///< Header hash of the last work package pushed.
+		std::chrono::steady_clock::time_point lastWorkCheck;
+		eth::ChainEventSubscriber events;
+	};
+
+	void doWork() override;
+	/// Sends everything @a _s has not seen yet. @returns false if its connection is gone.
+	bool deliver(std::string const& _id, Subscription& _s);
+	/// Pushes the current work package to @a _s if it changed. @returns false if its connection is gone.
+	bool deliverWork(std::string const& _id, Subscription& _s, int64_t _publishedAt);
+
+	eth::ChainEventBus& m_bus;
+
+	Mutex x_subscriptions;
+	std::map<std::string, std::shared_ptr<Subscription>> m_subscriptions;
+	unsigned m_lastId = 0;
+};
+
+}
+}
@@ -19,6 +19,11 @@
  * @date 2014
  */
 
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <thread>
 #include "Message.h"
 #include "BloomFilter.h"
 
@@ -97,7 +102,7 @@ bool Message::populate(bytes const& _data)
 	return true;
 }
 
-Envelope Message::seal(Secret const& _from, Topics const& _fullTopics, unsigned _ttl, unsigned _workToProve) const
+Envelope Message::seal(Secret const& _from, Topics const& _fullTopics, unsigned _ttl, unsigned _workToProve, unsigned _targetWork) const
 {
 	AbridgedTopics topics = abridge(_fullTopics);
 	Envelope ret(utcTime() + _ttl, _ttl, topics);
@@ -134,7 +139,7 @@ Envelope Message::seal(Secret const& _from, Topics const& _fullTopics, unsigned
 		ret.m_data += d;
 	}
 
-	ret.proveWork(_workToProve);
+	ret.proveWork(_workToProve, _targetWork);
 	return ret;
 }
 
@@ -160,24 +165,148 @@ unsigned Envelope::workProved() const
 	return dev::sha3(bytesConstRef(d[0].data(), 64)).firstBitSet();
 }
 
-void Envelope::proveWork(unsigned _ms)
+namespace
 {
-	h256 d[2];
-	d[0] = sha3(WithoutNonce);
-	unsigned bestBitSet = 0;
-	bytesConstRef chuck(d[0].data(), 64);
 
-	chrono::high_resolution_clock::time_point then = chrono::high_resolution_clock::now() + chrono::milliseconds(_ms);
-	while (chrono::high_resolution_clock::now() < then)
-		// do it rounds of 1024 for efficiency
-		for (unsigned i = 0; i < 1024; ++i, ++d[1])
-		{
-			auto fbs = dev::sha3(chuck).firstBitSet();
-			if (fbs > bestBitSet)
+/// Targets of at most this many bits take a few thousand hashes; handing them out costs more than it saves.
+static unsigned const c_singleThreadWork = 12;
+
+/// Helper threads for proveWork(), started on first use and shared by all envelopes, so that
+/// concurrent posts share the hardware rather than each starting a thread per core.
+class ProofOfWorkPool
+{
+public:
+	static ProofOfWorkPool& get() { static ProofOfWorkPool s_this; return s_this; }
+
+	unsigned size() const { return m_workers.size(); }
+
+	void post(function<void()> _f)
+	{
+		DEV_GUARDED(x_queue)
+			m_queue.push_back(move(_f));
+		m_queueChanged.notify_one();
+	}
+
+private:
+	ProofOfWorkPool()
+	{
+		unsigned threads = max(thread::hardware_concurrency(), 2u) - 1;
+		for (unsigned i = 0; i < threads; ++i)
+			m_workers.push_back(thread([this]()
 			{
-				bestBitSet = fbs;
-				m_nonce = (h256::Arith)d[1];
+				while (true)
+				{
+					function<void()> f;
+					{
+						unique_lock<Mutex> l(x_queue);
+						m_queueChanged.wait(l, [this]() { return m_stopping || !m_queue.empty(); });
+						if (m_queue.empty())
+							return;
+						f = move(m_queue.front());
+						m_queue.pop_front();
+					}
+					f();
+				}
+			}));
+	}
+
+	~ProofOfWorkPool()
+	{
+		DEV_GUARDED(x_queue)
+			m_stopping = true;
+		m_queueChanged.notify_all();
+		for (auto& w: m_workers)
+			w.join();
+	}
+
+	vector<thread> m_workers;
+	Mutex x_queue;
+	condition_variable m_queueChanged;
+	deque<function<void()>> m_queue;
+	bool m_stopping = false;
+};
+
+/// One proveWork() call, shared with the helpers so that one starting late touches nothing of the caller's.
+struct ProofOfWorkSearch
+{
+	h256 seed;
+	unsigned targetWork;
+	chrono::high_resolution_clock::time_point then;
+	atomic<bool> found{false};
+	vector<pair<unsigned, h256>> best;
+
+	Mutex x_helpers;
+	condition_variable helpersDone;
+	unsigned activeHelpers = 0;
+	bool closed = false;	///< Set once the caller is done; helpers that start later do nothing.
+
+	void run(unsigned _i)
+	{
+		h256 d[2];
+		d[0] = seed;
+		// each part starts from a distinct region of the nonce space
+		d[1] = h256(u256(_i) << 224);
+		bytesConstRef chuck(d[0].data(), 64);
+		while (!found && chrono::high_resolution_clock::now() < then)
+			// do it rounds of 1024 for efficiency
+			for (unsigned i = 0; i < 1024; ++i, ++d[1])
+			{
+				auto fbs = dev::sha3(chuck).firstBitSet();
+				if (fbs > best[_i].first)
+				{
+					best[_i] = make_pair(fbs, d[1]);
+					if (targetWork && fbs >= targetWork)
+						found = true;
+				}
 			}
+	}
+
+	void help(unsigned _i)
+	{
+		DEV_GUARDED(x_helpers)
+		{
+			if (closed)
+				return;
+			++activeHelpers;
+		}
+		run(_i);
+		DEV_GUARDED(x_helpers)
+			--activeHelpers;
+		helpersDone.notify_all();
+	}
+};
+
+}
+
+void Envelope::proveWork(unsigned _ms, unsigned _targetWork, unsigned _threads)
+{
+	ProofOfWorkPool& pool = ProofOfWorkPool::get();
+	if (!_threads || _threads > pool.size() + 1)
+		_threads = pool.size() + 1;
+	if (_targetWork && _targetWork <= c_singleThreadWork)
+		_threads = 1;
+
+	auto search = make_shared<ProofOfWorkSearch>();
+	search->seed = sha3(WithoutNonce);
+	search->targetWork = _targetWork;
+	search->then = chrono::high_resolution_clock::now() + chrono::milliseconds(_ms);
+	search->best.resize(_threads);
+
+	for (unsigned i = 1; i < _threads; ++i)
+		pool.post([search, i]() { search->help(i); });
+	search->run(0);
+	{
+		unique_lock<Mutex> l(search->x_helpers);
+		search->closed = true;
+		search->helpersDone.wait(l, [&]() { return search->activeHelpers == 0; });
+	}
+
+	unsigned bestBitSet = 0;
+	for (auto const& b: search->best)
+		if (b.first > bestBitSet)
+		{
+			bestBitSet = b.first;
+			m_nonce = (h256::Arith)b.second;
 		}
 }
 
@@ -68,7 +68,11 @@ public:
 	h256 sha3(IncludeNonce _withNonce = WithNonce) const { RLPStream s; streamRLP(s, _withNonce); return dev::sha3(s.out()); }
 	Message open(Topics const& _t, Secret const& _s = Secret()) const;
 	unsigned workProved() const;
-	void proveWork(unsigned _ms);
+	/// Searches for the nonce proving the most work within @a _ms milliseconds, splitting the nonce space
+	/// between the calling thread and up to @a _threads - 1 threads of a shared pool (0 to use all of them).
+	/// The search stops early once a nonce proving at least @a _targetWork bits is found (0 to use the
+	/// whole time budget); small targets are searched on the calling thread alone.
+	void proveWork(unsigned _ms, unsigned _targetWork = 0, unsigned _threads = 0);
 
 	unsigned sent() const { return m_expiry - m_ttl; }
 	unsigned expiry() const { return m_expiry; }
@@ -90,6 +94,8 @@ private:
 	bytes m_data;
 };
 
+using Envelopes = std::vector<Envelope>;
+
 enum /*Message Flags*/
 {
 	ContainsSignature = 1
@@ -118,7 +124,7 @@ public:
 	operator bool() const { return !!m_payload.size() || m_from || m_to; }
 
 	/// Turn this message into a ditributable Envelope.
-	Envelope seal(Secret const& _from, Topics const& _topics, unsigned _ttl = 50, unsigned _workToProve = 50) const;
+	Envelope seal(Secret const& _from, Topics const& _topics, unsigned _ttl = 50, unsigned _workToProve = 50, unsigned _targetWork = 0) const;
 	// Overloads for skipping _from or specifying _to.
 	Envelope seal(Topics const& _topics, unsigned _ttl = 50, unsigned _workToProve = 50) const { return seal(Secret(), _topics, _ttl, _workToProve); }
 	Envelope sealTo(Public _to, Topics const& _topics, unsigned _ttl = 50, unsigned _workToProve = 50) { m_to = _to; return seal(Secret(), _topics, _ttl, _workToProve); }
@@ -20,6 +20,7 @@
  */
 
 #include "WhisperDB.h"
+#include <limits>
 #include <boost/filesystem.hpp>
 #include <libdevcore/FileSystem.h>
 #include "WhisperHost.h"
@@ -29,10 +30,10 @@ using namespace dev;
 using namespace dev::shh;
 namespace fs = boost::filesystem;
 
-WhisperDB::WhisperDB(string const& _type)
+WhisperDB::WhisperDB(string const& _type, string const& _path)
 {
 	m_readOptions.verify_checksums = true;
-	string path = dev::getDataDir("shh");
+	string path = _path.empty() ? dev::getDataDir("shh") : _path;
 	fs::create_directories(path);
 	DEV_IGNORE_EXCEPTIONS(fs::permissions(path, fs::owner_all));
 	path += "/" + _type;
@@ -82,19 +83,49 @@ void WhisperDB::kill(dev::h256 const& _key)
 		BOOST_THROW_EXCEPTION(FailedDeleteInLevelDB(status.ToString()));
 }
 
+shared_ptr<WhisperMessagesDB> WhisperMessagesDB::shared(string const& _path)
+{
+	static Mutex s_x;
+	static map<string, weak_ptr<WhisperMessagesDB>> s_open;
+	Guard l(s_x);
+	shared_ptr<WhisperMessagesDB> ret = s_open[_path].lock();
+	if (!ret)
+	{
+		ret = make_shared<WhisperMessagesDB>(_path);
+		s_open[_path] = ret;
+	}
+	return ret;
+}
+
 void WhisperMessagesDB::loadAllMessages(std::map<h256, Envelope>& o_dst)
 {
-	leveldb::ReadOptions op;
-	op.fill_cache = false;
-	op.verify_checksums = true;
-	vector<string> wasted;
-	unique_ptr<leveldb::Iterator> it(m_db->NewIterator(op));
-	unsigned const now = utcTime();
+	Cursor cursor;
+	while (loadMessages(o_dst, numeric_limits<unsigned>::max(), cursor)) {}
+	cdebug << "WhisperDB::loadAll(): loaded " << o_dst.size() << "messages";
+}
 
-	for (it->SeekToFirst(); it->Valid(); it->Next())
+bool WhisperMessagesDB::loadMessages(std::map<h256, Envelope>& o_dst, unsigned _max, Cursor& io_cursor)
+{
+	if (!io_cursor)
 	{
-		leveldb::Slice const k = it->key();
-		leveldb::Slice const v = it->value();
+		leveldb::ReadOptions op;
+		op.fill_cache = false;
+		op.verify_checksums = true;
+		io_cursor.reset(m_db->NewIterator(op));
+		io_cursor->SeekToFirst();
+	}
+
+	leveldb::WriteBatch batch;
+	unsigned const now = utcTime();
+	unsigned loaded = 0;
+	unsigned wasted = 0;
+	for (; io_cursor->Valid() && loaded < _max; io_cursor->Next())
+	{
+		leveldb::Slice const k = io_cursor->key();
+		if (k.size() != h256::size)
+			continue;	// expiry index entry
+
+		leveldb::Slice const v = io_cursor->value();
 		bool useless = true;
 
 		try
@@ -102,51 +133,117 @@ void WhisperMessagesDB::loadAllMessages(std::map<h256, Envelope>& o_dst)
 			RLP rlp((byte const*)v.data(), v.size());
 			Envelope e(rlp);
 			h256 h2 = e.sha3();
-			h256 h1;
-
-			if (k.size() == h256::size)
-				h1 = h256((byte const*)k.data(), h256::ConstructFromPointer);
+			h256 h1((byte const*)k.data(), h256::ConstructFromPointer);
 
 			if (h1 != h2)
 				cwarn << "Corrupted data in Level DB:" << h1.hex() << "versus" << h2.hex();
 			else if (e.expiry() > now)
 			{
+				// envelopes stored before the expiry index existed get their entry now.
+				bytes const ek = expiryKey(e.expiry(), h1);
+				batch.Put(leveldb::Slice((char const*)ek.data(), ek.size()), leveldb::Slice());
 				o_dst[h1] = e;
 				useless = false;
+				++loaded;
 			}
 		}
 		catch(RLPException const& ex)
 		{
-			cwarn << "RLPException in WhisperDB::loadAll():" << ex.what();
+			cwarn << "RLPException in WhisperDB::loadMessages():" << ex.what();
 		}
 		catch(Exception const& ex)
 		{
-			cwarn << "Exception in WhisperDB::loadAll():" << ex.what();
+			cwarn << "Exception in WhisperDB::loadMessages():" << ex.what();
 		}
 
 		if (useless)
-			wasted.push_back(k.ToString());
+		{
+			batch.Delete(k);
+			++wasted;
+		}
 	}
 
-	cdebug << "WhisperDB::loadAll(): loaded " << o_dst.size() << ", deleted " << wasted.size() << "messages";
+	if (wasted)
+		cdebug << "WhisperDB::loadMessages(): deleted " << wasted << "messages";
+
+	leveldb::Status status = m_db->Write(m_writeOptions, &batch);
+	if (!status.ok())
+		cwarn << "Failed to update Level DB while loading:" << status.ToString();
+
+	if (io_cursor->Valid())
+		return true;
+	io_cursor.reset();
+	return false;
+}
 
-	for (auto const& k: wasted)
+void WhisperMessagesDB::saveMessages(std::map<h256, Envelope> const& _es)
+{
+	leveldb::WriteBatch batch;
+	for (auto const& i: _es)
 	{
-		leveldb::Status status = m_db->Delete(m_writeOptions, k);
+		RLPStream rlp;
+		i.second.streamRLP(rlp);
+		bytes const& v = rlp.out();
+		bytes const ek = expiryKey(i.second.expiry(), i.first);
+		batch.Put(leveldb::Slice((char const*)i.first.data(), i.first.size), leveldb::Slice((char const*)v.data(), v.size()));
+		batch.Put(leveldb::Slice((char const*)ek.data(), ek.size()), leveldb::Slice());
+	}
+
+	leveldb::Status status = m_db->Write(m_writeOptions, &batch);
+	if (!status.ok())
+		BOOST_THROW_EXCEPTION(FailedInsertInLevelDB(status.ToString()));
+}
+
+unsigned WhisperMessagesDB::deleteExpired(unsigned _now)
+{
+	leveldb::ReadOptions op;
+	op.fill_cache = false;
+	unique_ptr<leveldb::Iterator> it(m_db->NewIterator(op));
+	leveldb::WriteBatch batch;
+	unsigned ret = 0;
+
+	byte const prefix = c_expiryIndexPrefix;
+	for (it->Seek(leveldb::Slice((char const*)&prefix, 1)); it->Valid(); it->Next())
+	{
+		leveldb::Slice const k = it->key();
+		if (!k.size() || (byte)k.data()[0] != c_expiryIndexPrefix)
+			break;
+		if (k.size() != 1 + sizeof(uint32_t) + h256::size)
+			continue;	// an envelope whose hash happens to start with the prefix
+
+		bytesConstRef key((byte const*)k.data(), k.size());
+		if (fromBigEndian<unsigned>(key.cropped(1, sizeof(uint32_t))) > _now)
+			break;
+
+		batch.Delete(k);
+		batch.Delete(leveldb::Slice((char const*)key.cropped(1 + sizeof(uint32_t)).data(), h256::size));
+		++ret;
+	}
+
+	if (ret)
+	{
+		leveldb::Status status = m_db->Write(m_writeOptions, &batch);
 		if (!status.ok())
-			cwarn << "Failed to delete an entry from Level DB:" << k;
+			BOOST_THROW_EXCEPTION(FailedDeleteInLevelDB(status.ToString()));
 	}
+	return ret;
+}
+
+bytes WhisperMessagesDB::expiryKey(unsigned _expiry, h256 const& _h)
+{
+	bytes ret(1 + sizeof(uint32_t));
+	ret[0] = c_expiryIndexPrefix;
+	bytesRef be = bytesRef(&ret).cropped(1);
+	toBigEndian(uint32_t(_expiry), be);
+	ret += _h.asBytes();
+	return ret;
 }
 
 void WhisperMessagesDB::saveSingleMessage(h256 const& _key, Envelope const& _e)
 {
 	try
 	{
-		RLPStream rlp;
-		_e.streamRLP(rlp);
-		bytes b;
-		rlp.swapOut(b);
-		insert(_key, b);
+		saveMessages(map<h256, Envelope>{{_key, _e}});
 	}
 	catch(RLPException const& ex)
 	{
@@ -42,7 +42,8 @@ class WhisperHost;
 class WhisperDB
 {
 public:
-	WhisperDB(std::string const& _type);
+	/// Opens the store @a _type in @a _path, by default the Whisper data directory.
+	WhisperDB(std::string const& _type, std::string const& _path = std::string());
 	virtual ~WhisperDB() {}
 	std::string lookup(dev::h256 const& _key) const;
 	void insert(dev::h256 const& _key, std::string const& _value);
@@ -55,13 +56,43 @@ protected:
 	std::unique_ptr<leveldb::DB> m_db;
 };
 
+/**
+ * @brief Store of Whisper envelopes keyed by their hash.
+ * Next to each envelope an expiry index entry (prefix, big-endian expiry, hash) is kept, so that expired
+ * envelopes are found by a range scan of the index instead of reading the whole store.
+ */
 class WhisperMessagesDB: public WhisperDB
 {
 public:
-	WhisperMessagesDB(): WhisperDB("messages") {}
+	/// Position of an incremental load; null before the first loadMessages().
+	using Cursor = std::unique_ptr<leveldb::Iterator>;
+
+	explicit WhisperMessagesDB(std::string const& _path = std::string()): WhisperDB("messages", _path) {}
 	virtual ~WhisperMessagesDB() {}
+
+	/// @returns the message store in @a _path, shared by everyone in the process holding it open, as
+	/// LevelDB locks the store against being opened twice. @throws FailedToOpenLevelDB
+	static std::shared_ptr<WhisperMessagesDB> shared(std::string const& _path = std::string());
+
 	void loadAllMessages(std::map<h256, Envelope>& o_dst);
 	void saveSingleMessage(dev::h256 const& _key, Envelope const& _e);
+
+	/// Writes the envelopes and their expiry index entries in a single batch.
+	void saveMessages(std::map<h256, Envelope> const& _es);
+
+	/// Loads up to @a _max further unexpired envelopes into @a o_dst, continuing from @a io_cursor.
+	/// Expired or corrupted entries met on the way are deleted.
+	/// @returns false once the whole store has been read.
+	bool loadMessages(std::map<h256, Envelope>& o_dst, unsigned _max, Cursor& io_cursor);
+
+	/// Deletes all envelopes expiring at or before @a _now, as listed in the expiry index.
+	/// @returns the number of envelopes deleted.
+	unsigned deleteExpired(unsigned _now);
+
+private:
+	static bytes expiryKey(unsigned _expiry, h256 const& _h);
+
+	static const byte c_expiryIndexPrefix = 'x';
 };
 
 class WhisperFiltersDB: public WhisperDB
@@ -30,13 +30,29 @@ using namespace dev;
 using namespace dev::p2p;
 using namespace dev::shh;
 
-WhisperHost::WhisperHost(bool _storeMessagesInDB): Worker("shh"), m_storeMessagesInDB(_storeMessagesInDB)
+constexpr std::chrono::seconds WhisperHost::c_expiryInterval;
+
+WhisperHost::WhisperHost(bool _storeMessagesInDB, string const& _dbPath): Worker("shh"), m_storeMessagesInDB(_storeMessagesInDB)
 {
-	loadMessagesFromBD();
+	m_memoryReport = MemoryAccounting::get().add("whisper", [this]() { return memoryUsage(); }, [this]() { cleanup(); });
+
+	if (!m_storeMessagesInDB)
+		return;
+
+	try
+	{
+		m_db = WhisperMessagesDB::shared(_dbPath);
+		m_loading = true;
+	}
+	catch(FailedToOpenLevelDB const& ex)
+	{
+		cwarn << "Exception in WhisperHost::WhisperHost() - failed to open DB:" << ex.what();
+	}
 }
 
 WhisperHost::~WhisperHost()
 {
+	stopWorking();
 	saveMessagesToBD();
 }
 
@@ -53,61 +69,100 @@ void WhisperHost::streamMessage(h256 _m, RLPStream& _s) const
 }
 
 void WhisperHost::inject(Envelope const& _m, WhisperPeer* _p)
+{
+	inject(Envelopes{_m}, _p);
+}
+
+void WhisperHost::inject(Envelopes const& _es, WhisperPeer* _p)
 {
 	// this function processes both outgoing messages originated both by local host (_p == null)
 	// and incoming messages from remote peers (_p != null)
 
-	//cnote << this << ": inject: " << _m.expiry() << _m.ttl() << _m.topic() << toHex(_m.data());
-
-	if (_m.isExpired())
-		return;
-
-	auto h = _m.sha3();
+	struct Checked
 	{
-		UpgradableGuard l(x_messages);
-		if (m_messages.count(h))
-			return;
-		UpgradeGuard ll(l);
-		m_messages[h] = _m;
-		m_expiryQueue.insert(make_pair(_m.expiry(), h));
-	}
+		Envelope const* envelope;
+		h256 hash;
+		unsigned workProved;
+		int rating;
+		bool watched;
+	};
+
+	// drop expired envelopes, repeats within the batch and those already known, then evaluate the proof
+	// of work of the rest outside the lock; most envelopes a peer relays are ones we have already seen.
+	vector<Checked> checked;
+	checked.reserve(_es.size());
+	h256Hash batch;
+	for (auto const& e: _es)
+		if (!e.isExpired())
+		{
+			h256 h = e.sha3();
+			if (batch.insert(h).second)
+				checked.push_back(Checked{&e, h, 0, 0, false});
+		}
+	DEV_READ_GUARDED(x_messages)
+		checked.erase(remove_if(checked.begin(), checked.end(), [&](Checked const& c) { return m_messages.count(c.hash); }), checked.end());
+	if (checked.empty())
+		return;
+	for (auto& c: checked)
+		c.workProved = c.envelope->workProved();
+	m_workEvaluated += checked.size();
+
+	vector<Checked> fresh;
+	fresh.reserve(checked.size());
+	DEV_WRITE_GUARDED(x_messages)
+		for (auto const& c: checked)
+			if (m_messages.insert(make_pair(c.hash, *c.envelope)).second)
+			{
+				m_expiryQueue.insert(make_pair(c.envelope->expiry(), c.hash));
+				fresh.push_back(c);
+			}
+	checked.swap(fresh);
 
 	// rating of incoming message from remote host is assessed according to the following criteria:
 	// 1. installed watch match; 2. bloom filter match; 2. ttl; 3. proof of work
 
-	int rating = 0;
-
 	DEV_GUARDED(m_filterLock)
-		if (_m.matchesBloomFilter(m_bloom))
-		{
-			++rating;
-			for (auto const& f: m_filters)
-				if (f.second.filter.matches(_m))
-					for (auto& i: m_watches)
-						if (i.second.id == f.first) // match one of the watches
-						{
-							i.second.changes.push_back(h);
-							rating += 2;
-						}
-		}
+		for (auto& c: checked)
+			if (c.envelope->matchesBloomFilter(m_bloom))
+			{
+				++c.rating;
+				for (auto const& f: m_filters)
+					if (f.second.filter.matches(*c.envelope))
+						for (auto& i: m_watches)
+							if (i.second.id == f.first) // match one of the watches
+							{
+								i.second.changes.push_back(c.hash);
+								c.rating += 2;
+								c.watched = true;
+							}
+			}
+
+	// only envelopes someone watches are worth keeping across restarts.
+	if (m_db)
+		DEV_GUARDED(x_unsaved)
+			for (auto const& c: checked)
+				if (c.watched)
+					m_unsaved[c.hash] = *c.envelope;
 
 	if (_p) // incoming message from remote peer
-	{
-		rating *= 256;
-		unsigned ttlReward = (256 > _m.ttl() ? 256 - _m.ttl() : 0);
-		rating += ttlReward;
-		rating *= 256;
-		rating += _m.workProved();
-	}
+		for (auto& c: checked)
+		{
+			c.rating *= 256;
+			unsigned ttlReward = (256 > c.envelope->ttl() ? 256 - c.envelope->ttl() : 0);
+			c.rating += ttlReward;
+			c.rating *= 256;
+			c.rating += c.workProved;
+		}
 
 	// TODO p2p: capability-based rating
 	for (auto i: peerSessions())
 	{
 		auto w = capabilityFromSession<WhisperPeer>(*i.first).get();
-		if (w == _p)
-			w->addRating(rating);
-		else
-			w->noteNewMessage(h, _m);
+		for (auto const& c: checked)
+			if (w == _p)
+				w->addRating(c.rating);
+			else
+				w->noteNewMessage(c.hash, *c.envelope, c.workProved);
 	}
 }
 
@@ -131,6 +186,18 @@ unsigned WhisperHost::installWatch(shh::Topics const& _t)
 		cwatshh << "+++" << ret << h;
 	}
 
+	// envelopes already here are now worth keeping too.
+	if (m_db)
+	{
+		map<h256, Envelope> matching;
+		DEV_READ_GUARDED(x_messages)
+			for (auto const& m: m_messages)
+				if (f.filter.matches(m.second))
+					matching.insert(m);
+		DEV_GUARDED(x_unsaved)
+			m_unsaved.insert(matching.begin(), matching.end());
+	}
+
 	noteAdvertiseTopicsOfInterest();
 	return ret;
 }
@@ -160,8 +227,37 @@ void WhisperHost::uninstallWatch(unsigned _i)
 	noteAdvertiseTopicsOfInterest();
 }
 
+Envelope WhisperHost::envelope(h256 _m) const
+{
+	DEV_READ_GUARDED(x_messages)
+	{
+		auto it = m_messages.find(_m);
+		if (it != m_messages.end())
+			return it->second;
+	}
+
+	// not loaded yet, perhaps.
+	if (m_loading)
+		try
+		{
+			string const s = m_db->lookup(_m);
+			if (!s.empty())
+			{
+				RLP rlp(s);
+				Envelope e(rlp);
+				if (!e.isExpired())
+					return e;
+			}
+		}
+		catch (...) {}
+	return Envelope();
+}
+
 h256s WhisperHost::watchMessages(unsigned _watchId)
 {
+	if (m_loading)
+		loadMessagesFromBD(numeric_limits<unsigned>::max());
+
 	h256s ret;
 	auto wit = m_watches.find(_watchId);
 	if (wit == m_watches.end())
@@ -204,6 +300,14 @@ void WhisperHost::doWork()
 	for (auto i: peerSessions())
 		capabilityFromSession<WhisperPeer>(*i.first)->sendMessages();
 	cleanup();
+
+	if (m_db)
+	{
+		saveMessagesToBD();
+		if (m_loading)
+			loadMessagesFromBD();
+		deleteExpiredFromBD();
+	}
 }
 
 void WhisperHost::cleanup()
@@ -216,6 +320,32 @@ void WhisperHost::cleanup()
 		m_messages.erase(it->second);
 }
 
+MemoryUsage WhisperHost::memoryUsage() const
+{
+	// Map nodes and the envelope's fixed fields on top of its payload.
+	static const uint64_t c_overhead = sizeof(Envelope) + sizeof(h256) + 64;
+	MemoryUsage ret;
+	DEV_READ_GUARDED(x_messages)
+	{
+		for (auto const& i: m_messages)
+			ret.bytes += i.second.data().size() + c_overhead;
+		ret.items += m_messages.size();
+	}
+	DEV_GUARDED(x_unsaved)
+	{
+		for (auto const& i: m_unsaved)
+			ret.bytes += i.second.data().size() + c_overhead;
+		ret.items += m_unsaved.size();
+	}
+	DEV_GUARDED(m_filterLock)
+		for (auto const& i: m_watches)
+		{
+			ret.bytes += sizeof(ClientWatch) + i.second.changes.size() * sizeof(h256);
+			ret.items += i.second.changes.size();
+		}
+	return ret;
+}
+
 void WhisperHost::noteAdvertiseTopicsOfInterest()
 {
 	for (auto i: peerSessions())
@@ -236,22 +366,18 @@ bool WhisperHost::isWatched(Envelope const& _e) const
 
 void WhisperHost::saveMessagesToBD()
 {
-	if (!m_storeMessagesInDB)
+	if (!m_db)
+		return;
+
+	map<h256, Envelope> unsaved;
+	DEV_GUARDED(x_unsaved)
+		unsaved.swap(m_unsaved);
+	if (unsaved.empty())
 		return;
 
 	try
 	{
-		WhisperMessagesDB db;
-		ReadGuard g(x_messages);
-		uint64_t now = utcTime();
-		for (auto const& m: m_messages)
-			if (m.second.expiry() > now)
-				if (isWatched(m.second))
-					db.saveSingleMessage(m.first, m.second);
-	}
-	catch(FailedToOpenLevelDB const& ex)
-	{
-		cwarn << "Exception in WhisperHost::saveMessagesToBD() - failed to open DB:" << ex.what();
+		m_db->saveMessages(unsaved);
 	}
 	catch(Exception const& ex)
 	{
@@ -263,27 +389,47 @@ void WhisperHost::saveMessagesToBD()
 	}
 }
 
-void WhisperHost::loadMessagesFromBD()
+void WhisperHost::loadMessagesFromBD(unsigned _max)
 {
-	if (!m_storeMessagesInDB)
+	Guard l(x_loading);
+	if (!m_loading)
 		return;
 
 	try
 	{
 		map<h256, Envelope> m;
-		WhisperMessagesDB db;
-		db.loadAllMessages(m);
-		WriteGuard g(x_messages);
-		m_messages.swap(m);
-		for (auto const& msg: m)
-			m_expiryQueue.insert(make_pair(msg.second.expiry(), msg.first));
+		m_loading = m_db->loadMessages(m, _max, m_loader);
+		DEV_WRITE_GUARDED(x_messages)
+			for (auto const& msg: m)
+				if (m_messages.insert(msg).second)
+					m_expiryQueue.insert(make_pair(msg.second.expiry(), msg.first));
 	}
 	catch(Exception const& ex)
 	{
 		cwarn << "Exception in WhisperHost::loadMessagesFromBD():" << ex.what();
+		m_loading = false;
 	}
 	catch(...)
 	{
 		cwarn << "Unknown Exception in WhisperHost::loadMessagesFromBD()";
+		m_loading = false;
+	}
+}
+
+void WhisperHost::deleteExpiredFromBD()
+{
+	auto now = chrono::steady_clock::now();
+	if (now - m_lastExpiry < c_expiryInterval)
+		return;
+	m_lastExpiry = now;
+
+	try
+	{
+		if (unsigned n = m_db->deleteExpired(utcTime()))
+			clog(NetAllDetail) << "Deleted" << n << "expired messages from the message store";
+	}
+	catch(Exception const& ex)
+	{
+		cwarn << "Exception in WhisperHost::deleteExpiredFromBD():" << ex.what();
 	}
 }
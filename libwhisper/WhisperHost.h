@@ -21,6 +21,7 @@
 
 #pragma once
 
+#include <atomic>
 #include <mutex>
 #include <array>
 #include <set>
@@ -30,11 +31,13 @@
 #include <libdevcore/RLP.h>
 #include <libdevcore/Worker.h>
 #include <libdevcore/Guards.h>
+#include <libdevcore/MemoryAccounting.h>
 #include <libdevcore/SHA3.h>
 #include "Common.h"
 #include "WhisperPeer.h"
 #include "Interface.h"
 #include "BloomFilter.h"
+#include "WhisperDB.h"
 
 namespace dev
 {
@@ -48,7 +51,8 @@ class WhisperHost: public HostCapability<WhisperPeer>, public Interface, public
 	friend class WhisperPeer;
 
 public:
-	WhisperHost(bool _storeMessagesInDB = false);
+	/// @param _dbPath where to keep the message store if @a _storeMessagesInDB; by default the Whisper data directory.
+	WhisperHost(bool _storeMessagesInDB = false, std::string const& _dbPath = std::string());
 	virtual ~WhisperHost();
 	unsigned protocolVersion() const { return WhisperProtocolVersion; }
 	void cleanup(); ///< remove old messages
@@ -56,13 +60,18 @@ public:
 	TopicBloomFilterHash bloom() const { dev::Guard l(m_filterLock); return m_bloom; }
 
 	virtual void inject(Envelope const& _e, WhisperPeer* _from = nullptr) override;
+	/// Injects a batch of envelopes. Hashes, expiry and proof of work are evaluated for the whole batch
+	/// before the message store and the filters are locked, each of which is then locked once.
+	void inject(Envelopes const& _es, WhisperPeer* _from = nullptr);
+	/// @returns the number of injected envelopes whose proof of work was evaluated, since construction; known ones are not.
+	uint64_t workEvaluated() const { return m_workEvaluated; }
 	virtual Topics const& fullTopics(unsigned _id) const override { try { return m_filters.at(m_watches.at(_id).id).full; } catch (...) { return EmptyTopics; } }
 	virtual unsigned installWatch(Topics const& _filter) override;
 	virtual void uninstallWatch(unsigned _watchId) override;
 	virtual h256s peekWatch(unsigned _watchId) const override { dev::Guard l(m_filterLock); try { return m_watches.at(_watchId).changes; } catch (...) { return h256s(); } }
 	virtual h256s checkWatch(unsigned _watchId) override;
-	virtual h256s watchMessages(unsigned _watchId) override; ///< returns IDs of messages, which match specific watch criteria
-	virtual Envelope envelope(h256 _m) const override { try { dev::ReadGuard l(x_messages); return m_messages.at(_m); } catch (...) { return Envelope(); } }
+	virtual h256s watchMessages(unsigned _watchId) override; ///< returns IDs of messages, which match specific watch criteria; waits for stored envelopes to load
+	virtual Envelope envelope(h256 _m) const override;
 
 protected:
 	virtual void doWork() override;
@@ -72,9 +81,16 @@ protected:
 private:
 	virtual void onStarting() override { startWorking(); }
 	virtual void onStopping() override { stopWorking(); }
+	virtual void doneWorking() override { saveMessagesToBD(); }
 	void streamMessage(h256 _m, RLPStream& _s) const;
+	/// Writes the envelopes injected since the last call to the message store in one batch.
 	void saveMessagesToBD();
-	void loadMessagesFromBD();
+	/// Loads up to @a _max further stored envelopes; called from doWork() a chunk at a time until the store has been read.
+	void loadMessagesFromBD(unsigned _max = c_loadChunk);
+	/// Removes expired envelopes from the message store, at most once per c_expiryInterval.
+	void deleteExpiredFromBD();
+	/// Memory held by the envelopes and the watches' pending changes, reported to MemoryAccounting.
+	MemoryUsage memoryUsage() const;
 
 	mutable dev::SharedMutex x_messages;
 	std::map<h256, Envelope> m_messages;
@@ -86,6 +102,20 @@ private:
 	TopicBloomFilter m_bloom;
 
 	bool m_storeMessagesInDB; ///< needed for tests and other special cases
+	std::shared_ptr<WhisperMessagesDB> m_db;	///< Message store, shared with other hosts of the process; null unless m_storeMessagesInDB and the store could be opened.
+	mutable dev::Mutex x_loading;
+	std::atomic<bool> m_loading{false};			///< True while stored envelopes are still being loaded.
+	WhisperMessagesDB::Cursor m_loader;			///< Position of the load in the store.
+	std::chrono::steady_clock::time_point m_lastExpiry;	///< Last time expired envelopes were removed from the store.
+	static const unsigned c_loadChunk = 1024;	///< Envelopes loaded from the store per doWork().
+	static constexpr std::chrono::seconds c_expiryInterval{1};
+
+	mutable dev::Mutex x_unsaved;
+	std::map<h256, Envelope> m_unsaved;			///< Watched envelopes injected but not yet written to m_db.
+
+	std::atomic<uint64_t> m_workEvaluated{0};	///< Envelopes injected as new, whose proof of work was evaluated.
+
+	MemoryAccounting::Handle m_memoryReport;
 };
 
 }
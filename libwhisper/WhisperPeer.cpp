@@ -72,8 +72,11 @@ bool WhisperPeer::interpret(unsigned _id, RLP const& _r)
 	}
 	case MessagesPacket:
 	{
+		Envelopes envelopes;
+		envelopes.reserve(_r.itemCount());
 		for (auto i: _r)
-			host()->inject(Envelope(i), this);
+			envelopes.push_back(Envelope(i));
+		host()->inject(envelopes, this);
 		break;
 	}
 	case TopicFilterPacket:
@@ -111,14 +114,14 @@ void WhisperPeer::sendMessages()
 	}
 }
 
-void WhisperPeer::noteNewMessage(h256 _h, Envelope const& _m)
+void WhisperPeer::noteNewMessage(h256 _h, Envelope const& _m, unsigned _workProved)
 {
-	unsigned rate = ratingForPeer(_m);
+	unsigned rate = ratingForPeer(_m, _workProved);
 	Guard l(x_unseen);
 	m_unseen.insert(make_pair(rate, _h));
 }
 
-unsigned WhisperPeer::ratingForPeer(Envelope const& e) const
+unsigned WhisperPeer::ratingForPeer(Envelope const& e, unsigned _workProved) const
 {
 	// we try to estimate, how valuable this nessage will be for the remote peer,
 	// according to the following criteria:
@@ -136,7 +139,7 @@ unsigned WhisperPeer::ratingForPeer(Envelope const& e) const
 	rating += ttlReward;
 
 	rating *= 256;
-	rating += e.workProved();
+	rating += _workProved;
 	return rating;
 }
 
@@ -62,8 +62,8 @@ public:
 private:
 	virtual bool interpret(unsigned _id, RLP const&) override;
 	void sendMessages();
-	unsigned ratingForPeer(Envelope const& e) const;
-	void noteNewMessage(h256 _h, Envelope const& _m);
+	unsigned ratingForPeer(Envelope const& e, unsigned _workProved) const;
+	void noteNewMessage(h256 _h, Envelope const& _m, unsigned _workProved);
 	void setBloom(TopicBloomFilterHash const& _b) { dev::Guard g(x_bloom); m_bloom = _b; }
 
 	mutable dev::Mutex x_unseen;
@@ -0,0 +1,90 @@
+/*
+	This file is part of cpp-ethereum.
+
+	cpp-ethereum is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	cpp-ethereum is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with cpp-ethereum.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/** @file Hash.cpp
+ * @date 2017
+ */
+
+#include <libdevcore/Hash.h>
+#include <libdevcore/picosha2.h>
+#include <test/libtesteth/TestHelper.h>
+
+using namespace std;
+using namespace dev;
+
+namespace dev
+{
+namespace test
+{
+
+namespace
+{
+
+bytesConstRef asBytes(string const& _s) { return bytesConstRef((byte const*)_s.data(), _s.size()); }
+
+}
+
+BOOST_FIXTURE_TEST_SUITE(HashTests, TestOutputHelper)
+
+BOOST_AUTO_TEST_CASE(sha256Vectors)
+{
+	string const million(1000000, 'a');
+	for (SHA256Kernel k: { SHA256Kernel::Portable, SHA256Kernel::SHAExtensions })
+	{
+		if (!sha256Supported(k))
+			continue;
+		BOOST_CHECK_EQUAL(sha256(asBytes(""), k), h256("e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855"));
+		BOOST_CHECK_EQUAL(sha256(asBytes("abc"), k), h256("ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad"));
+		BOOST_CHECK_EQUAL(sha256(asBytes("abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq"), k), h256("248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1"));
+		BOOST_CHECK_EQUAL(sha256(asBytes(million), k), h256("cdc76e5c9914fb9281a1c7e284d73e67f1809a48a497200e046d39ccc7112cd0"));
+	}
+	BOOST_CHECK(sha256Supported(SHA256Kernel::Portable));
+	BOOST_CHECK(sha256Supported(sha256Kernel()));
+}
+
+BOOST_AUTO_TEST_CASE(sha256Kernels)
+{
+	// Every tail length, across one and two padding blocks, against picosha2.
+	bytes data(300);
+	for (size_t i = 0; i < data.size(); ++i)
+		data[i] = byte(i * 7 + 3);
+	for (size_t size = 0; size <= data.size(); ++size)
+	{
+		bytesConstRef in(data.data(), size);
+		h256 expected;
+		picosha2::hash256(in.begin(), in.end(), expected.data(), expected.data() + 32);
+		BOOST_CHECK_EQUAL(sha256(in), expected);
+		BOOST_CHECK_EQUAL(sha256(in, SHA256Kernel::Portable), expected);
+		if (sha256Supported(SHA256Kernel::SHAExtensions))
+			BOOST_CHECK_EQUAL(sha256(in, SHA256Kernel::SHAExtensions), expected);
+	}
+}
+
+BOOST_AUTO_TEST_CASE(ripemd160Vectors)
+{
+	BOOST_CHECK_EQUAL(ripemd160(asBytes("")), h160("9c1185a5c5e9fc54612808977ee8f548b2258d31"));
+	BOOST_CHECK_EQUAL(ripemd160(asBytes("abc")), h160("8eb208f7e05d987a9b044a8e98c6b087f15a0bfc"));
+	BOOST_CHECK_EQUAL(ripemd160(asBytes("abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq")), h160("12a053384a9c0c88e405a06c27dcf49ada62eb2b"));
+	BOOST_CHECK_EQUAL(ripemd160(asBytes("ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789")), h160("b0e20b6e3116640286ed3a87a5713079b21f5189"));
+	BOOST_CHECK_EQUAL(ripemd160(asBytes("12345678901234567890123456789012345678901234567890123456789012345678901234567890")), h160("9b752e45573d4b39f4dbd3323cab82bf63326bfb"));
+	string const million(1000000, 'a');
+	BOOST_CHECK_EQUAL(ripemd160(asBytes(million)), h160("52783243c1697bdbe16d37f97f68f08325dc1528"));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+}
+}
@@ -0,0 +1,85 @@
+/*
+	This file is part of cpp-ethereum.
+
+	cpp-ethereum is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	cpp-ethereum is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with cpp-ethereum.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/** @file MemoryAccounting.cpp
+ * @date 2017
+ */
+
+#include <libdevcore/MemoryAccounting.h>
+#include <test/libtesteth/TestHelper.h>
+
+using namespace std;
+using namespace dev;
+
+namespace dev
+{
+namespace test
+{
+
+BOOST_FIXTURE_TEST_SUITE(MemoryAccountingTest, TestOutputHelper)
+
+BOOST_AUTO_TEST_CASE(sampleAndTrim)
+{
+	MemoryAccounting& m = MemoryAccounting::get();
+	uint64_t a = 1000;
+	uint64_t b = 500;
+	unsigned trimmed = 0;
+	auto sampleA = [&]() { MemoryUsage u; u.bytes = a; u.items = a / 100; return u; };
+	auto sampleB = [&]() { MemoryUsage u; u.bytes = b; u.items = 1; return u; };
+
+	MemoryAccounting::Handle ha = m.add("test.shared", sampleA, [&]() { a = 100; ++trimmed; });
+	MemoryAccounting::Handle hb = m.add("test.shared", sampleB);
+
+	MemoryAccounting::Reports r = m.sample();
+	BOOST_REQUIRE(r.count("test.shared"));
+	BOOST_CHECK_EQUAL(r["test.shared"].usage.bytes, 1500);
+	BOOST_CHECK_EQUAL(r["test.shared"].usage.items, 11);
+	BOOST_CHECK_EQUAL(r["test.shared"].sources, 2);
+
+	// Under the limit: nothing gets trimmed.
+	m.setSoftLimit("test.shared", 2000);
+	m.check();
+	BOOST_CHECK_EQUAL(trimmed, 0);
+
+	m.setSoftLimit("test.shared", 1200);
+	r = m.check();
+	BOOST_CHECK_EQUAL(trimmed, 1);
+	BOOST_CHECK_EQUAL(r["test.shared"].usage.bytes, 600);
+	BOOST_CHECK_EQUAL(r["test.shared"].softLimit, 1200);
+	BOOST_CHECK_EQUAL(r["test.shared"].trims, 1);
+
+	hb.reset();
+	BOOST_CHECK_EQUAL(m.sample()["test.shared"].usage.bytes, 100);
+	m.setSoftLimit("test.shared", 0);
+	ha.reset();
+	BOOST_CHECK(!m.sample().count("test.shared"));
+}
+
+BOOST_AUTO_TEST_CASE(summary)
+{
+	MemoryAccounting::Reports r;
+	r["small"].usage.bytes = 10;
+	r["large"].usage.bytes = 20000;
+	r["large"].usage.items = 3;
+	string s = MemoryAccounting::summary(r);
+	BOOST_CHECK(s.find("large") < s.find("small"));
+	BOOST_CHECK(s.find("(3)") != string::npos);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+}
+}
@@ -0,0 +1,109 @@
+/*
+	This file is part of cpp-ethereum.
+
+	cpp-ethereum is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	cpp-ethereum is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with cpp-ethereum.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/** @file Metrics.cpp
+ * @date 2017
+ */
+
+#include <thread>
+#include <libdevcore/Metrics.h>
+#include <test/libtesteth/TestHelper.h>
+
+using namespace std;
+using namespace dev;
+
+namespace dev
+{
+namespace test
+{
+
+BOOST_FIXTURE_TEST_SUITE(MetricsTest, TestOutputHelper)
+
+BOOST_AUTO_TEST_CASE(buckets)
+{
+	for (uint64_t v: {0ull, 1ull, 7ull, 8ull, 9ull, 15ull, 16ull, 17ull, 1000ull, 123456789ull, ~0ull})
+	{
+		unsigned b = Histogram::bucket(v);
+		BOOST_REQUIRE(b < Histogram::c_buckets);
+		BOOST_CHECK(Histogram::bucketFloor(b) <= v);
+		if (b + 1 < Histogram::c_buckets)
+			BOOST_CHECK(v < Histogram::bucketFloor(b + 1));
+	}
+	// Each bucket is at most an eighth of its floor wide.
+	for (unsigned b = 8; b + 1 < Histogram::c_buckets; ++b)
+		BOOST_CHECK(Histogram::bucketFloor(b + 1) - Histogram::bucketFloor(b) <= Histogram::bucketFloor(b) / 8);
+}
+
+BOOST_AUTO_TEST_CASE(percentiles)
+{
+	Histogram h("test.percentiles");
+	vector<thread> threads;
+	for (unsigned t = 0; t < 4; ++t)
+		threads.push_back(thread([&]() { for (uint64_t v = 1; v <= 1000; ++v) h.record(v * 1000); }));
+	for (auto& t: threads)
+		t.join();
+
+	Histogram::Snapshot s = h.snapshot();
+	BOOST_CHECK_EQUAL(s.count, 4000);
+	BOOST_CHECK_EQUAL(s.max, 1000000);
+	BOOST_CHECK_EQUAL(s.sum, 4 * 500500000ull);
+	BOOST_CHECK_CLOSE(s.mean(), 500500.0, 0.001);
+	BOOST_CHECK_CLOSE(double(s.percentile(0.5)), 500000.0, 100.0 / 16);
+	BOOST_CHECK_CLOSE(double(s.percentile(0.99)), 990000.0, 100.0 / 16);
+	BOOST_CHECK(s.percentile(1) <= s.max);
+
+	h.reset();
+	BOOST_CHECK_EQUAL(h.snapshot().count, 0);
+	BOOST_CHECK_EQUAL(h.snapshot().percentile(0.5), 0);
+}
+
+BOOST_AUTO_TEST_CASE(scopesAndCounters)
+{
+	for (unsigned i = 0; i < 3; ++i)
+	{
+		DEV_METERED("test.metered")
+			this_thread::sleep_for(chrono::microseconds(10));
+		DEV_COUNT("test.counted", 2);
+	}
+	Histogram::Snapshot s = Metrics::get().histograms()["test.metered"];
+	BOOST_CHECK_EQUAL(s.count, 3);
+	BOOST_CHECK(s.percentile(0.5) >= 10000);
+	BOOST_CHECK_EQUAL(Metrics::get().counters()["test.counted"], 6);
+}
+
+BOOST_AUTO_TEST_CASE(tracing)
+{
+	Metrics::get().startTracing(2);
+	for (unsigned i = 0; i < 3; ++i)
+	{
+		DEV_METERED_SCOPE("test.traced");
+	}
+	string trace = Metrics::get().stopTracing();
+	BOOST_CHECK_EQUAL(trace.find("{\"traceEvents\":["), 0);
+	BOOST_CHECK(trace.find("\"ph\":\"M\"") != string::npos);
+
+	// Capped at two spans.
+	unsigned spans = 0;
+	for (size_t p = 0; (p = trace.find("\"name\":\"test.traced\",\"ph\":\"X\"", p)) != string::npos; ++p)
+		++spans;
+	BOOST_CHECK_EQUAL(spans, 2);
+	BOOST_CHECK(!Metrics::tracing());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+}
+}
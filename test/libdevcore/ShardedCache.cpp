@@ -0,0 +1,77 @@
+/*
+	This file is part of cpp-ethereum.
+
+	cpp-ethereum is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	cpp-ethereum is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with cpp-ethereum.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/** @file ShardedCache.cpp
+ * @date 2017
+ */
+
+#include <libdevcore/SHA3.h>
+#include <libdevcore/ShardedCache.h>
+#include <test/libtesteth/TestHelper.h>
+
+using namespace std;
+using namespace dev;
+
+namespace dev
+{
+namespace test
+{
+
+BOOST_FIXTURE_TEST_SUITE(ShardedCacheTest, TestOutputHelper)
+
+BOOST_AUTO_TEST_CASE(lookupAndStatistics)
+{
+	ShardedCache<h256, unsigned> cache(8);
+	unsigned v = 0;
+	BOOST_CHECK(!cache.lookup(h256(1), v));
+	cache.insert(h256(1), 10);
+	cache.insert(h256(1), 11);
+	BOOST_CHECK(cache.lookup(h256(1), v));
+	BOOST_CHECK_EQUAL(v, 11);
+	BOOST_CHECK_EQUAL(cache.size(), 1);
+	BOOST_CHECK_EQUAL(cache.hits(), 1);
+	BOOST_CHECK_EQUAL(cache.misses(), 1);
+
+	cache.erase(h256(1));
+	BOOST_CHECK(!cache.lookup(h256(1), v));
+	cache.insert(h256(2), 2);
+	cache.clear();
+	BOOST_CHECK_EQUAL(cache.size(), 0);
+	BOOST_CHECK_EQUAL(cache.misses(), 2);
+}
+
+BOOST_AUTO_TEST_CASE(bounded)
+{
+	ShardedCache<h256, unsigned, 4> cache(8);
+	for (unsigned i = 0; i < 1000; ++i)
+		cache.insert(sha3(toBigEndian(u256(i))), i);
+	BOOST_CHECK_EQUAL(cache.size(), 4 * 8);
+
+	// Replacing a value never evicts another one.
+	h256 kept;
+	unsigned keptValue = 0;
+	cache.forEach([&](h256 const& _k, unsigned _v) { kept = _k; keptValue = _v; });
+	cache.insert(kept, keptValue + 1);
+	unsigned v = 0;
+	BOOST_CHECK(cache.lookup(kept, v));
+	BOOST_CHECK_EQUAL(v, keptValue + 1);
+	BOOST_CHECK_EQUAL(cache.size(), 4 * 8);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+}
+}
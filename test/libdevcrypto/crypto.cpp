@@ -79,6 +79,24 @@ BOOST_AUTO_TEST_CASE(sha3general)
 	BOOST_REQUIRE_EQUAL(sha3("hello"), h256("1c8aff950685c2ed4bc3174f3472287b56d9517b9c948127319a09a7a36deac8"));
 }
 
+BOOST_AUTO_TEST_CASE(sha3batch)
+{
+	// Lengths around the 136-byte block boundary, unevenly spread over the lanes.
+	vector<bytes> inputs;
+	for (size_t l: { 0, 1, 31, 32, 135, 136, 137, 271, 272, 600, 5, 135, 136 })
+		inputs.push_back(bytes(l, (byte)l));
+	vector<bytesConstRef> refs;
+	for (auto const& i: inputs)
+		refs.push_back(&i);
+	for (size_t count = 0; count <= refs.size(); ++count)
+	{
+		vector<h256> hashes(count);
+		sha3Batch(refs.data(), count, hashes.data());
+		for (size_t i = 0; i < count; ++i)
+			BOOST_CHECK_EQUAL(hashes[i], sha3(refs[i]));
+	}
+}
+
 BOOST_AUTO_TEST_CASE(emptySHA3Types)
 {
 	h256 emptySHA3(fromHex("c5d2460186f7233c927e7db2dcc703c0e500b653ca82273b7bfad8045d85a470"));
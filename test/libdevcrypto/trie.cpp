@@ -21,6 +21,7 @@
 #include <libdevcore/CommonIO.h>
 #include <libdevcore/TrieDB.h>
 #include <libdevcore/TrieHash.h>
+#include <libdevcore/TrieScan.h>
 #include "MemTrie.h"
 #include <test/libtesteth/TestHelper.h>
 
@@ -602,6 +603,83 @@ template<typename Trie> void perfTestTrie(char const* _name)
 	}
 }
 
+BOOST_AUTO_TEST_CASE(orderedTrieRootMatchesTrie)
+{
+	h256 seed;
+	for (unsigned count: { 0, 1, 2, 3, 16, 17, 127, 128, 129, 130, 255, 256, 257, 300, 4097, 70000 })
+	{
+		vector<bytes> items;
+		BytesMap m;
+		for (unsigned i = 0; i < count; ++i)
+		{
+			// Mix values short enough for their leaves to be inlined with ones that get hashed.
+			seed = sha3(seed);
+			bytes v = seed[0] % 2 ? bytes(1, seed[1]) : bytes(seed[1] % 200, seed[2]);
+			items.push_back(v);
+			m[rlp(i)] = v;
+		}
+		BOOST_CHECK_MESSAGE(orderedTrieRoot(items) == hash256(m), "count " << count);
+	}
+}
+
+BOOST_AUTO_TEST_CASE(trieScan)
+{
+	MemoryDB m;
+	GenericTrieDB<MemoryDB> t(&m);
+	t.init();
+	map<bytes, bytes> expected;
+	h256 seed;
+	for (unsigned i = 0; i < 2000; ++i)
+	{
+		// Hashed keys like the state's, with some short ones to make inline nodes and values in branches.
+		seed = sha3(seed);
+		bytes k = i % 10 ? seed.asBytes() : bytes(seed.data(), seed.data() + 1 + seed[0] % 3);
+		bytes v = i % 3 ? bytes(1, seed[1]) : bytes(1 + seed[1], seed[2]);
+		t.insert(k, v);
+		expected[k] = v;
+	}
+
+	auto scan = [&](TrieRange const& _r, unsigned _readers)
+	{
+		map<bytes, bytes> ret;
+		bytes last;
+		TrieScan<MemoryDB>(m, t.root(), _r, _readers, 16).run([&](bytesConstRef _k, bytesConstRef _v)
+		{
+			BOOST_CHECK(ret.empty() || _k.toBytes() > last);
+			last = _k.toBytes();
+			ret[last] = _v.toBytes();
+			return true;
+		});
+		return ret;
+	};
+
+	for (unsigned readers: { 0, 1, 4 })
+	{
+		BOOST_CHECK(scan(TrieRange(), readers) == expected);
+
+		bytes begin = h256("0x4000000000000000000000000000000000000000000000000000000000000000").asBytes();
+		bytes end = h256("0xa800000000000000000000000000000000000000000000000000000000000000").asBytes();
+		map<bytes, bytes> part(expected.lower_bound(begin), expected.lower_bound(end));
+		BOOST_CHECK(scan(TrieRange{begin, end}, readers) == part);
+	}
+
+	for (unsigned parts: { 1, 3, 16, 100 })
+	{
+		vector<TrieRange> ranges = TrieScan<MemoryDB>::split(m, t.root(), TrieRange(), parts);
+		BOOST_CHECK_LE(ranges.size(), parts);
+		map<bytes, bytes> all;
+		for (auto const& r: ranges)
+			for (auto const& i: scan(r, 2))
+				BOOST_CHECK(all.insert(i).second);
+		BOOST_CHECK(all == expected);
+	}
+
+	// Stopping early.
+	unsigned visited = 0;
+	BOOST_CHECK(!TrieScan<MemoryDB>(m, t.root()).run([&](bytesConstRef, bytesConstRef) { return ++visited < 10; }));
+	BOOST_CHECK_EQUAL(visited, 10);
+}
+
 BOOST_AUTO_TEST_CASE(triePerf)
 {
 	if (test::Options::get().performance)
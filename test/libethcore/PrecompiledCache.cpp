@@ -0,0 +1,96 @@
+/*
+	This file is part of cpp-ethereum.
+
+	cpp-ethereum is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	cpp-ethereum is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with cpp-ethereum.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/** @file PrecompiledCache.cpp
+ * @date 2017
+ */
+
+#include <boost/test/unit_test.hpp>
+#include <libdevcrypto/Common.h>
+#include <libethcore/PrecompiledCache.h>
+#include <test/libtesteth/TestHelper.h>
+
+using namespace std;
+using namespace dev;
+using namespace dev::eth;
+using namespace dev::test;
+
+namespace
+{
+
+/// @returns the input of ecrecover for the signature of @a _hash by @a _key.
+bytes ecrecoverInput(KeyPair const& _key, h256 const& _hash)
+{
+	SignatureStruct sig(sign(_key.secret(), _hash));
+	return _hash.asBytes() + h256(u256(sig.v + 27)).asBytes() + sig.r.asBytes() + sig.s.asBytes();
+}
+
+}
+
+BOOST_FIXTURE_TEST_SUITE(PrecompiledCacheTests, TestOutputHelper)
+
+BOOST_AUTO_TEST_CASE(ecrecoverCached)
+{
+	PrecompiledCache& cache = PrecompiledCache::instance();
+	cache.clear();
+	PrecompiledExecutor const& ecrecover = PrecompiledRegistrar::executor("ecrecover");
+	KeyPair key = KeyPair::create();
+	bytes in = ecrecoverInput(key, sha3("message"));
+	bytes const expected = h256(key.address(), h256::AlignRight).asBytes();
+
+	uint64_t hits = cache.hits();
+	uint64_t misses = cache.misses();
+	BOOST_CHECK(ecrecover(&in) == make_pair(true, expected));
+	BOOST_CHECK_EQUAL(cache.misses(), misses + 1);
+	BOOST_CHECK(ecrecover(&in) == make_pair(true, expected));
+	BOOST_CHECK_EQUAL(cache.hits(), hits + 1);
+
+	// Trailing bytes are not read, so they share the entry.
+	in.resize(200, 7);
+	BOOST_CHECK(ecrecover(&in) == make_pair(true, expected));
+	BOOST_CHECK_EQUAL(cache.hits(), hits + 2);
+	BOOST_CHECK_EQUAL(cache.size(), 1);
+
+	// A failed recovery is cached like any other output.
+	bytes bad(128, 0);
+	BOOST_CHECK(ecrecover(&bad) == make_pair(true, bytes()));
+	BOOST_CHECK(ecrecover(&bad) == make_pair(true, bytes()));
+	BOOST_CHECK_EQUAL(cache.hits(), hits + 3);
+}
+
+BOOST_AUTO_TEST_CASE(disabled)
+{
+	PrecompiledCache& cache = PrecompiledCache::instance();
+	cache.clear();
+	unsigned runs = 0;
+	PrecompiledExecutor exec = [&](bytesConstRef _in) { ++runs; return make_pair(true, _in.toBytes()); };
+	bytes in = {1, 2, 3};
+
+	cache.setEnabled(false);
+	cache.execute("test", &in, exec);
+	cache.execute("test", &in, exec);
+	cache.setEnabled(true);
+	BOOST_CHECK_EQUAL(runs, 2);
+	BOOST_CHECK_EQUAL(cache.size(), 0);
+
+	BOOST_CHECK(cache.execute("test", &in, exec) == make_pair(true, in));
+	BOOST_CHECK(cache.execute("test", &in, exec) == make_pair(true, in));
+	BOOST_CHECK(cache.execute("other", &in, exec) == make_pair(true, in));
+	BOOST_CHECK_EQUAL(runs, 4);
+	cache.clear();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -21,8 +21,13 @@
  */
 
 #include <fstream>
+#include <set>
+#include <boost/filesystem.hpp>
 #include <json_spirit/JsonSpiritHeaders.h>
 #include <libdevcore/CommonIO.h>
+#include <libdevcore/TransientDirectory.h>
+#include <libethash/internal.h>
+#include <libethash/io.h>
 #include <libethashseal/Ethash.h>
 #include <libethashseal/EthashAux.h>
 #include <boost/test/unit_test.hpp>
@@ -80,4 +85,101 @@ BOOST_AUTO_TEST_CASE(basic_test)
 	}
 }
 
+BOOST_AUTO_TEST_CASE(persisted_light_test)
+{
+	TransientDirectory dir;
+	ethash_light_t computed = ethash_light_new(0);
+	ethash_light_t stored = ethash_light_new_persisted(0, dir.path().c_str());
+	ethash_light_t loaded = ethash_light_new_persisted(0, dir.path().c_str());
+	BOOST_REQUIRE(computed && stored && loaded);
+
+	BOOST_CHECK(!stored->mapped);
+	BOOST_CHECK(loaded->mapped);
+	BOOST_REQUIRE_EQUAL(loaded->cache_size, computed->cache_size);
+	BOOST_CHECK(memcmp(loaded->cache, computed->cache, (size_t)computed->cache_size) == 0);
+
+	ethash_h256_t header;
+	memset(&header, 0x42, sizeof(header));
+	ethash_return_value_t a = ethash_light_compute(computed, header, 7);
+	ethash_return_value_t b = ethash_light_compute(loaded, header, 7);
+	BOOST_CHECK(a.success && b.success);
+	BOOST_CHECK(memcmp(&a.result, &b.result, sizeof(a.result)) == 0);
+	BOOST_CHECK(memcmp(&a.mix_hash, &b.mix_hash, sizeof(a.mix_hash)) == 0);
+
+	ethash_light_delete(loaded);
+	ethash_light_delete(stored);
+	ethash_light_delete(computed);
+}
+
+BOOST_AUTO_TEST_CASE(persisted_light_prune_test)
+{
+	TransientDirectory dir;
+	auto lightFiles = [&]()
+	{
+		set<string> ret;
+		for (boost::filesystem::directory_iterator it(dir.path()), end; it != end; ++it)
+			ret.insert(it->path().filename().string());
+		return ret;
+	};
+	auto lightFile = [](uint64_t _epoch)
+	{
+		ethash_h256_t seed = ethash_get_seedhash(_epoch * ETHASH_EPOCH_LENGTH);
+		char name[LIGHT_MUTABLE_NAME_MAX_SIZE];
+		ethash_io_light_mutable_name(ETHASH_REVISION, &seed, name);
+		return string(name);
+	};
+
+	// Stand-ins for the caches of epochs 0 and 1; pruning goes by name only.
+	byte cache[64] = {};
+	ethash_h256_t checksum;
+	memset(&checksum, 0, sizeof(checksum));
+	for (uint64_t e: {0, 1})
+		BOOST_REQUIRE(ethash_io_light_store(dir.path().c_str(), ethash_get_seedhash(e * ETHASH_EPOCH_LENGTH), cache, sizeof(cache), &checksum));
+	BOOST_CHECK(lightFiles() == (set<string>{lightFile(0), lightFile(1)}));
+
+	ethash_light_t light = ethash_light_new_persisted(2 * ETHASH_EPOCH_LENGTH, dir.path().c_str());
+	BOOST_REQUIRE(light);
+	ethash_light_delete(light);
+	// No temporary files left over, the previous epoch kept and anything older gone.
+	BOOST_CHECK(lightFiles() == (set<string>{lightFile(1), lightFile(2)}));
+}
+
+BOOST_AUTO_TEST_CASE(light_persistence_switch_test)
+{
+	TransientDirectory dir;
+	h256 seed = EthashAux::seedHash(0);
+
+	EthashAux::setLightPersistence(true, dir.path());
+	EthashAux::LightAllocation stored(seed);
+	EthashAux::setLightPersistence(false);
+	EthashAux::LightAllocation computed(seed);
+
+	BOOST_CHECK(!boost::filesystem::is_empty(dir.path()));
+	BOOST_CHECK(!computed.light->mapped);
+	BOOST_CHECK(stored.data().toBytes() == computed.data().toBytes());
+}
+
+BOOST_AUTO_TEST_CASE(replicate_full_test)
+{
+	// A stand-in DAG: replication only copies the data.
+	bytes data(4 * 1024 * 1024 + 64);
+	for (size_t i = 0; i < data.size(); ++i)
+		data[i] = (byte)(i * 7);
+	ethash_full dag;
+	memset(&dag, 0, sizeof(dag));
+	dag.file_size = data.size();
+	dag.data = (node*)data.data();
+
+	for (ethash_pages_t p: {ETHASH_PAGES_DEFAULT, ETHASH_PAGES_TRANSPARENT, ETHASH_PAGES_2MB, ETHASH_PAGES_1GB})
+	{
+		ethash_pages_t used = ETHASH_PAGES_1GB;
+		ethash_full_t replica = ethash_full_replicate(&dag, p, &used);
+		BOOST_REQUIRE(replica);
+		BOOST_CHECK(used <= p);
+		BOOST_CHECK_EQUAL(ethash_full_dag_size(replica), data.size());
+		BOOST_CHECK(memcmp(ethash_full_dag(replica), data.data(), data.size()) == 0);
+		ethash_full_delete(replica);
+	}
+}
+
 BOOST_AUTO_TEST_SUITE_END()
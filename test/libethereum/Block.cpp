@@ -201,6 +201,41 @@ BOOST_AUTO_TEST_CASE(bGasPricer)
 	}
 }
 
+BOOST_AUTO_TEST_CASE(bTransactionSyncStats)
+{
+	TestBlockChain testBlockchain(TestBlockChain::defaultGenesisBlock(63000));
+	TestBlock const& genesisBlock = testBlockchain.testGenesis();
+	OverlayDB const& genesisDB = genesisBlock.state().db();
+	BlockChain const& blockchain = testBlockchain.interface();
+
+	TestBlock testBlock;
+	testBlock.addTransaction(TestTransaction::defaultTransaction(1, 1, 21000));
+	testBlock.addTransaction(TestTransaction::defaultTransaction(2, 1, 21000));
+	testBlock.addTransaction(TestTransaction::defaultTransaction(12, 1, 21000));
+
+	ZeroGasPricer gp;
+	Block block = blockchain.genesisBlock(genesisDB);
+	block.sync(blockchain);
+	TransactionSyncStats before = Block::transactionSyncStats();
+	auto r = block.sync(blockchain, testBlock.transactionQueue(), gp);
+	TransactionSyncStats stats = Block::transactionSyncStats() - before;
+
+	BOOST_CHECK_EQUAL(r.first.size(), 2);
+	BOOST_CHECK_EQUAL(stats.syncs, 1);
+	BOOST_CHECK_EQUAL(stats.executed, 2);
+	// The nonce gap is found without executing the transaction, and only retried while the sender makes progress.
+	BOOST_CHECK_EQUAL(stats.nonceBlocked, 2);
+	BOOST_CHECK_EQUAL(stats.passes, 2);
+	BOOST_CHECK_EQUAL(stats.dropped, 1);
+
+	// The next sync looks at none of them again: two are in the block and the third left the queue.
+	before = Block::transactionSyncStats();
+	r = block.sync(blockchain, testBlock.transactionQueue(), gp);
+	stats = Block::transactionSyncStats() - before;
+	BOOST_CHECK(r.first.empty());
+	BOOST_CHECK_EQUAL(stats.considered, 0);
+}
+
 BOOST_AUTO_TEST_CASE(bCopyOperator)
 {
 	try
@@ -586,4 +586,103 @@ BOOST_AUTO_TEST_CASE(updateStats)
 	}
 }
 
+BOOST_AUTO_TEST_CASE(decodedBlock)
+{
+	try
+	{
+		TestBlockChain bc(TestBlockChain::defaultGenesisBlock());
+		BlockChain& bcRef = bc.interfaceUnsafe();
+		h256 genesisHash = bcRef.genesisHash();
+		BOOST_REQUIRE(bcRef.decodedBlock(genesisHash)->details.children.empty());
+
+		TestTransaction tr = TestTransaction::defaultTransaction();
+		TestBlock block;
+		block.addTransaction(tr);
+		block.mine(bc);
+		bc.addBlock(block);
+
+		// The parent's entry goes with its details.
+		h256 hash = bcRef.currentHash();
+		BOOST_REQUIRE(bcRef.decodedBlock(genesisHash)->details.children == h256s{hash});
+
+		DecodedBlockPtr d = bcRef.decodedBlock(hash);
+		BOOST_REQUIRE(d);
+		BOOST_CHECK(d == bcRef.decodedBlock(hash));
+		BOOST_CHECK(d->header.hash() == hash);
+		BOOST_CHECK_EQUAL(d->details.number, 1);
+		BOOST_REQUIRE_EQUAL(d->transactions.size(), 1);
+		BOOST_CHECK(d->transactionHashes == bcRef.transactionHashes(hash));
+		BOOST_CHECK(d->uncleHashes == bcRef.uncleHashes(hash));
+		BOOST_CHECK(d->withSender(0).safeSender() == tr.transaction().sender());
+		BOOST_CHECK(d->withSenders()[0].safeSender() == tr.transaction().sender());
+		BOOST_CHECK(bcRef.usage(true).memDecodedBlocks > 0);
+
+		bcRef.garbageCollect(true);
+		BOOST_CHECK_EQUAL(bcRef.usage(true).memDecodedBlocks, 0);
+		BOOST_CHECK(d != bcRef.decodedBlock(hash));
+		BOOST_CHECK(!bcRef.decodedBlock(h256(1)));
+	}
+	catch (Exception const& _e)
+	{
+		BOOST_ERROR("Failed test with Exception: " << diagnostic_information(_e));
+	}
+	catch (std::exception const& _e)
+	{
+		BOOST_ERROR("Failed test with Exception: " << _e.what());
+	}
+	catch(...)
+	{
+		BOOST_ERROR("Exception thrown when trying to mine or import a block!");
+	}
+}
+
+BOOST_AUTO_TEST_CASE(decodedBlockReorg)
+{
+	try
+	{
+		TestBlockChain bc(TestBlockChain::defaultGenesisBlock());
+		TestBlockChain bc2(TestBlockChain::defaultGenesisBlock());
+		BlockChain& bcRef = bc.interfaceUnsafe();
+
+		TestBlock a1;
+		a1.addTransaction(TestTransaction::defaultTransaction());
+		a1.mine(bc);
+		bc.addBlock(a1);
+		h256 a1Hash = bcRef.currentHash();
+		DecodedBlockPtr d = bcRef.decodedBlock(a1Hash);
+		BOOST_REQUIRE(d);
+
+		// A longer fork from genesis takes over.
+		TestBlock b1;
+		b1.mine(bc2);
+		bc2.addBlock(b1);
+		TestBlock b2;
+		b2.mine(bc2);
+		bc2.addBlock(b2);
+		bc.addBlock(b1);
+		bc.addBlock(b2);
+		BOOST_REQUIRE(bcRef.currentHash() == b2.blockHeader().hash());
+
+		// The reversion drops every decoded block, including those of the old branch.
+		BOOST_CHECK(d != bcRef.decodedBlock(a1Hash));
+		DecodedBlockPtr first = bcRef.decodedBlock(bcRef.numberHash(1));
+		BOOST_REQUIRE(first);
+		BOOST_CHECK(first->header.hash() == b1.blockHeader().hash());
+		BOOST_CHECK(first->transactions.empty());
+		BOOST_CHECK_EQUAL(bcRef.decodedBlock(bcRef.genesisHash())->details.children.size(), 2);
+	}
+	catch (Exception const& _e)
+	{
+		BOOST_ERROR("Failed test with Exception: " << diagnostic_information(_e));
+	}
+	catch (std::exception const& _e)
+	{
+		BOOST_ERROR("Failed test with Exception: " << _e.what());
+	}
+	catch(...)
+	{
+		BOOST_ERROR("Exception thrown when trying to mine or import a block!");
+	}
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -738,7 +738,7 @@ void checkBlocks(TestBlock const& _blockFromFields, TestBlock const& _blockFromR
 		Transaction const& trField = txsFromField.at(i).transaction();
 		Transaction const& trRlp = txsFromRlp.at(i).transaction();
 
-		BOOST_CHECK_MESSAGE(trField.data() == trRlp.data(), _testname + "transaction data in rlp and in field do not match");
+		BOOST_CHECK_MESSAGE(trField.data().toBytes() == trRlp.data().toBytes(), _testname + "transaction data in rlp and in field do not match");
 		BOOST_CHECK_MESSAGE(trField.gas() == trRlp.gas(), _testname + "transaction gasLimit in rlp and in field do not match");
 		BOOST_CHECK_MESSAGE(trField.gasPrice() == trRlp.gasPrice(), _testname + "transaction gasPrice in rlp and in field do not match");
 		BOOST_CHECK_MESSAGE(trField.nonce() == trRlp.nonce(), _testname + "transaction nonce in rlp and in field do not match");
@@ -20,6 +20,9 @@
  * BlockQueue test functions.
  */
 
+#include <thread>
+#include <libethash/internal.h>
+#include <libethashseal/Ethash.h>
 #include <libethereum/BlockQueue.h>
 #include <test/libtesteth/TestHelper.h>
 #include <test/libtesteth/BlockChainHelper.h>
@@ -101,3 +104,78 @@ using namespace dev::test;
 //}
 
 //BOOST_AUTO_TEST_SUITE_END()
+
+namespace
+{
+
+/// Gives @a io_header a seal that passes the quick nonce check done on import, but not the full check
+/// the verifiers do: the mix hash is made up.
+void fakeSeal(BlockHeader& io_header)
+{
+	Ethash::setMixHash(io_header, h256(1));
+	h256 const hash = io_header.hash(WithoutSeal);
+	h256 const boundary = Ethash::boundary(io_header);
+	h256 const mix = Ethash::mixHash(io_header);
+	for (uint64_t n = 0;; ++n)
+		if (ethash_quick_check_difficulty((ethash_h256_t const*)hash.data(), n, (ethash_h256_t const*)mix.data(), (ethash_h256_t const*)boundary.data()))
+		{
+			Ethash::setNonce(io_header, (h64)(u64)n);
+			return;
+		}
+}
+
+bytes blockWith(BlockHeader const& _header, bytes const& _block)
+{
+	RLP r(_block);
+	RLPStream header;
+	_header.streamRLP(header);
+	RLPStream ret(3);
+	ret.appendRaw(header.out());
+	ret.appendRaw(r[1].data());
+	ret.appendRaw(r[2].data());
+	return ret.out();
+}
+
+}
+
+BOOST_FIXTURE_TEST_SUITE(BlockQueueSuite, TestOutputHelper)
+
+BOOST_AUTO_TEST_CASE(bqDescendantsOfBadBlock)
+{
+	TestBlockChain blockchain(TestBlockChain::defaultGenesisBlock());
+	TestBlock block1;
+	block1.mine(blockchain);
+
+	BlockHeader badHeader = block1.blockHeader();
+	fakeSeal(badHeader);
+	bytes const bad = blockWith(badHeader, block1.bytes());
+
+	// The child keeps its parent's timestamp, or it could wait in the future queue; nothing checks it against the parent here.
+	BlockHeader childHeader = badHeader;
+	childHeader.setParentHash(badHeader.hash());
+	childHeader.setNumber(badHeader.number() + 1);
+	fakeSeal(childHeader);
+	bytes const child = blockWith(childHeader, block1.bytes());
+
+	BlockQueue bq;
+	bq.setChain(blockchain.interface());
+	BOOST_REQUIRE(bq.import(&bad) == ImportResult::Success);
+	ImportResult childResult = bq.import(&child);
+	BOOST_REQUIRE(childResult == ImportResult::Success || childResult == ImportResult::BadChain);
+
+	// Either the verifiers skip the child because its parent turned out bad, or it is dropped on
+	// leaving the queue; both blocks end up bad and neither reaches the chain.
+	for (unsigned i = 0; i < 1000 && (bq.blockStatus(badHeader.hash()) != QueueStatus::Bad || bq.blockStatus(childHeader.hash()) != QueueStatus::Bad); ++i)
+		this_thread::sleep_for(chrono::milliseconds(10));
+	BOOST_CHECK(bq.blockStatus(badHeader.hash()) == QueueStatus::Bad);
+	QueueStatus childStatus = bq.blockStatus(childHeader.hash());
+	BOOST_CHECK(childStatus == QueueStatus::Bad || childStatus == QueueStatus::UnknownParent);
+
+	vector<VerifiedBlock> out;
+	bq.drain(out, 10);
+	BOOST_CHECK(out.empty());
+	bq.doneDrain();
+	BOOST_CHECK(bq.import(&child) == ImportResult::AlreadyKnown);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,141 @@
+/*
+	This file is part of cpp-ethereum.
+
+	cpp-ethereum is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	cpp-ethereum is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with cpp-ethereum.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/** @file BlockSpeculator.cpp
+ * @date 2017
+ */
+
+#include <thread>
+#include <libethereum/BlockSpeculator.h>
+#include <libethereum/BlockChain.h>
+#include <test/libtesteth/TestHelper.h>
+#include <test/libtesteth/BlockChainHelper.h>
+
+using namespace std;
+using namespace dev;
+using namespace dev::eth;
+using namespace dev::test;
+
+namespace
+{
+
+/// Waits for the speculator to have executed at least @a _count transactions on top of @a io_block and adopts them.
+bool adoptWithin(BlockSpeculator& _s, Block& io_block, size_t _count, TransactionReceipts& o_receipts)
+{
+	for (unsigned i = 0; i < 500; ++i)
+	{
+		Block b = io_block;
+		TransactionReceipts r;
+		if (_s.adopt(b, r) && b.pending().size() >= _count)
+		{
+			io_block = b;
+			o_receipts = r;
+			return true;
+		}
+		this_thread::sleep_for(chrono::milliseconds(10));
+	}
+	return false;
+}
+
+}
+
+BOOST_FIXTURE_TEST_SUITE(BlockSpeculatorSuite, TestOutputHelper)
+
+BOOST_AUTO_TEST_CASE(adoptAndRebase)
+{
+	TestBlockChain testBlockchain(TestBlockChain::defaultGenesisBlock());
+	OverlayDB const& genesisDB = testBlockchain.testGenesis().state().db();
+	BlockChain const& bc = testBlockchain.interface();
+
+	TestBlock pending;
+	pending.addTransaction(TestTransaction::defaultTransaction(1, 1, 21000));
+	pending.addTransaction(TestTransaction::defaultTransaction(2, 1, 21000));
+	TransactionQueue& tq = pending.transactionQueue();
+
+	Block base = bc.genesisBlock(genesisDB);
+	base.sync(bc);
+
+	BlockSpeculator s(bc, tq, make_shared<ZeroGasPricer>(), function<void()>());
+	s.start();
+	s.reset(base);
+
+	// Same parent, nothing executed yet: the speculative block is taken as it is.
+	Block working = base;
+	TransactionReceipts receipts;
+	BOOST_REQUIRE(adoptWithin(s, working, 2, receipts));
+	BOOST_CHECK_EQUAL(working.pending().size(), 2);
+	BOOST_CHECK_EQUAL(receipts.size(), 2);
+	BOOST_CHECK_EQUAL(s.adopted(), 1);
+
+	// Nothing beyond what the block already has.
+	receipts.clear();
+	BOOST_CHECK(!s.adopt(working, receipts));
+	BOOST_CHECK(receipts.empty());
+
+	// A new head: the speculative block is on the old parent, so the client falls back to Block::sync().
+	TestBlock next;
+	next.mine(testBlockchain);
+	testBlockchain.addBlock(next);
+	Block onHead = bc.genesisBlock(genesisDB);
+	onHead.sync(bc);
+	BOOST_REQUIRE(onHead.info().parentHash() != base.info().parentHash());
+	BOOST_CHECK(!s.adopt(onHead, receipts));
+	BOOST_CHECK(!s.isBusyWith(onHead));
+	Block fallback = onHead;
+	ZeroGasPricer gp;
+	BOOST_CHECK_EQUAL(fallback.sync(bc, tq, gp).first.size(), 2);
+
+	// Rebased on the new head, the transactions are executed again on top of it.
+	s.reset(onHead);
+	BOOST_REQUIRE(adoptWithin(s, onHead, 2, receipts));
+	BOOST_CHECK(onHead.info().parentHash() == bc.currentHash());
+	BOOST_CHECK(onHead.rootHash() == fallback.rootHash());
+	BOOST_CHECK_EQUAL(s.adopted(), 2);
+	s.stop();
+}
+
+BOOST_AUTO_TEST_CASE(otherAuthor)
+{
+	TestBlockChain testBlockchain(TestBlockChain::defaultGenesisBlock());
+	OverlayDB const& genesisDB = testBlockchain.testGenesis().state().db();
+	BlockChain const& bc = testBlockchain.interface();
+
+	TestBlock pending;
+	pending.addTransaction(TestTransaction::defaultTransaction(1, 1, 21000));
+	TransactionQueue& tq = pending.transactionQueue();
+
+	Block base = bc.genesisBlock(genesisDB);
+	base.sync(bc);
+
+	BlockSpeculator s(bc, tq, make_shared<ZeroGasPricer>(), function<void()>());
+	s.start();
+	s.reset(base);
+	Block working = base;
+	TransactionReceipts receipts;
+	BOOST_REQUIRE(adoptWithin(s, working, 1, receipts));
+
+	// Another author's block has different rewards, so none of the speculation carries over.
+	Block other = base;
+	other.setAuthor(Address(0x1234));
+	receipts.clear();
+	BOOST_CHECK(!s.adopt(other, receipts));
+	s.reset(other);
+	BOOST_REQUIRE(adoptWithin(s, other, 1, receipts));
+	BOOST_CHECK(other.author() == Address(0x1234));
+	s.stop();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,140 @@
+/*
+	This file is part of cpp-ethereum.
+
+	cpp-ethereum is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	cpp-ethereum is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with cpp-ethereum.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/** @file ChainEvents.cpp
+ * @date 2017
+ * ChainEventBus test functions.
+ */
+
+#include <chrono>
+#include <thread>
+#include <libethereum/ChainEvents.h>
+#include <test/libtesteth/TestHelper.h>
+
+using namespace std;
+using namespace dev;
+using namespace dev::eth;
+using namespace dev::test;
+
+namespace
+{
+
+void publishPending(ChainEventBus& _bus, unsigned _i)
+{
+	ChainEvent e;
+	e.type = ChainEventType::PendingTransactions;
+	e.transactions.push_back(h256(_i));
+	_bus.publish(move(e));
+}
+
+}
+
+BOOST_FIXTURE_TEST_SUITE(ChainEventsSuite, TestOutputHelper)
+
+BOOST_AUTO_TEST_CASE(chainEventsInOrder)
+{
+	ChainEventBus bus(4);
+	BOOST_CHECK(!bus.hasSubscribers());
+	ChainEventSubscriber a(bus);
+	publishPending(bus, 0);
+	ChainEventSubscriber b(bus);
+	BOOST_CHECK(bus.hasSubscribers());
+	for (unsigned i = 1; i < 5; ++i)
+		publishPending(bus, i);
+
+	vector<ChainEventPtr> ea;
+	BOOST_CHECK_EQUAL(a.poll(ea), 0);
+	BOOST_REQUIRE_EQUAL(ea.size(), 5);
+	for (unsigned i = 0; i < 5; ++i)
+	{
+		BOOST_CHECK_EQUAL(ea[i]->sequence, i);
+		BOOST_CHECK(ea[i]->transactions.at(0) == h256(i));
+	}
+
+	// Subscribers only see events published after they subscribed.
+	vector<ChainEventPtr> eb;
+	BOOST_CHECK_EQUAL(b.poll(eb, 2), 0);
+	BOOST_REQUIRE_EQUAL(eb.size(), 2);
+	BOOST_CHECK_EQUAL(eb[0]->sequence, 1);
+	eb.clear();
+	BOOST_CHECK_EQUAL(b.poll(eb), 0);
+	BOOST_REQUIRE_EQUAL(eb.size(), 2);
+	BOOST_CHECK_EQUAL(b.cursor(), 5);
+
+	ea.clear();
+	BOOST_CHECK_EQUAL(a.poll(ea), 0);
+	BOOST_CHECK(ea.empty());
+}
+
+BOOST_AUTO_TEST_CASE(chainEventsOverflow)
+{
+	ChainEventBus bus(3);
+	ChainEventSubscriber s(bus);
+	for (unsigned i = 0; i < 20; ++i)
+		publishPending(bus, i);
+
+	vector<ChainEventPtr> events;
+	BOOST_CHECK_EQUAL(s.poll(events), 20 - bus.capacity());
+	BOOST_REQUIRE_EQUAL(events.size(), bus.capacity());
+	BOOST_CHECK_EQUAL(events.front()->sequence, 20 - bus.capacity());
+	BOOST_CHECK_EQUAL(events.back()->sequence, 19);
+}
+
+BOOST_AUTO_TEST_CASE(chainEventsConcurrentPublishers)
+{
+	ChainEventBus bus(10);
+	ChainEventSubscriber s(bus);
+	vector<thread> publishers;
+	for (unsigned t = 0; t < 4; ++t)
+		publishers.emplace_back([&bus, t]() {
+			for (unsigned i = 0; i < 200; ++i)
+				publishPending(bus, t * 200 + i);
+		});
+	for (auto& t: publishers)
+		t.join();
+
+	vector<ChainEventPtr> events;
+	BOOST_CHECK_EQUAL(s.poll(events), 0);
+	BOOST_REQUIRE_EQUAL(events.size(), 800);
+	set<h256> seen;
+	for (unsigned i = 0; i < events.size(); ++i)
+	{
+		BOOST_CHECK_EQUAL(events[i]->sequence, i);
+		seen.insert(events[i]->transactions.at(0));
+	}
+	BOOST_CHECK_EQUAL(seen.size(), 800);
+}
+
+BOOST_AUTO_TEST_CASE(chainEventsPublishedAt)
+{
+	ChainEventBus bus(4);
+	ChainEventSubscriber s(bus);
+	int64_t before = chrono::duration_cast<chrono::microseconds>(chrono::system_clock::now().time_since_epoch()).count();
+	ChainEvent e;
+	e.type = ChainEventType::NewWork;
+	e.sealingHash = h256(1);
+	bus.publish(move(e));
+	int64_t after = chrono::duration_cast<chrono::microseconds>(chrono::system_clock::now().time_since_epoch()).count();
+
+	vector<ChainEventPtr> events;
+	BOOST_CHECK_EQUAL(s.poll(events), 0);
+	BOOST_REQUIRE_EQUAL(events.size(), 1);
+	BOOST_CHECK(events[0]->sealingHash == h256(1));
+	BOOST_CHECK(events[0]->publishedAt >= before);
+	BOOST_CHECK(events[0]->publishedAt <= after);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
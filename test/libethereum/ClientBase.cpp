@@ -23,6 +23,7 @@
 #include <libdevcore/CommonJS.h>
 #include <libethashseal/Ethash.h>
 #include <test/libtesteth/TestHelper.h>
+#include <test/libtesteth/BlockChainHelper.h>
 #include <test/libtesteth/TestUtils.h>
 #include <test/libtestutils/FixedClient.h>
 
@@ -223,3 +224,58 @@ BOOST_AUTO_TEST_CASE(blocks)
 }
 
 BOOST_AUTO_TEST_SUITE_END()
+
+namespace
+{
+
+/// Increments storage slot 0 and returns the new value.
+bytes const c_counterCode = fromHex("6000546001018060005560005260206000f3");
+/// Returns the caller's balance.
+bytes const c_balanceCode = fromHex("333160005260206000f3");
+
+}
+
+BOOST_FIXTURE_TEST_SUITE(ClientBaseCallMany, TestOutputHelper)
+
+BOOST_AUTO_TEST_CASE(callMany)
+{
+	TestBlockChain testBlockchain(TestBlockChain::defaultGenesisBlock());
+	BlockChain const& bc = testBlockchain.interface();
+	Block block = bc.genesisBlock(testBlockchain.testGenesis().state().db());
+	block.sync(bc);
+	Address const counter(0x1000);
+	Address const balance(0x1001);
+	block.mutableState().createContract(counter);
+	block.mutableState().setNewCode(counter, bytes(c_counterCode));
+	block.mutableState().createContract(balance);
+	block.mutableState().setNewCode(balance, bytes(c_balanceCode));
+	block.mutableState().commit(State::CommitBehaviour::KeepEmptyAccounts);
+	FixedClient client(bc, block);
+
+	Address const from("a94f5374fce5edbc8e2a8697c15331677e6ebf0b");
+	auto call = [&](Address const& _to, u256 const& _gas)
+	{
+		TransactionSkeleton t;
+		t.from = from;
+		t.to = _to;
+		t.gas = _gas;
+		t.gasPrice = 1;
+		return t;
+	};
+
+	// The second call fails before executing, with the lenient top-up of its sender already applied.
+	vector<ExecutionResult> r = client.callMany({call(counter, 100000), call(counter, 100), call(balance, 100000), call(counter, 100000)}, PendingBlock, FudgeFactor::Lenient);
+	BOOST_REQUIRE_EQUAL(r.size(), 4);
+	// Each call starts from the same state: the counter's first increment is never seen.
+	BOOST_CHECK_EQUAL(u256(h256(r[0].output)), 1);
+	BOOST_CHECK(r[1].output.empty());
+	// The failed call's top-up was rolled back.
+	BOOST_CHECK_EQUAL(u256(h256(r[2].output)), client.balanceAt(from, PendingBlock));
+	BOOST_CHECK_EQUAL(u256(h256(r[3].output)), 1);
+
+	// A single call answers as callMany does.
+	BOOST_CHECK(client.call(from, 0, counter, bytes(), 100000, 1, PendingBlock).output == r[0].output);
+	BOOST_CHECK(client.callMany({}, PendingBlock).empty());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -26,7 +26,10 @@
 #include <boost/test/unit_test.hpp>
 #include <json_spirit/JsonSpiritHeaders.h>
 #include <libdevcore/CommonIO.h>
+#include <libdevcore/MemoryDB.h>
+#include <libethcore/Exceptions.h>
 #include <libethereum/BlockChain.h>
+#include <libethereum/State.h>
 #include <libethashseal/GenesisInfo.h>
 #include <test/libtesteth/TestHelper.h>
 
@@ -67,4 +70,40 @@ BOOST_AUTO_TEST_CASE(genesis_tests)
 	BOOST_CHECK_EQUAL(BlockHeader(p.genesisBlock()).hash(), h256(o["genesis_hash"].get_str()));
 }
 
+BOOST_AUTO_TEST_CASE(genesis_binary)
+{
+	ChainParams fromJson(genesisInfo(Network::MainNetwork), genesisStateRoot(Network::MainNetwork));
+	ChainParams fromBinary = genesisParams(Network::MainNetwork);
+	BOOST_CHECK_EQUAL(toHex(fromBinary.genesisBlock()), toHex(fromJson.genesisBlock()));
+	BOOST_CHECK_EQUAL(fromBinary.genesisState.size(), fromJson.genesisState.size());
+	BOOST_CHECK_EQUAL(fromBinary.precompiled.size(), fromJson.precompiled.size());
+	BOOST_CHECK_EQUAL(fromBinary.calculateStateRoot(true), genesisStateRoot(Network::MainNetwork));
+
+	BOOST_REQUIRE(fromBinary.genesisStateNodes);
+	MemoryDB db;
+	for (auto const& n: *fromBinary.genesisStateNodes)
+		db.insert(sha3(n), &n);
+	BOOST_CHECK(db.exists(genesisStateRoot(Network::MainNetwork)));
+
+#if ETH_FATDB
+	// The key preimages come along, so the accounts can be listed as with a state built from the JSON.
+	BOOST_REQUIRE(fromBinary.genesisStateAux);
+	OverlayDB binaryDB;
+	for (auto const& n: *fromBinary.genesisStateNodes)
+		binaryDB.insert(sha3(n), &n);
+	for (auto const& a: *fromBinary.genesisStateAux)
+		binaryDB.insertAux(sha3(a), &a);
+	State binaryState(fromBinary.accountStartNonce, binaryDB, BaseState::PreExisting);
+	binaryState.setRoot(genesisStateRoot(Network::MainNetwork));
+	State jsonState(fromJson.accountStartNonce);
+	jsonState.populateFrom(fromJson.genesisState);
+	BOOST_CHECK(binaryState.addresses() == jsonState.addresses());
+#endif
+
+	// A binary of another state is refused.
+	bytes binary = fromJson.genesisStateBinary();
+	BOOST_CHECK_THROW(fromJson.loadGenesisStateBinary(&binary, sha3(binary)), InvalidStateRoot);
+	BOOST_CHECK_EQUAL(fromJson.loadGenesisStateBinary(&binary).stateRoot, genesisStateRoot(Network::MainNetwork));
+}
+
 BOOST_AUTO_TEST_SUITE_END()
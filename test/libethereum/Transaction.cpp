@@ -23,6 +23,7 @@
 #include "test/libtesteth/TestHelper.h"
 #include <libethcore/Exceptions.h>
 #include <libethcore/Common.h>
+#include <libethcore/SenderCache.h>
 #include <libevm/VMFace.h>
 using namespace dev;
 using namespace eth;
@@ -36,6 +37,41 @@ BOOST_AUTO_TEST_CASE(TransactionGasRequired)
 	BOOST_CHECK_EQUAL(tr.baseGasRequired(FrontierSchedule), 21952);
 }
 
+BOOST_AUTO_TEST_CASE(TransactionKeepsOriginalRLP)
+{
+	bytes const rlp = fromHex("0xf86d800182521c94095e7baea6a6c7c4c2dfeb977efac326af552d870a8e0358ac39584bc98a7c979f984b031ba048b55bfa915ac795c431978d8a6a992b628d557da5ff759b307d495a36649353a0efffd310ac743f371de3b9f7f9cb56c0b28ad43601b4ab949f53faa07bd2c804");
+	Transaction tr(rlp, CheckTransaction::None);
+	BOOST_CHECK(tr.rlp() == rlp);
+	BOOST_CHECK_EQUAL(tr.sha3(), sha3(rlp));
+
+	RLPStream s;
+	tr.streamRLP(s);
+	BOOST_CHECK(s.out() == rlp);
+
+	bytes const data = fromHex("0x0358ac39584bc98a7c979f984b03");
+	BOOST_CHECK(tr.data().toBytes() == data);
+
+	// Dropping the original encoding keeps the data.
+	Transaction copy = tr;
+	copy.setNonce(1);
+	BOOST_CHECK(copy.rlp() != rlp);
+	BOOST_CHECK(copy.sha3() != tr.sha3());
+	BOOST_CHECK(copy.data().toBytes() == data);
+	BOOST_CHECK(tr.rlp() == rlp);
+	BOOST_CHECK(tr.data().toBytes() == data);
+}
+
+BOOST_AUTO_TEST_CASE(TransactionSenderCache)
+{
+	bytes const rlp = fromHex("0xf86d800182521c94095e7baea6a6c7c4c2dfeb977efac326af552d870a8e0358ac39584bc98a7c979f984b031ba048b55bfa915ac795c431978d8a6a992b628d557da5ff759b307d495a36649353a0efffd310ac743f371de3b9f7f9cb56c0b28ad43601b4ab949f53faa07bd2c804");
+	SenderCache::instance().clear();
+	Transaction first(rlp, CheckTransaction::Everything);
+	uint64_t hits = SenderCache::instance().hits();
+	Transaction second(rlp, CheckTransaction::Everything);
+	BOOST_CHECK_EQUAL(SenderCache::instance().hits(), hits + 1);
+	BOOST_CHECK_EQUAL(first.sender(), second.sender());
+}
+
 BOOST_AUTO_TEST_CASE(ExecutionResultOutput)
 {
 	std::stringstream buffer;
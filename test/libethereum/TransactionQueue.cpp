@@ -284,7 +284,7 @@ BOOST_AUTO_TEST_CASE(tqEqueue)
 
 	//check that Transaction could be recreated from the RLP
 	Transaction tRlpTransaction(payloadToDecode, CheckTransaction::Cheap);
-	BOOST_REQUIRE(tRlpTransaction.data() == testTransaction.transaction().data());
+	BOOST_REQUIRE(tRlpTransaction.data().toBytes() == testTransaction.transaction().data().toBytes());
 
 	//try to import transactions
 	string hashStr = "01020304050607080910111213141516171819202122232425262728293031320102030405060708091011121314151617181920212223242526272829303132";
@@ -0,0 +1,191 @@
+/*
+	This file is part of cpp-ethereum.
+
+	cpp-ethereum is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	cpp-ethereum is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with cpp-ethereum.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/** @file ThreadedVM.cpp
+ * @date 2017
+ * The threaded interpreter against the bytecode one. The VM test suite runs on it with --vm threaded.
+ */
+
+#include <typeinfo>
+#include <libevm/VMFactory.h>
+#include <test/libtesteth/TestHelper.h>
+
+using namespace std;
+using namespace dev;
+using namespace dev::eth;
+
+namespace dev
+{
+namespace test
+{
+
+namespace
+{
+
+class TestExt: public ExtVMFace
+{
+public:
+	TestExt(EnvInfo const& _envInfo, bytes const& _code, EVMSchedule const& _schedule):
+		ExtVMFace(_envInfo, Address(1), Address(2), Address(3), 0, 1, bytesConstRef(), _code, sha3(_code), 0),
+		m_schedule(_schedule)
+	{}
+
+	u256 store(u256 _n) override { return storage[_n]; }
+	EVMSchedule const& evmSchedule() const override { return m_schedule; }
+	void setStore(u256 _n, u256 _v) override { storage[_n] = _v; }
+	boost::optional<owning_bytes_ref> call(CallParameters&) override { return boost::none; }
+
+	map<u256, u256> storage;
+
+private:
+	EVMSchedule const& m_schedule;
+};
+
+struct Result
+{
+	bytes output;
+	u256 gas;
+	map<u256, u256> storage;
+	string exception;
+	vector<uint64_t> trace;
+};
+
+Result run(VMKind _kind, string const& _code, u256 _gas = 100000, bool _trace = false, EVMSchedule const& _schedule = DefaultSchedule)
+{
+	EnvInfo env;
+	TestExt ext(env, fromHex(_code), _schedule);
+	Result ret;
+	ret.gas = _gas;
+	OnOpFunc onOp;
+	if (_trace)
+		onOp = [&](uint64_t, uint64_t _pc, Instruction, bigint, bigint, bigint, VM*, ExtVMFace const*) { ret.trace.push_back(_pc); };
+	try
+	{
+		ret.output = VMFactory::create(_kind)->exec(ret.gas, ext, onOp).toBytes();
+	}
+	catch (VMException const& _e)
+	{
+		ret.exception = typeid(_e).name();
+	}
+	ret.storage = ext.storage;
+	return ret;
+}
+
+void checkSame(string const& _code, u256 _gas = 100000)
+{
+	for (bool trace: {false, true})
+	{
+		Result expected = run(VMKind::Interpreter, _code, _gas, trace);
+		Result threaded = run(VMKind::Threaded, _code, _gas, trace);
+		BOOST_CHECK_EQUAL(threaded.exception, expected.exception);
+		BOOST_CHECK(threaded.trace == expected.trace);
+		// A fused sequence failing charges nothing of it, which is moot as all gas goes anyway.
+		if (expected.exception.empty())
+		{
+			BOOST_CHECK_EQUAL(threaded.gas, expected.gas);
+			BOOST_CHECK(threaded.output == expected.output);
+			BOOST_CHECK(threaded.storage == expected.storage);
+		}
+	}
+}
+
+// Sums 10..1 in a loop of fused ISZERO PUSH JUMPI, DUP SWAP and PUSH JUMP, stores the sum through fused
+// PUSH MSTORE and PUSH MLOAD, stores 42 at key 5 and returns three words of memory.
+string const c_loop = "600a60005b811560155781019060019003906004565b600052600051602052600781906040525050602a60055560606000f3";
+
+}
+
+BOOST_FIXTURE_TEST_SUITE(ThreadedVMTest, TestOutputHelper)
+
+BOOST_AUTO_TEST_CASE(fusedSequences)
+{
+	Result r = run(VMKind::Threaded, c_loop);
+	BOOST_REQUIRE_EQUAL(r.exception, "");
+	BOOST_REQUIRE_EQUAL(r.output.size(), 96);
+	BOOST_CHECK_EQUAL(u256(h256(bytesConstRef(&r.output).cropped(0, 32))), 55);
+	BOOST_CHECK_EQUAL(u256(h256(bytesConstRef(&r.output).cropped(32, 32))), 55);
+	BOOST_CHECK_EQUAL(u256(h256(bytesConstRef(&r.output).cropped(64, 32))), 7);
+	BOOST_CHECK_EQUAL(r.storage[5], 42);
+	checkSame(c_loop);
+}
+
+BOOST_AUTO_TEST_CASE(outOfGas)
+{
+	// Running out anywhere, including within a fused sequence, fails the same way.
+	Result full = run(VMKind::Interpreter, c_loop);
+	for (u256 gas = 0; gas < 100000 - full.gas; gas += 7)
+		checkSame(c_loop, gas);
+}
+
+BOOST_AUTO_TEST_CASE(jumps)
+{
+	// PUSH JUMP into PUSH data
+	checkSame("6003566001005b00");
+	// PUSH JUMPI to an invalid destination, not taken
+	checkSame("600060ff5700");
+	// ... and taken
+	checkSame("600160ff5700");
+	// dynamic JUMP to a JUMPDEST, and out of range
+	checkSame("60076001015600005b00");
+	checkSame("60056001015600005b00");
+	checkSame("7fffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffff5600");
+	// JUMP to the end of the code
+	checkSame("6003565b");
+}
+
+BOOST_AUTO_TEST_CASE(stackBounds)
+{
+	// DUP SWAP and PUSH MSTORE underflowing
+	checkSame("8091");
+	checkSame("600052");
+	// ISZERO PUSH JUMPI on an empty stack
+	checkSame("156004575b00");
+	// 1024 pushes then a fused DUP SWAP overflowing
+	string pushes;
+	for (unsigned i = 0; i < 1024; ++i)
+		pushes += "6001";
+	checkSame(pushes + "809000");
+	checkSame(pushes.substr(4) + "809000");
+}
+
+BOOST_AUTO_TEST_CASE(invalidAndTruncated)
+{
+	// undefined instruction, instructions of the interpreter's own, and PUSH data past the end of the code
+	checkSame("600160020c");
+	checkSame("6001b0");
+	checkSame("6001ac00");
+	checkSame("60016000556003600055630102");
+	checkSame("");
+}
+
+BOOST_AUTO_TEST_CASE(sharedTranslations)
+{
+	// Code is translated once per schedule and shared by later runs: DELEGATECALL only exists from Homestead.
+	string const delegateCall = "600060006000600060006000f400";
+	for (EVMSchedule const* schedule: {&HomesteadSchedule, &FrontierSchedule, &HomesteadSchedule, &FrontierSchedule})
+	{
+		Result expected = run(VMKind::Interpreter, delegateCall, 100000, false, *schedule);
+		Result threaded = run(VMKind::Threaded, delegateCall, 100000, false, *schedule);
+		BOOST_CHECK_EQUAL(threaded.exception, expected.exception);
+		BOOST_CHECK_EQUAL(threaded.gas, expected.gas);
+		BOOST_CHECK_EQUAL(threaded.exception.empty(), schedule->haveDelegateCall);
+	}
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+}
+}
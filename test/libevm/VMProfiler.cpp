@@ -0,0 +1,97 @@
+/*
+	This file is part of cpp-ethereum.
+
+	cpp-ethereum is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	cpp-ethereum is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with cpp-ethereum.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/** @file VMProfiler.cpp
+ * @date 2017
+ */
+
+#include <libevm/VMProfiler.h>
+#include <test/libtesteth/TestHelper.h>
+
+using namespace std;
+using namespace dev;
+using namespace dev::eth;
+
+namespace dev
+{
+namespace test
+{
+
+BOOST_FIXTURE_TEST_SUITE(VMProfilerTest, TestOutputHelper)
+
+BOOST_AUTO_TEST_CASE(nestedRuns)
+{
+	h256 caller(1);
+	h256 callee(2);
+
+	// Nothing is kept while not profiling.
+	{
+		VMProfiler::Run r(caller, 100);
+		r.record(Instruction::ADD, 0, 3);
+	}
+	VMProfiler::start();
+	{
+		VMProfiler::Run r(caller, 100);
+		r.record(Instruction::PUSH1, 0, 3);
+		r.record(Instruction::CALL, 40, 700);
+		{
+			VMProfiler::Run nested(callee, 10);
+			nested.record(Instruction::ADD, 0, 3);
+			nested.record(Instruction::STOP, 10, 0);
+		}
+		r.record(Instruction::ADD, 41, 3);
+		r.record(Instruction::STOP, 100, 0);
+	}
+	VMProfiler::Profile p = VMProfiler::stop();
+	BOOST_CHECK(!VMProfiler::enabled());
+
+	BOOST_CHECK_EQUAL(p.opcodes[(unsigned)Instruction::ADD].count, 2);
+	BOOST_CHECK_EQUAL(p.opcodes[(unsigned)Instruction::ADD].gas, 6);
+	BOOST_CHECK_EQUAL(p.opcodes[(unsigned)Instruction::CALL].gas, 700);
+	BOOST_CHECK_EQUAL(p.opcodes[(unsigned)Instruction::STOP].count, 2);
+
+	BOOST_REQUIRE_EQUAL(p.contracts[caller].size(), 4);
+	BOOST_CHECK_EQUAL(p.contracts[caller][0].count, 1);
+	BOOST_CHECK_EQUAL(p.contracts[caller][1].count, 2);
+	BOOST_CHECK_EQUAL(p.contracts[caller][3].count, 1);
+	BOOST_CHECK_EQUAL(p.contractTotals()[callee].count, 2);
+	BOOST_CHECK_EQUAL(p.contractTotals()[caller].gas, 706);
+
+	// Every instruction but the last of each run was followed by another one.
+	uint64_t cycles = 0;
+	for (auto const& s: p.opcodes)
+		cycles += s.cycles;
+	BOOST_CHECK(cycles > 0);
+	BOOST_CHECK_EQUAL(cycles, p.contractTotals()[caller].cycles + p.contractTotals()[callee].cycles);
+}
+
+BOOST_AUTO_TEST_CASE(folded)
+{
+	VMProfiler::Profile p;
+	p.opcodes[(unsigned)Instruction::SLOAD].count = 3;
+	p.opcodes[(unsigned)Instruction::SLOAD].gas = 600;
+	p.contracts[h256(1)].resize(2);
+	p.contracts[h256(1)][1].gas = 600;
+
+	BOOST_CHECK_EQUAL(p.folded(VMProfiler::Metric::Instructions, false), "SLOAD 3\n");
+	BOOST_CHECK_EQUAL(p.folded(VMProfiler::Metric::Gas, true), "0x" + h256(1).hex() + ";0x20-0x3f 600\n");
+	BOOST_CHECK_EQUAL(p.folded(VMProfiler::Metric::Cycles, true), "");
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+}
+}
@@ -40,7 +40,7 @@ void printHelp()
 	cout << setw(30) << "--singletest <TestName>" << setw(25) << "Run on a single test" << std::endl;
 	cout << setw(30) << "--singletest <TestFile> <TestName>" << std::endl;
 	cout << setw(30) << "--verbosity <level>" << setw(25) << "Set logs verbosity. 0 - silent, 1 - only errors, 2 - informative, >2 - detailed" << std::endl;
-	cout << setw(30) << "--vm <interpreter|jit|smart>" << setw(25) << "Set VM type for VMTests suite" << std::endl;
+	cout << setw(30) << "--vm <interpreter|jit|smart|threaded>" << setw(25) << "Set VM type for VMTests suite" << std::endl;
 	cout << setw(30) << "--vmtrace" << setw(25) << "Enable VM trace for the test. (Require build with VMTRACE=1)" << std::endl;
 	cout << setw(30) << "--stats <OutFile>" << setw(25) << "Output debug stats to the file" << std::endl;
 	cout << setw(30) << "--exectimelog" << setw(25) << "Output execution time for each test suite" << std::endl;
@@ -89,6 +89,8 @@ Options::Options(int argc, char** argv)
 				VMFactory::setKind(VMKind::JIT);
 			else if (vmKind == "smart")
 				VMFactory::setKind(VMKind::Smart);
+			else if (vmKind == "threaded")
+				VMFactory::setKind(VMKind::Threaded);
 			else
 				cerr << "Unknown VM kind: " << vmKind << endl;
 		}
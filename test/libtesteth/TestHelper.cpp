@@ -376,7 +376,7 @@ void checkCallCreates(eth::Transactions _resultCallCreates, eth::Transactions _e
 
 	for (size_t i = 0; i < _resultCallCreates.size(); ++i)
 	{
-		BOOST_CHECK(_resultCallCreates[i].data() == _expectedCallCreates[i].data());
+		BOOST_CHECK(_resultCallCreates[i].data().toBytes() == _expectedCallCreates[i].data().toBytes());
 		BOOST_CHECK(_resultCallCreates[i].receiveAddress() == _expectedCallCreates[i].receiveAddress());
 		BOOST_CHECK(_resultCallCreates[i].gas() == _expectedCallCreates[i].gas());
 		BOOST_CHECK(_resultCallCreates[i].value() == _expectedCallCreates[i].value());
@@ -39,6 +39,7 @@
 #include <clocale>
 #include <stdlib.h>
 #include <test/libtesteth/TestHelper.h>
+#include <libethashseal/EthashAux.h>
 #include <boost/version.hpp>
 
 using namespace boost::unit_test;
@@ -153,6 +154,9 @@ int main( int argc, char* argv[] )
 	for (int i = 0; i < argc; i++)
 		parameters.push_back(argv[i]);
 
+	// Tests must not leave light caches in the user's DAG directory.
+	dev::eth::EthashAux::setLightPersistence(false);
+
 	stopTravisOut = false;
 	std::future<int> ret = std::async(unit_test_main, fake_init_func, argc, argv);
 	std::thread outputThread(travisOut);
@@ -0,0 +1,180 @@
+/*
+	This file is part of cpp-ethereum.
+
+	cpp-ethereum is free software: you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation, either version 3 of the License, or
+	(at your option) any later version.
+
+	cpp-ethereum is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	You should have received a copy of the GNU General Public License
+	along with cpp-ethereum.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/** @file BatchHandler.cpp
+ * @date 2017
+ */
+
+#include <chrono>
+#include <libweb3jsonrpc/BatchHandler.h>
+#include <test/libtesteth/TestHelper.h>
+
+using namespace std;
+using namespace dev;
+using namespace dev::rpc;
+
+namespace dev
+{
+namespace test
+{
+
+namespace
+{
+
+/// Answers each call with its parameter and notes how many run at once. "eth_call" with a negative parameter throws.
+class Handler: public jsonrpc::IProcedureInvokationHandler
+{
+public:
+	void HandleMethodCall(jsonrpc::Procedure& _proc, Json::Value const& _input, Json::Value& _output) override
+	{
+		{
+			unique_lock<mutex> l(x_calls);
+			order.push_back(_input[0u].asInt());
+			peak = max(peak, ++running);
+			// Hold read-only calls until another one joins, so an overlap is certain when it can happen.
+			if (hold && BatchHandler::isReadOnly(_proc.GetProcedureName()))
+			{
+				m_changed.notify_all();
+				m_changed.wait_for(l, chrono::seconds(2), [&]() { return peak > 1; });
+			}
+			--running;
+		}
+		if (_input[0u].asInt() < 0)
+			throw runtime_error("failed");
+		_output = _input[0u];
+	}
+
+	void HandleNotificationCall(jsonrpc::Procedure&, Json::Value const&) override {}
+
+	bool hold = true;
+	mutex x_calls;
+	vector<int> order;
+	int running = 0;
+	int peak = 0;
+
+private:
+	condition_variable m_changed;
+};
+
+Json::Value request(string const& _method, int _param)
+{
+	Json::Value ret;
+	ret["jsonrpc"] = "2.0";
+	ret["method"] = _method;
+	ret["params"].append(_param);
+	ret["id"] = _param;
+	return ret;
+}
+
+}
+
+BOOST_FIXTURE_TEST_SUITE(BatchHandlerTest, TestOutputHelper)
+
+BOOST_AUTO_TEST_CASE(batchOrder)
+{
+	Handler h;
+	BatchHandler b(h, 2);
+	b.AddProcedure(jsonrpc::Procedure("eth_getBalance", jsonrpc::PARAMS_BY_POSITION, jsonrpc::JSON_INTEGER, "param1", jsonrpc::JSON_INTEGER, NULL));
+	b.AddProcedure(jsonrpc::Procedure("eth_call", jsonrpc::PARAMS_BY_POSITION, jsonrpc::JSON_INTEGER, "param1", jsonrpc::JSON_INTEGER, NULL));
+	b.AddProcedure(jsonrpc::Procedure("eth_sendTransaction", jsonrpc::PARAMS_BY_POSITION, jsonrpc::JSON_INTEGER, "param1", jsonrpc::JSON_INTEGER, NULL));
+
+	Json::Value batch(Json::arrayValue);
+	for (int i = 0; i < 4; ++i)
+		batch.append(request(i % 2 ? "eth_call" : "eth_getBalance", i));
+	batch.append(request("eth_sendTransaction", 4));
+	batch.append(request("eth_call", -6));
+	batch.append(request("eth_getBalance", 7));
+
+	Json::Value response;
+	b.HandleJsonRequest(batch, response);
+
+	// Responses come back in order, the failure as an error.
+	BOOST_REQUIRE_EQUAL(response.size(), 7);
+	for (int i: {0, 1, 2, 3, 4})
+		BOOST_CHECK_EQUAL(response[i]["result"].asInt(), i);
+	BOOST_CHECK_EQUAL(response[5]["id"].asInt(), -6);
+	BOOST_CHECK(response[5].isMember("error"));
+	BOOST_CHECK_EQUAL(response[6]["result"].asInt(), 7);
+
+	// Read-only calls overlapped, but none ran alongside the transaction.
+	BOOST_CHECK_GT(h.peak, 1);
+	auto tx = find(h.order.begin(), h.order.end(), 4);
+	BOOST_REQUIRE(tx != h.order.end());
+	for (auto i = h.order.begin(); i != tx; ++i)
+		BOOST_CHECK_LT(*i, 4);
+	for (auto i = tx + 1; i != h.order.end(); ++i)
+		BOOST_CHECK(*i > 4 || *i < 0);
+}
+
+BOOST_AUTO_TEST_CASE(singleRequests)
+{
+	Handler h;
+	h.hold = false;
+	BatchHandler b(h, 2);
+	b.AddProcedure(jsonrpc::Procedure("eth_getBalance", jsonrpc::PARAMS_BY_POSITION, jsonrpc::JSON_INTEGER, "param1", jsonrpc::JSON_INTEGER, NULL));
+
+	Json::Value response;
+	b.HandleJsonRequest(request("eth_getBalance", 3), response);
+	BOOST_CHECK_EQUAL(response["result"].asInt(), 3);
+
+	Json::Value batch(Json::arrayValue);
+	batch.append(request("eth_getBalance", 1));
+	b.HandleJsonRequest(batch, response);
+	BOOST_REQUIRE_EQUAL(response.size(), 1);
+	BOOST_CHECK_EQUAL(response[0u]["result"].asInt(), 1);
+	BOOST_CHECK_EQUAL(h.peak, 1);
+}
+
+BOOST_AUTO_TEST_CASE(batchShape)
+{
+	Handler h;
+	h.hold = false;
+	BatchHandler b(h, 2);
+	b.AddProcedure(jsonrpc::Procedure("eth_getBalance", jsonrpc::PARAMS_BY_POSITION, jsonrpc::JSON_INTEGER, "param1", jsonrpc::JSON_INTEGER, NULL));
+	b.AddProcedure(jsonrpc::Procedure("eth_note", jsonrpc::PARAMS_BY_POSITION, "param1", jsonrpc::JSON_INTEGER, NULL));
+
+	// A nested batch is an invalid request, not a sub-batch.
+	Json::Value nested(Json::arrayValue);
+	nested.append(request("eth_getBalance", 2));
+	Json::Value batch(Json::arrayValue);
+	batch.append(request("eth_getBalance", 1));
+	batch.append(nested);
+	batch.append(request("eth_getBalance", 3));
+	Json::Value response;
+	b.HandleJsonRequest(batch, response);
+	BOOST_REQUIRE_EQUAL(response.size(), 3);
+	BOOST_CHECK_EQUAL(response[0u]["result"].asInt(), 1);
+	BOOST_CHECK_EQUAL(response[1]["error"]["code"].asInt(), int(jsonrpc::Errors::ERROR_RPC_INVALID_REQUEST));
+	BOOST_CHECK(response[1]["id"].isNull());
+	BOOST_CHECK_EQUAL(response[2]["result"].asInt(), 3);
+
+	// Notifications only: no response at all.
+	Json::Value notifications(Json::arrayValue);
+	for (int i = 0; i < 2; ++i)
+	{
+		Json::Value n = request("eth_note", i);
+		n.removeMember("id");
+		notifications.append(n);
+	}
+	Json::Value none;
+	b.HandleJsonRequest(notifications, none);
+	BOOST_CHECK(none.isNull());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+}
+}
@@ -33,6 +33,8 @@
 #include <libwebthree/WebThree.h>
 #include <libp2p/Network.h>
 #include <test/libtesteth/TestHelper.h>
+#include <test/libtesteth/BlockChainHelper.h>
+#include <test/libtestutils/FixedClient.h>
 
 // This is defined by some weird windows header - workaround for now.
 #undef GetMessage
@@ -138,6 +140,38 @@ BOOST_AUTO_TEST_CASE(Personal)
 	BOOST_CHECK_EQUAL(sendingShouldFail(), "Transaction rejected by user.");
 }
 
+BOOST_AUTO_TEST_CASE(CallMany)
+{
+	TestBlockChain testBlockchain(TestBlockChain::defaultGenesisBlock());
+	BlockChain const& bc = testBlockchain.interface();
+	Block block = bc.genesisBlock(testBlockchain.testGenesis().state().db());
+	block.sync(bc);
+	// Increments storage slot 0 and returns the new value.
+	Address const counter(0x1000);
+	block.mutableState().createContract(counter);
+	block.mutableState().setNewCode(counter, fromHex("6000546001018060005560005260206000f3"));
+	block.mutableState().commit(State::CommitBehaviour::KeepEmptyAccounts);
+	FixedClient client(bc, block);
+	FixedAccountHolder accountHolder([&](){ return &client; }, {});
+	rpc::Eth eth(client, accountHolder);
+
+	Json::Value calls(Json::arrayValue);
+	for (string gas: {"0x186a0", "0x64", "0x186a0"})
+	{
+		Json::Value c;
+		c["from"] = string("0xa94f5374fce5edbc8e2a8697c15331677e6ebf0b");
+		c["to"] = toJS(counter);
+		c["gas"] = gas;
+		c["gasPrice"] = string("0x1");
+		calls.append(c);
+	}
+	Json::Value const r = eth.eth_callMany(calls, "pending");
+	BOOST_REQUIRE_EQUAL(r.size(), 3);
+	BOOST_CHECK_EQUAL(r[0u].asString(), toJS(h256(1).asBytes()));
+	BOOST_CHECK_EQUAL(r[1].asString(), "0x");
+	BOOST_CHECK_EQUAL(r[2].asString(), toJS(h256(1).asBytes()));
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 }
@@ -30,6 +30,7 @@ along with cpp-ethereum.  If not, see <http://www.gnu.org/licenses/>.
 #pragma warning(pop)
 #endif
 
+#include <libdevcore/TransientDirectory.h>
 #include <libp2p/Host.h>
 #include <libwhisper/WhisperDB.h>
 #include <libwhisper/WhisperHost.h>
@@ -48,6 +49,29 @@ struct P2PFixture: public TestOutputHelper
 	TestOutputHelper testHelper;
 };
 
+namespace
+{
+
+Envelope makeEnvelope(unsigned _expiry, AbridgedTopics const& _topics, bytes const& _data)
+{
+	RLPStream s(5);
+	s << _expiry << 50 << _topics << _data << 0;
+	return Envelope(RLP(s.out()));
+}
+
+map<h256, Envelope> makeEnvelopes(unsigned _count, unsigned _expiry)
+{
+	map<h256, Envelope> ret;
+	for (unsigned i = 0; i < _count; ++i)
+	{
+		Envelope e = makeEnvelope(_expiry, AbridgedTopics(), bytes{byte(i), byte(_expiry)});
+		ret[e.sha3()] = e;
+	}
+	return ret;
+}
+
+}
+
 BOOST_FIXTURE_TEST_SUITE(whisperDB, P2PFixture)
 
 //
@@ -227,4 +251,92 @@ BOOST_FIXTURE_TEST_SUITE(whisperDB, P2PFixture)
 //	}
 //}
 
+BOOST_AUTO_TEST_CASE(loadInChunks)
+{
+	TransientDirectory dir;
+	unsigned const now = utcTime();
+	map<h256, Envelope> const live = makeEnvelopes(10, now + 1000);
+	map<h256, Envelope> const expired = makeEnvelopes(3, now - 10);
+
+	WhisperMessagesDB db(dir.path());
+	db.saveMessages(live);
+	db.saveMessages(expired);
+
+	map<h256, Envelope> loaded;
+	WhisperMessagesDB::Cursor cursor;
+	unsigned chunks = 0;
+	bool more = true;
+	while (more)
+	{
+		size_t const before = loaded.size();
+		more = db.loadMessages(loaded, 3, cursor);
+		BOOST_CHECK_LE(loaded.size() - before, 3);
+		BOOST_REQUIRE_LT(++chunks, 10);
+	}
+	BOOST_CHECK_GE(chunks, 4);
+	BOOST_CHECK_EQUAL(loaded.size(), live.size());
+	for (auto const& i: live)
+		BOOST_CHECK(loaded.count(i.first));
+
+	// expired envelopes met on the way are gone.
+	for (auto const& i: expired)
+		BOOST_CHECK(db.lookup(i.first).empty());
+}
+
+BOOST_AUTO_TEST_CASE(deleteExpired)
+{
+	TransientDirectory dir;
+	unsigned const now = utcTime();
+	map<h256, Envelope> const early = makeEnvelopes(5, now + 100);
+	map<h256, Envelope> const late = makeEnvelopes(5, now + 200);
+
+	WhisperMessagesDB db(dir.path());
+	db.saveMessages(early);
+	db.saveMessages(late);
+
+	BOOST_CHECK_EQUAL(db.deleteExpired(now + 150), 5);
+	BOOST_CHECK_EQUAL(db.deleteExpired(now + 150), 0);
+	for (auto const& i: early)
+		BOOST_CHECK(db.lookup(i.first).empty());
+	for (auto const& i: late)
+		BOOST_CHECK(!db.lookup(i.first).empty());
+
+	map<h256, Envelope> loaded;
+	db.loadAllMessages(loaded);
+	BOOST_CHECK_EQUAL(loaded.size(), late.size());
+
+	BOOST_CHECK_EQUAL(db.deleteExpired(now + 200), 5);
+	loaded.clear();
+	db.loadAllMessages(loaded);
+	BOOST_CHECK(loaded.empty());
+}
+
+BOOST_AUTO_TEST_CASE(hostKeepsWatched)
+{
+	TransientDirectory dir;
+	Topics const topics{sha3("watched")};
+	Envelope const watched = makeEnvelope(utcTime() + 1000, abridge(topics), bytes{1});
+	Envelope const unwatched = makeEnvelope(utcTime() + 1000, abridge(Topics{sha3("other")}), bytes{2});
+
+	{
+		p2p::Host h1("Test");
+		p2p::Host h2("Test");
+		auto wh1 = h1.registerCapability(make_shared<WhisperHost>(true, dir.path()));
+		// a second host in the process shares the store rather than failing to open it.
+		auto wh2 = h2.registerCapability(make_shared<WhisperHost>(true, dir.path()));
+		wh1->installWatch(topics);
+		wh1->inject(watched);
+		wh1->inject(unwatched);
+	}
+
+	// neither host was started; the stored envelope is still found.
+	p2p::Host h("Test");
+	auto wh = h.registerCapability(make_shared<WhisperHost>(true, dir.path()));
+	BOOST_CHECK(wh->envelope(watched.sha3()).sha3() == watched.sha3());
+	BOOST_CHECK(wh->envelope(unwatched.sha3()).data().empty());
+	unsigned w = wh->installWatch(topics);
+	BOOST_CHECK(wh->watchMessages(w) == h256s{watched.sha3()});
+	BOOST_CHECK_EQUAL(wh->all().size(), 1);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -19,8 +19,11 @@ along with cpp-ethereum.  If not, see <http://www.gnu.org/licenses/>.
 * @date May 2015
 */
 
+#include <thread>
 #include <boost/test/unit_test.hpp>
+#include <libp2p/Host.h>
 #include <libwhisper/Message.h>
+#include <libwhisper/WhisperHost.h>
 #include <test/libtesteth/TestHelper.h>
 
 using namespace std;
@@ -116,4 +119,46 @@ BOOST_FIXTURE_TEST_SUITE(whisperMessage, TestOutputHelper)
 //	}
 //}
 
+BOOST_AUTO_TEST_CASE(workTarget)
+{
+	// a small target is searched on the calling thread alone
+	Secret zero;
+	Message m(createRandomPayload(42));
+	Envelope e = m.seal(zero, createRandomTopics(42), 1, 60000, 4);
+	BOOST_REQUIRE(e.workProved() >= 4);
+}
+
+BOOST_AUTO_TEST_CASE(workTargetPooled)
+{
+	// targets above a few bits are split with the pool; concurrent searches share it
+	Secret zero;
+	vector<Envelope> envelopes;
+	for (unsigned i = 0; i < 4; ++i)
+		envelopes.push_back(Message(createRandomPayload(i)).seal(zero, createRandomTopics(i), 1, 0));
+	vector<thread> posts;
+	for (auto& e: envelopes)
+		posts.push_back(thread([&e]() { e.proveWork(60000, 16, 2); }));
+	for (auto& t: posts)
+		t.join();
+	for (auto const& e: envelopes)
+		BOOST_CHECK(e.workProved() >= 16);
+}
+
+BOOST_AUTO_TEST_CASE(knownEnvelopeSkipped)
+{
+	p2p::Host h("Test");
+	auto wh = h.registerCapability(make_shared<WhisperHost>());
+	Secret zero;
+	Envelope const e1 = Message(createRandomPayload(1)).seal(zero, createRandomTopics(1), 100, 0);
+	Envelope const e2 = Message(createRandomPayload(2)).seal(zero, createRandomTopics(2), 100, 0);
+
+	wh->inject(e1);
+	BOOST_CHECK_EQUAL(wh->workEvaluated(), 1);
+	// neither a known envelope nor a repeat within the batch has its work evaluated again
+	wh->inject(e1);
+	wh->inject(Envelopes{e1, e2, e2});
+	BOOST_CHECK_EQUAL(wh->workEvaluated(), 2);
+	BOOST_CHECK_EQUAL(wh->all().size(), 2);
+}
+
 BOOST_AUTO_TEST_SUITE_END()